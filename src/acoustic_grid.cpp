@@ -0,0 +1,54 @@
+#include "acoustic_grid.hpp"
+
+#include "dungeon.hpp"
+
+#include <algorithm>
+
+void AcousticGrid::update(const Dungeon& d, int i) {
+    const int x = i % w_;
+    const int y = i / w_;
+    uint8_t c = 0;
+    if (d.soundPassable(x, y)) c = static_cast<uint8_t>(std::clamp(d.soundTileCost(x, y), 1, 255));
+    cost_[static_cast<size_t>(i)] = c;
+}
+
+void AcousticGrid::rebuild(const Dungeon& d) {
+    w_ = std::max(0, d.width);
+    h_ = std::max(0, d.height);
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    cost_.assign(n, uint8_t{0});
+    for (size_t i = 0; i < n; ++i) update(d, static_cast<int>(i));
+
+    epoch_ = d.terrainEpoch;
+    journalPos_ = d.terrainJournal.size();
+    materialRevision_ = d.materialRevision;
+    valid_ = true;
+}
+
+void AcousticGrid::sync(const Dungeon& d) {
+    const size_t n = static_cast<size_t>(std::max(0, d.width)) * static_cast<size_t>(std::max(0, d.height));
+    if (d.tiles.size() != n) {
+        // Packed/hollow level: nothing to mirror.
+        clear();
+        return;
+    }
+
+    if (!valid_ || d.width != w_ || d.height != h_ || d.terrainEpoch != epoch_ ||
+        d.materialRevision != materialRevision_ || journalPos_ > d.terrainJournal.size()) {
+        rebuild(d);
+        return;
+    }
+
+    for (size_t j = journalPos_; j < d.terrainJournal.size(); ++j) {
+        const int i = d.terrainJournal[j];
+        if (i >= 0 && static_cast<size_t>(i) < n) update(d, i);
+    }
+    journalPos_ = d.terrainJournal.size();
+}
+
+void AcousticGrid::clear() {
+    std::vector<uint8_t>().swap(cost_);
+    w_ = 0;
+    h_ = 0;
+    valid_ = false;
+}
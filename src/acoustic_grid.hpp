@@ -0,0 +1,49 @@
+#pragma once
+
+// Cached sound step costs for Dungeon::computeSoundMap() (see Dungeon::acoustics()).
+//
+// Every expansion of a sound search used to re-derive the cost of the tile being entered:
+// the tile type (walls/pillars/secret doors block, doors muffle) plus the substrate delta
+// from the material cache. AcousticGrid keeps that answer as one byte per tile:
+//   0      sound does not pass (Dungeon::soundPassable() is false)
+//   1..255 Dungeon::soundTileCost()
+//
+// It follows Dungeon::tiles like TilePlanes does: terrain edits replay
+// Dungeon::terrainJournal, and a new terrain epoch, a resized map or a rebuilt material
+// cache (Dungeon::materialRevision) re-derives the whole grid.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Dungeon;
+
+class AcousticGrid {
+public:
+    // Brings the grid up to date with `d`. Cheap when nothing changed.
+    void sync(const Dungeon& d);
+
+    // Releases the grid; the next sync() rebuilds from scratch.
+    void clear();
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    const uint8_t* costs() const { return cost_.data(); }
+    int cost(int x, int y) const { return cost_[static_cast<size_t>(y * w_ + x)]; }
+
+    size_t memoryBytes() const { return cost_.capacity(); }
+
+private:
+    void rebuild(const Dungeon& d);
+    void update(const Dungeon& d, int i);
+
+    std::vector<uint8_t> cost_;
+
+    int w_ = 0;
+    int h_ = 0;
+    uint32_t epoch_ = 0u;
+    size_t journalPos_ = 0;
+    uint32_t materialRevision_ = 0u;
+    bool valid_ = false;
+};
@@ -24,25 +24,25 @@ namespace {
 // Used by monsters when they only have an *approximate* last-known player position
 // (typically from noise localization).
 const std::vector<std::vector<Vec2i>>& investigationRings() {
-    static std::vector<std::vector<Vec2i>> rings;
-    if (!rings.empty()) return rings;
+    // Built once, thread-safely: headless replay verification runs games in parallel.
+    static const std::vector<std::vector<Vec2i>> rings = [] {
+        constexpr int MAXR = 8;
+        std::vector<std::vector<Vec2i>> out(MAXR + 1);
 
-    constexpr int MAXR = 8;
-    rings.resize(MAXR + 1);
+        out[0].push_back({0, 0});
 
-    rings[0].push_back({0, 0});
-
-    for (int r = 1; r <= MAXR; ++r) {
-        auto& v = rings[static_cast<size_t>(r)];
-        v.reserve(static_cast<size_t>(8 * r));
-
-        // Walk the perimeter clockwise starting from the north-west corner.
-        for (int dx = -r; dx <= r; ++dx) v.push_back({dx, -r});
-        for (int dy = -r + 1; dy <= r - 1; ++dy) v.push_back({r, dy});
-        for (int dx = r; dx >= -r; --dx) v.push_back({dx, r});
-        for (int dy = r - 1; dy >= -r + 1; --dy) v.push_back({-r, dy});
-    }
+        for (int r = 1; r <= MAXR; ++r) {
+            auto& v = out[static_cast<size_t>(r)];
+            v.reserve(static_cast<size_t>(8 * r));
 
+            // Walk the perimeter clockwise starting from the north-west corner.
+            for (int dx = -r; dx <= r; ++dx) v.push_back({dx, -r});
+            for (int dy = -r + 1; dy <= r - 1; ++dy) v.push_back({r, dy});
+            for (int dx = r; dx >= -r; --dx) v.push_back({dx, r});
+            for (int dy = r - 1; dy >= -r + 1; --dy) v.push_back({-r, dy});
+        }
+        return out;
+    }();
     return rings;
 }
 
@@ -245,51 +245,104 @@ void Game::monsterTurn() {
     };
 
     // Discovered traps are visible in the world; most creatures will try to route around them
-    // when practical. Build a per-tile penalty map so pathfinding can be trap-aware without
-    // doing an O(traps) lookup per tile expansion.
-    std::vector<int> discoveredTrapPenalty = buildDiscoveredTrapPenaltyGrid(*this);
-    if (discoveredTrapPenalty.size() != static_cast<size_t>(W * H)) {
-        discoveredTrapPenalty.assign(static_cast<size_t>(W * H), 0);
-    }
+    // when practical. The nav grid bakes terrain + discovered-trap penalties into per-caps
+    // planes; trap knowledge is snapshotted here once per turn, while terrain changes made
+    // by earlier movers (doors, digging, boulders) are replayed on each navFor() call.
+    monsterNav_.sync(dung, trapsCur);
+    auto navFor = [&](int caps) -> MonsterNavView {
+        monsterNav_.syncTerrain(dung);
+        return monsterNavView(*this, monsterNav_, caps);
+    };
 
-    // Cache cost-to-target maps for this turn.
-    // Keyed by (target tile index, capability mask) to keep caching correct.
+    // Cost-to-target maps: the first request for a (target tile, capability mask) in a
+    // turn is served from the cross-turn monsterCostCache_, keyed additionally by the nav
+    // grid generation and the hazard penalty layout, so a stationary target only costs a
+    // Dijkstra run when terrain/doors/traps/hazard penalties actually changed. Within a
+    // turn the first answer sticks (as before), even if an earlier mover opened a door.
     // These maps are "minimum turns" approximations (doors/locks cost extra).
-    std::unordered_map<int, std::vector<int>> costCache;
+    monsterCostCache_.beginTurn();
+    std::unordered_map<int, const std::vector<int>*> costCache;
     costCache.reserve(32);
 
+    // Per-tile hazard step penalty over the union of the fields' active rects (every
+    // nonzero hazard tile lies inside its field's rect).
+    auto hazardLayout = [&]() -> MonsterHazardLayout {
+        MonsterHazardLayout l;
+        const size_t n = static_cast<size_t>(W) * static_cast<size_t>(H);
+        const std::pair<const std::vector<uint8_t>*, const hazard::ActiveRect*> fields[] = {
+            {&fireField_, &fireActive_}, {&confusionGas_, &confusionActive_},
+            {&poisonGas_, &poisonActive_}, {&corrosiveGas_, &corrosiveActive_},
+        };
+        for (const auto& [field, active] : fields) {
+            if (field->size() < n) continue;
+            const hazard::ActiveRect r = active->clipped(W, H);
+            if (r.empty()) continue;
+            if (l.empty()) {
+                l.x0 = r.x0;
+                l.y0 = r.y0;
+                l.x1 = r.x1;
+                l.y1 = r.y1;
+            } else {
+                l.x0 = std::min(l.x0, r.x0);
+                l.y0 = std::min(l.y0, r.y0);
+                l.x1 = std::max(l.x1, r.x1);
+                l.y1 = std::max(l.y1, r.y1);
+            }
+        }
+        if (l.empty()) return l;
+
+        auto at = [n](const std::vector<uint8_t>& f, size_t i) { return (f.size() >= n) ? f[i] : uint8_t{0}; };
+        l.penalty.reserve(static_cast<size_t>((l.x1 - l.x0 + 1) * (l.y1 - l.y0 + 1)));
+        for (int y = l.y0; y <= l.y1; ++y) {
+            for (int x = l.x0; x <= l.x1; ++x) {
+                const size_t i = static_cast<size_t>(idx(x, y));
+                const int p = monsterHazardStepPenalty(at(fireField_, i), at(confusionGas_, i),
+                                                       at(poisonGas_, i), at(corrosiveGas_, i));
+                l.penalty.push_back(static_cast<uint8_t>(p));
+            }
+        }
+        return l;
+    };
+
     auto getCostMap = [&](Vec2i target, int caps) -> const std::vector<int>& {
         // Key by (target tile index, capability mask). We pack caps in the low bits.
         // We keep caps <= 3 bits (0..7) in monster_pathing.hpp.
         const int key = (idx(target.x, target.y) << 3) | (caps & 7);
         auto it = costCache.find(key);
-        if (it != costCache.end()) return it->second;
+        if (it != costCache.end()) return *it->second;
 
-        PassableFn passable = monsterPassableFn(*this, caps);
-        StepCostFn stepCost = monsterStepCostFn(*this, caps, &discoveredTrapPenalty);
-        DiagonalOkFn diagOk = monsterDiagonalOkFn(*this, caps);
+        const MonsterNavView nav = navFor(caps);
+        MonsterCostCacheKey ck;
+        ck.target = idx(target.x, target.y);
+        ck.caps = caps & 7;
+        ck.navGen = monsterNav_.generation();
+        ck.hazardId = monsterCostCache_.internHazards(hazardLayout());
 
-        auto [it2, inserted] = costCache.emplace(key, dijkstraCostToTarget(W, H, target, passable, stepCost, diagOk));
-        (void)inserted;
-        return it2->second;
+        const std::vector<int>& m = monsterCostCache_.getOrCompute(ck, [&](std::vector<int>& out) {
+            monsterCostToTarget(nav, H, target, out);
+        });
+        costCache.emplace(key, &m);
+        return m;
     };
 
     auto bestStepToward = [&](const Entity& m, const std::vector<int>& costMap, int caps) -> Vec2i {
         Vec2i best = m.pos;
         int bestScore = std::numeric_limits<int>::max();
+        if (!dung.inBounds(m.pos.x, m.pos.y)) return best;
+        const MonsterNavView nav = navFor(caps);
         for (auto& dv : dirs) {
             int dx = dv[0], dy = dv[1];
             const int nx = m.pos.x + dx;
             const int ny = m.pos.y + dy;
             if (!dung.inBounds(nx, ny)) continue;
-            if (dx != 0 && dy != 0 && !monsterDiagonalOkForCaps(*this, m.pos.x, m.pos.y, dx, dy, caps)) continue;
-            if (!monsterPassableForCaps(*this, nx, ny, caps)) continue;
+            if (!nav.diagonalOk(m.pos.x, m.pos.y, dx, dy)) continue;
+            if (!nav.passable(nx, ny)) continue;
             if (entityAt(nx, ny)) continue;
 
             const int cToTarget = costMap[static_cast<size_t>(idx(nx, ny))];
             if (cToTarget < 0) continue;
 
-            const int step = monsterStepCostForCaps(*this, nx, ny, caps, &discoveredTrapPenalty);
+            const int step = nav.stepCost(nx, ny);
             if (step <= 0) continue;
 
             // Choose the move that minimizes "step + remaining" cost.
@@ -305,13 +358,15 @@ void Game::monsterTurn() {
     auto bestStepAway = [&](const Entity& m, const std::vector<int>& costMap, int caps) -> Vec2i {
         Vec2i best = m.pos;
         int bestD = -1;
+        if (!dung.inBounds(m.pos.x, m.pos.y)) return best;
+        const MonsterNavView nav = navFor(caps);
         for (auto& dv : dirs) {
             int dx = dv[0], dy = dv[1];
             const int nx = m.pos.x + dx;
             const int ny = m.pos.y + dy;
             if (!dung.inBounds(nx, ny)) continue;
-            if (dx != 0 && dy != 0 && !monsterDiagonalOkForCaps(*this, m.pos.x, m.pos.y, dx, dy, caps)) continue;
-            if (!monsterPassableForCaps(*this, nx, ny, caps)) continue;
+            if (!nav.diagonalOk(m.pos.x, m.pos.y, dx, dy)) continue;
+            if (!nav.passable(nx, ny)) continue;
             if (entityAt(nx, ny)) continue;
 
             const int d0 = costMap[static_cast<size_t>(idx(nx, ny))];
@@ -1367,7 +1422,7 @@ void Game::monsterTurn() {
                             pushMsg(std::string("THE ") + kindNameForMsg(m, player().effects.hallucinationTurns > 0) + " BLINKS!", MessageKind::Info, false);
                         }
 
-                        m.pos = cand;
+                        setEntityPos(m, cand);
 
                         if (wasVisible) {
                             pushFxParticle(FXParticlePreset::Blink, m.pos, 10, 0.18f, 0.03f);
@@ -1690,6 +1745,7 @@ void Game::monsterTurn() {
                 auto seedPoisonGas = [&](Vec2i c, int radius, uint8_t baseStrength) {
                     ensureField(poisonGas_);
                     if (poisonGas_.empty()) return;
+                    markHazard(poisonGas_, c.x, c.y, radius);
                     dung.computeFovMask(c.x, c.y, radius, aoeMask);
                     for (int dy = -radius; dy <= radius; ++dy) {
                         for (int dx = -radius; dx <= radius; ++dx) {
@@ -1716,6 +1772,7 @@ void Game::monsterTurn() {
                 auto seedFireField = [&](Vec2i c, int radius, uint8_t baseStrength) {
                     ensureField(fireField_);
                     if (fireField_.empty()) return;
+                    markHazard(fireField_, c.x, c.y, radius);
                     dung.computeFovMask(c.x, c.y, radius, aoeMask);
                     for (int dy = -radius; dy <= radius; ++dy) {
                         for (int dx = -radius; dx <= radius; ++dx) {
@@ -1807,7 +1864,7 @@ void Game::monsterTurn() {
                             pushFxParticle(FXParticlePreset::Blink, m.pos, 16, 0.18f);
                             pushFxParticle(FXParticlePreset::Blink, best, 16, 0.18f, 0.03f);
 
-                            m.pos = best;
+                            setEntityPos(m, best);
                             emitNoise(m.pos, 10);
 
                             if (isAdjacent8(m.pos, p.pos)) {
@@ -2029,7 +2086,7 @@ void Game::monsterTurn() {
                             fxp.stepTime = 0.02f;
                             fx.push_back(fxp);
 
-                            pm.pos = dest;
+                            setEntityPos(pm, dest);
                             emitNoise(dest, 12);
 
                             // Trigger traps on landing and update vision immediately (forced movement can change LOS).
@@ -2220,7 +2277,7 @@ void Game::monsterTurn() {
 
                         if (dst != m.pos) {
                             const bool wasVisible = dung.inBounds(m.pos.x, m.pos.y) && dung.at(m.pos.x, m.pos.y).visible;
-                            m.pos = dst;
+                            setEntityPos(m, dst);
                             if (wasVisible) pushMsg("IT VANISHES!", MessageKind::Info, false);
                             return;
                         }
@@ -2253,7 +2310,7 @@ void Game::monsterTurn() {
                     }
                     if (dst != m.pos) {
                         const bool wasVisible = dung.inBounds(m.pos.x, m.pos.y) && dung.at(m.pos.x, m.pos.y).visible;
-                        m.pos = dst;
+                        setEntityPos(m, dst);
                         if (wasVisible) pushMsg(msg, mk, false);
                         return true;
                     }
@@ -2524,7 +2581,7 @@ void Game::monsterTurn() {
                 }
                 if (dst != m.pos) {
                     const bool wasVisible = dung.inBounds(m.pos.x, m.pos.y) && dung.at(m.pos.x, m.pos.y).visible;
-                    m.pos = dst;
+                    setEntityPos(m, dst);
                     if (wasVisible) pushMsg("THE WIZARD BLINKS AWAY!", MessageKind::Warning, false);
                     return;
                 }
@@ -2549,7 +2606,7 @@ void Game::monsterTurn() {
 
                 if (dst != m.pos) {
                     const bool wasVisible = dung.inBounds(m.pos.x, m.pos.y) && dung.at(m.pos.x, m.pos.y).visible;
-                    m.pos = dst;
+                    setEntityPos(m, dst);
                     if (wasVisible) pushMsg("THE LEPRECHAUN VANISHES!", MessageKind::Warning, false);
                     return;
                 }
@@ -2574,7 +2631,7 @@ void Game::monsterTurn() {
 
                 if (dst != m.pos) {
                     const bool wasVisible = dung.inBounds(m.pos.x, m.pos.y) && dung.at(m.pos.x, m.pos.y).visible;
-                    m.pos = dst;
+                    setEntityPos(m, dst);
                     if (wasVisible) pushMsg("THE NYMPH VANISHES!", MessageKind::Warning, false);
                     return;
                 }
@@ -2631,7 +2688,7 @@ void Game::monsterTurn() {
                         TileType t = dung.at(nxt.x, nxt.y).type;
                         if (t == TileType::DoorClosed || t == TileType::DoorLocked) {
                             // Smash doors open as part of the charge.
-                            dung.at(nxt.x, nxt.y).type = TileType::DoorOpen;
+                            dung.setTileType(nxt.x, nxt.y, TileType::DoorOpen);
                             emitNoise(nxt, 14);
                             if (wasVisible) {
                                 pushMsg("A DOOR BURSTS OPEN!", MessageKind::System, false);
@@ -2643,7 +2700,7 @@ void Game::monsterTurn() {
                         if (!dung.isWalkable(nxt.x, nxt.y)) break;
 
                         // Move.
-                        m.pos = nxt;
+                        setEntityPos(m, nxt);
                         cur = nxt;
 
                         // Charging can still trigger traps.
@@ -2806,7 +2863,7 @@ void Game::monsterTurn() {
                         if (newMan <= 2) score += 400;
 
                         // Prefer "cheaper" tiles (includes hazards).
-                        const int stepC = monsterStepCostForCaps(*this, nx, ny, caps, &discoveredTrapPenalty);
+                        const int stepC = navFor(caps).stepCost(nx, ny);
                         if (stepC > 0) score += stepC * 10;
 
                         if (!found || score < bestScore) {
@@ -1198,6 +1198,8 @@ void Game::attackMelee(Entity& attacker, Entity& defender, bool kick) {
 
             const Vec2i before = defender.pos;
             KnockbackResult kb = applyKnockback(dung, ents, rng, attacker.id, defender.id, kdx, kdy, kcfg);
+            // applyKnockback() works on the raw entity vector; sync the occupancy index.
+            if (defender.pos != before) noteEntityMoved(defender, before);
 
             if (kb.stepsMoved > 0) {
                 std::ostringstream ks;
@@ -1216,6 +1218,9 @@ void Game::attackMelee(Entity& attacker, Entity& defender, bool kick) {
                 }
             }
 
+            // The smash and the stop below are heard together.
+            NoiseBatch noises(*this);
+
             // Door smash feedback.
             if (kb.doorChanged) {
                 pushMsg("A DOOR BURSTS OPEN!", MessageKind::System, msgFromPlayer);
@@ -1785,11 +1790,13 @@ void Game::attackRanged(Entity& attacker, Vec2i target, int range, int atkBonus,
             if (tt.type == TileType::DoorClosed) {
                 if (rng.chance(0.35f)) {
                     tt.type = TileType::DoorOpen;
+                    dung.noteTerrainChanged(bt.x, bt.y);
                     if (tt.visible) ++doorsBlownSeen;
                 }
             } else if (tt.type == TileType::DoorLocked) {
                 if (rng.chance(0.15f)) {
                     tt.type = TileType::DoorOpen;
+                    dung.noteTerrainChanged(bt.x, bt.y);
                     if (tt.visible) ++doorsBlownSeen;
                 }
             }
@@ -1822,6 +1829,7 @@ void Game::attackRanged(Entity& attacker, Vec2i target, int range, int atkBonus,
                 const uint8_t next = static_cast<uint8_t>(clampi(s, 0, 255));
                 if (next > prev) {
                     fireField_[i] = next;
+                    markHazard(fireField_, bt.x, bt.y);
                     if (prev == uint8_t{0} && dung.at(bt.x, bt.y).visible) ++ignitedVisible;
                 }
             }
@@ -2277,6 +2285,7 @@ void Game::attackRanged(Entity& attacker, Vec2i target, int range, int atkBonus,
                             const uint8_t prev = fireField_[i];
                             const uint8_t next = static_cast<uint8_t>(std::max<int>(prev, 5));
                             fireField_[i] = next;
+                            markHazard(fireField_, land.x, land.y);
                         }
                     }
                 }
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 
 namespace {
@@ -486,16 +488,21 @@ void applySpawnOverride(std::vector<SpawnEntry>& table, const SpawnTableOverride
     }
 }
 
+// Rebuilt when the overrides change; the generation check is atomic and the rebuild is
+// locked so games on several threads (parallel replay verification) can share it.
 struct SpawnCaches {
     std::array<std::vector<SpawnEntry>, Game::DUNGEON_MAX_DEPTH + 1> room;
     std::array<std::vector<SpawnEntry>, Game::DUNGEON_MAX_DEPTH + 1> guardian;
-    uint32_t generation = 0;
+    std::atomic<uint32_t> generation{0u};
+    std::mutex mutex;
 };
 
 SpawnCaches g_spawnCaches;
 
 void rebuildSpawnCachesIfNeeded() {
-    if (g_spawnCaches.generation == g_generation) return;
+    if (g_spawnCaches.generation.load(std::memory_order_acquire) == g_generation) return;
+    std::lock_guard<std::mutex> lock(g_spawnCaches.mutex);
+    if (g_spawnCaches.generation.load(std::memory_order_relaxed) == g_generation) return;
 
     for (int depth = 1; depth <= Game::DUNGEON_MAX_DEPTH; ++depth) {
         g_spawnCaches.room[depth] = defaultRoomSpawnTable(depth);
@@ -511,7 +518,7 @@ void rebuildSpawnCachesIfNeeded() {
         }
     }
 
-    g_spawnCaches.generation = g_generation;
+    g_spawnCaches.generation.store(g_generation, std::memory_order_release);
 }
 
 } // namespace
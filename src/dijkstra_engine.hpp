@@ -0,0 +1,572 @@
+#pragma once
+
+// Header-templated Dijkstra engine for 8-way grid pathing.
+//
+// pathfinding.hpp keeps the std::function based API; those entry points are now
+// thin wrappers around the templates below. Hot callers (monster AI cost maps,
+// the visible-hostile threat field) call the templates directly so their
+// passable/stepCost/diagonalOk policies inline into the neighbor loop instead of
+// paying three type-erased calls per expansion.
+//
+// Allocation:
+//   Queue storage and the predecessor/provenance arrays live in a per-thread
+//   DijkstraScratch that keeps its capacity between searches. Results are written
+//   into caller-owned vectors, so a steady-state search allocates nothing.
+//
+// Queues:
+//   - Cost fields use a monotone radix queue. Dijkstra only ever pushes keys that
+//     are >= the last popped key, and the small integer step costs used by
+//     monsters and auto-travel keep nearly all traffic in the lowest buckets.
+//   - path() keeps a (cost, index) binary heap. Path reconstruction depends on
+//     the pop order of equal-cost nodes and dungeon generation carves corridors
+//     from these paths, so the legacy tie order must be preserved exactly.
+//
+// Policy callables follow the conventions documented in pathfinding.hpp.
+// They must not start another search on the same thread while one is running
+// (a nested search falls back to a private scratch, which is correct but slow).
+
+#include "common.hpp"
+#include "pathfinding.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace dijkstra {
+
+// Diagonal policy that never blocks corner moves.
+struct AllowAllDiagonals {
+    bool operator()(int, int, int, int) const { return true; }
+};
+
+inline int bitWidth32(uint32_t v) {
+#if defined(__GNUG__) || defined(__clang__)
+    return (v == 0u) ? 0 : 32 - __builtin_clz(v);
+#else
+    int n = 0;
+    while (v) { ++n; v >>= 1u; }
+    return n;
+#endif
+}
+
+// Monotone radix heap keyed by non-negative int costs.
+//
+// Invariant: every pushed key is >= the key most recently popped. Entries whose
+// key equals the last popped key live in bucket 0; otherwise an entry lives in
+// the bucket given by the highest bit in which its key differs from it.
+class RadixQueue {
+public:
+    void clear() {
+        for (auto& b : buckets_) b.clear();
+        last_ = 0u;
+        size_ = 0;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    void push(int key, int idx) {
+        const uint32_t k = static_cast<uint32_t>(key);
+        buckets_[bucketFor(k)].push_back(Entry{k, idx});
+        ++size_;
+    }
+
+    // Pops an entry with the minimum key. Undefined when empty().
+    void pop(int& key, int& idx) {
+        if (buckets_[0].empty()) {
+            size_t b = 1;
+            while (buckets_[b].empty()) ++b;
+
+            std::vector<Entry>& src = buckets_[b];
+            uint32_t mn = src.front().key;
+            for (const Entry& e : src) mn = std::min(mn, e.key);
+            last_ = mn;
+
+            // Every entry moves to a strictly lower bucket.
+            for (const Entry& e : src) buckets_[bucketFor(e.key)].push_back(e);
+            src.clear();
+        }
+
+        const Entry e = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        key = static_cast<int>(e.key);
+        idx = e.idx;
+    }
+
+private:
+    struct Entry {
+        uint32_t key;
+        int idx;
+    };
+
+    size_t bucketFor(uint32_t k) const {
+        return static_cast<size_t>(bitWidth32(k ^ last_));
+    }
+
+    std::array<std::vector<Entry>, 33> buckets_{};
+    uint32_t last_ = 0u;
+    size_t size_ = 0;
+};
+
+// Reusable per-thread buffers. Everything is resized with assign()/clear() so the
+// capacity from earlier (same-sized) maps is kept.
+struct DijkstraScratch {
+    RadixQueue queue;
+    std::vector<uint64_t> heap;  // packed (cost << 32 | index) for path()
+    std::vector<int> best;
+    std::vector<int> prev;
+    std::vector<int> seed;
+    bool inUse = false;
+};
+
+// RAII handle to the calling thread's scratch (or a private one if a search is
+// already running on this thread).
+class ScratchLease {
+public:
+    ScratchLease() {
+        thread_local DijkstraScratch tls;
+        if (!tls.inUse) {
+            s_ = &tls;
+        } else {
+            own_ = std::make_unique<DijkstraScratch>();
+            s_ = own_.get();
+        }
+        s_->inUse = true;
+    }
+    ~ScratchLease() { s_->inUse = false; }
+
+    ScratchLease(const ScratchLease&) = delete;
+    ScratchLease& operator=(const ScratchLease&) = delete;
+
+    DijkstraScratch& operator*() const { return *s_; }
+    DijkstraScratch* operator->() const { return s_; }
+
+private:
+    DijkstraScratch* s_ = nullptr;
+    std::unique_ptr<DijkstraScratch> own_;
+};
+
+namespace detail {
+
+constexpr int DIRS8[8][2] = {
+    {1,0},{-1,0},{0,1},{0,-1},
+    {1,1},{1,-1},{-1,1},{-1,-1}
+};
+
+constexpr int INF = std::numeric_limits<int>::max() / 4;
+
+inline bool inBounds(int w, int h, int x, int y) {
+    return x >= 0 && y >= 0 && x < w && y < h;
+}
+
+inline size_t mapSize(int width, int height) {
+    return static_cast<size_t>(std::max(0, width) * std::max(0, height));
+}
+
+// Shared multi-source search.
+//
+// Reverse == true expands outward from the seeds while pricing each edge by the
+// cost of entering the *popped* tile (cost-to-seed fields). Reverse == false
+// prices edges by the neighbor being entered (cost-from-seed fields).
+//
+// `best` must be INF-filled and sized to the map. On return it holds the raw
+// INF-sentinel costs.
+template <bool Reverse, typename SeedAt, typename PassableF, typename StepCostF, typename DiagOkF>
+inline void seededSearch(
+    int width,
+    int height,
+    size_t seedCount,
+    const SeedAt& seedAt,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    int maxCost,
+    std::vector<int>& best,
+    RadixQueue& pq)
+{
+    pq.clear();
+
+    for (size_t s = 0; s < seedCount; ++s) {
+        const DijkstraSeed sd = seedAt(s);
+        if (!inBounds(width, height, sd.pos.x, sd.pos.y)) continue;
+        if (!passable(sd.pos.x, sd.pos.y)) continue;
+
+        int init = sd.initialCost;
+        if (init < 0) init = 0;
+        if (maxCost >= 0 && init > maxCost) continue;
+
+        const int si = sd.pos.y * width + sd.pos.x;
+        int& slot = best[static_cast<size_t>(si)];
+        if (init >= slot) continue;
+
+        slot = init;
+        pq.push(init, si);
+    }
+
+    while (!pq.empty()) {
+        int costHere = 0;
+        int i = 0;
+        pq.pop(costHere, i);
+
+        if (maxCost >= 0 && costHere > maxCost) continue;
+        if (best[static_cast<size_t>(i)] != costHere) continue;
+
+        const int x = i % width;
+        const int y = i / width;
+
+        int enterCostHere = 0;
+        if (Reverse) {
+            // A path neighbor -> (x,y) -> ... pays for entering (x,y).
+            enterCostHere = stepCost(x, y);
+            if (enterCostHere <= 0) continue;
+        }
+
+        for (const auto& dv : DIRS8) {
+            const int nx = x + dv[0];
+            const int ny = y + dv[1];
+            if (!inBounds(width, height, nx, ny)) continue;
+            if (!passable(nx, ny)) continue;
+
+            if (dv[0] != 0 && dv[1] != 0) {
+                if (Reverse) {
+                    // Reverse move: neighbor -> current, so flip the direction.
+                    if (!diagonalOk(nx, ny, -dv[0], -dv[1])) continue;
+                } else {
+                    if (!diagonalOk(x, y, dv[0], dv[1])) continue;
+                }
+            }
+
+            int step = enterCostHere;
+            if (!Reverse) {
+                step = stepCost(nx, ny);
+                if (step <= 0) continue;
+            }
+
+            const int ncost = costHere + step;
+            if (maxCost >= 0 && ncost > maxCost) continue;
+
+            const int ni = ny * width + nx;
+            int& slot = best[static_cast<size_t>(ni)];
+            if (ncost < slot) {
+                slot = ncost;
+                pq.push(ncost, ni);
+            }
+        }
+    }
+}
+
+// Converts an INF-sentinel field into the public -1 sentinel format in place.
+inline void finalizeCostField(std::vector<int>& field, int maxCost) {
+    for (int& v : field) {
+        if (v == INF || (maxCost >= 0 && v > maxCost)) v = -1;
+    }
+}
+
+} // namespace detail
+
+// Returns a path including {start, ..., goal}. Empty on failure.
+// Same semantics (and tie-breaking) as ::dijkstraPath.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline std::vector<Vec2i> path(
+    int width,
+    int height,
+    Vec2i start,
+    Vec2i goal,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk)
+{
+    using detail::inBounds;
+    if (width <= 0 || height <= 0) return {};
+    if (!inBounds(width, height, start.x, start.y)) return {};
+    if (!inBounds(width, height, goal.x, goal.y)) return {};
+    if (start == goal) return {start};
+
+    const int startI = start.y * width + start.x;
+    const int goalI = goal.y * width + goal.x;
+    const size_t n = detail::mapSize(width, height);
+
+    ScratchLease s;
+    std::vector<int>& dist = s->best;
+    std::vector<int>& prev = s->prev;
+    std::vector<uint64_t>& heap = s->heap;
+    dist.assign(n, detail::INF);
+    prev.assign(n, -1);
+    heap.clear();
+
+    auto pack = [](int cost, int idx) -> uint64_t {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cost)) << 32) | static_cast<uint32_t>(idx);
+    };
+    const std::greater<uint64_t> cmp;
+
+    // Note: we intentionally do NOT require passable(start); the caller may
+    // allow starting on non-passable tiles in some edge cases (e.g., standing
+    // on an explored-but-locked door that just got unlocked).
+    dist[static_cast<size_t>(startI)] = 0;
+    heap.push_back(pack(0, startI));
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        const uint64_t top = heap.back();
+        heap.pop_back();
+
+        const int costHere = static_cast<int>(top >> 32);
+        const int i = static_cast<int>(top & 0xFFFFFFFFu);
+        if (i == goalI) break;
+        if (costHere != dist[static_cast<size_t>(i)]) continue;
+
+        const int x = i % width;
+        const int y = i / width;
+
+        for (const auto& dv : detail::DIRS8) {
+            const int nx = x + dv[0];
+            const int ny = y + dv[1];
+            if (!inBounds(width, height, nx, ny)) continue;
+            if (!passable(nx, ny)) continue;
+
+            if (dv[0] != 0 && dv[1] != 0) {
+                if (!diagonalOk(x, y, dv[0], dv[1])) continue;
+            }
+
+            const int step = stepCost(nx, ny);
+            if (step <= 0) continue;
+
+            const int ni = ny * width + nx;
+            const int ncost = costHere + step;
+            if (ncost < dist[static_cast<size_t>(ni)]) {
+                dist[static_cast<size_t>(ni)] = ncost;
+                prev[static_cast<size_t>(ni)] = i;
+                heap.push_back(pack(ncost, ni));
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    if (dist[static_cast<size_t>(goalI)] == detail::INF) return {};
+
+    std::vector<Vec2i> out;
+    int cur = goalI;
+    while (cur != -1) {
+        out.push_back({cur % width, cur / width});
+        if (cur == startI) break;
+        cur = prev[static_cast<size_t>(cur)];
+    }
+
+    if (out.empty() || out.back() != start) return {};
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+// Cost-to-nearest-seed field (reverse expansion) written into `out`.
+// Same semantics as ::dijkstraCostToNearestSeeded.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline void costToNearestSeeded(
+    int width,
+    int height,
+    const std::vector<DijkstraSeed>& seeds,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    std::vector<int>& out,
+    int maxCost = -1)
+{
+    const size_t n = detail::mapSize(width, height);
+    if (n == 0 || seeds.empty()) {
+        out.assign(n, -1);
+        return;
+    }
+
+    out.assign(n, detail::INF);
+    ScratchLease s;
+    detail::seededSearch<true>(width, height, seeds.size(),
+        [&](size_t i) { return seeds[i]; },
+        passable, stepCost, diagonalOk, maxCost, out, s->queue);
+    detail::finalizeCostField(out, maxCost);
+}
+
+// Cost-to-target field (reverse expansion) written into `out`.
+// Same semantics as ::dijkstraCostToTarget.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline void costToTarget(
+    int width,
+    int height,
+    Vec2i target,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    std::vector<int>& out,
+    int maxCost = -1)
+{
+    const size_t n = detail::mapSize(width, height);
+    if (n == 0) {
+        out.clear();
+        return;
+    }
+
+    out.assign(n, detail::INF);
+    ScratchLease s;
+    detail::seededSearch<true>(width, height, 1,
+        [&](size_t) { return DijkstraSeed{target, 0}; },
+        passable, stepCost, diagonalOk, maxCost, out, s->queue);
+    detail::finalizeCostField(out, maxCost);
+}
+
+// Cost-from-nearest-seed field (forward expansion) written into `out`.
+// Same semantics as ::dijkstraCostFromSeeded.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline void costFromSeeded(
+    int width,
+    int height,
+    const std::vector<DijkstraSeed>& seeds,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    std::vector<int>& out,
+    int maxCost = -1)
+{
+    const size_t n = detail::mapSize(width, height);
+    if (n == 0 || seeds.empty()) {
+        out.assign(n, -1);
+        return;
+    }
+
+    out.assign(n, detail::INF);
+    ScratchLease s;
+    detail::seededSearch<false>(width, height, seeds.size(),
+        [&](size_t i) { return seeds[i]; },
+        passable, stepCost, diagonalOk, maxCost, out, s->queue);
+    detail::finalizeCostField(out, maxCost);
+}
+
+// Cost-from-nearest-source field (forward expansion, all seeds at cost 0).
+// Same semantics as ::dijkstraCostFromSources.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline void costFromSources(
+    int width,
+    int height,
+    const std::vector<Vec2i>& sources,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    std::vector<int>& out,
+    int maxCost = -1)
+{
+    const size_t n = detail::mapSize(width, height);
+    if (n == 0 || sources.empty()) {
+        out.assign(n, -1);
+        return;
+    }
+
+    out.assign(n, detail::INF);
+    ScratchLease s;
+    detail::seededSearch<false>(width, height, sources.size(),
+        [&](size_t i) { return DijkstraSeed{sources[i], 0}; },
+        passable, stepCost, diagonalOk, maxCost, out, s->queue);
+    detail::finalizeCostField(out, maxCost);
+}
+
+// Reverse seeded search that also records which seed won each tile.
+// Same semantics (including the smallest-seed-index tie-break) as
+// ::dijkstraCostToNearestSeededWithProvenance.
+template <typename PassableF, typename StepCostF, typename DiagOkF>
+inline void costToNearestSeededWithProvenance(
+    int width,
+    int height,
+    const std::vector<DijkstraSeed>& seeds,
+    const PassableF& passable,
+    const StepCostF& stepCost,
+    const DiagOkF& diagonalOk,
+    DijkstraNearestSeededResult& out,
+    int maxCost = -1)
+{
+    using detail::inBounds;
+    const size_t n = detail::mapSize(width, height);
+    if (n == 0 || seeds.empty()) {
+        out.cost.assign(n, -1);
+        out.nearestSeedIndex.assign(n, -1);
+        return;
+    }
+
+    std::vector<int>& best = out.cost;
+    std::vector<int>& bestSeed = out.nearestSeedIndex;
+    best.assign(n, detail::INF);
+    bestSeed.assign(n, -1);
+
+    ScratchLease s;
+    RadixQueue& pq = s->queue;
+    pq.clear();
+
+    for (int si = 0; si < static_cast<int>(seeds.size()); ++si) {
+        const DijkstraSeed& sd = seeds[static_cast<size_t>(si)];
+        if (!inBounds(width, height, sd.pos.x, sd.pos.y)) continue;
+        if (!passable(sd.pos.x, sd.pos.y)) continue;
+
+        int init = sd.initialCost;
+        if (init < 0) init = 0;
+        if (maxCost >= 0 && init > maxCost) continue;
+
+        const int idx = sd.pos.y * width + sd.pos.x;
+        const size_t ii = static_cast<size_t>(idx);
+        const int cur = best[ii];
+        if (init < cur || (init == cur && (bestSeed[ii] < 0 || si < bestSeed[ii]))) {
+            best[ii] = init;
+            bestSeed[ii] = si;
+            pq.push(init, idx);
+        }
+    }
+
+    while (!pq.empty()) {
+        int costHere = 0;
+        int i = 0;
+        pq.pop(costHere, i);
+        const size_t ii = static_cast<size_t>(i);
+
+        if (maxCost >= 0 && costHere > maxCost) continue;
+        if (best[ii] != costHere) continue;
+
+        const int seedHere = bestSeed[ii];
+        if (seedHere < 0) continue;
+
+        const int x = i % width;
+        const int y = i / width;
+
+        const int enterCostHere = stepCost(x, y);
+        if (enterCostHere <= 0) continue;
+
+        for (const auto& dv : detail::DIRS8) {
+            const int nx = x + dv[0];
+            const int ny = y + dv[1];
+            if (!inBounds(width, height, nx, ny)) continue;
+            if (!passable(nx, ny)) continue;
+
+            if (dv[0] != 0 && dv[1] != 0) {
+                if (!diagonalOk(nx, ny, -dv[0], -dv[1])) continue;
+            }
+
+            const int ncost = costHere + enterCostHere;
+            if (maxCost >= 0 && ncost > maxCost) continue;
+
+            const size_t nii = static_cast<size_t>(ny * width + nx);
+            const int prevCost = best[nii];
+            const int prevSeed = bestSeed[nii];
+            if (ncost < prevCost || (ncost == prevCost && (prevSeed < 0 || seedHere < prevSeed))) {
+                best[nii] = ncost;
+                bestSeed[nii] = seedHere;
+                pq.push(ncost, static_cast<int>(nii));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (best[i] == detail::INF || (maxCost >= 0 && best[i] > maxCost)) {
+            best[i] = -1;
+            bestSeed[i] = -1;
+        }
+    }
+}
+
+} // namespace dijkstra
@@ -3,12 +3,15 @@
 #include "corridor_braid.hpp"
 #include "terrain_sculpt.hpp"
 #include "pathfinding.hpp"
+#include "dijkstra_engine.hpp"
 #include "wfc.hpp"
 #include "vault_prefab_catalog.hpp"
 #include "proc_rd.hpp"
 #include "poisson_disc.hpp"
 #include "spatial_hash.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <deque>
@@ -6944,13 +6947,14 @@ static bool tryWfcFurnishRoom(Dungeon& d, const Room& r, RNG& rng, int depth, in
     const int interiorArea = (maxX - minX + 1) * (maxY - minY + 1);
     if (interiorArea > 900) step = 3;
 
-    // Build rules once.
-    static bool rulesBuilt = false;
-    static std::vector<uint32_t> allow[4];
-    if (!rulesBuilt) {
-        buildWfcFurnishRules(allow);
-        rulesBuilt = true;
-    }
+    // Build rules once (thread-safe: floor candidates may be generated concurrently).
+    struct Rules { std::vector<uint32_t> allow[4]; };
+    static const Rules rules = [] {
+        Rules r;
+        buildWfcFurnishRules(r.allow);
+        return r;
+    }();
+    const std::vector<uint32_t>* allow = rules.allow;
 
     constexpr int nTiles = 4;
     const uint32_t floorBit = 1u << static_cast<uint32_t>(WfcFurnishTile::Floor);
@@ -10200,10 +10204,11 @@ static bool annexGenWfcAnnex(AnnexGrid& g, RNG& rng, Vec2i entry, int depth) {
     int startCx = std::clamp((entry.x - 1) / 2, 0, cellW - 1);
     int startCy = std::clamp((entry.y - 1) / 2, 0, cellH - 1);
 
-    // Build adjacency rules once.
-    static bool rulesBuilt = false;
-    static std::vector<uint32_t> allow[4];
-    if (!rulesBuilt) {
+    // Build adjacency rules once (thread-safe: floor candidates may be generated concurrently).
+    struct Rules { std::vector<uint32_t> allow[4]; };
+    static const Rules rules = [&] {
+        Rules r;
+        std::vector<uint32_t>* allow = r.allow;
         constexpr int nTiles = 16;
         for (int dir = 0; dir < 4; ++dir) allow[dir].assign(nTiles, 0u);
 
@@ -10225,8 +10230,9 @@ static bool annexGenWfcAnnex(AnnexGrid& g, RNG& rng, Vec2i entry, int depth) {
             }
         }
 
-        rulesBuilt = true;
-    }
+        return r;
+    }();
+    const std::vector<uint32_t>* allow = rules.allow;
 
     constexpr int nTiles = 16;
     const uint32_t full = wfc::allMask(nTiles);
@@ -12345,12 +12351,13 @@ static std::vector<std::string> makeWfcVaultBase(RNG& rng, int w, int h, char do
 
     // WFC solve on full grid with fixed boundary/door.
     constexpr int nTiles = 5;
-    static bool rulesBuilt = false;
-    static std::vector<uint32_t> allow[4];
-    if (!rulesBuilt) {
-        buildWfcVaultRules(allow);
-        rulesBuilt = true;
-    }
+    struct Rules { std::vector<uint32_t> allow[4]; };
+    static const Rules rules = [] {
+        Rules r;
+        buildWfcVaultRules(r.allow);
+        return r;
+    }();
+    const std::vector<uint32_t>* allow = rules.allow;
 
     auto bit = [](WfcVaultTile t) -> uint32_t { return 1u << static_cast<uint32_t>(t); };
 
@@ -17775,21 +17782,18 @@ Dungeon::Dungeon(int w, int h) : width(w), height(h) {
 
 bool Dungeon::isWalkable(int x, int y) const {
     if (!inBounds(x, y)) return false;
-    TileType t = at(x, y).type;
-    return (t == TileType::Floor || t == TileType::Fountain || t == TileType::Altar || t == TileType::DoorOpen || t == TileType::StairsDown || t == TileType::StairsUp);
+    return TilePlanes::walkableType(at(x, y).type);
 }
 
 bool Dungeon::isPassable(int x, int y) const {
     if (!inBounds(x, y)) return false;
-    TileType t = at(x, y).type;
     // Note: locked doors are NOT passable for pathing/AI until unlocked.
-    return (t == TileType::Floor || t == TileType::Fountain || t == TileType::Altar || t == TileType::DoorOpen || t == TileType::DoorClosed || t == TileType::StairsDown || t == TileType::StairsUp);
+    return TilePlanes::passableType(at(x, y).type);
 }
 
 bool Dungeon::isOpaque(int x, int y) const {
     if (!inBounds(x, y)) return true;
-    TileType t = at(x, y).type;
-    return (t == TileType::Wall || t == TileType::Pillar || t == TileType::DoorClosed || t == TileType::DoorLocked || t == TileType::DoorSecret);
+    return TilePlanes::opaqueType(at(x, y).type);
 }
 
 bool Dungeon::blocksProjectiles(int x, int y) const {
@@ -17831,6 +17835,7 @@ void Dungeon::closeDoor(int x, int y) {
     if (!inBounds(x, y)) return;
     if (at(x, y).type == TileType::DoorOpen) {
         at(x, y).type = TileType::DoorClosed;
+        noteTerrainChanged(x, y);
     }
 }
 
@@ -17838,6 +17843,7 @@ void Dungeon::openDoor(int x, int y) {
     if (!inBounds(x, y)) return;
     if (at(x, y).type == TileType::DoorClosed) {
         at(x, y).type = TileType::DoorOpen;
+        noteTerrainChanged(x, y);
     }
 }
 
@@ -17845,6 +17851,7 @@ void Dungeon::lockDoor(int x, int y) {
     if (!inBounds(x, y)) return;
     if (at(x, y).type == TileType::DoorClosed) {
         at(x, y).type = TileType::DoorLocked;
+        noteTerrainChanged(x, y);
     }
 }
 
@@ -17853,6 +17860,7 @@ void Dungeon::unlockDoor(int x, int y) {
     if (at(x, y).type == TileType::DoorLocked) {
         // Unlocking converts the door to a normal closed door.
         at(x, y).type = TileType::DoorClosed;
+        noteTerrainChanged(x, y);
     }
 }
 
@@ -17878,9 +17886,40 @@ bool Dungeon::dig(int x, int y) {
 
     // Digging destroys the obstacle and leaves a clear floor tile behind.
     at(x, y).type = TileType::Floor;
+    noteTerrainChanged(x, y);
     return true;
 }
 
+void Dungeon::setTileType(int x, int y, TileType t) {
+    if (!inBounds(x, y)) return;
+    if (at(x, y).type == t) return;
+    at(x, y).type = t;
+    noteTerrainChanged(x, y);
+}
+
+void Dungeon::noteTerrainChanged(int x, int y) {
+    if (!inBounds(x, y)) return;
+    if (terrainJournal.size() >= TERRAIN_JOURNAL_MAX) {
+        // Consumers that fell this far behind are cheaper to rebuild anyway.
+        resetTerrainJournal();
+    }
+    terrainJournal.push_back(y * width + x);
+}
+
+void Dungeon::resetTerrainJournal() {
+    terrainEpoch = nextTerrainEpoch();
+    terrainJournal.clear();
+}
+
+uint32_t Dungeon::nextTerrainEpoch() {
+    // Shared by every Dungeon instance (including worker-thread candidates), so
+    // epochs are unique per process. 0 is reserved for "never synced".
+    static std::atomic<uint32_t> counter{0u};
+    uint32_t e = counter.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    if (e == 0u) e = counter.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    return e;
+}
+
 namespace {
 
 
@@ -21335,7 +21374,7 @@ void Dungeon::generate(RNG& rng, int depth, int maxDepth) {
     generate(rng, DungeonBranch::Main, depth, maxDepth, 0u);
 }
 
-void Dungeon::generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth, uint32_t worldSeed) {
+void Dungeon::generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth, uint32_t worldSeed, int floorCandidates) {
     // A default-constructed Dungeon starts at 0x0. Ensure we have a valid grid
     // allocated before generation begins (especially for special layouts that return early).
     if (width <= 0 || height <= 0) {
@@ -21503,6 +21542,7 @@ void Dungeon::generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth,
         // Final safety: ensure stair tiles survive any later carving/decoration overlap.
         if (inBounds(stairsUp.x, stairsUp.y)) at(stairsUp.x, stairsUp.y).type = TileType::StairsUp;
         if (inBounds(stairsDown.x, stairsDown.y)) at(stairsDown.x, stairsDown.y).type = TileType::StairsDown;
+        resetTerrainJournal();
         return;
     }
 
@@ -21535,6 +21575,10 @@ void Dungeon::generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth,
     }
 
     attempts = std::clamp(attempts, 1, 3);
+
+    // Optional wider search (Settings::floorCandidates). This changes which floor wins,
+    // so it is a recorded gameplay setting and never derived from the core count.
+    if (floorCandidates > attempts) attempts = std::min(floorCandidates, MAX_FLOOR_CANDIDATES);
     genPickAttempts = attempts;
     genPickChosenIndex = 0;
     genPickScore = 0;
@@ -21550,25 +21594,33 @@ void Dungeon::generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth,
         attemptSeeds.push_back(s);
     }
 
-    int bestScore = std::numeric_limits<int>::min();
-    int bestIdx = 0;
-    Dungeon best(width, height);
-
-    for (int i = 0; i < attempts; ++i) {
-        RNG rr(attemptSeeds[static_cast<size_t>(i)]);
-        Dungeon cand(width, height);
+    // Each candidate only depends on its own seed, so they are built on the shared
+    // worker pool; the winner is still picked in index order (first best score wins).
+    std::vector<Dungeon> cands(static_cast<size_t>(attempts));
+    std::vector<int> scores(static_cast<size_t>(attempts), 0);
+    const int candW = width;
+    const int candH = height;
+    parallelFor(static_cast<size_t>(attempts), [&](size_t i) {
+        RNG rr(attemptSeeds[i]);
+        Dungeon cand(candW, candH);
 
         generateStandardFloorWithKind(cand, rr, branch, depth, maxDepth, g, worldSeed, stratum);
-        const int score = scoreFloorCandidate(cand, depth, maxDepth, attemptSeeds[static_cast<size_t>(i)]);
+        scores[i] = scoreFloorCandidate(cand, depth, maxDepth, attemptSeeds[i]);
+        cands[i] = std::move(cand);
+    });
 
+    int bestScore = std::numeric_limits<int>::min();
+    int bestIdx = 0;
+    for (int i = 0; i < attempts; ++i) {
+        const int score = scores[static_cast<size_t>(i)];
         if (i == 0 || score > bestScore) {
             bestScore = score;
             bestIdx = i;
-            best = std::move(cand);
         }
     }
 
-    *this = std::move(best);
+    *this = std::move(cands[static_cast<size_t>(bestIdx)]);
+    resetTerrainJournal();
     genPickAttempts = attempts;
     genPickChosenIndex = bestIdx;
     genPickScore = bestScore;
@@ -21807,6 +21859,7 @@ void Dungeon::ensureMaterials(uint32_t worldSeed, DungeonBranch branch, int dept
     }
 
     materialCacheKey = key;
+    ++materialRevision;
     materialCacheW = width;
     materialCacheH = height;
 
@@ -22705,196 +22758,307 @@ bool Dungeon::soundDiagonalOk(int fromX, int fromY, int dx, int dy) const {
     return soundPassable(ax, ay) || soundPassable(bx, by);
 }
 
+namespace {
+
+// Sound search over the cached step costs: a tile passes sound iff its cost is non-zero,
+// and a diagonal step needs at least one of the two cardinal tiles it cuts between to
+// pass sound (same rules as soundPassable()/soundTileCost()/soundDiagonalOk()).
+void soundSearch(const Dungeon& d, const std::vector<DijkstraSeed>& seeds, int maxCost, std::vector<int>& out) {
+    const AcousticGrid& grid = d.acoustics();
+    const uint8_t* cost = grid.costs();
+    const int w = grid.width();
+    if (grid.height() != d.height || w != d.width) {
+        out.assign(static_cast<size_t>(std::max(0, d.width * d.height)), -1);
+        return;
+    }
+
+    auto at = [&](int x, int y) -> int { return cost[static_cast<size_t>(y * w + x)]; };
+    dijkstra::costFromSeeded(
+        w, d.height, seeds,
+        [&](int x, int y) { return at(x, y) != 0; },
+        [&](int x, int y) { return at(x, y); },
+        [&](int fromX, int fromY, int dx, int dy) { return at(fromX + dx, fromY) != 0 || at(fromX, fromY + dy) != 0; },
+        out, maxCost);
+}
+
+} // namespace
+
 std::vector<int> Dungeon::computeSoundMap(int sx, int sy, int maxCost) const {
-    std::vector<int> dist(static_cast<size_t>(width * height), -1);
-    if (maxCost < 0) return dist;
-    if (!inBounds(sx, sy)) return dist;
+    std::vector<int> dist;
+    computeSoundMap(sx, sy, maxCost, dist);
+    return dist;
+}
 
-    auto soundPassableFn = [&](int x, int y) -> bool { return soundPassable(x, y); };
-    auto tileCostFn = [&](int x, int y) -> int { return soundTileCost(x, y); };
+void Dungeon::computeSoundMap(int sx, int sy, int maxCost, std::vector<int>& out) const {
+    if (maxCost < 0 || !inBounds(sx, sy)) {
+        out.assign(static_cast<size_t>(width * height), -1);
+        return;
+    }
+    const std::vector<DijkstraSeed> seeds = {DijkstraSeed{Vec2i{sx, sy}, 0}};
+    soundSearch(*this, seeds, maxCost, out);
+}
 
-    if (!soundPassableFn(sx, sy)) return dist;
+void Dungeon::computeSoundField(const std::vector<DijkstraSeed>& seeds, int maxCost, std::vector<int>& out) const {
+    if (maxCost < 0) {
+        out.assign(static_cast<size_t>(width * height), -1);
+        return;
+    }
+    soundSearch(*this, seeds, maxCost, out);
+}
 
-    // Prevent diagonal "corner cutting" through two blocking tiles.
-    DiagonalOkFn diagOk = [&](int fromX, int fromY, int dx, int dy) -> bool {
-        return soundDiagonalOk(fromX, fromY, dx, dy);
-    };
 
-    const std::vector<Vec2i> sources = {Vec2i{sx, sy}};
-    return dijkstraCostFromSources(width, height, sources, soundPassableFn, tileCostFn, diagOk, maxCost);
+
+namespace {
+
+// Shadowcasting for 8 octants (RogueBasin "Recursive Shadowcasting"), driven by an
+// explicit span stack instead of recursion. The visible set is the union of what every
+// span marks, so the processing order does not change the result.
+//
+// Scratch buffers are thread-local and only ever grow, so steady-state calls do not
+// allocate. Opacity probes read the Dungeon's opaque bitplane (see TilePlanes); the
+// visibility result covers the view window (the radius square clipped to the map),
+// which contains every probe the caster makes.
+struct FovScratch {
+    struct Span {
+        int row;
+        float start;
+        float end;
+    };
+
+    int x0 = 0;
+    int y0 = 0;
+    int w = 0;
+    int h = 0;
+    std::vector<uint8_t> vis; // 1 byte per window cell (0/1)
+    std::vector<Span> stack;
+    std::vector<int> changes; // computeFov(): tiles flipped by this call
+};
+
+FovScratch& fovScratch() {
+    thread_local FovScratch s;
+    return s;
 }
 
+// Edge slopes of cell (dx, -dist) in octant space, for dist <= kFovSlopeRadius.
+// Row `dist` starts at dist * (dist + 1) / 2; entries are indexed by dx + dist.
+// Built with the exact float expressions the caster used to evaluate per probe.
+struct FovSlope {
+    float l;
+    float r;
+};
 
+constexpr int kFovSlopeRadius = 64;
 
-void Dungeon::computeFov(int px, int py, int radius, bool markExplored) {
-    // Reset visibility each frame
-    for (auto& t : tiles) t.visible = false;
-    if (!inBounds(px, py)) return;
+const FovSlope* fovSlopeRow(int dist) {
+    static const std::vector<FovSlope> table = [] {
+        std::vector<FovSlope> t;
+        t.reserve(static_cast<size_t>((kFovSlopeRadius + 1) * (kFovSlopeRadius + 2) / 2));
+        for (int dist = 0; dist <= kFovSlopeRadius; ++dist) {
+            const int dy = -dist;
+            for (int dx = -dist; dx <= 0; ++dx) {
+                t.push_back({(dx - 0.5f) / (dy + 0.5f), (dx + 0.5f) / (dy - 0.5f)});
+            }
+        }
+        return t;
+    }();
+    if (dist > kFovSlopeRadius) return nullptr;
+    return table.data() + static_cast<size_t>(dist * (dist + 1) / 2);
+}
 
-    auto isOpaqueTile = [&](int x, int y) {
-        if (!inBounds(x, y)) return true;
-        TileType tt = at(x, y).type;
-        return (tt == TileType::Wall || tt == TileType::Pillar || tt == TileType::DoorClosed || tt == TileType::DoorLocked || tt == TileType::DoorSecret);
-    };
+// Fills s.vis for the window around (px, py), which must be in bounds.
+void shadowcastFov(const Dungeon& d, int px, int py, int radius, FovScratch& s) {
+    const int reach = std::max(0, radius);
+    s.x0 = std::max(0, px - reach);
+    s.y0 = std::max(0, py - reach);
+    s.w = std::min(d.width - 1, px + reach) - s.x0 + 1;
+    s.h = std::min(d.height - 1, py + reach) - s.y0 + 1;
+    s.vis.assign(static_cast<size_t>(s.w * s.h), uint8_t{0});
 
-    auto markVis = [&](int x, int y) {
-        if (!inBounds(x, y)) return;
-        Tile& t = at(x, y);
-        t.visible = true;
-        if (markExplored) t.explored = true;
-    };
+    const TilePlanes& planes = d.planes();
+    const TilePlanes::Word* opaque = planes.opaque();
+    auto cell = [&](int x, int y) -> size_t { return static_cast<size_t>((y - s.y0) * s.w + (x - s.x0)); };
+    auto opaqueAt = [&](int x, int y) { return planes.test(opaque, x, y); };
 
     // Always see your own tile
-    markVis(px, py);
+    s.vis[cell(px, py)] = uint8_t{1};
 
-    // Recursive shadowcasting for 8 octants.
-    // Reference: RogueBasin "Recursive Shadowcasting".
-    const int r2 = radius * radius;
-
-    std::function<void(int, float, float, int, int, int, int)> castLight;
-    castLight = [&](int row, float start, float end, int xx, int xy, int yx, int yy) {
-        if (start < end) return;
-        float newStart = start;
-        for (int dist = row; dist <= radius; ++dist) {
-            bool blocked = false;
-
-            for (int dx = -dist, dy = -dist; dx <= 0; ++dx) {
-                const float lSlope = (dx - 0.5f) / (dy + 0.5f);
-                const float rSlope = (dx + 0.5f) / (dy - 0.5f);
-                if (start < rSlope) continue;
-                if (end > lSlope) break;
-
-                const int sax = dx * xx + dy * xy;
-                const int say = dx * yx + dy * yy;
-                const int ax = px + sax;
-                const int ay = py + say;
-
-                if (!inBounds(ax, ay)) continue;
-                const int d2 = (ax - px) * (ax - px) + (ay - py) * (ay - py);
-                if (d2 <= r2) {
-                    markVis(ax, ay);
-                }
+    static constexpr int kOctants[8][4] = {
+        {1, 0, 0, 1}, {0, 1, 1, 0}, {0, -1, 1, 0}, {-1, 0, 0, 1},
+        {-1, 0, 0, -1}, {0, -1, -1, 0}, {0, 1, -1, 0}, {1, 0, 0, -1},
+    };
 
-                if (blocked) {
-                    if (isOpaqueTile(ax, ay)) {
-                        newStart = rSlope;
-                        continue;
-                    } else {
+    const int r2 = radius * radius;
+    for (const auto& oct : kOctants) {
+        const int xx = oct[0];
+        const int xy = oct[1];
+        const int yx = oct[2];
+        const int yy = oct[3];
+
+        s.stack.clear();
+        s.stack.push_back({1, 1.0f, 0.0f});
+        while (!s.stack.empty()) {
+            const FovScratch::Span span = s.stack.back();
+            s.stack.pop_back();
+
+            float start = span.start;
+            const float end = span.end;
+            if (start < end) continue;
+            float newStart = start;
+            for (int dist = span.row; dist <= radius; ++dist) {
+                bool blocked = false;
+                const FovSlope* slopes = fovSlopeRow(dist);
+
+                for (int dx = -dist, dy = -dist; dx <= 0; ++dx) {
+                    const float lSlope = slopes ? slopes[dx + dist].l : (dx - 0.5f) / (dy + 0.5f);
+                    const float rSlope = slopes ? slopes[dx + dist].r : (dx + 0.5f) / (dy - 0.5f);
+                    if (start < rSlope) continue;
+                    if (end > lSlope) break;
+
+                    const int sax = dx * xx + dy * xy;
+                    const int say = dx * yx + dy * yy;
+                    const int ax = px + sax;
+                    const int ay = py + say;
+
+                    if (!d.inBounds(ax, ay)) continue;
+                    if (sax * sax + say * say <= r2) s.vis[cell(ax, ay)] = uint8_t{1};
+
+                    const bool opaque = opaqueAt(ax, ay);
+                    if (blocked) {
+                        if (opaque) {
+                            newStart = rSlope;
+                            continue;
+                        }
                         blocked = false;
                         start = newStart;
-                    }
-                } else {
-                    if (isOpaqueTile(ax, ay) && dist < radius) {
+                    } else if (opaque && dist < radius) {
                         blocked = true;
-                        castLight(dist + 1, start, lSlope, xx, xy, yx, yy);
+                        s.stack.push_back({dist + 1, start, lSlope});
                         newStart = rSlope;
                     }
                 }
-            }
 
-            if (blocked) break;
+                if (blocked) break;
+            }
         }
-    };
-
-    // Octant transforms
-    castLight(1, 1.0f, 0.0f, 1, 0, 0, 1);
-    castLight(1, 1.0f, 0.0f, 0, 1, 1, 0);
-    castLight(1, 1.0f, 0.0f, 0, -1, 1, 0);
-    castLight(1, 1.0f, 0.0f, -1, 0, 0, 1);
-    castLight(1, 1.0f, 0.0f, -1, 0, 0, -1);
-    castLight(1, 1.0f, 0.0f, 0, -1, -1, 0);
-    castLight(1, 1.0f, 0.0f, 0, 1, -1, 0);
-    castLight(1, 1.0f, 0.0f, 1, 0, 0, -1);
+    }
 }
 
+} // namespace
 
-void Dungeon::computeFovMask(int px, int py, int radius, std::vector<uint8_t>& outMask) const {
-    outMask.assign(static_cast<size_t>(width * height), uint8_t{0});
-    if (!inBounds(px, py)) return;
+void Dungeon::computeFov(int px, int py, int radius, bool markExplored) {
+    FovScratch& s = fovScratch();
+    std::vector<int>& changes = s.changes;
+    changes.clear();
 
-    auto idx = [&](int x, int y) -> size_t { return static_cast<size_t>(y * width + x); };
+    const bool haveView = inBounds(px, py);
+    if (haveView) {
+        shadowcastFov(*this, px, py, radius, s);
+    } else {
+        s.w = 0;
+        s.h = 0;
+    }
 
-    auto isOpaqueTile = [&](int x, int y) {
-        if (!inBounds(x, y)) return true;
-        TileType tt = at(x, y).type;
-        return (tt == TileType::Wall || tt == TileType::Pillar || tt == TileType::DoorClosed || tt == TileType::DoorLocked || tt == TileType::DoorSecret);
+    auto inView = [&](int x, int y) {
+        return x >= s.x0 && y >= s.y0 && x < s.x0 + s.w && y < s.y0 + s.h &&
+               s.vis[static_cast<size_t>((y - s.y0) * s.w + (x - s.x0))] != 0;
     };
+    auto update = [&](int x, int y) {
+        Tile& t = at(x, y);
+        const bool v = inView(x, y);
+        const bool e = t.explored || (v && markExplored);
+        if (t.visible == v && t.explored == e) return;
+        t.visible = v;
+        t.explored = e;
+        changes.push_back(y * width + x);
+    };
+
+    // Every tile this Dungeon marked visible lies inside the previous rectangle; anything
+    // else (first call, a resized map) falls back to a full pass.
+    const bool rectOk = fovRectValid && fovX0 >= 0 && fovY0 >= 0 && fovX1 < width && fovY1 < height &&
+                        tiles.size() == static_cast<size_t>(width * height);
+    if (!rectOk) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) update(x, y);
+        }
+    } else {
+        for (int y = fovY0; y <= fovY1; ++y) {
+            for (int x = fovX0; x <= fovX1; ++x) update(x, y);
+        }
+        for (int y = s.y0; y < s.y0 + s.h; ++y) {
+            for (int x = s.x0; x < s.x0 + s.w; ++x) {
+                if (x >= fovX0 && x <= fovX1 && y >= fovY0 && y <= fovY1) continue;
+                update(x, y);
+            }
+        }
+    }
 
-    auto markVis = [&](int x, int y) {
-        if (!inBounds(x, y)) return;
-        outMask[idx(x, y)] = uint8_t{1};
-    };
+    fovRectValid = true;
+    fovX0 = s.x0;
+    fovY0 = s.y0;
+    fovX1 = s.x0 + s.w - 1;
+    fovY1 = s.y0 + s.h - 1;
 
-    // Always see your own tile
-    markVis(px, py);
+    // An unchanged view leaves fovRevision/fovChanges describing the previous update.
+    if (!changes.empty()) {
+        fovChanges.swap(changes);
+        ++fovRevision;
+    }
+}
 
-    // Recursive shadowcasting for 8 octants.
-    // Reference: RogueBasin "Recursive Shadowcasting".
-    const int r2 = radius * radius;
 
-    std::function<void(int, float, float, int, int, int, int)> castLight;
-    castLight = [&](int row, float start, float end, int xx, int xy, int yx, int yy) {
-        if (start < end) return;
-        float newStart = start;
-        for (int dist = row; dist <= radius; ++dist) {
-            bool blocked = false;
-
-            for (int dx = -dist, dy = -dist; dx <= 0; ++dx) {
-                const float lSlope = (dx - 0.5f) / (dy + 0.5f);
-                const float rSlope = (dx + 0.5f) / (dy - 0.5f);
-                if (start < rSlope) continue;
-                if (end > lSlope) break;
-
-                const int sax = dx * xx + dy * xy;
-                const int say = dx * yx + dy * yy;
-                const int ax = px + sax;
-                const int ay = py + say;
-
-                if (!inBounds(ax, ay)) continue;
-                const int d2 = (ax - px) * (ax - px) + (ay - py) * (ay - py);
-                if (d2 <= r2) {
-                    markVis(ax, ay);
-                }
+void Dungeon::computeFovMask(int px, int py, int radius, std::vector<uint8_t>& outMask) const {
+    outMask.assign(static_cast<size_t>(width * height), uint8_t{0});
+    if (!inBounds(px, py)) return;
 
-                if (blocked) {
-                    if (isOpaqueTile(ax, ay)) {
-                        newStart = rSlope;
-                        continue;
-                    } else {
-                        blocked = false;
-                        start = newStart;
-                    }
-                } else {
-                    if (isOpaqueTile(ax, ay) && dist < radius) {
-                        blocked = true;
-                        castLight(dist + 1, start, lSlope, xx, xy, yx, yy);
-                        newStart = rSlope;
-                    }
-                }
-            }
+    FovScratch& s = fovScratch();
+    shadowcastFov(*this, px, py, radius, s);
+    for (int wy = 0; wy < s.h; ++wy) {
+        const uint8_t* src = &s.vis[static_cast<size_t>(wy * s.w)];
+        std::copy(src, src + s.w, outMask.begin() + static_cast<std::ptrdiff_t>((s.y0 + wy) * width + s.x0));
+    }
+}
 
-            if (blocked) break;
-        }
-    };
+void Dungeon::computeFovWindow(int px, int py, int radius, std::vector<uint8_t>& outMask,
+                               int& outX0, int& outY0, int& outW, int& outH) const {
+    outX0 = 0;
+    outY0 = 0;
+    outW = 0;
+    outH = 0;
+    outMask.clear();
+    if (!inBounds(px, py)) return;
 
-    // Octant transforms
-    castLight(1, 1.0f, 0.0f, 1, 0, 0, 1);
-    castLight(1, 1.0f, 0.0f, 0, 1, 1, 0);
-    castLight(1, 1.0f, 0.0f, 0, -1, 1, 0);
-    castLight(1, 1.0f, 0.0f, -1, 0, 0, 1);
-    castLight(1, 1.0f, 0.0f, -1, 0, 0, -1);
-    castLight(1, 1.0f, 0.0f, 0, -1, -1, 0);
-    castLight(1, 1.0f, 0.0f, 0, 1, -1, 0);
-    castLight(1, 1.0f, 0.0f, 1, 0, 0, -1);
+    FovScratch& s = fovScratch();
+    shadowcastFov(*this, px, py, radius, s);
+    outX0 = s.x0;
+    outY0 = s.y0;
+    outW = s.w;
+    outH = s.h;
+    outMask.assign(s.vis.begin(), s.vis.begin() + static_cast<std::ptrdiff_t>(s.w * s.h));
 }
 
 
 void Dungeon::revealAll() {
-    for (auto& t : tiles) {
-        t.explored = true;
+    std::vector<int> changes;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (tiles[i].explored) continue;
+        tiles[i].explored = true;
+        changes.push_back(static_cast<int>(i));
+    }
+    if (!changes.empty()) {
+        fovChanges.swap(changes);
+        ++fovRevision;
     }
 }
 
+void Dungeon::setExplored(int x, int y, bool explored) {
+    if (!inBounds(x, y)) return;
+    Tile& t = at(x, y);
+    if (t.explored == explored) return;
+    t.explored = explored;
+    fovChanges.assign(1, y * width + x);
+    ++fovRevision;
+}
+
 Vec2i Dungeon::randomFloor(RNG& rng, bool avoidDoors) const {
     for (int tries = 0; tries < 4000; ++tries) {
         int x = rng.range(1, width - 2);
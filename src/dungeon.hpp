@@ -1,6 +1,8 @@
 #pragma once
+#include "acoustic_grid.hpp"
 #include "common.hpp"
 #include "rng.hpp"
+#include "tile_planes.hpp"
 #include <cstdint>
 #include <vector>
 
@@ -8,6 +10,8 @@ enum class DungeonBranch : uint8_t;
 
 enum class ItemKind : uint8_t;
 
+struct DijkstraSeed;
+
 enum class EndlessStratumTheme : uint8_t {
     Ruins = 0,
     Caverns,
@@ -425,6 +429,9 @@ public:
     static constexpr int DEFAULT_W = 105;
     static constexpr int DEFAULT_H = 66;
 
+    // Upper bound for the generate-and-test candidate count (see generate()).
+    static constexpr int MAX_FLOOR_CANDIDATES = 16;
+
 	// Themed floors: fixed depths that bias generation style.
 	// These are still fully procedural; they're pacing anchors for run variety.
 	static constexpr int MINES_DEPTH = 2;        // Procedural mines: winding tunnels + small chambers
@@ -445,6 +452,8 @@ mutable int materialCacheW = 0;
 mutable int materialCacheH = 0;
 mutable int materialCacheCell = 0;
 mutable std::vector<uint8_t> materialCache;
+// Bumped whenever ensureMaterials() rebuilds the caches (keeps AcousticGrid in step).
+mutable uint32_t materialRevision = 0u;
 
 
 // Procedural bioluminescent terrain field (cosmetic only; not serialized).
@@ -782,11 +791,35 @@ mutable std::vector<uint8_t> leylineCache;
     // Returns true if the tile changed.
     bool dig(int x, int y);
 
+    // Runtime tile type change (boulders, secret doors, collapsing chasms, ...).
+    // Prefer this over writing at(x,y).type directly once a level is in play so
+    // the change is recorded in the terrain journal.
+    void setTileType(int x, int y, TileType t);
+
+    // Runtime terrain mutation journal (not serialized).
+    //
+    // dig(), the door helpers and setTileType() append the index of every tile
+    // they change so derived per-level caches (e.g. MonsterNavGrid) can update
+    // incrementally. `terrainEpoch` identifies one layout: every new Dungeon gets a
+    // fresh epoch, and resetTerrainJournal() issues another one (used when a stored
+    // level is swapped back in, or when the journal overflows). Consumers that see
+    // a different epoch rebuild from scratch.
+    static constexpr size_t TERRAIN_JOURNAL_MAX = 4096;
+    uint32_t terrainEpoch = nextTerrainEpoch();
+    std::vector<int> terrainJournal;
+
+    void noteTerrainChanged(int x, int y);
+    void resetTerrainJournal();
+    static uint32_t nextTerrainEpoch();
+
     // Procedural generation.
     //
     // `branch` selects the dungeon branch's layout rules (e.g. Camp hub vs Main dungeon).
     // `depth` is a branch-local depth used for pacing and special floors.
-    void generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth, uint32_t worldSeed = 0u);
+    // `floorCandidates` raises the number of candidate layouts scored per floor
+    // (0 = the default depth schedule of 1..3; capped at MAX_FLOOR_CANDIDATES).
+    void generate(RNG& rng, DungeonBranch branch, int depth, int maxDepth, uint32_t worldSeed = 0u,
+                  int floorCandidates = 0);
     void computeEndlessStratumInfo(uint32_t worldSeed, DungeonBranch branch, int depth, int maxDepth);
     void computeCampaignStratumInfo(uint32_t worldSeed, DungeonBranch branch, int depth, int maxDepth);
 
@@ -819,6 +852,41 @@ int materialCellSize() const { return materialCacheCell; }
     // as computeFov, but without mutating tiles.
     // `outMask` is resized and filled with 0/1, length = width*height.
     void computeFovMask(int px, int py, int radius, std::vector<uint8_t>& outMask) const;
+
+    // computeFovMask() restricted to its view window (the radius square clipped to the map):
+    // `outMask` holds outW x outH cells starting at (outX0, outY0). Empty when (px,py) is
+    // out of bounds.
+    void computeFovWindow(int px, int py, int radius, std::vector<uint8_t>& outMask,
+                          int& outX0, int& outY0, int& outW, int& outH) const;
+
+    // computeFov() bookkeeping (not serialized).
+    //
+    // computeFov() only rewrites tiles whose visible/explored flags change. Every tile it
+    // marked visible lies inside the fovX0..fovX1 x fovY0..fovY1 rectangle, so the next
+    // call revisits that rectangle and the new view window instead of the whole map.
+    // Each fog update (computeFov() plus darkness filtering, setExplored(), revealAll())
+    // bumps `fovRevision` once and leaves exactly the tiles it changed in `fovChanges`, so
+    // views and TilePlanes can skip work when nothing (or little) changed.
+    bool fovRectValid = false;
+    int fovX0 = 0;
+    int fovY0 = 0;
+    int fovX1 = -1;
+    int fovY1 = -1;
+    uint32_t fovRevision = 0;
+    std::vector<int> fovChanges;
+
+    // Runtime explored-flag change (magic mapping, amnesia, discovered secrets, ...).
+    // Counts as one fog update; prefer it over writing at(x,y).explored once a level is
+    // in play.
+    void setExplored(int x, int y, bool explored);
+
+    // Structure-of-arrays mirror of `tiles` (type plane + flag bitplanes, see
+    // tile_planes.hpp), brought up to date on access.
+    const TilePlanes& planes() const {
+        tilePlanes.sync(*this);
+        return tilePlanes;
+    }
+    mutable TilePlanes tilePlanes;
     void revealAll();
 
     bool hasLineOfSight(int x0, int y0, int x1, int y1) const;
@@ -833,6 +901,20 @@ int materialCellSize() const { return materialCacheCell; }
     //
     // `maxCost` limits the search for efficiency; tiles beyond this cost remain -1.
     std::vector<int> computeSoundMap(int sx, int sy, int maxCost) const;
+    void computeSoundMap(int sx, int sy, int maxCost, std::vector<int>& out) const;
+
+    // Multi-source form: out[i] = min over seeds of (seed.initialCost + attenuation from
+    // seed.pos to i), or -1 beyond `maxCost`. Seeding louder sources lower lets one search
+    // answer "does any of these sounds reach i" (see Game::resolveNoises()).
+    void computeSoundField(const std::vector<DijkstraSeed>& seeds, int maxCost, std::vector<int>& out) const;
+
+    // Per-tile sound step costs (see acoustic_grid.hpp), brought up to date on access.
+    // The material cache should be current (ensureMaterials()) for substrate acoustics.
+    const AcousticGrid& acoustics() const {
+        acousticGrid.sync(*this);
+        return acousticGrid;
+    }
+    mutable AcousticGrid acousticGrid;
 
     // Sound propagation helpers.
     //
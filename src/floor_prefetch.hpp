@@ -0,0 +1,128 @@
+#pragma once
+
+// Background pre-generation of the next floor's terrain (opt-in; see
+// Game::setFloorPrefetchEnabled()).
+//
+// A fresh floor is built in two phases:
+//   1) terrain: map size, Dungeon::generate() and the terrain-only post passes. This is
+//      a pure function of FloorTerrainParams (the run seed + level identity + generation
+//      settings) and is the expensive part.
+//   2) population: altars, graffiti, monsters, items, traps, bones... These mutate Game
+//      state (entity/item ids, bones files, the player) and always run on arrival.
+//
+// Only phase 1 is prefetched. Game::changeLevel() asks take() for terrain matching the
+// exact parameters it would use itself and falls back to generating synchronously, so
+// the resulting LevelState and determinismHash() are identical either way.
+
+#include "dungeon.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct FloorTerrainParams {
+    DungeonBranch branch{}; // forward-declared here (game.hpp)
+    int depth = 1;
+    uint32_t runSeed = 0;  // Game::seed()
+    uint32_t genSeed = 0;  // Game::levelGenSeed() for this level
+    bool infiniteWorld = false;
+    int floorCandidates = 0;
+
+    bool operator==(const FloorTerrainParams& o) const {
+        return branch == o.branch && depth == o.depth && runSeed == o.runSeed && genSeed == o.genSeed &&
+               infiniteWorld == o.infiniteWorld && floorCandidates == o.floorCandidates;
+    }
+};
+
+struct FloorTerrain {
+    Dungeon dung;
+    uint32_t rngState = 0; // level-generation RNG state after the terrain phase
+};
+
+class FloorPrefetch {
+public:
+    struct Stats {
+        uint64_t started = 0;
+        uint64_t used = 0;
+    };
+
+    FloorPrefetch() = default;
+    FloorPrefetch(const FloorPrefetch&) = delete;
+    FloorPrefetch& operator=(const FloorPrefetch&) = delete;
+
+    // Waits for jobs that are still running: a worker must not outlive the generator's
+    // function-local statics (WFC rule tables, ...) during process teardown.
+    ~FloorPrefetch() {
+        cancel();
+        for (auto& f : retired_) f.wait();
+    }
+
+    // Starts generating terrain for `params` on the shared worker pool, replacing any
+    // pending job. `generate` must be a pure function of its argument.
+    template <typename GenFn>
+    void start(const FloorTerrainParams& params, GenFn generate) {
+        auto job = std::make_shared<Job>();
+        job->params = params;
+        job->result = ThreadPool::shared().submit([params, generate] { return generate(params); });
+        cancel();
+        job_ = std::move(job);
+        ++stats_.started;
+    }
+
+    bool pendingFor(const FloorTerrainParams& params) const { return job_ && job_->params == params; }
+
+    // Hands over the prefetched terrain if it was generated for exactly `params`, waiting
+    // for the worker if it is still running. Any pending job is consumed either way.
+    bool take(const FloorTerrainParams& params, FloorTerrain& out) {
+        if (!job_ || !(job_->params == params) || !job_->result.valid()) {
+            cancel();
+            return false;
+        }
+        std::shared_ptr<Job> job = std::move(job_);
+        job_.reset();
+        try {
+            out = job->result.get();
+        } catch (const std::exception&) {
+            return false; // Caller regenerates synchronously.
+        }
+        ++stats_.used;
+        return true;
+    }
+
+    // Drops the pending job (a running worker finishes and its result is discarded).
+    void cancel() {
+        if (job_ && job_->result.valid()) {
+            retired_.push_back(std::move(job_->result));
+        }
+        job_.reset();
+        pruneRetired();
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Job {
+        FloorTerrainParams params;
+        std::future<FloorTerrain> result;
+    };
+
+    void pruneRetired() {
+        for (size_t i = 0; i < retired_.size();) {
+            if (retired_[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                retired_[i] = std::move(retired_.back());
+                retired_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    std::shared_ptr<Job> job_;
+    std::vector<std::future<FloorTerrain>> retired_;
+    Stats stats_{};
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+// Replay cache for one segment of a byte-serial FNV-1a 64-bit hash.
+//
+// Game::determinismHash() chains every subsystem through a single FNV-1a state, so a
+// sub-hash cannot simply be computed once and XOR-combined later without changing the
+// final value (and breaking every recorded .prr replay). It can still be cached:
+//
+// For FNV-1a, h' = (h ^ b) * P. XOR-ing a byte only touches the low 8 bits, so
+// (h ^ b) - h depends on (h & 0xFF) alone. Unrolled over a segment of n bytes:
+//
+//     h_out = h_in * P^n + D[h_in & 0xFF]
+//
+// where D depends only on the segment bytes and the *low byte* of the incoming state
+// (the low byte itself evolves as a closed 256-state automaton). Each time a segment is
+// hashed the slow way we learn one D entry; later calls with the same content and a
+// known low byte replay the whole segment with a single multiply-add.
+//
+// Owners decide when the content changed and call invalidate(); the cache never looks
+// at the bytes itself.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace fnv {
+
+inline constexpr uint64_t kPrime64 = 1099511628211ull;
+
+// P^n mod 2^64 (used to skip runs of zero bytes, which only multiply by P).
+inline uint64_t primePow(uint64_t n) {
+    uint64_t r = 1;
+    uint64_t b = kPrime64;
+    while (n != 0) {
+        if (n & 1u) r *= b;
+        b *= b;
+        n >>= 1;
+    }
+    return r;
+}
+
+} // namespace fnv
+
+class FnvSegmentCache {
+public:
+    bool valid() const { return valid_; }
+    uint64_t length() const { return len_; }
+
+    void invalidate() {
+        valid_ = false;
+        known_.fill(0);
+    }
+
+    // Advances `h` over the cached segment if its entry for the current low byte is known.
+    bool replay(uint64_t& h) const {
+        if (!valid_) return false;
+        const uint8_t lo = static_cast<uint8_t>(h & 0xFFu);
+        if ((known_[lo >> 6] & (1ull << (lo & 63u))) == 0) return false;
+        h = h * mul_ + add_[lo];
+        return true;
+    }
+
+    // Records the result of hashing the segment the slow way: `len` bytes took the state
+    // from `hIn` to `hOut`.
+    void record(uint64_t hIn, uint64_t hOut, uint64_t len) {
+        if (!valid_ || len != len_) {
+            known_.fill(0);
+            len_ = len;
+            mul_ = fnv::primePow(len);
+            valid_ = true;
+        }
+        const uint8_t lo = static_cast<uint8_t>(hIn & 0xFFu);
+        add_[lo] = hOut - hIn * mul_;
+        known_[lo >> 6] |= (1ull << (lo & 63u));
+    }
+
+private:
+    bool valid_ = false;
+    uint64_t len_ = 0;
+    uint64_t mul_ = 1;
+    std::array<uint64_t, 256> add_{};
+    std::array<uint64_t, 4> known_{};
+};
@@ -64,16 +64,15 @@ namespace {
 // phase, `ents` is still empty. Returning a stable dummy prevents UB (and Windows
 // access violations) while keeping the rest of the code simple.
 Entity& dummyPlayerEntity() {
-    static Entity dummy;
-    static bool init = false;
-    if (!init) {
-        dummy.id = 0;
-        dummy.kind = EntityKind::Player;
-        dummy.hpMax = 1;
-        dummy.hp = 1;
-        dummy.pos = {0, 0};
-        init = true;
-    }
+    static Entity dummy = [] {
+        Entity e;
+        e.id = 0;
+        e.kind = EntityKind::Player;
+        e.hpMax = 1;
+        e.hp = 1;
+        e.pos = {0, 0};
+        return e;
+    }();
     return dummy;
 }
 }
@@ -717,30 +716,6 @@ void Game::buildScoresList(std::vector<size_t>& out) const {
     }
 }
 
-Entity* Game::entityById(int id) {
-    for (auto& e : ents) if (e.id == id) return &e;
-    return nullptr;
-}
-
-const Entity* Game::entityById(int id) const {
-    for (const auto& e : ents) if (e.id == id) return &e;
-    return nullptr;
-}
-
-Entity* Game::entityAtMut(int x, int y) {
-    for (auto& e : ents) {
-        if (e.hp > 0 && e.pos.x == x && e.pos.y == y) return &e;
-    }
-    return nullptr;
-}
-
-const Entity* Game::entityAt(int x, int y) const {
-    for (const auto& e : ents) {
-        if (e.hp > 0 && e.pos.x == x && e.pos.y == y) return &e;
-    }
-    return nullptr;
-}
-
 int Game::commanderAuraTierFor(const Entity& e) const {
     if (e.hp <= 0) return 0;
     if (e.id == playerId_ || e.kind == EntityKind::Player) return 0;
@@ -1789,6 +1764,7 @@ void Game::newGame(uint32_t seed) {
     branch_ = DungeonBranch::Camp;
     depth_ = 0;
     levels.clear();
+    invalidateLevelHashes();
     trapdoorFallers_.clear();
     overworldX_ = 0;
     overworldY_ = 0;
@@ -1802,6 +1778,9 @@ void Game::newGame(uint32_t seed) {
     overworldFeatureFlags_[OverworldKey{0, 0}] = 0u;
 
     ents.clear();
+    invalidateEntityIndex();
+    monsterCostCache_.clear();
+    monsterCostCache_.resetStats();
     ground.clear();
     chestContainers_.clear();
     trapsCur.clear();
@@ -1991,7 +1970,7 @@ void Game::newGame(uint32_t seed) {
 
     const Vec2i msz = proceduralMapSizeFor(rng, branch_, depth_);
     dung = Dungeon(msz.x, msz.y);
-    dung.generate(rng, branch_, depth_, DUNGEON_MAX_DEPTH, seed_);
+    dung.generate(rng, branch_, depth_, DUNGEON_MAX_DEPTH, seed_, floorCandidates_);
     if (atHomeCamp()) {
         overworld::ensureBorderGates(dung, seed_, 0, 0);
     }
@@ -2002,6 +1981,7 @@ void Game::newGame(uint32_t seed) {
     fireField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
     adhesiveFluid_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
     scentField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
+    resetHazardActivity();
 
     // Auto-explore bookkeeping is transient per-floor; size it to this dungeon.
     autoExploreSearchTriedTurns.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
@@ -2314,49 +2294,92 @@ void Game::newGame(uint32_t seed) {
         pushMsg("MOVE: WASD/ARROWS/NUMPAD + Q/E/Z/C DIAGONALS. TIP: SHIFT+C SEARCH. T DISARM TRAPS. O AUTO-EXPLORE. P AUTO-PICKUP.", MessageKind::System);
     }
     pushMsg("SAVE: F5   LOAD: F9   LOAD AUTO: F10", MessageKind::System);
+
+    scheduleFloorPrefetch();
+    scheduleOverworldPrefetch();
 }
 
-void Game::storeCurrentLevel() {
+void Game::storeCurrentLevel(bool leaving) {
+    // Refresh overworld atlas caches before stashing the chunk snapshot.
+    const bool surfaceChunk = atCamp() && !atHomeCamp();
+    if (surfaceChunk) {
+        recordOverworldChunkFeatureFlags(overworldX_, overworldY_, dung);
+        recordOverworldChunkTerrainSummary(overworldX_, overworldY_, dung);
+    }
+
+    auto stash = [leaving](auto& dst, auto& src) {
+        if (leaving) dst = std::move(src);
+        else dst = src;
+    };
+
     LevelState st;
     st.branch = branch_;
     st.depth = depth_;
-    st.dung = dung;
-    st.ground = ground;
-    st.traps = trapsCur;
-    st.markers = mapMarkers_;
-    st.engravings = engravings_;
-    st.chestContainers = chestContainers_;
-    st.confusionGas = confusionGas_;
-    st.poisonGas = poisonGas_;
-    st.corrosiveGas = corrosiveGas_;
-    st.fireField = fireField_;
-    st.adhesiveFluid = adhesiveFluid_;
-    st.scentField = scentField_;
-    st.monsters.clear();
-    for (const auto& e : ents) {
+    stash(st.dung, dung);
+    stash(st.ground, ground);
+    stash(st.traps, trapsCur);
+    stash(st.markers, mapMarkers_);
+    stash(st.engravings, engravings_);
+    stash(st.chestContainers, chestContainers_);
+    // The mirror copy is packed right away, so a field whose active box is empty (all
+    // zeros) goes straight to its packed form instead of being copied and scanned.
+    size_t zeroFields[LevelSnapshot::kFieldCount];
+    auto stashField = [&](int slot, std::vector<uint8_t>& dst, std::vector<uint8_t>& src,
+                          const hazard::ActiveRect* active) {
+        zeroFields[slot] = (!leaving && active && active->empty()) ? src.size() : SIZE_MAX;
+        if (zeroFields[slot] == SIZE_MAX) stash(dst, src);
+    };
+    stashField(0, st.confusionGas, confusionGas_, &confusionActive_);
+    stashField(1, st.poisonGas, poisonGas_, &poisonActive_);
+    stashField(2, st.corrosiveGas, corrosiveGas_, &corrosiveActive_);
+    stashField(3, st.fireField, fireField_, &fireActive_);
+    stashField(4, st.adhesiveFluid, adhesiveFluid_, nullptr);
+    stashField(5, st.scentField, scentField_, &scentActive_);
+    st.monsters.reserve(ents.size());
+    for (auto& e : ents) {
         if (e.id == playerId_) continue;
-        st.monsters.push_back(e);
+        if (leaving) st.monsters.push_back(std::move(e));
+        else st.monsters.push_back(e);
     }
-    if (atCamp() && !atHomeCamp()) {
-        // Refresh overworld atlas caches before stashing the chunk snapshot.
-        recordOverworldChunkFeatureFlags(overworldX_, overworldY_, dung);
-        recordOverworldChunkTerrainSummary(overworldX_, overworldY_, dung);
+    if (leaving) {
+        // Moved-from monsters keep their ids, which is all remove_if looks at.
+        ents.erase(std::remove_if(ents.begin(), ents.end(), [&](const Entity& e) {
+            return e.id != playerId_;
+        }), ents.end());
+        invalidateEntityIndex();
+    }
+
+    // Inactive levels are kept packed; restoreLevel()/restoreOverworldChunk() decode them.
+    // The level being left stays expanded so an immediate return (stair dancing, chunk
+    // edge back-steps) is a plain move; whichever level was left before it is packed now.
+    if (leaving) {
+        packInactiveLevels();
+    } else {
+        st.pack(); // Mirror of the active level (saves, fresh floors); rarely read back.
+        for (int i = 0; i < LevelSnapshot::kFieldCount; ++i) {
+            if (zeroFields[i] != SIZE_MAX) st.setZeroField(i, zeroFields[i]);
+        }
+    }
+    if (surfaceChunk) {
         overworldChunks_[OverworldKey{overworldX_, overworldY_}] = std::move(st);
     } else {
         levels[{branch_, depth_}] = std::move(st);
+        invalidateLevelHash(LevelId{branch_, depth_});
     }
 }
 
-bool Game::restoreLevel(LevelId id) {
-    auto it = levels.find(id);
-    if (it == levels.end()) return false;
+void Game::adoptStoredLevel(LevelState& st) {
+    st.unpack();
 
-    dung = it->second.dung;
-    ground = it->second.ground;
-    trapsCur = it->second.traps;
-    mapMarkers_ = it->second.markers;
-    engravings_ = it->second.engravings;
-    chestContainers_ = it->second.chestContainers;
+    dung = std::move(st.dung);
+    // The stored snapshot shares its terrain epoch with the level that was filed away;
+    // give the live level a fresh one so derived caches never mistake it for that layout.
+    dung.resetTerrainJournal();
+    ground = std::move(st.ground);
+    trapsCur = std::move(st.traps);
+    mapMarkers_ = std::move(st.markers);
+    engravings_ = std::move(st.engravings);
+    chestContainers_ = std::move(st.chestContainers);
 
     // Drop any orphaned containers (e.g., chests that were destroyed).
     if (!chestContainers_.empty()) {
@@ -2369,39 +2392,47 @@ bool Game::restoreLevel(LevelId id) {
         }), chestContainers_.end());
     }
 
-    confusionGas_ = it->second.confusionGas;
     const size_t expect = static_cast<size_t>(dung.width * dung.height);
-    if (confusionGas_.size() != expect) confusionGas_.assign(expect, uint8_t{0});
-
-    poisonGas_ = it->second.poisonGas;
-    if (poisonGas_.size() != expect) poisonGas_.assign(expect, uint8_t{0});
-
-    corrosiveGas_ = it->second.corrosiveGas;
-    if (corrosiveGas_.size() != expect) corrosiveGas_.assign(expect, uint8_t{0});
-
-    fireField_ = it->second.fireField;
-    if (fireField_.size() != expect) fireField_.assign(expect, uint8_t{0});
-
-    adhesiveFluid_ = it->second.adhesiveFluid;
-    if (adhesiveFluid_.size() != expect) adhesiveFluid_.assign(expect, uint8_t{0});
-
-    scentField_ = it->second.scentField;
-    if (scentField_.size() != expect) scentField_.assign(expect, uint8_t{0});
+    auto adoptField = [expect](std::vector<uint8_t>& dst, std::vector<uint8_t>& src) {
+        dst = std::move(src);
+        if (dst.size() != expect) dst.assign(expect, uint8_t{0});
+    };
+    adoptField(confusionGas_, st.confusionGas);
+    adoptField(poisonGas_, st.poisonGas);
+    adoptField(corrosiveGas_, st.corrosiveGas);
+    adoptField(fireField_, st.fireField);
+    adoptField(adhesiveFluid_, st.adhesiveFluid);
+    adoptField(scentField_, st.scentField);
+    resetHazardActivity();
 
     // Keep player, restore monsters.
     ents.erase(std::remove_if(ents.begin(), ents.end(), [&](const Entity& e) {
         return e.id != playerId_;
     }), ents.end());
 
-    for (const auto& m : it->second.monsters) {
-        ents.push_back(m);
+    ents.reserve(ents.size() + st.monsters.size());
+    for (auto& m : st.monsters) {
+        ents.push_back(std::move(m));
     }
+    st.monsters.clear();
+    invalidateEntityIndex();
 
     // Defensive: older saves (or pre-pet allies) may not have pet traits initialized yet.
     for (auto& e : ents) {
         if (e.id == playerId_) continue;
         ensurePetTraits(e);
     }
+}
+
+bool Game::restoreLevel(LevelId id) {
+    auto it = levels.find(id);
+    if (it == levels.end()) return false;
+
+    // The entry is hollow once its contents move into the live level; drop it so atlas and
+    // save code never read it as the stored copy (storeCurrentLevel() files it again).
+    adoptStoredLevel(it->second);
+    levels.erase(it);
+    invalidateLevelHash(id);
 
     if (id.branch == DungeonBranch::Camp && id.depth == 0) {
         overworld::ensureBorderGates(dung, seed_, 0, 0);
@@ -2417,57 +2448,8 @@ bool Game::restoreOverworldChunk(int x, int y) {
     auto it = overworldChunks_.find(key);
     if (it == overworldChunks_.end()) return false;
 
-    dung = it->second.dung;
-    ground = it->second.ground;
-    trapsCur = it->second.traps;
-    mapMarkers_ = it->second.markers;
-    engravings_ = it->second.engravings;
-    chestContainers_ = it->second.chestContainers;
-
-    // Drop any orphaned containers (e.g., chests that were destroyed).
-    if (!chestContainers_.empty()) {
-        chestContainers_.erase(std::remove_if(chestContainers_.begin(), chestContainers_.end(), [&](const ChestContainer& c) {
-            if (c.chestId <= 0) return true;
-            for (const auto& gi : ground) {
-                if (isChestKind(gi.item.kind) && gi.item.id == c.chestId) return false;
-            }
-            return true;
-        }), chestContainers_.end());
-    }
-
-    confusionGas_ = it->second.confusionGas;
-    const size_t expect = static_cast<size_t>(dung.width * dung.height);
-    if (confusionGas_.size() != expect) confusionGas_.assign(expect, uint8_t{0});
-
-    poisonGas_ = it->second.poisonGas;
-    if (poisonGas_.size() != expect) poisonGas_.assign(expect, uint8_t{0});
-
-    corrosiveGas_ = it->second.corrosiveGas;
-    if (corrosiveGas_.size() != expect) corrosiveGas_.assign(expect, uint8_t{0});
-
-    fireField_ = it->second.fireField;
-    if (fireField_.size() != expect) fireField_.assign(expect, uint8_t{0});
-
-    adhesiveFluid_ = it->second.adhesiveFluid;
-    if (adhesiveFluid_.size() != expect) adhesiveFluid_.assign(expect, uint8_t{0});
-
-    scentField_ = it->second.scentField;
-    if (scentField_.size() != expect) scentField_.assign(expect, uint8_t{0});
-
-    // Keep player, restore monsters.
-    ents.erase(std::remove_if(ents.begin(), ents.end(), [&](const Entity& e) {
-        return e.id != playerId_;
-    }), ents.end());
-
-    for (const auto& m : it->second.monsters) {
-        ents.push_back(m);
-    }
-
-    // Defensive: ensure restored friendly allies have their pet traits initialized.
-    for (auto& e : ents) {
-        if (e.id == playerId_) continue;
-        ensurePetTraits(e);
-    }
+    adoptStoredLevel(it->second);
+    overworldChunks_.erase(it);
 
     // Overworld chunks always have edge gates.
     overworld::ensureBorderGates(dung, seed_, x, y);
@@ -2498,7 +2480,7 @@ const Dungeon* Game::overworldChunkDungeon(int x, int y) const {
     // Home camp snapshot lives in the normal level store (Camp, depth 0).
     if (x == 0 && y == 0) {
         auto it = levels.find(LevelId{DungeonBranch::Camp, 0});
-        if (it != levels.end()) return &it->second.dung;
+        if (it != levels.end()) return &storedDungeonView(it->second);
         // If the camp is currently loaded but not stored, fall back.
         if (atHomeCamp()) return &dung;
         return nullptr;
@@ -2506,7 +2488,7 @@ const Dungeon* Game::overworldChunkDungeon(int x, int y) const {
 
     auto it = overworldChunks_.find(OverworldKey{x, y});
     if (it == overworldChunks_.end()) return nullptr;
-    return &it->second.dung;
+    return &storedDungeonView(it->second);
 }
 
 
@@ -3141,6 +3123,20 @@ void Game::markOverworldDiscovered(int x, int y) {
     }
 }
 
+namespace {
+
+// Terrain of a never-visited wilderness chunk (see overworld_prefetch.hpp), including the
+// material/ecosystem caches. Runs on the main thread or a pool worker, so it may only
+// depend on `p`.
+Dungeon generateOverworldChunkTerrain(const OverworldChunkParams& p) {
+    Dungeon d(p.width, p.height);
+    overworld::generateWildernessChunk(d, p.runSeed, p.x, p.y);
+    d.ensureMaterials(p.materialSeed, DungeonBranch::Camp, p.materialDepth, p.maxDepth);
+    return d;
+}
+
+} // namespace
+
 void Game::pruneOverworldChunks() {
     // Keep a bounded window around the current chunk to avoid unbounded memory growth.
     // (This is intentionally larger than the main-dungeon infinite keep window: overworld
@@ -3163,7 +3159,7 @@ bool Game::tryOverworldStep(int dx, int dy) {
     if ((dx == 0 && dy == 0) || (dx != 0 && dy != 0)) return false;
     if (dx < -1 || dx > 1 || dy < -1 || dy > 1) return false;
 
-    Entity& p = playerMut();
+    const Entity& p = player();
 
     // Only allow travel from edge tiles.
     if (dx == -1 && p.pos.x != 0) return false;
@@ -3189,7 +3185,7 @@ bool Game::tryOverworldStep(int dx, int dy) {
     }
 
     // Store the current chunk (without traveling companions).
-    storeCurrentLevel();
+    storeCurrentLevel(/*leaving=*/true);
 
     const int oldX = overworldX_;
     const int oldY = overworldY_;
@@ -3271,11 +3267,12 @@ bool Game::tryOverworldStep(int dx, int dy) {
         const uint32_t gameplayRngState = rng.state;
         rng.state = overworld::chunkSeed(seed_, overworldX_, overworldY_);
 
-        // Keep chunk size stable (use whatever size the current surface uses).
-        const int w = std::max(16, dung.width);
-        const int h = std::max(16, dung.height);
-        dung = Dungeon(w, h);
-        overworld::generateWildernessChunk(dung, seed_, overworldX_, overworldY_);
+        // Keep chunk size stable (use whatever size the current surface uses). The terrain may
+        // already be waiting in the prefetch ring; both paths run generateOverworldChunkTerrain().
+        const OverworldChunkParams chunkParams = overworldChunkParams(overworldX_, overworldY_);
+        if (!overworldPrefetch_.take(chunkParams, dung)) {
+            dung = generateOverworldChunkTerrain(chunkParams);
+        }
         dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
 
         confusionGas_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
@@ -3284,11 +3281,12 @@ bool Game::tryOverworldStep(int dx, int dy) {
         fireField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
         adhesiveFluid_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
         scentField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
+        resetHazardActivity();
 
         // Place player before spawning so we never spawn on top of them.
         const Vec2i arrival = computeArrival();
-        p.pos = arrival;
-        p.alerted = false;
+        setEntityPos(playerMut(), arrival);
+        playerMut().alerted = false;
 
         spawnGraffiti();
         spawnMonsters();
@@ -3314,12 +3312,12 @@ bool Game::tryOverworldStep(int dx, int dy) {
         const Vec2i arrival = computeArrival();
         const Entity* blocker = entityAt(arrival.x, arrival.y);
         if (blocker && blocker->id != playerId_) {
-            p.pos = findNearbyFreeTile(arrival, 6, true);
+            setEntityPos(playerMut(), findNearbyFreeTile(arrival, 6, true));
             pushMsg("THE PASSAGE IS BLOCKED! YOU STUMBLE ASIDE.", MessageKind::Warning, true);
         } else {
-            p.pos = arrival;
+            setEntityPos(playerMut(), arrival);
         }
-        p.alerted = false;
+        playerMut().alerted = false;
     }
 
     // Place companions near the player on the destination chunk.
@@ -3330,7 +3328,7 @@ bool Game::tryOverworldStep(int dx, int dy) {
         c.lastKnownPlayerAge = 9999;
         c.energy = 0;
 
-        Vec2i spawn = findNearbyFreeTile(p.pos, 4, false);
+        Vec2i spawn = findNearbyFreeTile(player().pos, 4, false);
         if (!dung.inBounds(spawn.x, spawn.y)) continue;
         const Entity* b = entityAt(spawn.x, spawn.y);
         if (b && b->id != playerId_) continue;
@@ -3357,7 +3355,7 @@ bool Game::tryOverworldStep(int dx, int dy) {
     ecosystemSeenMask_ = 0u;
     if (!atCamp()) {
         dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
-        const EcosystemKind e0 = dung.ecosystemAtCached(p.pos.x, p.pos.y);
+        const EcosystemKind e0 = dung.ecosystemAtCached(player().pos.x, player().pos.y);
         lastEcosystem_ = e0;
         if (e0 != EcosystemKind::None) {
             ecosystemSeenMask_ |= (1u << static_cast<uint32_t>(e0));
@@ -3366,8 +3364,9 @@ bool Game::tryOverworldStep(int dx, int dy) {
 
     recomputeFov();
 
-    // Prune the overworld cache around the new position.
+    // Prune the overworld cache around the new position, then stream in the neighbors.
     pruneOverworldChunks();
+    scheduleOverworldPrefetch();
 
     // Flavor messages.
     if (overworldX_ == 0 && overworldY_ == 0) {
@@ -3417,11 +3416,10 @@ uint32_t Game::levelGenSeed(LevelId id) const {
     return s;
 }
 
-void Game::ensureEndlessSanctumDownstairs(LevelId id, Dungeon& d, RNG& rngForPlacement) const {
-    if (!infiniteWorldEnabled_) return;
-    if (id.branch != DungeonBranch::Main) return;
-    if (id.depth != DUNGEON_MAX_DEPTH) return;
+namespace {
 
+// Body of Game::ensureEndlessSanctumDownstairs(), shared with the terrain worker.
+void placeEndlessSanctumDownstairs(Dungeon& d, RNG& rngForPlacement) {
     // If a downstairs already exists, don't disturb it.
     if (d.inBounds(d.stairsDown.x, d.stairsDown.y)) {
         if (d.at(d.stairsDown.x, d.stairsDown.y).type == TileType::StairsDown) return;
@@ -3460,7 +3458,106 @@ void Game::ensureEndlessSanctumDownstairs(LevelId id, Dungeon& d, RNG& rngForPla
 
     if (d.inBounds(best.x, best.y)) {
         d.stairsDown = best;
-        d.at(best.x, best.y).type = TileType::StairsDown;
+        d.setTileType(best.x, best.y, TileType::StairsDown);
+    }
+}
+
+// Terrain phase of a fresh floor (see floor_prefetch.hpp). Runs on the main thread or a
+// pool worker, so it may only depend on `p`.
+FloorTerrain generateFloorTerrain(const FloorTerrainParams& p) {
+    RNG r(p.genSeed);
+    FloorTerrain out;
+
+    const MapSizeWH msz = pickProceduralMapSize(r, p.branch, p.depth, Game::DUNGEON_MAX_DEPTH, p.infiniteWorld, p.runSeed);
+    out.dung = Dungeon(msz.w, msz.h);
+    out.dung.generate(r, p.branch, p.depth, Game::DUNGEON_MAX_DEPTH, p.runSeed, p.floorCandidates);
+
+    if (p.branch == DungeonBranch::Camp && p.depth == 0) {
+        overworld::ensureBorderGates(out.dung, p.runSeed, 0, 0);
+    }
+
+    // In infinite mode, the sanctum (depth == max) gains a downstairs so depth 26+ is reachable.
+    if (p.infiniteWorld && p.branch == DungeonBranch::Main && p.depth == Game::DUNGEON_MAX_DEPTH) {
+        placeEndlessSanctumDownstairs(out.dung, r);
+    }
+    out.dung.computeEndlessStratumInfo(p.runSeed, p.branch, p.depth, Game::DUNGEON_MAX_DEPTH);
+    out.dung.computeCampaignStratumInfo(p.runSeed, p.branch, p.depth, Game::DUNGEON_MAX_DEPTH);
+
+    out.rngState = r.state;
+    return out;
+}
+
+} // namespace
+
+void Game::ensureEndlessSanctumDownstairs(LevelId id, Dungeon& d, RNG& rngForPlacement) const {
+    if (!infiniteWorldEnabled_) return;
+    if (id.branch != DungeonBranch::Main) return;
+    if (id.depth != DUNGEON_MAX_DEPTH) return;
+
+    placeEndlessSanctumDownstairs(d, rngForPlacement);
+}
+
+FloorTerrainParams Game::floorTerrainParams(LevelId id) const {
+    FloorTerrainParams p;
+    p.branch = id.branch;
+    p.depth = id.depth;
+    p.runSeed = seed_;
+    p.genSeed = levelGenSeed(id);
+    p.infiniteWorld = infiniteWorldEnabled_;
+    p.floorCandidates = floorCandidates_;
+    return p;
+}
+
+void Game::scheduleFloorPrefetch() {
+    if (!floorPrefetchEnabled_) {
+        floorPrefetch_.cancel();
+        return;
+    }
+
+    // The likely next floor: the dungeon entrance from the surface, otherwise one deeper.
+    const LevelId next = atCamp() ? LevelId{DungeonBranch::Main, 1} : LevelId{branch_, depth_ + 1};
+    const bool endlessOk = infiniteWorldEnabled_ && next.branch == DungeonBranch::Main;
+    if ((next.depth > DUNGEON_MAX_DEPTH && !endlessOk) || levels.find(next) != levels.end()) {
+        floorPrefetch_.cancel();
+        return;
+    }
+
+    const FloorTerrainParams p = floorTerrainParams(next);
+    if (floorPrefetch_.pendingFor(p)) return;
+    floorPrefetch_.start(p, generateFloorTerrain);
+}
+
+OverworldChunkParams Game::overworldChunkParams(int x, int y) const {
+    OverworldChunkParams p;
+    p.runSeed = seed_;
+    p.x = x;
+    p.y = y;
+    // Chunk size follows the current surface (see tryOverworldStep()).
+    p.width = std::max(16, dung.width);
+    p.height = std::max(16, dung.height);
+    p.materialSeed = overworld::materialSeed(seed_, x, y);
+    p.materialDepth = overworld::dangerDepthFor(x, y, dungeonMaxDepth());
+    p.maxDepth = dungeonMaxDepth();
+    return p;
+}
+
+void Game::scheduleOverworldPrefetch() {
+    if (!floorPrefetchEnabled_ || !atCamp()) {
+        overworldPrefetch_.clear();
+        return;
+    }
+
+    // Only the gate-adjacent neighbors are reachable in one step; anything farther is stale.
+    overworldPrefetch_.retainAround(overworldX_, overworldY_, 1);
+
+    static constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (const auto& dir : kDirs) {
+        const int nx = overworldX_ + dir[0];
+        const int ny = overworldY_ + dir[1];
+        // Home camp is a regular level; visited chunks are restored, not generated.
+        if (nx == 0 && ny == 0) continue;
+        if (overworldChunks_.find(OverworldKey{nx, ny}) != overworldChunks_.end()) continue;
+        overworldPrefetch_.start(overworldChunkParams(nx, ny), overworldX_, overworldY_, generateOverworldChunkTerrain);
     }
 }
 
@@ -3484,6 +3581,7 @@ void Game::pruneEndlessLevels() {
         }
 
         if (id.depth < lo || id.depth > hi) {
+            invalidateLevelHash(id);
             it = levels.erase(it);
         } else {
             ++it;
@@ -4632,7 +4730,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         ents.erase(ents.begin() + static_cast<std::vector<Entity>::difference_type>(idx));
     }
 
-    storeCurrentLevel();
+    storeCurrentLevel(/*leaving=*/true);
 
     // Clear transient states.
     fx.clear();
@@ -4677,7 +4775,8 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
 
     bool restored = restoreLevel(newLevel);
 
-    Entity& p = playerMut();
+    // Note: spawning below can reallocate `ents`, so the player is looked up at each use
+    // instead of being held by reference across the whole function.
 
     // Helper: find a nearby free, walkable tile (used for safe stair arrival + follower placement).
     auto isFreeTile = [&](int x, int y, bool ignorePlayer) -> bool {
@@ -4745,7 +4844,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         for (auto& m : followers) {
             // Followers arrive "ready": they know where you are and will act on their next turn.
             m.alerted = true;
-            m.lastKnownPlayerPos = p.pos;
+            m.lastKnownPlayerPos = player().pos;
             m.lastKnownPlayerAge = 0;
             // Treat stair-travel as consuming their action budget.
             m.energy = 0;
@@ -4815,7 +4914,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
                 m.lastKnownPlayerAge = 9999;
             } else {
                 m.alerted = true;
-                m.lastKnownPlayerPos = p.pos;
+                m.lastKnownPlayerPos = player().pos;
                 m.lastKnownPlayerAge = 0;
             }
 
@@ -4857,22 +4956,18 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         // Infinite World regeneration when pruning old levels.
         const bool deterministicLevel = true;
         const uint32_t gameplayRngState = rng.state;
-        if (deterministicLevel) {
-            rng.state = levelGenSeed(newLevel);
-        }
-
-        const Vec2i msz = proceduralMapSizeFor(rng, branch_, depth_);
-        dung = Dungeon(msz.x, msz.y);
-        dung.generate(rng, branch_, depth_, DUNGEON_MAX_DEPTH, seed_);
 
-        if (branch_ == DungeonBranch::Camp && depth_ == 0) {
-            overworld::ensureBorderGates(dung, seed_, 0, 0);
+        // Terrain comes from the background prefetch when it was built for exactly these
+        // parameters; otherwise it is generated here. Both paths run generateFloorTerrain().
+        const FloorTerrainParams terrainParams = floorTerrainParams(LevelId{branch_, depth_});
+        FloorTerrain terrain;
+        if (!floorPrefetch_.take(terrainParams, terrain)) {
+            terrain = generateFloorTerrain(terrainParams);
+        }
+        dung = std::move(terrain.dung);
+        if (deterministicLevel) {
+            rng.state = terrain.rngState;
         }
-
-        // In infinite mode, the sanctum (depth == max) gains a downstairs so depth 26+ is reachable.
-        ensureEndlessSanctumDownstairs(newLevel, dung, rng);
-        dung.computeEndlessStratumInfo(seed_, branch_, depth_, DUNGEON_MAX_DEPTH);
-        dung.computeCampaignStratumInfo(seed_, branch_, depth_, DUNGEON_MAX_DEPTH);
 
         confusionGas_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
         poisonGas_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
@@ -4880,6 +4975,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         fireField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
         adhesiveFluid_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
         scentField_.assign(static_cast<size_t>(dung.width * dung.height), uint8_t{0});
+        resetHazardActivity();
 
         // Shrines get a visible altar overlay tile (placed before graffiti/spawns so it stays clear).
         spawnAltars();
@@ -4890,8 +4986,8 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         const Vec2i desiredArrival = goingDown ? dung.stairsUp : dung.stairsDown;
 
         // Place player before spawning so we never spawn on top of them.
-        p.pos = desiredArrival;
-        p.alerted = false;
+        setEntityPos(playerMut(), desiredArrival);
+        playerMut().alerted = false;
 
         // Generate deterministic level content (monsters/items/traps/bones) before placing
         // dynamic arrivals (followers/companions/trapdoor fallers).
@@ -4913,7 +5009,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         }
 
         // Place stair followers after spawning so generation is deterministic in infinite mode.
-        followedCount = placeFollowersNear(p.pos);
+        followedCount = placeFollowersNear(player().pos);
 
         // Place companions (allies) near the player on the new level.
         size_t companionCount = 0;
@@ -4925,7 +5021,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
             // Treat stair-travel as consuming their action budget.
             c.energy = 0;
 
-            Vec2i spawn = findNearbyFreeTile(p.pos, 4, true, false);
+            Vec2i spawn = findNearbyFreeTile(player().pos, 4, true, false);
             if (!dung.inBounds(spawn.x, spawn.y) || entityAt(spawn.x, spawn.y) != nullptr || !dung.isWalkable(spawn.x, spawn.y)) {
                 continue;
             }
@@ -4945,7 +5041,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         placeTrapdoorFallersHere();
 
         // Stair arrival is noisy: nearby monsters may wake and investigate.
-        emitNoise(p.pos, 12);
+        emitNoise(player().pos, 12);
 
         // Save this freshly created level.
         storeCurrentLevel();
@@ -4960,15 +5056,15 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         // If a monster is camping the stairs, don't overlap: step off to the side.
         const Entity* blocker = entityAt(desiredArrival.x, desiredArrival.y);
         if (blocker && blocker->id != playerId_) {
-            p.pos = findNearbyFreeTile(desiredArrival, 6, true, true);
+            setEntityPos(playerMut(), findNearbyFreeTile(desiredArrival, 6, true, true));
             pushMsg("THE STAIRS ARE BLOCKED! YOU STUMBLE ASIDE.", MessageKind::Warning, true);
         } else {
-            p.pos = desiredArrival;
+            setEntityPos(playerMut(), desiredArrival);
         }
 
-        p.alerted = false;
+        playerMut().alerted = false;
 
-        followedCount = placeFollowersNear(p.pos);
+        followedCount = placeFollowersNear(player().pos);
 
         // Place companions (allies) near the player on the new level.
         size_t companionCount = 0;
@@ -4980,7 +5076,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
             // Treat stair-travel as consuming their action budget.
             c.energy = 0;
 
-            Vec2i spawn = findNearbyFreeTile(p.pos, 4, true, false);
+            Vec2i spawn = findNearbyFreeTile(player().pos, 4, true, false);
             if (!dung.inBounds(spawn.x, spawn.y) || entityAt(spawn.x, spawn.y) != nullptr || !dung.isWalkable(spawn.x, spawn.y)) {
                 continue;
             }
@@ -5000,7 +5096,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
         placeTrapdoorFallersHere();
 
         // Stair arrival is noisy on visited floors too.
-        emitNoise(p.pos, 12);
+        emitNoise(player().pos, 12);
     }
 
     // Auto-explore bookkeeping is transient per-floor; size it to the current dungeon.
@@ -5012,7 +5108,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
     ecosystemSeenMask_ = 0u;
     if (!atCamp()) {
         dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
-        const EcosystemKind e0 = dung.ecosystemAtCached(p.pos.x, p.pos.y);
+        const EcosystemKind e0 = dung.ecosystemAtCached(player().pos.x, player().pos.y);
         lastEcosystem_ = e0;
         if (e0 != EcosystemKind::None) {
             ecosystemSeenMask_ |= (1u << static_cast<uint32_t>(e0));
@@ -5020,7 +5116,7 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
     }
 
     // Small heal on travel.
-    p.hp = std::min(p.hpMax, p.hp + 2);
+    playerMut().hp = std::min(player().hpMax, player().hp + 2);
 
     std::ostringstream ss;
     if (!goingDown && atCamp()) {
@@ -5077,11 +5173,11 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
     // MERCHANT GUILD PURSUIT: if you fled a shop with unpaid goods, guards may pursue across floors.
     if (merchantGuildAlerted_ && shopDebtTotal() > 0 && !atCamp()) {
         if (rng.chance(0.65f)) {
-            Vec2i gpos = findNearbyFreeTile(p.pos, 6, true, true);
+            Vec2i gpos = findNearbyFreeTile(player().pos, 6, true, true);
             if (dung.inBounds(gpos.x, gpos.y) && dung.isWalkable(gpos.x, gpos.y) && !entityAt(gpos.x, gpos.y)) {
                 Entity& g = spawnMonster(EntityKind::Guard, gpos, 0, /*allowGear=*/true);
                 g.alerted = true;
-                g.lastKnownPlayerPos = p.pos;
+                g.lastKnownPlayerPos = player().pos;
                 g.lastKnownPlayerAge = 0;
                 g.energy = 0;
                 pushMsg("YOU HEAR BOOTS ECHOING IN THE DARK...", MessageKind::Warning, true);
@@ -5229,6 +5325,10 @@ void Game::changeLevel(LevelId newLevel, bool goingDown) {
     // Infinite world: prune distant deep levels to keep the cache bounded.
     pruneEndlessLevels();
 
+    // Opt-in: start building the next floor's terrain while the player explores this one.
+    scheduleFloorPrefetch();
+    scheduleOverworldPrefetch();
+
     // Safety: when autosave is enabled, also autosave on floor transitions.
     // This avoids losing progress between levels even if the turn-based autosave interval hasn't triggered yet.
     if (autosaveInterval > 0 && !isFinished()) {
@@ -5363,11 +5463,63 @@ namespace {
 struct Hash64 {
     // FNV-1a 64-bit
     uint64_t h = 14695981039346656037ULL;
-    static constexpr uint64_t kPrime = 1099511628211ull;
+    uint64_t n = 0; // bytes hashed so far (segment lengths for FnvSegmentCache)
+    static constexpr uint64_t kPrime = fnv::kPrime64;
 
     void addByte(uint8_t b) {
         h ^= static_cast<uint64_t>(b);
         h *= kPrime;
+        ++n;
+    }
+
+    // A zero byte is a plain multiply by P, so a run of k zeros is one multiply by P^k.
+    void addZeros(uint64_t k) {
+        if (k == 0) return;
+        h *= fnv::primePow(k);
+        n += k;
+    }
+
+    // Same result as calling addByte() for every byte; long zero runs (idle hazard
+    // fields, unscented corridors) collapse into a single multiply.
+    void addBytes(const uint8_t* p, size_t len) {
+        size_t i = 0;
+        uint64_t zeros = 0;
+        while (i < len) {
+            if (i + 8 <= len) {
+                uint64_t w;
+                std::memcpy(&w, p + i, sizeof(w));
+                if (w == 0) {
+                    zeros += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+            if (p[i] == 0) {
+                ++zeros;
+            } else {
+                addZeros(zeros);
+                zeros = 0;
+                addByte(p[i]);
+            }
+            ++i;
+        }
+        addZeros(zeros);
+    }
+
+    void addBytes(const std::vector<uint8_t>& v) { addBytes(v.data(), v.size()); }
+
+    // One map tile: addEnum(type) (TileType is a uint8_t enum, so three zero bytes
+    // follow), then the two fog-of-war flags.
+    void addTile(const Tile& t) {
+        static_assert(sizeof(TileType) == 1, "addTile assumes a one-byte TileType");
+        static const uint64_t kPrime4 = fnv::primePow(4);
+        h ^= static_cast<uint64_t>(static_cast<uint8_t>(t.type));
+        h *= kPrime4;
+        h ^= t.visible ? 1u : 0u;
+        h *= kPrime;
+        h ^= t.explored ? 1u : 0u;
+        h *= kPrime;
+        n += 6;
     }
 
     void addBool(bool v) { addByte(v ? 1u : 0u); }
@@ -5415,6 +5567,47 @@ struct Hash64 {
     }
 };
 
+// Hashes one segment through `seg` when caching is enabled: replayed in O(1) if the
+// segment was already seen with the same incoming low byte, otherwise hashed the slow
+// way and recorded. The caller owns invalidation (content changed => seg->invalidate()).
+template <typename Fn>
+void hashSegment(Hash64& hh, FnvSegmentCache* seg, Fn&& body) {
+    if (seg && seg->replay(hh.h)) {
+        hh.n += seg->length();
+        return;
+    }
+    const uint64_t hIn = hh.h;
+    const uint64_t n0 = hh.n;
+    body();
+    if (seg) seg->record(hIn, hh.h, hh.n - n0);
+}
+
+// Packs the hashed tile state (type + fog flags) into `snap`; returns true if it differed.
+bool refreshTileSnapshot(std::vector<uint16_t>& snap, const Dungeon& d) {
+    bool changed = false;
+    if (snap.size() != d.tiles.size()) {
+        snap.assign(d.tiles.size(), 0);
+        changed = true;
+    }
+    for (size_t i = 0; i < d.tiles.size(); ++i) {
+        const Tile& t = d.tiles[i];
+        const uint16_t packed = static_cast<uint16_t>((static_cast<unsigned>(t.type) << 2) |
+                                                      (t.visible ? 1u : 0u) | (t.explored ? 2u : 0u));
+        if (snap[i] != packed) {
+            snap[i] = packed;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Keeps a copy of a byte field; returns true if the live field differed from it.
+bool refreshByteSnapshot(std::vector<uint8_t>& snap, const std::vector<uint8_t>& v) {
+    if (snap == v) return false;
+    snap = v;
+    return true;
+}
+
 static void hashItem(Hash64& hh, const Item& it) {
     hh.addI32(it.id);
     hh.addEnum(it.kind);
@@ -5521,19 +5714,30 @@ static void hashEntity(Hash64& hh, const Entity& e) {
     }
 }
 
-static void hashDungeon(Hash64& hh, const Dungeon& d) {
+// `packedTiles` hashes a stored level's tiles straight from LevelState::snapshot.
+static void hashDungeon(Hash64& hh, const Dungeon& d, FnvSegmentCache* tileSeg = nullptr,
+                        const PackedBytes* packedTiles = nullptr) {
     hh.addI32(d.width);
     hh.addI32(d.height);
     hh.addVec2(d.stairsUp);
     hh.addVec2(d.stairsDown);
 
     // Tiles: type + fog-of-war.
-    hh.addU32(static_cast<uint32_t>(d.tiles.size()));
-    for (const auto& t : d.tiles) {
-        hh.addEnum(t.type);
-        hh.addBool(t.visible);
-        hh.addBool(t.explored);
-    }
+    hh.addU32(packedTiles ? packedTiles->size : static_cast<uint32_t>(d.tiles.size()));
+    hashSegment(hh, tileSeg, [&] {
+        if (packedTiles) {
+            packedTiles->visit(
+                [&](uint8_t v, size_t count) {
+                    const Tile t = levelpack::unpackTile(v);
+                    for (size_t i = 0; i < count; ++i) hh.addTile(t);
+                },
+                [&](const uint8_t* p, size_t count) {
+                    for (size_t i = 0; i < count; ++i) hh.addTile(levelpack::unpackTile(p[i]));
+                });
+            return;
+        }
+        for (const auto& t : d.tiles) hh.addTile(t);
+    });
 
     // Rooms: used for special behaviors (shops, shrines, etc.).
     hh.addU32(static_cast<uint32_t>(d.rooms.size()));
@@ -5579,10 +5783,30 @@ static void hashChestContainer(Hash64& hh, const ChestContainer& c) {
     for (const auto& it : c.items) hashItem(hh, it);
 }
 
+static void hashLevelField(Hash64& hh, const std::vector<uint8_t>& v, const PackedBytes* packed) {
+    if (!packed) {
+        hh.addU32(static_cast<uint32_t>(v.size()));
+        hh.addBytes(v);
+        return;
+    }
+    hh.addU32(packed->size);
+    packed->visit(
+        [&](uint8_t b, size_t count) {
+            if (b == 0) {
+                hh.addZeros(count);
+            } else {
+                for (size_t i = 0; i < count; ++i) hh.addByte(b);
+            }
+        },
+        [&](const uint8_t* p, size_t count) { hh.addBytes(p, count); });
+}
+
 static void hashLevelState(Hash64& hh, const LevelState& ls) {
+    const LevelSnapshot* snap = ls.packed() ? &ls.snapshot : nullptr;
+
     hh.addEnum(ls.branch);
     hh.addI32(ls.depth);
-    hashDungeon(hh, ls.dung);
+    hashDungeon(hh, ls.dung, nullptr, snap ? &snap->tiles : nullptr);
 
     hh.addU32(static_cast<uint32_t>(ls.monsters.size()));
     for (const auto& e : ls.monsters) hashEntity(hh, e);
@@ -5602,29 +5826,67 @@ static void hashLevelState(Hash64& hh, const LevelState& ls) {
     hh.addU32(static_cast<uint32_t>(ls.chestContainers.size()));
     for (const auto& c : ls.chestContainers) hashChestContainer(hh, c);
 
-    hh.addU32(static_cast<uint32_t>(ls.confusionGas.size()));
-    for (uint8_t v : ls.confusionGas) hh.addU8(v);
+    hashLevelField(hh, ls.confusionGas, snap ? &snap->fields[0] : nullptr);
+    hashLevelField(hh, ls.poisonGas, snap ? &snap->fields[1] : nullptr);
+    hashLevelField(hh, ls.corrosiveGas, snap ? &snap->fields[2] : nullptr);
+    hashLevelField(hh, ls.fireField, snap ? &snap->fields[3] : nullptr);
+    hashLevelField(hh, ls.adhesiveFluid, snap ? &snap->fields[4] : nullptr);
+    hashLevelField(hh, ls.scentField, snap ? &snap->fields[5] : nullptr);
+}
+} // namespace
 
-    hh.addU32(static_cast<uint32_t>(ls.poisonGas.size()));
-    for (uint8_t v : ls.poisonGas) hh.addU8(v);
+uint64_t Game::determinismHash() const {
+    return determinismHashImpl(true);
+}
 
-    hh.addU32(static_cast<uint32_t>(ls.corrosiveGas.size()));
-    for (uint8_t v : ls.corrosiveGas) hh.addU8(v);
+uint64_t Game::determinismHashUncached() const {
+    return determinismHashImpl(false);
+}
 
-    hh.addU32(static_cast<uint32_t>(ls.fireField.size()));
-    for (uint8_t v : ls.fireField) hh.addU8(v);
+std::array<uint64_t, Game::kHashPartCount> Game::determinismHashParts() const {
+    std::array<uint64_t, kHashPartCount> parts{};
+    (void)determinismHashImpl(false, &parts);
+    return parts;
+}
 
-    hh.addU32(static_cast<uint32_t>(ls.adhesiveFluid.size()));
-    for (uint8_t v : ls.adhesiveFluid) hh.addU8(v);
+const char* Game::hashPartName(HashPart p) {
+    switch (p) {
+        case HashPart::Core:       return "core";
+        case HashPart::Automation: return "automation";
+        case HashPart::Player:     return "player";
+        case HashPart::Dungeon:    return "dungeon";
+        case HashPart::Monsters:   return "monsters";
+        case HashPart::Items:      return "items";
+        case HashPart::Features:   return "features";
+        case HashPart::Fields:     return "fields";
+        case HashPart::Levels:     return "levels";
+        case HashPart::Fallers:    return "fallers";
+    }
+    return "unknown";
+}
 
-    hh.addU32(static_cast<uint32_t>(ls.scentField.size()));
-    for (uint8_t v : ls.scentField) hh.addU8(v);
+void Game::invalidateLevelHash(LevelId id) {
+    hashCache_.levels.erase(id);
 }
-} // namespace
 
-uint64_t Game::determinismHash() const {
+void Game::invalidateLevelHashes() {
+    hashCache_.levels.clear();
+}
+
+uint64_t Game::determinismHashImpl(bool useCache, std::array<uint64_t, kHashPartCount>* parts) const {
     Hash64 hh;
 
+    // With `parts`, every section restarts from a fresh hasher and the chained result is
+    // meaningless; the caches are bypassed (they are keyed by the chained state).
+    if (parts) useCache = false;
+    size_t part = 0;
+    auto section = [&](HashPart next) {
+        if (!parts) return;
+        (*parts)[part] = hh.h;
+        hh = Hash64{};
+        part = static_cast<size_t>(next);
+    };
+
     // Core run identity.
     hh.addU32(seed_);
     hh.addU32(rng.state);
@@ -5684,6 +5946,7 @@ uint64_t Game::determinismHash() const {
     hh.addI32(yendorDoomMsgStage_);
 
     // Automation (affects future turns without further player input).
+    section(HashPart::Automation);
     hh.addEnum(autoMode);
     hh.addU32(static_cast<uint32_t>(autoPathTiles.size()));
     for (const auto& p : autoPathTiles) hh.addVec2(p);
@@ -5697,9 +5960,10 @@ uint64_t Game::determinismHash() const {
     hh.addI32(autoExploreSearchTurnsLeft);
     hh.addBool(autoExploreSearchAnnounced);
     hh.addU32(static_cast<uint32_t>(autoExploreSearchTriedTurns.size()));
-    for (uint8_t v : autoExploreSearchTriedTurns) hh.addU8(v);
+    hh.addBytes(autoExploreSearchTriedTurns);
 
     // Player progression.
+    section(HashPart::Player);
     hh.addEnum(playerClass_);
     hh.addI32(charLevel);
     hh.addI32(xp);
@@ -5724,14 +5988,26 @@ uint64_t Game::determinismHash() const {
     for (uint8_t v : identAppearance) hh.addU8(v);
 
     // Current level: dungeon, entities, items, traps, markers, fields.
-    hashDungeon(hh, dung);
+    //
+    // Tiles and the byte fields are compared against the snapshot taken by the previous
+    // call; unchanged ones replay their cached segment (see fnv_segment_cache.hpp).
+    section(HashPart::Dungeon);
+    FnvSegmentCache* tileSeg = nullptr;
+    if (useCache) {
+        if (refreshTileSnapshot(hashCache_.tileSnap, dung)) hashCache_.tileSeg.invalidate();
+        tileSeg = &hashCache_.tileSeg;
+    }
+    hashDungeon(hh, dung, tileSeg);
 
+    section(HashPart::Monsters);
     hh.addU32(static_cast<uint32_t>(ents.size()));
     for (const auto& e : ents) hashEntity(hh, e);
 
+    section(HashPart::Items);
     hh.addU32(static_cast<uint32_t>(ground.size()));
     for (const auto& g : ground) hashGroundItem(hh, g);
 
+    section(HashPart::Features);
     hh.addU32(static_cast<uint32_t>(trapsCur.size()));
     for (const auto& t : trapsCur) hashTrap(hh, t);
 
@@ -5744,25 +6020,25 @@ uint64_t Game::determinismHash() const {
     hh.addU32(static_cast<uint32_t>(chestContainers_.size()));
     for (const auto& c : chestContainers_) hashChestContainer(hh, c);
 
-    hh.addU32(static_cast<uint32_t>(confusionGas_.size()));
-    for (uint8_t v : confusionGas_) hh.addU8(v);
-
-    hh.addU32(static_cast<uint32_t>(poisonGas_.size()));
-    for (uint8_t v : poisonGas_) hh.addU8(v);
-
-    hh.addU32(static_cast<uint32_t>(corrosiveGas_.size()));
-    for (uint8_t v : corrosiveGas_) hh.addU8(v);
-
-    hh.addU32(static_cast<uint32_t>(fireField_.size()));
-    for (uint8_t v : fireField_) hh.addU8(v);
-
-    hh.addU32(static_cast<uint32_t>(adhesiveFluid_.size()));
-    for (uint8_t v : adhesiveFluid_) hh.addU8(v);
+    section(HashPart::Fields);
+    const std::vector<uint8_t>* byteFields[DeterminismHashCache::kByteFields] = {
+        &confusionGas_, &poisonGas_, &corrosiveGas_, &fireField_, &adhesiveFluid_, &scentField_,
+    };
+    for (size_t i = 0; i < DeterminismHashCache::kByteFields; ++i) {
+        const std::vector<uint8_t>& v = *byteFields[i];
+        hh.addU32(static_cast<uint32_t>(v.size()));
 
-    hh.addU32(static_cast<uint32_t>(scentField_.size()));
-    for (uint8_t v : scentField_) hh.addU8(v);
+        FnvSegmentCache* seg = nullptr;
+        if (useCache) {
+            DeterminismHashCache::ByteField& c = hashCache_.fields[i];
+            if (refreshByteSnapshot(c.snap, v)) c.seg.invalidate();
+            seg = &c.seg;
+        }
+        hashSegment(hh, seg, [&] { hh.addBytes(v); });
+    }
 
     // Persisted off-screen levels.
+    section(HashPart::Levels);
     //
     // NOTE: `levels` is primarily intended to cache *off-screen* floors, but the
     // currently active depth may also be mirrored into `levels` as a convenience
@@ -5779,12 +6055,17 @@ uint64_t Game::determinismHash() const {
     hh.addU32(levelCount);
     for (const auto& kv : levels) {
         if (kv.first == curId) continue;
-        hh.addEnum(kv.first.branch);
-        hh.addI32(kv.first.depth);
-        hashLevelState(hh, kv.second);
+        // Stored levels only change at a handful of sites, which call invalidateLevelHash().
+        FnvSegmentCache* seg = useCache ? &hashCache_.levels[kv.first] : nullptr;
+        hashSegment(hh, seg, [&] {
+            hh.addEnum(kv.first.branch);
+            hh.addI32(kv.first.depth);
+            hashLevelState(hh, kv.second);
+        });
     }
 
     // Pending trapdoor fallers (creatures that fell to deeper levels but aren't placed yet).
+    section(HashPart::Fallers);
     // Keyed by (branch, depth) so multiple branches can safely coexist.
     uint32_t fallEntryCount = 0;
     for (const auto& kv : trapdoorFallers_) {
@@ -5801,6 +6082,7 @@ uint64_t Game::determinismHash() const {
         for (const auto& e : vec) hashEntity(hh, e);
     }
 
+    if (parts) (*parts)[part] = hh.h;
     return hh.h;
 }
 
@@ -2,6 +2,14 @@
 #include "common.hpp"
 #include "dungeon.hpp"
 #include "items.hpp"
+#include "floor_prefetch.hpp"
+#include "overworld_prefetch.hpp"
+#include "fnv_segment_cache.hpp"
+#include "hazard_kernels.hpp"
+#include "level_snapshot.hpp"
+#include "light_map.hpp"
+#include "monster_cost_cache.hpp"
+#include "monster_nav_grid.hpp"
 #include "spells.hpp"
 #include "effects.hpp"
 #include "rng.hpp"
@@ -1420,6 +1428,23 @@ struct LevelState {
     // Persistent scent trail used by smell-capable monsters to track the player.
     // Stored as a per-tile intensity map (0..255).
     std::vector<uint8_t> scentField;
+
+    // Compact form of the per-tile vectors above (dung.tiles, the Dungeon's material
+    // caches and the six fields) while the level is inactive; see level_snapshot.hpp.
+    // Game::restoreLevel() decodes lazily. Other code that needs those vectors from a
+    // stored level calls unpack() first (or works on expanded()).
+    LevelSnapshot snapshot;
+
+    bool packed() const { return snapshot.valid; }
+    void pack();
+    void unpack();
+    // Sets field `i` (LevelSnapshot order) to `n` zeros, in whichever form the level is in.
+    void setZeroField(int i, size_t n);
+    LevelState expanded() const;
+
+    // Approximate heap footprint, as stored and as it would be fully expanded.
+    size_t memoryBytes() const;
+    size_t expandedBytes() const;
 };
 
 class Game {
@@ -1561,6 +1586,24 @@ public:
     // 0 means no scent. Only meaningful on in-bounds tiles.
     uint8_t scentAt(int x, int y) const;
 
+    // Raw per-tile hazard planes for tight loops (monster pathing). Each is either
+    // empty or dungeon().width * dungeon().height.
+    const std::vector<uint8_t>& confusionGasField() const { return confusionGas_; }
+    const std::vector<uint8_t>& poisonGasField() const { return poisonGas_; }
+    const std::vector<uint8_t>& corrosiveGasField() const { return corrosiveGas_; }
+    const std::vector<uint8_t>& fireField() const { return fireField_; }
+
+    // Cached monster navigation planes for the current level (see monster_nav_grid.hpp).
+    // Synced lazily against the dungeon's terrain journal and discovered traps.
+    const MonsterNavGrid& monsterNavGrid() const;
+
+    // Cached floor coefficients for the gas/fire/scent kernels (see hazard_kernels.hpp).
+    // Synced on every call: doors and digging change terrain mid-turn.
+    const hazard::HazardPlanes& hazardPlanes() const;
+
+    // Cross-turn cost-to-target cache used by monster AI (hit/miss counters for tooling).
+    const MonsterCostCache& monsterCostCache() const { return monsterCostCache_; }
+
     // Procedural per-level wind (deterministic from run seed + level id).
     // Used to bias gas and fire drift/spread. Returns a cardinal direction vector
     // (dx,dy) or {0,0} for calm.
@@ -1966,6 +2009,10 @@ bool clearItemCallLabel(ItemKind k);
     uint8_t tileLightLevel(int x, int y) const;
     // Per-tile light color (RGB 0..255) for the current level.
     Color tileLightColor(int x, int y) const;
+    // Tile rectangles whose light changed in the last light map update. lightRevision()
+    // advances with every such update; a renderer that missed one should redraw everything.
+    const std::vector<LightRect>& lightDirtyRects() const { return lightCache_.dirtyRects(); }
+    uint32_t lightRevision() const { return lightCache_.revision(); }
     // A short HUD-friendly label for lighting state ("DARK", "TORCH(123)", ...).
     std::string lightTag() const;
 
@@ -2002,6 +2049,25 @@ bool clearItemCallLabel(ItemKind k);
     void setInfiniteKeepWindow(int n) { infiniteKeepWindow_ = std::clamp(n, 0, 200); }
     int infiniteKeepWindow() const { return infiniteKeepWindow_; }
 
+    // Floor generate-and-test width: 0 keeps the default 1..3 candidates per floor;
+    // higher values score more candidate layouts (built in parallel). Gameplay-affecting.
+    void setFloorCandidates(int n) { floorCandidates_ = std::clamp(n, 0, Dungeon::MAX_FLOOR_CANDIDATES); }
+    int floorCandidates() const { return floorCandidates_; }
+
+    // Background pre-generation of the next floor's terrain and of the wilderness chunks
+    // around the current one (see floor_prefetch.hpp, overworld_prefetch.hpp).
+    // Does not change gameplay: arrival produces the same floor/chunk either way.
+    void setFloorPrefetchEnabled(bool enabled) {
+        floorPrefetchEnabled_ = enabled;
+        if (!enabled) {
+            floorPrefetch_.cancel();
+            overworldPrefetch_.clear();
+        }
+    }
+    bool floorPrefetchEnabled() const { return floorPrefetchEnabled_; }
+    const FloorPrefetch::Stats& floorPrefetchStats() const { return floorPrefetch_.stats(); }
+    const OverworldChunkPrefetch::Stats& overworldPrefetchStats() const { return overworldPrefetch_.stats(); }
+
 
     // Targeting
     bool isTargeting() const { return targeting; }
@@ -2356,15 +2422,50 @@ bool clearItemCallLabel(ItemKind k);
     // and real-time timers so it can be used to validate deterministic simulation
     // across machines/frame rates.
     uint64_t determinismHash() const;
+    // Same value computed without the segment caches (reference path for tests/tools).
+    uint64_t determinismHashUncached() const;
+
+    // determinismHash() split by subsystem: every part hashes its own section of the state
+    // from a fresh seed, so two runs can be compared part by part (desync bisection).
+    enum class HashPart : uint8_t {
+        Core = 0,   // run identity, counters, toggles, shrine/economy/endgame state
+        Automation, // auto-move / auto-explore bookkeeping
+        Player,     // progression, inventory, equipment, identification
+        Dungeon,    // current level tiles
+        Monsters,   // current level entities
+        Items,      // current level ground items
+        Features,   // traps, map markers, engravings, chests
+        Fields,     // gas/fire/fluid/scent fields
+        Levels,     // stored off-screen levels
+        Fallers,    // pending trapdoor fallers
+    };
+    static constexpr size_t kHashPartCount = 10;
+    static const char* hashPartName(HashPart p);
+    std::array<uint64_t, kHashPartCount> determinismHashParts() const;
+
+    // Memory held by stored (inactive) floors and overworld chunks; see LevelState::pack().
+    struct LevelCacheStats {
+        size_t floors = 0;
+        size_t chunks = 0;
+        size_t packed = 0;        // entries currently in packed form
+        size_t bytes = 0;         // approximate heap footprint as stored
+        size_t expandedBytes = 0; // the same entries fully expanded
+    };
+    LevelCacheStats levelCacheStats() const;
 
     // Optional callback invoked once per completed player turn (after the turn counter
     // increments and end-of-turn logic like monster turns/FOV/effects have been applied).
     //
     // Used by the replay recorder/verifier to attach per-turn state hashes without
-    // coupling the core game logic to replay I/O.
+    // coupling the core game logic to replay I/O. With everyTurns > 1 the hook (and the
+    // state hash it needs) only runs on turns divisible by it.
     using TurnHookFn = void(*)(void* user, uint32_t turn, uint64_t stateHash);
-    void setTurnHook(TurnHookFn fn, void* user) { turnHookFn_ = fn; turnHookUser_ = user; }
-    void clearTurnHook() { turnHookFn_ = nullptr; turnHookUser_ = nullptr; }
+    void setTurnHook(TurnHookFn fn, void* user, uint32_t everyTurns = 1) {
+        turnHookFn_ = fn;
+        turnHookUser_ = user;
+        turnHookEvery_ = everyTurns;
+    }
+    void clearTurnHook() { turnHookFn_ = nullptr; turnHookUser_ = nullptr; turnHookEvery_ = 1; }
 
     // Messages + scrollback
     const std::vector<Message>& messages() const { return msgs; }
@@ -2630,6 +2731,37 @@ private:
     // Persistent visited levels (monsters + items + explored tiles)
     std::map<LevelId, LevelState> levels;
 
+    // determinismHash() segment caches. The hash is called every turn while recording
+    // or verifying replays, and most of its input (stored levels, idle hazard fields,
+    // fog-of-war while standing still) does not change between turns.
+    //  - Current-level tiles/fields are checked against a snapshot on every call.
+    //  - Stored levels are trusted until invalidateLevelHash()/invalidateLevelHashes();
+    //    every write to `levels` must call one of them.
+    struct DeterminismHashCache {
+        static constexpr size_t kByteFields = 6;
+        struct ByteField {
+            std::vector<uint8_t> snap;
+            FnvSegmentCache seg;
+        };
+
+        std::vector<uint16_t> tileSnap;
+        FnvSegmentCache tileSeg;
+        std::array<ByteField, kByteFields> fields;
+        std::map<LevelId, FnvSegmentCache> levels;
+    };
+    mutable DeterminismHashCache hashCache_;
+
+    uint64_t determinismHashImpl(bool useCache, std::array<uint64_t, kHashPartCount>* parts = nullptr) const;
+
+    // Packs every stored level except the active one (level departures, save loading).
+    void packInactiveLevels();
+    // Read-only Dungeon of a stored level; packed entries are decoded into a scratch copy
+    // that stays valid until the next call.
+    const Dungeon& storedDungeonView(const LevelState& st) const;
+    mutable Dungeon storedDungeonScratch_;
+    void invalidateLevelHash(LevelId id);
+    void invalidateLevelHashes();
+
     // Overworld chunk cache (Camp depth 0).
     //
     // The hub camp is always at (0,0) and is stored in `levels[{Camp,0}]` like before.
@@ -2680,6 +2812,32 @@ private:
     int nextEntityId = 1;
     int playerId_ = 0;
 
+    // Spatial occupancy index over `ents` (see game_spatial_index.cpp).
+    // Each tile records how many entities stand on it and, when exactly one does,
+    // its slot in `ents`; ids map to slots via a flat table. Structural edits to
+    // `ents` (push/erase/swap) are detected by fingerprint and trigger a rebuild,
+    // while position changes go through setEntityPos()/noteEntityMoved().
+    struct EntityIndexCell {
+        int32_t slot = -1;   // -1 = unknown/ambiguous (resolved by scan)
+        uint16_t count = 0;
+    };
+    mutable std::vector<EntityIndexCell> entCells_;
+    mutable std::vector<int32_t> entSlotById_;
+    mutable bool entIndexValid_ = false;
+    mutable int entIndexW_ = 0;
+    mutable int entIndexH_ = 0;
+    mutable size_t entIndexSize_ = 0;
+    mutable const Entity* entIndexData_ = nullptr;
+    mutable int entIndexFrontId_ = 0;
+    mutable int entIndexBackId_ = 0;
+
+    bool entityIndexCurrent() const;
+    void rebuildEntityIndex() const;
+    const Entity* entityAtIndexed(int x, int y) const;
+    const Entity* entityByIdIndexed(int id) const;
+    const Entity* entityAtScan(int x, int y) const;
+    const Entity* entityByIdScan(int id) const;
+
     // Items on ground (current level)
     std::vector<GroundItem> ground;
 
@@ -2703,6 +2861,20 @@ private:
     std::vector<uint8_t> adhesiveFluid_;
     std::vector<uint8_t> scentField_;
 
+    // Derived per-level cache (not serialized); see monsterNavGrid().
+    mutable MonsterNavGrid monsterNav_;
+    MonsterCostCache monsterCostCache_;
+    mutable hazard::HazardPlanes hazardPlanes_;
+    std::vector<uint8_t> hazardScratch_;
+
+    // Bounding boxes of the nonzero tiles of the gas/fire/scent fields; the end-of-turn
+    // kernels only visit these. Not serialized: a restored field starts unbounded.
+    hazard::ActiveRect confusionActive_;
+    hazard::ActiveRect poisonActive_;
+    hazard::ActiveRect corrosiveActive_;
+    hazard::ActiveRect fireActive_;
+    hazard::ActiveRect scentActive_;
+
     int nextItemId = 1;
 
     // Player inventory & equipment
@@ -3020,6 +3192,22 @@ private:
     // Sliding window size (in floors) for keeping deep (post-quest) levels cached.
     int infiniteKeepWindow_ = 12;
 
+    // Floor generation candidate count (see setFloorCandidates()).
+    int floorCandidates_ = 0;
+
+    // Next-floor terrain prefetch (opt-in).
+    bool floorPrefetchEnabled_ = false;
+    FloorPrefetch floorPrefetch_;
+
+    FloorTerrainParams floorTerrainParams(LevelId id) const;
+    void scheduleFloorPrefetch();
+
+    // Gate-adjacent wilderness chunk prefetch (same switch as the floor prefetch).
+    OverworldChunkPrefetch overworldPrefetch_;
+
+    OverworldChunkParams overworldChunkParams(int x, int y) const;
+    void scheduleOverworldPrefetch();
+
     // Hunger system (optional; when disabled, hunger does not tick).
     bool hungerEnabled_ = false;
     int hunger = 0;
@@ -3036,6 +3224,8 @@ private:
     std::vector<uint8_t> lightMap_;
     // Per-tile light color for the current level (RGB 0..255). Recomputed with lightMap_.
     std::vector<Color> lightColorMap_;
+    // Cached room light and per-source contributions behind the two maps (not serialized).
+    LightMapCache lightCache_;
 
     // Item identification (NetHack-style). When enabled, potions/scrolls start unknown each run
     // and become identified through use/identify scrolls.
@@ -3090,6 +3280,12 @@ private:
     // Optional per-turn hook (used by the replay recorder/verifier).
     TurnHookFn turnHookFn_ = nullptr;
     void* turnHookUser_ = nullptr;
+    uint32_t turnHookEvery_ = 1;
+    void runTurnHook() {
+        if (turnHookFn_ && (turnHookEvery_ <= 1u || turnCount % turnHookEvery_ == 0u)) {
+            turnHookFn_(turnHookUser_, turnCount, determinismHash());
+        }
+    }
     int naturalRegenCounter = 0;
 
     // Haste is handled as "every other player action skips the monster turn".
@@ -3204,6 +3400,25 @@ private:
     Entity* entityAtMut(int x, int y);
     const Entity* entityAt(int x, int y) const;
 
+    // Move an entity that lives in `ents` and keep the occupancy index in sync.
+    // Direct writes to Entity::pos on live entities would leave the index stale.
+    void setEntityPos(Entity& e, Vec2i p);
+    // For code that moved an entity by other means (e.g. physics helpers that
+    // operate on the raw entity vector).
+    void noteEntityMoved(const Entity& e, Vec2i from);
+    // Force a full rebuild on the next lookup (level swaps, bulk edits).
+    void invalidateEntityIndex() { entIndexValid_ = false; }
+    // Cross-check the index against a linear scan of `ents` (tests / debug builds).
+    bool validateEntityIndex() const;
+
+    // Anything that raises a gas/fire field value outside the end-of-turn kernels must
+    // widen that field's active box (the square of `radius` around (x, y)).
+    void markHazard(const std::vector<uint8_t>& field, int x, int y, int radius = 0);
+    // Forget the active boxes (level swaps, fresh fields); the next pass sweeps once.
+    void resetHazardActivity();
+    // Check that every nonzero field tile lies inside its active box (tests / debug builds).
+    bool validateHazardActivity() const;
+
     bool tryMove(Entity& e, int dx, int dy);
     bool attemptPlayerWebBreak(bool weakAttempt);
 
@@ -3322,8 +3537,13 @@ private:
     void zapDiggingWand(int range);
 
     // Level transitions
-    void storeCurrentLevel();
+    // Files the active level into `levels` / overworldChunks_. With `leaving` the live
+    // state is moved rather than copied; the caller must restore or generate a level next.
+    void storeCurrentLevel(bool leaving = false);
     bool restoreLevel(LevelId id);
+    // Moves a stored level's state into the live members. restoreLevel/restoreOverworldChunk
+    // then erase the hollow map entry; the level is filed again by storeCurrentLevel().
+    void adoptStoredLevel(LevelState& st);
 
     // Overworld chunk travel (Camp depth 0).
     // Triggered when the player attempts to step out-of-bounds through an edge gate.
@@ -3373,6 +3593,15 @@ public:
     // Convenience: attempt to load the requested save file, and if it fails,
     // automatically try rotated backups (<path>.bak1..bak10) in order.
     bool loadFromFileWithBackups(const std::string& path);
+
+    // The save file image (payload + CRC footer) without touching the disk; used for
+    // in-memory replay snapshots. loadFromMemory() takes the same bytes as loadFromFile().
+    void saveToMemory(std::string& out);
+    bool loadFromMemory(const std::string& bytes, bool reportErrors = true);
+
+    // True when a save taken now and loaded into a fresh Game continues the run exactly:
+    // no auto-move in progress and no overlay holding input state.
+    bool isSnapshotSafe() const;
 #if defined(PROCROGUE_TEST_ACCESS)
 public:
 #else
@@ -3496,6 +3725,40 @@ private:
     // through solid rock.
     void emitNoise(Vec2i pos, int volume);
 
+    // Noise batching.
+    //
+    // While a NoiseBatch is alive, emitNoise() only queues; the outermost batch resolves
+    // the queue when it closes. One multi-source sound search (each source seeded at
+    // loudest - volume) finds the listeners that any of the noises can reach, and only
+    // those are resolved against per-source maps, in emission order; repeated sources
+    // share one map. The result is identical to emitting one by one, provided nothing in
+    // the scope moves monsters, changes terrain or reads their alert state; open batches
+    // only around such runs of noises.
+    struct PendingNoise {
+        Vec2i pos;
+        int volume = 0;
+    };
+    class NoiseBatch {
+    public:
+        explicit NoiseBatch(Game& g) : g_(g) { ++g_.noiseBatchDepth_; }
+        ~NoiseBatch() {
+            if (--g_.noiseBatchDepth_ == 0) g_.flushNoiseBatch();
+        }
+        NoiseBatch(const NoiseBatch&) = delete;
+        NoiseBatch& operator=(const NoiseBatch&) = delete;
+
+    private:
+        Game& g_;
+    };
+    void flushNoiseBatch();
+    void resolveNoises(const std::vector<PendingNoise>& noises);
+
+    // Batch state and search buffers (transient).
+    int noiseBatchDepth_ = 0;
+    std::vector<PendingNoise> noiseBatch_;
+    std::vector<int> noiseField_;
+    std::vector<int> noiseMap_;
+
     // ------------------------------------------------------------
     // Lab doors can have procedurally generated seals.
     //
@@ -16,6 +16,34 @@ const Trap* discoveredTrapAt(const std::vector<Trap>& traps, int x, int y) {
     return nullptr;
 }
 
+// Per-tile buffers for Game::findNearestExploreFrontier(), kept across calls. Tiles are
+// marked with a generation stamp instead of a freshly zeroed W*H vector per BFS pass, so
+// a search costs what it visits rather than the size of the map.
+struct ExploreScratch {
+    std::vector<uint32_t> visit; // == pass stamp: queued in the current pass
+    std::vector<uint32_t> trap;  // == call stamp: a known trap
+    std::vector<int> firstTrap;  // valid for tiles queued in the current pass
+    std::deque<Vec2i> queue;
+    uint32_t gen = 0u;
+
+    // Sizes the buffers; leaves room for every stamp one search takes.
+    void begin(size_t n) {
+        if (visit.size() != n || gen > 0xFFFFFFF0u) {
+            visit.assign(n, 0u);
+            trap.assign(n, 0u);
+            firstTrap.assign(n, -1);
+            gen = 0u;
+        }
+    }
+
+    uint32_t stamp() { return ++gen; }
+};
+
+ExploreScratch& exploreScratch() {
+    thread_local ExploreScratch s;
+    return s;
+}
+
 int autoMoveTrapPenalty(TrapKind kind) {
     switch (kind) {
         case TrapKind::TrapDoor: return 120;
@@ -414,6 +442,8 @@ bool Game::stepAutoMove() {
         autoExploreSearchTurnsLeft--;
 
         advanceAfterPlayerAction();
+        // Monster turns may grow `ents` (and reallocate it); re-fetch the player.
+        const Entity& pNow = player();
 
         // Post-action safety stops (monsters can act during the turn we just spent searching).
         if (hungerEnabled_ && hungerStateFor(hunger, hungerMax) >= 2) {
@@ -421,27 +451,27 @@ bool Game::stepAutoMove() {
             stopAutoMove(true);
             return false;
         }
-        if (p.hp < hpBefore) {
+        if (pNow.hp < hpBefore) {
             pushMsg("AUTO-MOVE STOPPED (YOU TOOK DAMAGE).", MessageKind::Warning);
             stopAutoMove(true);
             return false;
         }
-        if (p.effects.poisonTurns > poisonBefore) {
+        if (pNow.effects.poisonTurns > poisonBefore) {
             pushMsg("AUTO-MOVE STOPPED (YOU WERE POISONED).", MessageKind::Warning);
             stopAutoMove(true);
             return false;
         }
-        if (p.effects.webTurns > webBefore) {
+        if (pNow.effects.webTurns > webBefore) {
             pushMsg("AUTO-MOVE STOPPED (YOU WERE WEBBED).", MessageKind::Warning);
             stopAutoMove(true);
             return false;
         }
-        if (p.effects.confusionTurns > confBefore) {
+        if (pNow.effects.confusionTurns > confBefore) {
             pushMsg("AUTO-MOVE STOPPED (YOU WERE CONFUSED).", MessageKind::Warning);
             stopAutoMove(true);
             return false;
         }
-        if (p.effects.burnTurns > burnBefore) {
+        if (pNow.effects.burnTurns > burnBefore) {
             pushMsg("AUTO-MOVE STOPPED (YOU CAUGHT FIRE).", MessageKind::Warning);
             stopAutoMove(true);
             return false;
@@ -672,6 +702,8 @@ bool Game::stepAutoMove() {
     }
 
     advanceAfterPlayerAction();
+    // Monster turns may grow `ents` (and reallocate it); re-fetch the player.
+    const Entity& pNow = player();
 
     if (hungerEnabled_ && hungerStateFor(hunger, hungerMax) >= 2) {
         pushMsg("AUTO-MOVE STOPPED (YOU ARE STARVING).", MessageKind::Warning);
@@ -679,41 +711,41 @@ bool Game::stepAutoMove() {
         return false;
     }
 
-    if (p.hp < hpBefore) {
+    if (pNow.hp < hpBefore) {
         pushMsg("AUTO-MOVE STOPPED (YOU TOOK DAMAGE).", MessageKind::Warning);
         stopAutoMove(true);
         return false;
     }
 
-    if (p.effects.poisonTurns > poisonBefore) {
+    if (pNow.effects.poisonTurns > poisonBefore) {
         pushMsg("AUTO-MOVE STOPPED (YOU WERE POISONED).", MessageKind::Warning);
         stopAutoMove(true);
         return false;
     }
 
-    if (p.effects.webTurns > webBefore) {
+    if (pNow.effects.webTurns > webBefore) {
         pushMsg("AUTO-MOVE STOPPED (YOU WERE WEBBED).", MessageKind::Warning);
         stopAutoMove(true);
         return false;
     }
 
-    if (p.effects.confusionTurns > confBefore) {
+    if (pNow.effects.confusionTurns > confBefore) {
         pushMsg("AUTO-MOVE STOPPED (YOU WERE CONFUSED).", MessageKind::Warning);
         stopAutoMove(true);
         return false;
     }
 
-    if (p.effects.burnTurns > burnBefore) {
+    if (pNow.effects.burnTurns > burnBefore) {
         pushMsg("AUTO-MOVE STOPPED (YOU CAUGHT FIRE).", MessageKind::Warning);
         stopAutoMove(true);
         return false;
     }
 
     // If we were auto-exploring toward loot, stop once we arrive (so the player can decide what to do).
-    if (autoMode == AutoMoveMode::Explore && autoExploreGoalIsLoot && p.pos == autoExploreGoalPos) {
-        if (tileHasAutoExploreLoot(p.pos)) {
+    if (autoMode == AutoMoveMode::Explore && autoExploreGoalIsLoot && pNow.pos == autoExploreGoalPos) {
+        if (tileHasAutoExploreLoot(pNow.pos)) {
             const bool chestHere = std::any_of(ground.begin(), ground.end(), [&](const GroundItem& gi) {
-                return gi.pos == p.pos && gi.item.kind == ItemKind::Chest;
+                return gi.pos == pNow.pos && gi.item.kind == ItemKind::Chest;
             });
             pushMsg(chestHere ? "AUTO-EXPLORE STOPPED (CHEST REACHED)." : "AUTO-EXPLORE STOPPED (LOOT REACHED).",
                     MessageKind::System);
@@ -977,7 +1009,14 @@ Vec2i Game::findNearestExploreFrontier() const {
     const int H = std::max(1, dung.height);
 
     auto idxOf = [W](int x, int y) -> int { return x + y * W; };
-    auto isKnownTrap = [&](int x, int y) -> bool { return discoveredTrapAt(trapsCur, x, y) != nullptr; };
+
+    ExploreScratch& scratch = exploreScratch();
+    scratch.begin(static_cast<size_t>(W * H));
+    const uint32_t trapStamp = scratch.stamp();
+    for (const Trap& t : trapsCur) {
+        if (t.discovered && dung.inBounds(t.pos.x, t.pos.y)) scratch.trap[idxOf(t.pos.x, t.pos.y)] = trapStamp;
+    }
+    auto isKnownTrap = [&](int x, int y) -> bool { return scratch.trap[idxOf(x, y)] == trapStamp; };
 
     const int dirs[8][2] = {
         { 1, 0 },
@@ -990,13 +1029,31 @@ Vec2i Game::findNearestExploreFrontier() const {
         { -1, -1 },
     };
 
+    // Explored/passable lookups read the tile bitplanes. "Borders an unexplored tile" is
+    // the frontier plane TilePlanes maintains from the FOV deltas, so nothing here scales
+    // with the map except the word scan below.
+    const TilePlanes& planes = dung.planes();
+    const TilePlanes::Word* exploredBits = planes.explored();
+    const TilePlanes::Word* passableBits = planes.passable();
+    const TilePlanes::Word* frontierBits = planes.frontier();
+    auto isExplored = [&](int x, int y) -> bool { return planes.test(exploredBits, x, y); };
+    auto bordersUnexplored = [&](int x, int y) -> bool { return planes.test(frontierBits, x, y); };
+
+    // With no explored, passable tile next to unexplored ground anywhere on the map,
+    // passes 1-2 cannot find a frontier; skip their BFS (common once a floor is done).
+    bool anyFrontierCandidate = levitating;
+    const size_t words = static_cast<size_t>(planes.stride()) * static_cast<size_t>(planes.height());
+    for (size_t k = 0; !anyFrontierCandidate && k < words; ++k) {
+        anyFrontierCandidate = (frontierBits[k] & passableBits[k]) != 0;
+    }
+
     auto isFrontier = [&](int x, int y) -> bool {
         if (!dung.inBounds(x, y)) return false;
-        if (!dung.at(x, y).explored) return false;
+        if (!isExplored(x, y)) return false;
 
         // Allow frontier candidates that are only reachable while levitating (chasms).
         const TileType ttHere = dung.at(x, y).type;
-        const bool passableHere = dung.isPassable(x, y) || (levitating && ttHere == TileType::Chasm);
+        const bool passableHere = planes.test(passableBits, x, y) || (levitating && ttHere == TileType::Chasm);
         if (!passableHere) return false;
 
         if (fireAt(x, y) > 0u) return false;
@@ -1004,25 +1061,19 @@ Vec2i Game::findNearestExploreFrontier() const {
         if (poisonGasAt(x, y) > 0u) return false;
         if (corrosiveGasAt(x, y) > 0u) return false;
 
-        for (int dir = 0; dir < 8; ++dir) {
-            const int nx = x + dirs[dir][0];
-            const int ny = y + dirs[dir][1];
-            if (!dung.inBounds(nx, ny)) continue;
-            if (!dung.at(nx, ny).explored) return true;
-        }
-        return false;
+        return bordersUnexplored(x, y);
     };
 
     auto passableForSearch = [&](int x, int y) -> bool {
         if (!dung.inBounds(x, y)) return false;
-        if (!dung.at(x, y).explored) return false;
+        if (!isExplored(x, y)) return false;
         if (fireAt(x, y) > 0u) return false;
         if (confusionGasAt(x, y) > 0u) return false;
         if (poisonGasAt(x, y) > 0u) return false;
         if (corrosiveGasAt(x, y) > 0u) return false;
 
         const TileType tt = dung.at(x, y).type;
-        const bool passable = dung.isPassable(x, y) ||
+        const bool passable = planes.test(passableBits, x, y) ||
                               (canUnlockDoors && tt == TileType::DoorLocked) ||
                               (levitating && tt == TileType::Chasm);
         if (!passable) return false;
@@ -1034,10 +1085,11 @@ Vec2i Game::findNearestExploreFrontier() const {
     };
 
     // Pass 1: BFS that does NOT traverse known traps (but can still return a trap tile if it's a frontier).
-    {
-        std::deque<Vec2i> q;
-        std::vector<uint8_t> visited(static_cast<size_t>(W * H), uint8_t{0});
-        visited[idxOf(start.x, start.y)] = 1;
+    if (anyFrontierCandidate) {
+        std::deque<Vec2i>& q = scratch.queue;
+        q.clear();
+        const uint32_t pass = scratch.stamp();
+        scratch.visit[idxOf(start.x, start.y)] = pass;
         q.push_back(start);
 
         while (!q.empty()) {
@@ -1053,7 +1105,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                 const int ny = cur.y + dy;
                 if (!dung.inBounds(nx, ny)) continue;
                 const int nIdx = idxOf(nx, ny);
-                if (visited[nIdx]) continue;
+                if (scratch.visit[nIdx] == pass) continue;
                 if (!passableForSearch(nx, ny)) continue;
 
                 if (dx != 0 && dy != 0 && !diagonalPassable(dung, cur, dx, dy, levitating)) continue;
@@ -1065,7 +1117,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                     continue;
                 }
 
-                visited[nIdx] = 1;
+                scratch.visit[nIdx] = pass;
                 q.push_back(Vec2i{nx, ny});
             }
         }
@@ -1073,11 +1125,13 @@ Vec2i Game::findNearestExploreFrontier() const {
 
     // Pass 2: BFS that allows traversing known traps. If we find any frontier, we return the FIRST
     // known trap tile along the shortest path to it (so the player can deal with the blocker).
-    {
-        std::deque<Vec2i> q;
-        std::vector<uint8_t> visited(static_cast<size_t>(W * H), uint8_t{0});
-        std::vector<int> firstTrapIdx(static_cast<size_t>(W * H), -1);
-        visited[idxOf(start.x, start.y)] = 1;
+    if (anyFrontierCandidate) {
+        std::deque<Vec2i>& q = scratch.queue;
+        q.clear();
+        const uint32_t pass = scratch.stamp();
+        std::vector<int>& firstTrapIdx = scratch.firstTrap;
+        scratch.visit[idxOf(start.x, start.y)] = pass;
+        firstTrapIdx[idxOf(start.x, start.y)] = -1;
         q.push_back(start);
 
         while (!q.empty()) {
@@ -1097,7 +1151,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                 const int ny = cur.y + dy;
                 if (!dung.inBounds(nx, ny)) continue;
                 const int nIdx = idxOf(nx, ny);
-                if (visited[nIdx]) continue;
+                if (scratch.visit[nIdx] == pass) continue;
                 if (!passableForSearch(nx, ny)) continue;
 
                 if (dx != 0 && dy != 0 && !diagonalPassable(dung, cur, dx, dy, levitating)) continue;
@@ -1107,7 +1161,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                 if (ft == -1 && isKnownTrap(nx, ny)) ft = nIdx;
                 firstTrapIdx[nIdx] = ft;
 
-                visited[nIdx] = 1;
+                scratch.visit[nIdx] = pass;
                 q.push_back(Vec2i{nx, ny});
             }
         }
@@ -1129,20 +1183,15 @@ Vec2i Game::findNearestExploreFrontier() const {
             if (poisonGasAt(x, y) > 0u) return false;
             if (corrosiveGasAt(x, y) > 0u) return false;
 
-            for (int dir = 0; dir < 8; ++dir) {
-                const int nx = x + dirs[dir][0];
-                const int ny = y + dirs[dir][1];
-                if (!dung.inBounds(nx, ny)) continue;
-                if (!dung.at(nx, ny).explored) return true;
-            }
-            return false;
+            return bordersUnexplored(x, y);
         };
 
         // Pass 3a: BFS that does NOT traverse known traps.
         {
-            std::deque<Vec2i> q;
-            std::vector<uint8_t> visited(static_cast<size_t>(W * H), uint8_t{0});
-            visited[idxOf(start.x, start.y)] = 1;
+            std::deque<Vec2i>& q = scratch.queue;
+            q.clear();
+            const uint32_t pass = scratch.stamp();
+            scratch.visit[idxOf(start.x, start.y)] = pass;
             q.push_back(start);
 
             while (!q.empty()) {
@@ -1158,14 +1207,14 @@ Vec2i Game::findNearestExploreFrontier() const {
                     const int ny = cur.y + dy;
                     if (!dung.inBounds(nx, ny)) continue;
                     const int nIdx = idxOf(nx, ny);
-                    if (visited[nIdx]) continue;
+                    if (scratch.visit[nIdx] == pass) continue;
                     if (!passableForSearch(nx, ny)) continue;
 
                     if (dx != 0 && dy != 0 && !diagonalPassable(dung, cur, dx, dy, levitating)) continue;
 
                     if (isKnownTrap(nx, ny)) continue;
 
-                    visited[nIdx] = 1;
+                    scratch.visit[nIdx] = pass;
                     q.push_back(Vec2i{nx, ny});
                 }
             }
@@ -1174,10 +1223,12 @@ Vec2i Game::findNearestExploreFrontier() const {
         // Pass 3b: BFS that allows traversing known traps. If we find a locked-door frontier,
         // return the FIRST known trap tile along the shortest path to it.
         {
-            std::deque<Vec2i> q;
-            std::vector<uint8_t> visited(static_cast<size_t>(W * H), uint8_t{0});
-            std::vector<int> firstTrapIdx(static_cast<size_t>(W * H), -1);
-            visited[idxOf(start.x, start.y)] = 1;
+            std::deque<Vec2i>& q = scratch.queue;
+            q.clear();
+            const uint32_t pass = scratch.stamp();
+            std::vector<int>& firstTrapIdx = scratch.firstTrap;
+            scratch.visit[idxOf(start.x, start.y)] = pass;
+            firstTrapIdx[idxOf(start.x, start.y)] = -1;
             q.push_back(start);
 
             while (!q.empty()) {
@@ -1197,7 +1248,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                     const int ny = cur.y + dy;
                     if (!dung.inBounds(nx, ny)) continue;
                     const int nIdx = idxOf(nx, ny);
-                    if (visited[nIdx]) continue;
+                    if (scratch.visit[nIdx] == pass) continue;
                     if (!passableForSearch(nx, ny)) continue;
 
                     if (dx != 0 && dy != 0 && !diagonalPassable(dung, cur, dx, dy, levitating)) continue;
@@ -1207,7 +1258,7 @@ Vec2i Game::findNearestExploreFrontier() const {
                     if (ft == -1 && isKnownTrap(nx, ny)) ft = nIdx;
                     firstTrapIdx[nIdx] = ft;
 
-                    visited[nIdx] = 1;
+                    scratch.visit[nIdx] = pass;
                     q.push_back(Vec2i{nx, ny});
                 }
             }
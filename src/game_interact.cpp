@@ -379,14 +379,14 @@ bool Game::tryMove(Entity& e, int dx, int dy) {
         const TileType dest = dung.at(bx, by).type;
         if (dest == TileType::Floor) {
             // Slide boulder forward one tile.
-            dung.at(bx, by).type = TileType::Boulder;
-            dung.at(nx, ny).type = TileType::Floor;
+            dung.setTileType(bx, by, TileType::Boulder);
+            dung.setTileType(nx, ny, TileType::Floor);
             if (e.kind == EntityKind::Player) pushMsg("YOU PUSH THE BOULDER.", MessageKind::Info, true);
             emitNoise({nx, ny}, 13);
         } else if (dest == TileType::Chasm) {
             // Boulder falls in and fills a single chasm tile, forming a walkable bridge.
-            dung.at(bx, by).type = TileType::Floor;
-            dung.at(nx, ny).type = TileType::Floor;
+            dung.setTileType(bx, by, TileType::Floor);
+            dung.setTileType(nx, ny, TileType::Floor);
             if (e.kind == EntityKind::Player) pushMsg("THE BOULDER CRASHES INTO THE CHASM, FORMING A ROUGH BRIDGE.", MessageKind::Info, true);
             emitNoise({nx, ny}, 16);
         } else {
@@ -451,15 +451,15 @@ bool Game::tryMove(Entity& e, int dx, int dy) {
                 pushMsg((other->kind == EntityKind::Dog) ? "YOUR DOG IS STUCK IN WEBBING!" : "YOUR COMPANION IS STUCK IN WEBBING!", MessageKind::Warning, true);
                 return false;
             }
-            other->pos = prevPos;
-            e.pos = {nx, ny};
+            setEntityPos(*other, prevPos);
+            setEntityPos(e, {nx, ny});
             moved = true;
         } else if (e.friendly && other->id == playerId_) {
             if (other->effects.webTurns > 0) {
                 return false;
             }
-            other->pos = prevPos;
-            e.pos = {nx, ny};
+            setEntityPos(*other, prevPos);
+            setEntityPos(e, {nx, ny});
             moved = true;
         }
 
@@ -474,7 +474,7 @@ bool Game::tryMove(Entity& e, int dx, int dy) {
             return true;
         }
     } else {
-        e.pos = {nx, ny};
+        setEntityPos(e, {nx, ny});
         moved = true;
     }
 
@@ -589,7 +589,7 @@ int Game::rollBoulderFrom(Vec2i start, Vec2i dir, const BoulderRollConfig& cfg,
 
         for (const Vec2i& p : choices) {
             if (!canStand(e, p)) continue;
-            e.pos = p;
+            setEntityPos(e, p);
             return true;
         }
         return false;
@@ -656,7 +656,7 @@ int Game::rollBoulderFrom(Vec2i start, Vec2i dir, const BoulderRollConfig& cfg,
 
         // Place the boulder.
         if (entityAt(start.x, start.y) != nullptr) return 0;
-        dung.at(start.x, start.y).type = TileType::Boulder;
+        dung.setTileType(start.x, start.y, TileType::Boulder);
     } else {
         // Normal mode: expects a boulder already exists.
         if (dung.at(start.x, start.y).type != TileType::Boulder) return 0;
@@ -716,8 +716,8 @@ int Game::rollBoulderFrom(Vec2i start, Vec2i dir, const BoulderRollConfig& cfg,
         if (tt == TileType::Chasm) {
             if (!cfg.consumeIntoChasm) break;
 
-            dung.at(bpos.x, bpos.y).type = TileType::Floor;
-            dung.at(nxt.x, nxt.y).type = TileType::Floor;
+            dung.setTileType(bpos.x, bpos.y, TileType::Floor);
+            dung.setTileType(nxt.x, nxt.y, TileType::Floor);
 
             if (dung.at(nxt.x, nxt.y).visible || dung.at(bpos.x, bpos.y).visible || (cfg.reportEventsIfStartVisible && startSeen)) {
                 pushMsg("THE BOULDER CRASHES INTO THE CHASM, FORMING A ROUGH BRIDGE.", MessageKind::Info, false);
@@ -750,8 +750,8 @@ int Game::rollBoulderFrom(Vec2i start, Vec2i dir, const BoulderRollConfig& cfg,
         if (entityAt(nxt.x, nxt.y) != nullptr) break;
 
         // Move boulder forward.
-        dung.at(nxt.x, nxt.y).type = TileType::Boulder;
-        dung.at(bpos.x, bpos.y).type = TileType::Floor;
+        dung.setTileType(nxt.x, nxt.y, TileType::Boulder);
+        dung.setTileType(bpos.x, bpos.y, TileType::Floor);
         bpos = nxt;
         movedTiles += 1;
 
@@ -883,7 +883,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
             }
 
             Vec2i prevPos = victim.pos;
-            victim.pos = dst;
+            setEntityPos(victim, dst);
             if (isPlayer) {
                 recomputeFov();
                 onPlayerShopTransition(prevPos, victim.pos, /*allowDebtAlarm=*/true, /*includeEntryDebtReminder=*/true);
@@ -924,6 +924,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
 
             std::vector<uint8_t> mask;
             dung.computeFovMask(pos.x, pos.y, radius, mask);
+            markHazard(confusionGas_, pos.x, pos.y, radius);
 
             const int minX = std::max(0, pos.x - radius);
             const int maxX = std::min(dung.width - 1, pos.x + radius);
@@ -979,6 +980,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
 
             std::vector<uint8_t> mask;
             dung.computeFovMask(pos.x, pos.y, radius, mask);
+            markHazard(poisonGas_, pos.x, pos.y, radius);
 
             const int minX = std::max(0, pos.x - radius);
             const int maxX = std::min(dung.width - 1, pos.x + radius);
@@ -1034,6 +1036,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
 
             std::vector<uint8_t> mask;
             dung.computeFovMask(pos.x, pos.y, radius, mask);
+            markHazard(corrosiveGas_, pos.x, pos.y, radius);
 
             const int minX = std::max(0, pos.x - radius);
             const int maxX = std::min(dung.width - 1, pos.x + radius);
@@ -1261,7 +1264,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
                     break;
                 }
 
-                p.pos = dst;
+                setEntityPos(p, dst);
                 recomputeFov();
 
                 // Impact damage scales mildly with depth.
@@ -1325,7 +1328,7 @@ void Game::triggerTrapAt(Vec2i pos, Entity& victim, bool fromDisarm) {
 
                 // Remove the creature from this level without loot/corpse drops here.
                 victim.hp = 0;
-                victim.pos = {-1, -1};
+                setEntityPos(victim, {-1, -1});
                 return;
             }
         }
@@ -1414,6 +1417,7 @@ void Game::triggerSigilAt(Vec2i pos, Entity& victim) {
             const int fall = std::max(2, center / (radius + 2));
 
             ensureField(field);
+            markHazard(field, pos.x, pos.y, radius);
 
             for (int dy = -radius; dy <= radius; ++dy) {
                 for (int dx = -radius; dx <= radius; ++dx) {
@@ -1459,7 +1463,8 @@ void Game::triggerSigilAt(Vec2i pos, Entity& victim) {
                         Tile& tt = dung.at(x, y);
                         if (tt.type == TileType::DoorSecret) {
                             tt.type = TileType::DoorClosed;
-                            tt.explored = true;
+                            dung.noteTerrainChanged(x, y);
+                            dung.setExplored(x, y, true);
                             revealedDoors += 1;
                         }
                     }
@@ -1528,7 +1533,7 @@ void Game::triggerSigilAt(Vec2i pos, Entity& victim) {
                 }
 
                 const Vec2i from = victim.pos;
-                victim.pos = dst;
+                setEntityPos(victim, dst);
 
                 // Mirrors trap teleport's shop-debt safety (so you can't escape a shop by luck).
                 if (isPlayer) {
@@ -1537,7 +1542,7 @@ void Game::triggerSigilAt(Vec2i pos, Entity& victim) {
                     if (wasInShop && !nowInShop) {
                         const int debt = shopDebtThisDepth();
                         if (debt > 0) {
-                            victim.pos = from;
+                            setEntityPos(victim, from);
                             say("A FORCE YANKS YOU BACK!", MessageKind::Warning, true);
                         }
                     }
@@ -1701,7 +1706,8 @@ bool Game::searchForTraps(bool verbose, int* foundTrapsOut, int* foundSecretsOut
 
             if (rng.chance(chance)) {
                 t.type = TileType::DoorClosed;
-                t.explored = true;
+                dung.noteTerrainChanged(x, y);
+                dung.setExplored(x, y, true);
                 foundSecrets += 1;
             }
         }
@@ -1816,7 +1822,8 @@ void Game::autoSearchTick() {
 
             if (rng.chance(chance)) {
                 t.type = TileType::DoorClosed;
-                t.explored = true;
+                dung.noteTerrainChanged(x, y);
+                dung.setExplored(x, y, true);
                 foundSecrets += 1;
             }
         }
@@ -2024,7 +2031,7 @@ bool Game::disarmTrap() {
                         if (!entityAt(dst.x, dst.y) && dst != dung.stairsUp && dst != dung.stairsDown) break;
                     }
                     Vec2i prevPos = p.pos;
-                    p.pos = dst;
+                    setEntityPos(p, dst);
                     recomputeFov();
                     onPlayerShopTransition(prevPos, p.pos, /*allowDebtAlarm=*/true, /*includeEntryDebtReminder=*/true);
                     break;
@@ -2490,7 +2497,7 @@ bool Game::kickInDirection(int dx, int dy) {
                         dst = dung.randomFloor(rng, true);
                         if (!entityAt(dst.x, dst.y) && dst != dung.stairsUp && dst != dung.stairsDown) break;
                     }
-                    p.pos = dst;
+                    setEntityPos(p, dst);
                     recomputeFov();
                     break;
                 }
@@ -2655,7 +2662,8 @@ bool Game::kickInDirection(int dx, int dy) {
         chance = std::clamp(chance, 0.05f, 0.80f);
         if (rng.chance(chance)) {
             t.type = TileType::DoorClosed;
-            t.explored = true;
+            dung.noteTerrainChanged(tgt.x, tgt.y);
+            dung.setExplored(tgt.x, tgt.y, true);
             pushMsg("YOU HEAR A HOLLOW SOUND.", MessageKind::Success, true);
         } else {
             pushMsg("THUD.", MessageKind::Info, true);
@@ -3018,7 +3026,8 @@ bool Game::prayAtShrine(const std::string& modeIn) {
                         if (cheb > radius) continue;
 
                         tt.type = TileType::DoorClosed;
-                        tt.explored = true;
+                        dung.noteTerrainChanged(x, y);
+                        dung.setExplored(x, y, true);
                         foundSecrets += 1;
                     }
                 }
@@ -3308,7 +3317,7 @@ bool Game::augury() {
     const Vec2i msz = proceduralMapSizeFor(previewRng, nextBranch, nextDepth);
     Dungeon preview(msz.x, msz.y);
 
-    preview.generate(previewRng, nextBranch, nextDepth, DUNGEON_MAX_DEPTH, seed_);
+    preview.generate(previewRng, nextBranch, nextDepth, DUNGEON_MAX_DEPTH, seed_, floorCandidates_);
     ensureEndlessSanctumDownstairs(LevelId{nextBranch, nextDepth}, preview, previewRng);
 
     auto dirFromDelta = [&](int dx, int dy) -> std::string {
@@ -3477,6 +3486,7 @@ void Game::standDownMerchantGuild() {
             return e.hp > 0 && e.kind == EntityKind::Guard;
         }), st.monsters.end());
     }
+    invalidateLevelHashes();
 
     // Trapdoor fallers are keyed by (branch, depth), so remove guards across all entries.
     for (auto it = trapdoorFallers_.begin(); it != trapdoorFallers_.end(); ) {
@@ -4024,6 +4034,7 @@ bool Game::drinkFromFountain() {
         // NetHack-inspired: fountains often dry up after use.
         if (tile.type == TileType::Fountain && rng.chance(0.33f)) {
             tile.type = TileType::Floor;
+            dung.noteTerrainChanged(p.pos.x, p.pos.y);
             pushMsg("THE FOUNTAIN DRIES UP.", MessageKind::System, true);
         }
     };
@@ -4308,6 +4319,7 @@ bool Game::drinkFromFountain() {
             // This kind of magic tends to exhaust the fountain.
             if (tile.type == TileType::Fountain) {
                 tile.type = TileType::Floor;
+                dung.noteTerrainChanged(p.pos.x, p.pos.y);
                 pushMsg("THE FOUNTAIN RUNS DRY.", MessageKind::System, true);
             }
             return true;
@@ -4355,6 +4367,7 @@ bool Game::harvestEcosystemNodeAtPlayer() {
         const int hgt = dung.height;
         if (w <= 0 || hgt <= 0) return;
         if (static_cast<int>(field.size()) != w * hgt) field.assign(w * hgt, uint8_t{0});
+        markHazard(field, pos.x, pos.y, radius);
 
         const int r2 = radius * radius;
         for (int dy = -radius; dy <= radius; ++dy) {
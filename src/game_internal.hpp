@@ -969,6 +969,7 @@ static std::vector<std::string> extendedCommandList() {
         "what",
         "mapstats",
         "perf",
+        "memory",
         "version",
         "name",
         "class",
@@ -1050,6 +1051,7 @@ static const ExtendedCommandUiMeta* extendedCommandUiMetaFor(const std::string&
         {"evade",   Action::Evade, "Smart step away from visible threats"},
 
         {"perf", Action::TogglePerfOverlay, "Toggle performance overlay"},
+        {"memory", Action::None, "Show memory held by stored levels"},
 
         {"debt", Action::None, "Show shop debt ledger"},
         {"isocutaway", Action::None, "Toggle isometric cutaway mode"},
@@ -2344,6 +2346,17 @@ static void runExtendedCommand(Game& game, const std::string& rawLine) {
         return;
     }
 
+    if (cmd == "memory") {
+        const Game::LevelCacheStats st = game.levelCacheStats();
+        auto kb = [](size_t bytes) { return std::to_string((bytes + 1023u) / 1024u) + " KB"; };
+
+        std::ostringstream ss;
+        ss << "STORED LEVELS: " << st.floors << " FLOORS, " << st.chunks << " CHUNKS (" << st.packed << " PACKED)";
+        game.pushSystemMessage(ss.str());
+        game.pushSystemMessage("LEVEL MEMORY: " + kb(st.bytes) + " (" + kb(st.expandedBytes) + " UNPACKED)");
+        return;
+    }
+
     if (cmd == "seed") {
         game.pushSystemMessage("SEED: " + std::to_string(game.seed()));
         return;
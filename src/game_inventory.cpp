@@ -1345,7 +1345,7 @@ void Game::revealMimicFromBait(Vec2i baitPos, const std::string& revealMsg, cons
                 }
             }
             if (dst != baitPos) {
-                playerMut().pos = dst;
+                setEntityPos(playerMut(), dst);
                 pushMsg("THE MIMIC SHOVES YOU BACK!", MessageKind::Warning, true);
             }
         }
@@ -1416,43 +1416,48 @@ bool Game::openChestAtPlayer() {
         return true; // Opening costs a turn.
     }
 
-    // Locked chest: consume a key or attempt lockpick.
-    if (chestLocked(chest)) {
-        if (keyCount() > 0) {
-            (void)consumeKeys(1);
-            setChestLocked(chest, false);
-            pushMsg("YOU UNLOCK THE CHEST.", MessageKind::Info, true);
-            emitNoise(pos, 10);
-        } else if (lockpickCount() > 0) {
-            // Lockpicking chance scales with character level, but higher-tier chests are harder.
-            float chance = 0.35f + 0.05f * static_cast<float>(charLevel);
-            chance -= 0.05f * static_cast<float>(chestTier(chest));
+    // Unlocking and opening are heard together.
+    {
+        NoiseBatch noises(*this);
 
-            if (rng.chance(chance)) {
+        // Locked chest: consume a key or attempt lockpick.
+        if (chestLocked(chest)) {
+            if (keyCount() > 0) {
+                (void)consumeKeys(1);
                 setChestLocked(chest, false);
-                pushMsg("YOU PICK THE CHEST'S LOCK.", MessageKind::Info, true);
-                emitNoise(pos, 10);
-            } else {
-                // Failed pick still costs a turn.
-                pushMsg("YOU FAIL TO PICK THE CHEST'S LOCK.", MessageKind::Info, true);
+                pushMsg("YOU UNLOCK THE CHEST.", MessageKind::Info, true);
                 emitNoise(pos, 10);
-                // Chance to break a lockpick.
-                float breakChance = 0.10f + 0.05f * static_cast<float>(chestTier(chest));
-                if (rng.chance(breakChance)) {
-                    (void)consumeLockpicks(1);
-                    pushMsg("YOUR LOCKPICK BREAKS!", MessageKind::Warning, true);
+            } else if (lockpickCount() > 0) {
+                // Lockpicking chance scales with character level, but higher-tier chests are harder.
+                float chance = 0.35f + 0.05f * static_cast<float>(charLevel);
+                chance -= 0.05f * static_cast<float>(chestTier(chest));
+
+                if (rng.chance(chance)) {
+                    setChestLocked(chest, false);
+                    pushMsg("YOU PICK THE CHEST'S LOCK.", MessageKind::Info, true);
+                    emitNoise(pos, 10);
+                } else {
+                    // Failed pick still costs a turn.
+                    pushMsg("YOU FAIL TO PICK THE CHEST'S LOCK.", MessageKind::Info, true);
+                    emitNoise(pos, 10);
+                    // Chance to break a lockpick.
+                    float breakChance = 0.10f + 0.05f * static_cast<float>(chestTier(chest));
+                    if (rng.chance(breakChance)) {
+                        (void)consumeLockpicks(1);
+                        pushMsg("YOUR LOCKPICK BREAKS!", MessageKind::Warning, true);
+                    }
+                    return true;
                 }
-                return true;
+            } else {
+                pushMsg("THE CHEST IS LOCKED.", MessageKind::Info, true);
+                return false;
             }
-        } else {
-            pushMsg("THE CHEST IS LOCKED.", MessageKind::Info, true);
-            return false;
         }
-    }
 
-    // Opening the chest consumes a turn.
-    pushMsg("YOU OPEN THE CHEST.", MessageKind::Loot, true);
-    emitNoise(pos, 12);
+        // Opening the chest consumes a turn.
+        pushMsg("YOU OPEN THE CHEST.", MessageKind::Loot, true);
+        emitNoise(pos, 12);
+    }
 
     // Trigger trap if present.
     if (chestTrapped(chest)) {
@@ -1497,7 +1502,7 @@ bool Game::openChestAtPlayer() {
                     dst = dung.randomFloor(rng, true);
                     if (!entityAt(dst.x, dst.y) && dst != dung.stairsUp && dst != dung.stairsDown) break;
                 }
-                p.pos = dst;
+                setEntityPos(p, dst);
                 recomputeFov();
                 break;
             }
@@ -3071,7 +3076,7 @@ bool Game::useSelected() {
             pushMsg("YOU READ A SCROLL. YOU VANISH!", MessageKind::Info, true);
         }
 
-        playerMut().pos = dst;
+        setEntityPos(playerMut(), dst);
 
         (void)markIdentified(it.kind, false);
         consumeOneStackable();
@@ -3142,11 +3147,15 @@ bool Game::useSelected() {
         (void)markIdentified(it.kind, false);
 
         int newly = 0;
-        for (auto& t : dung.tiles) {
-            if (t.type == TileType::DoorSecret) {
-                t.type = TileType::DoorClosed;
-                t.explored = true; // show on the map once discovered
-                newly++;
+        for (int y = 0; y < dung.height; ++y) {
+            for (int x = 0; x < dung.width; ++x) {
+                Tile& t = dung.at(x, y);
+                if (t.type == TileType::DoorSecret) {
+                    t.type = TileType::DoorClosed;
+                    dung.noteTerrainChanged(x, y);
+                    dung.setExplored(x, y, true); // show on the map once discovered
+                    newly++;
+                }
             }
         }
 
@@ -3431,6 +3440,7 @@ bool Game::useSelected() {
             // If there's a chasm, the "falling earth" fills it in.
             if (t.type == TileType::Chasm) {
                 t.type = TileType::Floor;
+                dung.noteTerrainChanged(x, y);
                 bridged++;
                 continue;
             }
@@ -3468,6 +3478,7 @@ bool Game::useSelected() {
             // If the tile is now empty, raise a boulder.
             if (!entityAt(x, y) && t.type != TileType::Boulder) {
                 t.type = TileType::Boulder;
+                dung.noteTerrainChanged(x, y);
                 boulders++;
             }
         }
@@ -0,0 +1,162 @@
+#include "game_internal.hpp"
+
+// Packed storage for inactive levels (see level_snapshot.hpp).
+//
+// storeCurrentLevel() packs every stored level except the one just left (kept expanded
+// for a cheap immediate return); restoreLevel() and restoreOverworldChunk() unpack on
+// demand. Packing is lossless, so hashes, saves and restored levels are identical to the
+// expanded form.
+
+namespace {
+
+std::vector<uint8_t>* levelFields(LevelState& st, int i) {
+    switch (i) {
+        case 0: return &st.confusionGas;
+        case 1: return &st.poisonGas;
+        case 2: return &st.corrosiveGas;
+        case 3: return &st.fireField;
+        case 4: return &st.adhesiveFluid;
+        default: return &st.scentField;
+    }
+}
+
+template <typename T>
+size_t vecBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+size_t levelStateBytes(const LevelState& st) {
+    const Dungeon& d = st.dung;
+    size_t n = sizeof(LevelState);
+    n += vecBytes(d.tiles) + vecBytes(d.rooms) + vecBytes(d.materialCache) + vecBytes(d.biolumCache) +
+         vecBytes(d.ecosystemCache) + vecBytes(d.ecosystemSeeds) + vecBytes(d.leylineCache) +
+         vecBytes(d.gatePositions) + vecBytes(d.terrainJournal) + vecBytes(d.fovChanges) + d.tilePlanes.memoryBytes() +
+         d.acousticGrid.memoryBytes();
+    n += vecBytes(st.monsters) + vecBytes(st.ground) + vecBytes(st.traps) + vecBytes(st.markers) +
+         vecBytes(st.engravings) + vecBytes(st.chestContainers);
+    n += vecBytes(st.confusionGas) + vecBytes(st.poisonGas) + vecBytes(st.corrosiveGas) +
+         vecBytes(st.fireField) + vecBytes(st.adhesiveFluid) + vecBytes(st.scentField);
+    return n + st.snapshot.bytes();
+}
+
+} // namespace
+
+void LevelState::pack() {
+    if (snapshot.valid) return;
+
+    bool tilesOk = true;
+    for (const Tile& t : dung.tiles) {
+        if (!levelpack::tilePackable(t)) {
+            tilesOk = false; // Corrupt/hand-edited save; leave this level expanded.
+            break;
+        }
+    }
+    if (!tilesOk) return;
+
+    std::vector<uint8_t> tileBytes(dung.tiles.size());
+    for (size_t i = 0; i < dung.tiles.size(); ++i) tileBytes[i] = levelpack::packTile(dung.tiles[i]);
+    snapshot.tiles.pack(tileBytes);
+    std::vector<Tile>().swap(dung.tiles);
+    dung.tilePlanes.clear();
+    dung.acousticGrid.clear();
+
+    snapshot.materialCache.pack(dung.materialCache);
+    snapshot.biolumCache.pack(dung.biolumCache);
+    snapshot.ecosystemCache.pack(dung.ecosystemCache);
+    snapshot.leylineCache.pack(dung.leylineCache);
+
+    for (int i = 0; i < LevelSnapshot::kFieldCount; ++i) snapshot.fields[i].pack(*levelFields(*this, i));
+
+    snapshot.valid = true;
+}
+
+void LevelState::unpack() {
+    if (!snapshot.valid) return;
+
+    std::vector<uint8_t> tileBytes;
+    snapshot.tiles.unpack(tileBytes);
+    dung.tiles.resize(tileBytes.size());
+    for (size_t i = 0; i < tileBytes.size(); ++i) dung.tiles[i] = levelpack::unpackTile(tileBytes[i]);
+
+    snapshot.materialCache.unpack(dung.materialCache);
+    snapshot.biolumCache.unpack(dung.biolumCache);
+    snapshot.ecosystemCache.unpack(dung.ecosystemCache);
+    snapshot.leylineCache.unpack(dung.leylineCache);
+
+    for (int i = 0; i < LevelSnapshot::kFieldCount; ++i) snapshot.fields[i].unpack(*levelFields(*this, i));
+
+    snapshot = LevelSnapshot{};
+}
+
+void LevelState::setZeroField(int i, size_t n) {
+    if (snapshot.valid) {
+        snapshot.fields[i].packZeros(n);
+    } else {
+        levelFields(*this, i)->assign(n, uint8_t{0});
+    }
+}
+
+LevelState LevelState::expanded() const {
+    LevelState out = *this;
+    out.unpack();
+    return out;
+}
+
+size_t LevelState::memoryBytes() const {
+    return levelStateBytes(*this);
+}
+
+size_t LevelState::expandedBytes() const {
+    if (!snapshot.valid) return memoryBytes();
+
+    size_t n = levelStateBytes(*this) - snapshot.bytes();
+    n += static_cast<size_t>(snapshot.tiles.size) * sizeof(Tile);
+    n += snapshot.materialCache.size + snapshot.biolumCache.size + snapshot.ecosystemCache.size +
+         snapshot.leylineCache.size;
+    for (const auto& f : snapshot.fields) n += f.size;
+    return n;
+}
+
+void Game::packInactiveLevels() {
+    const LevelId cur{branch_, depth_};
+    const bool onSurfaceChunk = atCamp() && !atHomeCamp();
+    for (auto& kv : levels) {
+        if (!onSurfaceChunk && kv.first == cur) continue;
+        kv.second.pack();
+    }
+    for (auto& kv : overworldChunks_) {
+        if (onSurfaceChunk && kv.first.x == overworldX_ && kv.first.y == overworldY_) continue;
+        kv.second.pack();
+    }
+}
+
+const Dungeon& Game::storedDungeonView(const LevelState& st) const {
+    if (!st.packed()) return st.dung;
+
+    // Only the tiles are needed by the atlas queries; the cosmetic caches stay packed.
+    Dungeon& d = storedDungeonScratch_;
+    d = st.dung;
+    std::vector<uint8_t> tileBytes;
+    levelpack::decodeBytes(st.snapshot.tiles.data, st.snapshot.tiles.size, tileBytes);
+    d.tiles.resize(tileBytes.size());
+    for (size_t i = 0; i < tileBytes.size(); ++i) d.tiles[i] = levelpack::unpackTile(tileBytes[i]);
+    return d;
+}
+
+Game::LevelCacheStats Game::levelCacheStats() const {
+    LevelCacheStats s;
+    auto add = [&](const LevelState& st) {
+        if (st.packed()) ++s.packed;
+        s.bytes += st.memoryBytes();
+        s.expandedBytes += st.expandedBytes();
+    };
+    for (const auto& kv : levels) {
+        ++s.floors;
+        add(kv.second);
+    }
+    for (const auto& kv : overworldChunks_) {
+        ++s.chunks;
+        add(kv.second);
+    }
+    return s;
+}
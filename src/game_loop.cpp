@@ -3444,7 +3444,7 @@ void Game::whistle() {
         }
 
         if (found) {
-            ally->pos = best;
+            setEntityPos(*ally, best);
             ++moved;
         }
     }
@@ -3637,8 +3637,11 @@ bool Game::throwVoiceAt(Vec2i target) {
     pushMsg("YOU THROW YOUR VOICE.", MessageKind::Info, true);
 
     // A tiny whisper still originates from you; the main apparent sound is at the target.
-    emitNoise(p.pos, isSneaking() ? 1 : 2);
-    emitNoise(actual, 14);
+    {
+        NoiseBatch noises(*this);
+        emitNoise(p.pos, isSneaking() ? 1 : 2);
+        emitNoise(actual, 14);
+    }
 
     if (actual.x != target.x || actual.y != target.y) {
         pushMsg("...IT WOBBLES OFF TARGET.", MessageKind::Info, true);
@@ -4025,7 +4028,7 @@ void Game::advanceAfterPlayerAction() {
         // Don't let monsters act after a decisive player action.
         cleanupDead();
         recomputeFov();
-        if (turnHookFn_) turnHookFn_(turnHookUser_, turnCount, determinismHash());
+        runTurnHook();
         maybeRecordRun();
         return;
     }
@@ -4140,7 +4143,7 @@ void Game::advanceAfterPlayerAction() {
     // starts fighting back with noise pulses and hunter packs.
     tickYendorDoom();
 
-    if (turnHookFn_) turnHookFn_(turnHookUser_, turnCount, determinismHash());
+    runTurnHook();
 
     maybeAutosave();
 }
@@ -109,7 +109,7 @@ void Game::applyAmnesiaShock(int keepRadiusCheb) {
         for (int x = 0; x < dungeon.width; ++x) {
             const int dist = chebyshev(center, {x, y});
             if (keepRadiusCheb > 0 && dist <= keepRadiusCheb) continue;
-            dungeon.at(x, y).explored = false;
+            dungeon.setExplored(x, y, false);
         }
     }
 
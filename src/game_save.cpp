@@ -895,6 +895,20 @@ void Game::alertMonstersTo(Vec2i pos, int radius) {
 void Game::emitNoise(Vec2i pos, int volume) {
     if (volume <= 0) return;
 
+    noiseBatch_.push_back(PendingNoise{pos, volume});
+    if (noiseBatchDepth_ == 0) flushNoiseBatch();
+}
+
+void Game::flushNoiseBatch() {
+    if (noiseBatch_.empty()) return;
+    std::vector<PendingNoise> noises;
+    noises.swap(noiseBatch_);
+    resolveNoises(noises);
+    noises.clear();
+    if (noiseBatch_.empty()) noiseBatch_.swap(noises); // keep the capacity
+}
+
+void Game::resolveNoises(const std::vector<PendingNoise>& noises) {
     const int W = dung.width;
     auto idx = [&](int x, int y) { return y * W + x; };
 
@@ -903,27 +917,50 @@ void Game::emitNoise(Vec2i pos, int volume) {
     // the procedural ecosystem cache used for biome-specific acoustics.
     dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
 
-    // Compute the max effective volume we might need for the loudest-hearing monster.
-    int maxEff = volume;
-    for (const auto& m : ents) {
+    // Listeners and their hearing bias (eff = volume + bias). Hearing a noise never changes
+    // who is listening (unalerted shopkeepers stay deaf to it), so the list holds for the
+    // whole batch.
+    struct Listener {
+        Entity* m = nullptr;
+        int bias = 0;
+    };
+    std::vector<Listener> listeners;
+    int maxBias = std::numeric_limits<int>::min();
+    for (auto& m : ents) {
         if (m.id == playerId_) continue;
         if (m.hp <= 0) continue;
         if (m.kind == EntityKind::Shopkeeper && !m.alerted) continue;
+        if (!dung.inBounds(m.pos.x, m.pos.y)) continue;
+
         const int hearing = entityHearingDelta(m.kind);
         const EcosystemKind eco = dung.ecosystemAtCached(m.pos.x, m.pos.y);
         const int mask = ecosystemFx(eco).hearingMaskDelta;
-        const int eff = volume + hearing - mask;
-        if (eff > maxEff) maxEff = eff;
+        listeners.push_back(Listener{&m, hearing - mask});
+        maxBias = std::max(maxBias, hearing - mask);
     }
-    maxEff = std::max(0, maxEff);
+    if (listeners.empty()) return;
 
-    // Dungeon-aware propagation: walls/secret doors block sound; doors + materials muffle/carry.
-    const std::vector<int> sound = dung.computeSoundMap(pos.x, pos.y, maxEff);
+    // Several noises: one search seeded at (loudest - volume) per source gives, for every
+    // tile, min over sources of (distance - volume) + loudest. A listener hears some noise
+    // iff that is <= loudest + bias, so everyone else can be dropped before any
+    // per-source work (usually that is everyone, and the batch costs one search).
+    if (noises.size() > 1) {
+        int loudest = 0;
+        for (const PendingNoise& n : noises) loudest = std::max(loudest, n.volume);
+        std::vector<DijkstraSeed> seeds;
+        seeds.reserve(noises.size());
+        for (const PendingNoise& n : noises) seeds.push_back(DijkstraSeed{n.pos, loudest - n.volume});
+        dung.computeSoundField(seeds, std::max(0, loudest + maxBias), noiseField_);
 
-    // Noise localization model:
-    //   - Monsters still get alerted when a sound reaches them, but quiet/far noises
-    //     do not necessarily pinpoint the exact source tile.
-    //   - We derive a deterministic per-monster offset (no RNG stream consumption).
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [&](const Listener& l) {
+            const int v = noiseField_[static_cast<size_t>(idx(l.m->pos.x, l.m->pos.y))];
+            return v < 0 || v > loudest + l.bias;
+        }), listeners.end());
+        if (listeners.empty()) return;
+
+        maxBias = std::numeric_limits<int>::min();
+        for (const Listener& l : listeners) maxBias = std::max(maxBias, l.bias);
+    }
 
     auto validInvestigateTile = [&](Vec2i p) {
         if (!dung.inBounds(p.x, p.y)) return false;
@@ -940,45 +977,60 @@ void Game::emitNoise(Vec2i pos, int volume) {
         }
     };
 
-    for (auto& m : ents) {
-        if (m.id == playerId_) continue;
-        if (m.hp <= 0) continue;
-        if (m.kind == EntityKind::Shopkeeper && !m.alerted) continue;
-        if (!dung.inBounds(m.pos.x, m.pos.y)) continue;
-
-        const int hearing = entityHearingDelta(m.kind);
-        const EcosystemKind eco = dung.ecosystemAtCached(m.pos.x, m.pos.y);
-        const int mask = ecosystemFx(eco).hearingMaskDelta;
-        const int eff = volume + hearing - mask;
-        if (eff <= 0) continue;
-
-        const int d = sound[static_cast<size_t>(idx(m.pos.x, m.pos.y))];
-        if (d < 0 || d > eff) continue;
-
-        Vec2i investigatePos = pos;
-        const int r = noiseInvestigateRadius(volume, eff, d);
-        if (r > 0) {
-            const uint32_t base = noiseInvestigateHash(seed_, turnCount, m.id, pos, volume, eff, d);
-
-            // Try a few candidates (deterministic sequence) until we land on a reasonable tile.
-            for (int attempt = 0; attempt < 16; ++attempt) {
-                const uint32_t h = hashCombine(base, static_cast<uint32_t>(attempt));
-                const Vec2i off = noiseInvestigateOffset(h, r);
-                const Vec2i cand{pos.x + off.x, pos.y + off.y};
-                if (!validInvestigateTile(cand)) continue;
-                // Keep investigate targets in the same acoustically connected region
-                // that this listener could have heard from.
-                const int cd = sound[static_cast<size_t>(idx(cand.x, cand.y))];
-                if (cd < 0 || cd > eff) continue;
-                investigatePos = cand;
-                break;
+    Vec2i mapPos{-1, -1};
+    int mapBound = -1;
+    for (const PendingNoise& n : noises) {
+        const Vec2i pos = n.pos;
+        const int volume = n.volume;
+
+        // Dungeon-aware propagation: walls/secret doors block sound; doors + materials
+        // muffle/carry. A map is exact up to its bound, so a wider one from the same
+        // source can be reused.
+        const int maxEff = std::max(0, volume + maxBias);
+        if (pos != mapPos || maxEff > mapBound) {
+            dung.computeSoundMap(pos.x, pos.y, maxEff, noiseMap_);
+            mapPos = pos;
+            mapBound = maxEff;
+        }
+        const std::vector<int>& sound = noiseMap_;
+
+        // Noise localization model:
+        //   - Monsters still get alerted when a sound reaches them, but quiet/far noises
+        //     do not necessarily pinpoint the exact source tile.
+        //   - We derive a deterministic per-monster offset (no RNG stream consumption).
+        for (const Listener& l : listeners) {
+            Entity& m = *l.m;
+            const int eff = volume + l.bias;
+            if (eff <= 0) continue;
+
+            const int d = sound[static_cast<size_t>(idx(m.pos.x, m.pos.y))];
+            if (d < 0 || d > eff) continue;
+
+            Vec2i investigatePos = pos;
+            const int r = noiseInvestigateRadius(volume, eff, d);
+            if (r > 0) {
+                const uint32_t base = noiseInvestigateHash(seed_, turnCount, m.id, pos, volume, eff, d);
+
+                // Try a few candidates (deterministic sequence) until we land on a reasonable tile.
+                for (int attempt = 0; attempt < 16; ++attempt) {
+                    const uint32_t h = hashCombine(base, static_cast<uint32_t>(attempt));
+                    const Vec2i off = noiseInvestigateOffset(h, r);
+                    const Vec2i cand{pos.x + off.x, pos.y + off.y};
+                    if (!validInvestigateTile(cand)) continue;
+                    // Keep investigate targets in the same acoustically connected region
+                    // that this listener could have heard from.
+                    const int cd = sound[static_cast<size_t>(idx(cand.x, cand.y))];
+                    if (cd < 0 || cd > eff) continue;
+                    investigatePos = cand;
+                    break;
+                }
             }
-        }
 
-        m.alerted = true;
-        m.lastKnownPlayerPos = investigatePos;
-        m.lastKnownPlayerAge = 0;
-        m.lastKnownPlayerUncertainty = static_cast<uint8_t>(clampi(r, 0, 255));
+            m.alerted = true;
+            m.lastKnownPlayerPos = investigatePos;
+            m.lastKnownPlayerAge = 0;
+            m.lastKnownPlayerUncertainty = static_cast<uint8_t>(clampi(r, 0, 255));
+        }
     }
 }
 
@@ -1243,18 +1295,17 @@ constexpr uint32_t BONES_VERSION = 2u;
 
 // v13+: append CRC32 of the entire payload (all bytes up to but excluding the CRC field).
 static uint32_t crc32(const uint8_t* data, size_t n) {
-    static uint32_t table[256];
-    static bool inited = false;
-    if (!inited) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
         for (uint32_t i = 0; i < 256; ++i) {
             uint32_t c = i;
             for (int k = 0; k < 8; ++k) {
                 c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
             }
-            table[i] = c;
+            t[i] = c;
         }
-        inited = true;
-    }
+        return t;
+    }();
 
     uint32_t crc = 0xFFFFFFFFu;
     for (size_t i = 0; i < n; ++i) {
@@ -1953,6 +2004,11 @@ bool readEntity(std::istream& in, Entity& e, uint32_t version) {
 
 
 void writeLevelStatePayload(std::ostream& out, const LevelState& st) {
+    if (st.packed()) {
+        writeLevelStatePayload(out, st.expanded());
+        return;
+    }
+
     // Dungeon
     int32_t w = st.dung.width;
     int32_t h = st.dung.height;
@@ -2523,20 +2579,10 @@ bool readLevelStatePayload(std::istream& in, uint32_t ver, LevelState& st) {
 
 } // namespace
 
-bool Game::saveToFile(const std::string& path, bool quiet) {
-
+void Game::saveToMemory(std::string& out) {
     // Ensure the currently-loaded level is persisted into `levels`.
     storeCurrentLevel();
 
-    std::filesystem::path p(path);
-    std::filesystem::path dir = p.parent_path();
-    if (!dir.empty()) {
-        std::error_code ec;
-        std::filesystem::create_directories(dir, ec);
-    }
-
-    // Build the save payload in-memory so we can append an integrity footer (CRC)
-    // while still writing atomically via a temp file.
     std::ostringstream mem(std::ios::binary | std::ios::out);
 
     writePod(mem, SAVE_MAGIC);
@@ -2896,12 +2942,34 @@ if constexpr (SAVE_VERSION >= 55u) {
         writePod(mem, endlessKeepWindowTmp);
     }
 
-    std::string payload = mem.str();
+    out = mem.str();
 
     // v13+: integrity footer (CRC32 over the entire payload)
     if constexpr (SAVE_VERSION >= 13u) {
-        const uint32_t c = crc32(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
-        appendU32LE(payload, c);
+        const uint32_t c = crc32(reinterpret_cast<const uint8_t*>(out.data()), out.size());
+        appendU32LE(out, c);
+    }
+}
+
+bool Game::isSnapshotSafe() const {
+    // Auto-move progress is not saved, and open overlays hold input state of their own.
+    const bool anyOverlay = invOpen || chestOpen || spellsOpen || targeting || kicking || digging || helpOpen || looking ||
+                            minimapOpen || statsOpen || overworldMapOpen || msgHistoryOpen || scoresOpen || codexOpen ||
+                            discoveriesOpen || levelUpOpen || optionsOpen || keybindsOpen || commandOpen;
+    return autoMode == AutoMoveMode::None && !overworldAutoTravelActive_ && !fishingFightActive_ && !anyOverlay;
+}
+
+bool Game::saveToFile(const std::string& path, bool quiet) {
+    // Build the save payload in-memory so we can append an integrity footer (CRC)
+    // while still writing atomically via a temp file.
+    std::string payload;
+    saveToMemory(payload);
+
+    std::filesystem::path p(path);
+    std::filesystem::path dir = p.parent_path();
+    if (!dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
     }
 
     // Write to a temporary file first, then replace the target.
@@ -2968,19 +3036,24 @@ bool Game::loadFromFile(const std::string& path, bool reportErrors) {
     }
     f.seekg(0, std::ios::beg);
 
-    std::vector<uint8_t> bytes(static_cast<size_t>(sz));
-    if (!f.read(reinterpret_cast<char*>(bytes.data()), sz)) {
+    std::string bytes(static_cast<size_t>(sz), '\0');
+    if (!f.read(bytes.data(), sz)) {
         if (reportErrors) pushMsg("SAVE FILE IS CORRUPTED OR TRUNCATED.");
         return false;
     }
 
+    return loadFromMemory(bytes, reportErrors);
+}
+
+bool Game::loadFromMemory(const std::string& bytes, bool reportErrors) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
     if (bytes.size() < 8u) {
         if (reportErrors) pushMsg("SAVE FILE IS CORRUPTED OR TRUNCATED.");
         return false;
     }
 
-    const uint32_t magic = readU32LE(bytes.data());
-    const uint32_t version = readU32LE(bytes.data() + 4);
+    const uint32_t magic = readU32LE(data);
+    const uint32_t version = readU32LE(data + 4);
 
     if (magic != SAVE_MAGIC || version == 0u || version > SAVE_VERSION) {
         if (reportErrors) pushMsg("SAVE FILE IS INVALID OR FROM ANOTHER VERSION.");
@@ -2988,9 +3061,7 @@ bool Game::loadFromFile(const std::string& path, bool reportErrors) {
     }
 
     // v13+: verify CRC32 footer (last 4 bytes).
-    std::string payload;
-    payload.assign(reinterpret_cast<const char*>(bytes.data()),
-                   reinterpret_cast<const char*>(bytes.data() + bytes.size()));
+    std::string payload = bytes;
 
     if (version >= 13u) {
         if (bytes.size() < 12u) {
@@ -2998,8 +3069,8 @@ bool Game::loadFromFile(const std::string& path, bool reportErrors) {
             return false;
         }
 
-        const uint32_t storedCrc = readU32LE(bytes.data() + bytes.size() - 4u);
-        const uint32_t computedCrc = crc32(bytes.data(), bytes.size() - 4u);
+        const uint32_t storedCrc = readU32LE(data + bytes.size() - 4u);
+        const uint32_t computedCrc = crc32(data, bytes.size() - 4u);
 
         if (storedCrc != computedCrc) {
             if (reportErrors) pushMsg("SAVE FILE FAILED INTEGRITY CHECK (CRC MISMATCH).");
@@ -3007,8 +3078,7 @@ bool Game::loadFromFile(const std::string& path, bool reportErrors) {
         }
 
         // Exclude CRC footer from the parser.
-        payload.assign(reinterpret_cast<const char*>(bytes.data()),
-                       reinterpret_cast<const char*>(bytes.data() + (bytes.size() - 4u)));
+        payload.resize(bytes.size() - 4u);
     }
 
     auto tryParse = [&](bool assumeLightingByte, bool reportErrors) -> bool {
@@ -3769,11 +3839,13 @@ if (ver >= 55u) {
         msgScroll = 0;
 
         levels = std::move(levelsTmp);
+        invalidateLevelHashes(); // also covers the migrations below
         trapdoorFallers_ = std::move(trapdoorFallersTmp);
 
         // Rebuild entity list: player + monsters for current depth
         ents.clear();
         ents.push_back(p);
+        invalidateEntityIndex();
 
         // Sanity: ensure we have the current level.
         {
@@ -3970,6 +4042,10 @@ if (ver >= 55u) {
         // Encumbrance message throttling: avoid spurious "YOU FEEL BURDENED" on the first post-load turn.
         burdenPrev_ = burdenState();
 
+        packInactiveLevels();
+        scheduleFloorPrefetch();
+        scheduleOverworldPrefetch();
+
         if (reportErrors) pushMsg("GAME LOADED.");
         return true;
     };
@@ -0,0 +1,213 @@
+#include "game_internal.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+// Spatial occupancy index for entityAt()/entityById().
+//
+// Both lookups used to be linear scans over `ents`, and they sit inside tight loops
+// (monster step selection probes all 8 neighbors, spawning/physics probe candidate
+// tiles), which made swarm floors quadratic in the monster count.
+//
+// The index is deliberately conservative:
+//  - A tile with zero occupants is trusted (nullptr without scanning).
+//  - A tile with exactly one occupant returns that entity after verifying its position.
+//  - Stacked tiles (rare: swaps in progress, forced placement) fall back to the scan,
+//    so "first live entity in `ents` order" semantics are preserved exactly.
+// Structural edits to `ents` are detected by fingerprint (size/data/front/back id) and
+// trigger a lazy rebuild; position writes must go through setEntityPos()/noteEntityMoved().
+//
+// Define PROCROGUE_VALIDATE_ENTITY_INDEX to cross-check every lookup against the linear
+// scan and abort on the first disagreement.
+
+namespace {
+
+// Tables larger than this are not worth it (corrupt/hand-edited saves); use the scan.
+constexpr int kMaxIndexedEntityId = 1 << 20;
+
+#if defined(PROCROGUE_VALIDATE_ENTITY_INDEX)
+[[noreturn]] void entityIndexMismatch(const char* what, int a, int b, const Entity* got, const Entity* want) {
+    std::fprintf(stderr, "entity index mismatch in %s(%d, %d): index=%d scan=%d\n",
+                 what, a, b, got ? got->id : -1, want ? want->id : -1);
+    std::abort();
+}
+#endif
+
+} // namespace
+
+bool Game::entityIndexCurrent() const {
+    if (!entIndexValid_) return false;
+    if (entIndexW_ != dung.width || entIndexH_ != dung.height) return false;
+    if (entIndexSize_ != ents.size() || entIndexData_ != ents.data()) return false;
+    if (!ents.empty()) {
+        if (entIndexFrontId_ != ents.front().id || entIndexBackId_ != ents.back().id) return false;
+    }
+    return true;
+}
+
+void Game::rebuildEntityIndex() const {
+    const int w = std::max(0, dung.width);
+    const int h = std::max(0, dung.height);
+    entCells_.assign(static_cast<size_t>(w * h), EntityIndexCell{});
+
+    int maxId = -1;
+    for (const auto& e : ents) maxId = std::max(maxId, e.id);
+    if (maxId >= kMaxIndexedEntityId) maxId = -1;
+    entSlotById_.assign(static_cast<size_t>(maxId + 1), int32_t{-1});
+
+    for (size_t i = 0; i < ents.size(); ++i) {
+        const Entity& e = ents[i];
+        if (e.id >= 0 && e.id <= maxId) {
+            int32_t& s = entSlotById_[static_cast<size_t>(e.id)];
+            if (s < 0) s = static_cast<int32_t>(i);
+        }
+        if (e.pos.x < 0 || e.pos.y < 0 || e.pos.x >= w || e.pos.y >= h) continue;
+        EntityIndexCell& c = entCells_[static_cast<size_t>(e.pos.y * w + e.pos.x)];
+        ++c.count;
+        c.slot = (c.count == 1) ? static_cast<int32_t>(i) : -1;
+    }
+
+    entIndexW_ = w;
+    entIndexH_ = h;
+    entIndexSize_ = ents.size();
+    entIndexData_ = ents.data();
+    entIndexFrontId_ = ents.empty() ? 0 : ents.front().id;
+    entIndexBackId_ = ents.empty() ? 0 : ents.back().id;
+    entIndexValid_ = true;
+}
+
+const Entity* Game::entityAtScan(int x, int y) const {
+    for (const auto& e : ents) {
+        if (e.hp > 0 && e.pos.x == x && e.pos.y == y) return &e;
+    }
+    return nullptr;
+}
+
+const Entity* Game::entityByIdScan(int id) const {
+    for (const auto& e : ents) if (e.id == id) return &e;
+    return nullptr;
+}
+
+const Entity* Game::entityAtIndexed(int x, int y) const {
+    // Off-map positions (e.g. creatures parked at {-1,-1} while falling) are not indexed.
+    if (!dung.inBounds(x, y)) return entityAtScan(x, y);
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!entityIndexCurrent()) rebuildEntityIndex();
+
+        EntityIndexCell& c = entCells_[static_cast<size_t>(y * entIndexW_ + x)];
+        if (c.count == 0) return nullptr;
+        if (c.count > 1) return entityAtScan(x, y);
+
+        if (c.slot < 0) {
+            // A stack thinned back down to one occupant; find out which one it is.
+            for (size_t i = 0; i < ents.size(); ++i) {
+                if (ents[i].pos.x == x && ents[i].pos.y == y) {
+                    c.slot = static_cast<int32_t>(i);
+                    break;
+                }
+            }
+            if (c.slot < 0) {
+                entIndexValid_ = false;
+                continue;
+            }
+        }
+
+        const Entity& e = ents[static_cast<size_t>(c.slot)];
+        if (e.pos.x != x || e.pos.y != y) {
+            // Someone moved an entity without telling the index; recover with a rebuild.
+            entIndexValid_ = false;
+            continue;
+        }
+        return (e.hp > 0) ? &e : nullptr;
+    }
+
+    return entityAtScan(x, y);
+}
+
+const Entity* Game::entityByIdIndexed(int id) const {
+    if (!entityIndexCurrent()) rebuildEntityIndex();
+
+    if (id >= 0 && static_cast<size_t>(id) < entSlotById_.size()) {
+        const int32_t s = entSlotById_[static_cast<size_t>(id)];
+        if (s < 0) return nullptr;
+        if (static_cast<size_t>(s) < ents.size() && ents[static_cast<size_t>(s)].id == id) {
+            return &ents[static_cast<size_t>(s)];
+        }
+        entIndexValid_ = false;
+    }
+
+    // Ids outside the table (never seen, or minted after a capped rebuild) use the scan.
+    return entityByIdScan(id);
+}
+
+Entity* Game::entityById(int id) {
+    return const_cast<Entity*>(static_cast<const Game*>(this)->entityById(id));
+}
+
+const Entity* Game::entityById(int id) const {
+    const Entity* e = entityByIdIndexed(id);
+#if defined(PROCROGUE_VALIDATE_ENTITY_INDEX)
+    const Entity* want = entityByIdScan(id);
+    if (e != want) entityIndexMismatch("entityById", id, 0, e, want);
+#endif
+    return e;
+}
+
+Entity* Game::entityAtMut(int x, int y) {
+    return const_cast<Entity*>(static_cast<const Game*>(this)->entityAt(x, y));
+}
+
+const Entity* Game::entityAt(int x, int y) const {
+    const Entity* e = entityAtIndexed(x, y);
+#if defined(PROCROGUE_VALIDATE_ENTITY_INDEX)
+    const Entity* want = entityAtScan(x, y);
+    if (e != want) entityIndexMismatch("entityAt", x, y, e, want);
+#endif
+    return e;
+}
+
+void Game::setEntityPos(Entity& e, Vec2i p) {
+    const Vec2i from = e.pos;
+    e.pos = p;
+    if (from != p) noteEntityMoved(e, from);
+}
+
+void Game::noteEntityMoved(const Entity& e, Vec2i from) {
+    if (!entityIndexCurrent()) return; // Rebuilt lazily on the next lookup anyway.
+    if (ents.empty() || &e < ents.data() || &e >= ents.data() + ents.size()) return;
+    if (from == e.pos) return;
+
+    const int32_t slot = static_cast<int32_t>(&e - ents.data());
+    auto cellAt = [&](Vec2i v) -> EntityIndexCell* {
+        if (v.x < 0 || v.y < 0 || v.x >= entIndexW_ || v.y >= entIndexH_) return nullptr;
+        return &entCells_[static_cast<size_t>(v.y * entIndexW_ + v.x)];
+    };
+
+    if (EntityIndexCell* c = cellAt(from)) {
+        if (c->count == 0) {
+            entIndexValid_ = false;
+            return;
+        }
+        --c->count;
+        c->slot = -1;
+    }
+    if (EntityIndexCell* c = cellAt(e.pos)) {
+        ++c->count;
+        c->slot = (c->count == 1) ? slot : -1;
+    }
+}
+
+bool Game::validateEntityIndex() const {
+    if (!entityIndexCurrent()) rebuildEntityIndex();
+
+    for (int y = 0; y < dung.height; ++y) {
+        for (int x = 0; x < dung.width; ++x) {
+            if (entityAtIndexed(x, y) != entityAtScan(x, y)) return false;
+        }
+    }
+    for (const auto& e : ents) {
+        if (entityByIdIndexed(e.id) != entityByIdScan(e.id)) return false;
+    }
+    return true;
+}
@@ -4741,6 +4741,7 @@ void Game::spawnChemicalHazards() {
         auto addField = [&](std::vector<uint8_t>& field, size_t gi, uint8_t v) {
             if (gi >= field.size()) return;
             if (field[gi] < v) field[gi] = v;
+            markHazard(field, static_cast<int>(gi) % dung.width, static_cast<int>(gi) / dung.width);
         };
 
         if (tiny || maxB <= minB + 0.0001f) {
@@ -5095,6 +5096,7 @@ void Game::onDoorOpened(Vec2i doorPos, bool openerIsPlayer) {
             f[i] = static_cast<uint8_t>(nv);
         };
 
+        markHazard(f, doorPos.x, doorPos.y, 2); // doorway + up to two tiles beyond it
         add(iDoor, toDoor);
         add(iDst, toSide1);
         if (toSide2 > 0) add(iDst2, toSide2);
@@ -5158,32 +5160,8 @@ void Game::applyEndOfTurnEffects() {
     // hazard simulation can query materialAtCached() cheaply and deterministically.
     dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
 
-    // Substrate chemistry helpers: porous materials absorb fumes; smooth sealed
-    // surfaces let vapors drift a little farther.
-    auto gasAbsorb = [&](TerrainMaterial m) -> int {
-        switch (m) {
-            case TerrainMaterial::Moss:
-            case TerrainMaterial::Dirt:
-            case TerrainMaterial::Wood:
-            case TerrainMaterial::Bone:
-                return 1;
-            default:
-                return 0;
-        }
-    };
-
-    auto gasSlick = [&](TerrainMaterial m) -> int {
-        switch (m) {
-            case TerrainMaterial::Metal:
-            case TerrainMaterial::Crystal:
-            case TerrainMaterial::Obsidian:
-            case TerrainMaterial::Marble:
-                return 1;
-            default:
-                return 0;
-        }
-    };
-
+    // Substrate chemistry (porous materials absorb fumes, smooth sealed surfaces let
+    // vapors drift farther) is folded into the hazard planes; see hazard_kernels.cpp.
 
     // ------------------------------------------------------------
     // Field chemistry: fire / gas reactions
@@ -5295,6 +5273,7 @@ void Game::applyEndOfTurnEffects() {
                             auto bloom = [&](std::vector<uint8_t>& field, Vec2i c, int radius, int peak, bool requireWalkable) {
                                 radius = clampi(radius, 0, 12);
                                 peak = clampi(peak, 0, 255);
+                                markHazard(field, c.x, c.y, radius);
 
                                 const int fall = std::max(1, peak / std::max(1, radius + 1));
 
@@ -5485,8 +5464,12 @@ void Game::applyEndOfTurnEffects() {
             bool playerHit = false;
 
             // Pass 1: fire burns away gas in place; dense poison gas can ignite.
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
+            //
+            // Only the fire box can burn. Its bounds are re-read as we go: a flash fire
+            // widens it, and the new flames below/right of the scan must still be visited
+            // this pass, exactly as a full row-major sweep would.
+            for (int y = std::max(0, fireActive_.y0); y <= std::min(h - 1, fireActive_.y1); ++y) {
+                for (int x = std::max(0, fireActive_.x0); x <= std::min(w - 1, fireActive_.x1); ++x) {
                     const size_t i = idx2(x, y);
                     const uint8_t f = fireField_[i];
                     if (f == 0u) continue;
@@ -5544,6 +5527,7 @@ void Game::applyEndOfTurnEffects() {
 
                                         // A flash fire is loud.
                                         emitNoise({x, y}, 16);
+                                        markHazard(fireField_, x, y, radius);
 
                                         for (int yy = minY; yy <= maxY; ++yy) {
                                             for (int xx = minX; xx <= maxX; ++xx) {
@@ -5613,6 +5597,7 @@ void Game::applyEndOfTurnEffects() {
                             const int add = 1 + static_cast<int>(aPre) / 7;
                             const int nv = static_cast<int>(poisonGas_[i]) + add;
                             poisonGas_[i] = static_cast<uint8_t>(clampi(nv, 0, 255));
+                            markHazard(poisonGas_, x, y);
                         }
 
                         // Acid slightly damps flames when dense.
@@ -5636,8 +5621,11 @@ void Game::applyEndOfTurnEffects() {
             bool mixVisible = false;
             bool playerMixed = false;
 
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
+            // Both gases must be present: scan where their boxes overlap.
+            const hazard::ActiveRect pr = poisonActive_.clipped(w, h);
+            const hazard::ActiveRect cr = corrosiveActive_.clipped(w, h);
+            for (int y = std::max(pr.y0, cr.y0); y <= std::min(pr.y1, cr.y1); ++y) {
+                for (int x = std::max(pr.x0, cr.x0); x <= std::min(pr.x1, cr.x1); ++x) {
                     const size_t i = idx2(x, y);
                     if (i >= poisonGas_.size() || i >= corrosiveGas_.size() || i >= confusionGas_.size()) continue;
 
@@ -5657,6 +5645,7 @@ void Game::applyEndOfTurnEffects() {
                     const int add = react + m / 10;
                     const int nv = static_cast<int>(confusionGas_[i]) + add;
                     confusionGas_[i] = static_cast<uint8_t>(clampi(nv, 0, 255));
+                    markHazard(confusionGas_, x, y);
 
                     // Only message on strong reactions in view to avoid spam.
                     if (m >= 10 && strongMixes < MAX_MIX_MSGS) {
@@ -6115,10 +6104,10 @@ void Game::applyEndOfTurnEffects() {
                 }
 
                 if (landing.x >= 0) {
-                    p.pos = landing;
+                    setEntityPos(p, landing);
                 } else {
                     // Emergency fallback: collapse the chasm tile into a floor tile.
-                    dung.at(p.pos.x, p.pos.y).type = TileType::Floor;
+                    dung.setTileType(p.pos.x, p.pos.y, TileType::Floor);
                     pushMsg("YOU CRASH DOWN, FILLING IN THE CHASM BENEATH YOU!", MessageKind::Warning, true);
                 }
 
@@ -6738,10 +6727,10 @@ void Game::applyEndOfTurnEffects() {
                     }
 
                     if (landing.x >= 0) {
-                        m.pos = landing;
+                        setEntityPos(m, landing);
                     } else {
                         // Emergency fallback: collapse the chasm tile.
-                        dung.at(m.pos.x, m.pos.y).type = TileType::Floor;
+                        dung.setTileType(m.pos.x, m.pos.y, TileType::Floor);
                     }
 
                     emitNoise(m.pos, 18);
@@ -6778,93 +6767,14 @@ void Game::applyEndOfTurnEffects() {
         }
 
         if (!confusionGas_.empty()) {
-            const int w = dung.width;
-            const int h = dung.height;
-            const size_t n = static_cast<size_t>(w * h);
-
-            std::vector<uint8_t> next(n, uint8_t{0});
-            auto idx2 = [&](int x, int y) -> size_t { return static_cast<size_t>(y * w + x); };
-            auto passable = [&](int x, int y) -> bool {
-                if (!dung.inBounds(x, y)) return false;
-                const TileType tt = dung.at(x, y).type;
-                // Vapor can drift over chasms (open pits) even though they are not walkable.
-                return dung.isWalkable(x, y) || (tt == TileType::Chasm);
-            };
-
-            constexpr Vec2i kDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    const size_t i = idx2(x, y);
-                    const uint8_t s = confusionGas_[i];
-                    if (s == 0u) continue;
-                    if (!passable(x, y)) continue;
-
-                    const TileType tt = dung.at(x, y).type;
-                    const TerrainMaterial mat = dung.materialAtCached(x, y);
-                    const EcosystemKind eco = dung.ecosystemAtCached(x, y);
-                    const EcosystemFx ecoFx = ecosystemFx(eco);
-
-                    int decay = 1 + gasAbsorb(mat);
-                    // Light haze disperses quickly over open pits.
-                    if (tt == TileType::Chasm) decay += 1;
-
-                    // Ecosystem microclimate: some regions scrub vapors quickly, others let dense clouds linger.
-                    if (ecoFx.confusionGasQuenchDelta > 0) decay += ecoFx.confusionGasQuenchDelta;
-
-                    // Always decay in place.
-                    uint8_t self = (s > static_cast<uint8_t>(decay)) ? static_cast<uint8_t>(s - static_cast<uint8_t>(decay)) : 0u;
-                    if (ecoFx.confusionGasQuenchDelta < 0 && s >= 8u) {
-                        const int boost = -ecoFx.confusionGasQuenchDelta;
-                        self = static_cast<uint8_t>(clampi(static_cast<int>(self) + boost, 0, 255));
-                    }
-                    if (next[i] < self) next[i] = self;
-
-                    // Spread to neighbors with extra decay.
-                    //
-                    // Wind bias: downwind tiles get a slightly "stronger" spread, while upwind tiles
-                    // dissipate a bit faster. This makes gas feel like it's drifting through corridors.
-                    if (s >= 3u) {
-                        int base = static_cast<int>(s) - 2;
-                        base -= gasAbsorb(mat);
-                        base += gasSlick(mat); // smooth surfaces let vapor slide a little farther
-                        base += ecoFx.confusionGasSpreadDelta;
-                        base = std::clamp(base, 0, static_cast<int>(s));
-
-                        for (const Vec2i& d : kDirs) {
-                            const int nx = x + d.x;
-                            const int ny = y + d.y;
-                            if (!passable(nx, ny)) continue;
-
-                            int spread = base;
-
-                            if (windStr > 0) {
-                                if (d.x == wind.x && d.y == wind.y) {
-                                    spread = std::min(static_cast<int>(s), spread + windStr);
-                                } else if (d.x == upWind.x && d.y == upWind.y) {
-                                    spread = std::max(0, spread - windStr);
-                                }
-                            }
-
-                            const TileType nt = dung.at(nx, ny).type;
-
-                            // Light vapor prefers to "rise out" of chasms and resists sinking into them.
-                            if (nt == TileType::Chasm && tt != TileType::Chasm) {
-                                spread = std::max(0, spread - 2);
-                            } else if (tt == TileType::Chasm && nt != TileType::Chasm) {
-                                spread = std::min(static_cast<int>(s), spread + 2);
-                            }
-
-                            if (spread <= 0) continue;
-                            const size_t j = idx2(nx, ny);
-                            const uint8_t su = static_cast<uint8_t>(std::clamp(spread, 0, 255));
-                            if (next[j] < su) next[j] = su;
-                        }
-                    }
-                }
-            }
-
-            confusionGas_.swap(next);
+            hazard::GasRule rule;
+            rule.keep = 2;
+            rule.wind = wind;
+            rule.windBonus = (windStr > 0) ? windStr : 0;
+            // Light vapor prefers to "rise out" of chasms and resists sinking into them.
+            rule.intoChasm = -2;
+            rule.outOfChasm = 2;
+            hazard::diffuseGas(hazardPlanes(), hazard::Gas::Confusion, rule, confusionGas_, confusionActive_, hazardScratch_);
         }
     }
 
@@ -6878,90 +6788,15 @@ void Game::applyEndOfTurnEffects() {
         }
 
         if (!poisonGas_.empty()) {
-            const int w = dung.width;
-            const int h = dung.height;
-            const size_t n = static_cast<size_t>(w * h);
-
-            std::vector<uint8_t> next(n, uint8_t{0});
-            auto idx2 = [&](int x, int y) -> size_t { return static_cast<size_t>(y * w + x); };
-            auto passable = [&](int x, int y) -> bool {
-                if (!dung.inBounds(x, y)) return false;
-                const TileType tt = dung.at(x, y).type;
-                // Heavy-ish gas can drift over open pits.
-                return dung.isWalkable(x, y) || (tt == TileType::Chasm);
-            };
-
-            constexpr Vec2i kDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    const size_t i = idx2(x, y);
-                    const uint8_t s = poisonGas_[i];
-                    if (s == 0u) continue;
-                    if (!passable(x, y)) continue;
-
-                    const TileType tt = dung.at(x, y).type;
-                    const TerrainMaterial mat = dung.materialAtCached(x, y);
-                    const EcosystemKind eco = dung.ecosystemAtCached(x, y);
-                    const EcosystemFx ecoFx = ecosystemFx(eco);
-
-                    int decay = 1 + gasAbsorb(mat);
-                    if (ecoFx.poisonGasQuenchDelta > 0) decay += ecoFx.poisonGasQuenchDelta;
-
-                    // Always decay in place.
-                    uint8_t self = (s > static_cast<uint8_t>(decay)) ? static_cast<uint8_t>(s - static_cast<uint8_t>(decay)) : 0u;
-                    if (ecoFx.poisonGasQuenchDelta < 0 && s >= 8u) {
-                        const int boost = -ecoFx.poisonGasQuenchDelta;
-                        self = static_cast<uint8_t>(clampi(static_cast<int>(self) + boost, 0, 255));
-                    }
-                    if (next[i] < self) next[i] = self;
-
-                    // Spread to neighbors with extra decay (more dissipative than confusion gas).
-                    //
-                    // Wind bias: poison gas stays localized, but still drifts downwind in corridors.
-                    if (s >= 4u) {
-                        int base = static_cast<int>(s) - 3;
-                        base -= gasAbsorb(mat);
-                        base += gasSlick(mat); // sealed surfaces let fumes "slide" a bit
-                        base += ecoFx.poisonGasSpreadDelta;
-                        base = std::clamp(base, 0, static_cast<int>(s));
-
-                        for (const Vec2i& d : kDirs) {
-                            const int nx = x + d.x;
-                            const int ny = y + d.y;
-                            if (!passable(nx, ny)) continue;
-
-                            int spread = base;
-
-                            if (windStr > 0) {
-                                // Slightly weaker than confusion gas so poison doesn't become too "flowy".
-                                const int bonus = std::max(1, windStr - 1);
-                                if (d.x == wind.x && d.y == wind.y) {
-                                    spread = std::min(static_cast<int>(s), spread + bonus);
-                                } else if (d.x == upWind.x && d.y == upWind.y) {
-                                    spread = std::max(0, spread - bonus);
-                                }
-                            }
-
-                            const TileType nt = dung.at(nx, ny).type;
-
-                            // Poison vapors are heavier than haze: they tend to sink into pits and stay there.
-                            if (nt == TileType::Chasm && tt != TileType::Chasm) {
-                                spread = std::min(static_cast<int>(s), spread + 2);
-                            } else if (tt == TileType::Chasm && nt != TileType::Chasm) {
-                                spread = std::max(0, spread - 2);
-                            }
-
-                            if (spread <= 0) continue;
-                            const size_t j = idx2(nx, ny);
-                            const uint8_t su = static_cast<uint8_t>(std::clamp(spread, 0, 255));
-                            if (next[j] < su) next[j] = su;
-                        }
-                    }
-                }
-            }
-
-            poisonGas_.swap(next);
+            hazard::GasRule rule;
+            rule.keep = 3;
+            rule.wind = wind;
+            // Slightly weaker than confusion gas so poison doesn't become too "flowy".
+            rule.windBonus = (windStr > 0) ? std::max(1, windStr - 1) : 0;
+            // Poison vapors are heavier than haze: they tend to sink into pits and stay there.
+            rule.intoChasm = 2;
+            rule.outOfChasm = -2;
+            hazard::diffuseGas(hazardPlanes(), hazard::Gas::Poison, rule, poisonGas_, poisonActive_, hazardScratch_);
         }
     }
 
@@ -6975,93 +6810,15 @@ void Game::applyEndOfTurnEffects() {
         }
 
         if (!corrosiveGas_.empty()) {
-            const int w = dung.width;
-            const int h = dung.height;
-            const size_t n = static_cast<size_t>(w * h);
-
-            std::vector<uint8_t> next(n, uint8_t{0});
-            auto idx2 = [&](int x, int y) -> size_t { return static_cast<size_t>(y * w + x); };
-            auto passable = [&](int x, int y) -> bool {
-                if (!dung.inBounds(x, y)) return false;
-                const TileType tt = dung.at(x, y).type;
-                // Acid fumes can drift over open pits.
-                return dung.isWalkable(x, y) || (tt == TileType::Chasm);
-            };
-
-            constexpr Vec2i kDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    const size_t i = idx2(x, y);
-                    const uint8_t s = corrosiveGas_[i];
-                    if (s == 0u) continue;
-                    if (!passable(x, y)) continue;
-
-                    const TileType tt = dung.at(x, y).type;
-                    const TerrainMaterial mat = dung.materialAtCached(x, y);
-                    const EcosystemKind eco = dung.ecosystemAtCached(x, y);
-                    const EcosystemFx ecoFx = ecosystemFx(eco);
-
-                    int decay = 1 + gasAbsorb(mat);
-                    if (ecoFx.corrosiveGasQuenchDelta > 0) decay += ecoFx.corrosiveGasQuenchDelta;
-
-                    // Always decay in place.
-                    uint8_t self = (s > static_cast<uint8_t>(decay)) ? static_cast<uint8_t>(s - static_cast<uint8_t>(decay)) : 0u;
-                    if (ecoFx.corrosiveGasQuenchDelta < 0 && s >= 8u) {
-                        const int boost = -ecoFx.corrosiveGasQuenchDelta;
-                        self = static_cast<uint8_t>(clampi(static_cast<int>(self) + boost, 0, 255));
-                    }
-                    if (next[i] < self) next[i] = self;
-
-                    // Spread is more dissipative than poison gas.
-                    // Wind bias is weaker: this vapor tends to cling.
-                    if (s >= 5u) {
-                        int base = static_cast<int>(s) - 4;
-                        base -= gasAbsorb(mat);
-
-                        // Corrosive vapor is sticky on some substrates (it condenses rather than drifting).
-                        if (mat == TerrainMaterial::Metal || mat == TerrainMaterial::Obsidian || mat == TerrainMaterial::Basalt) {
-                            base -= 1;
-                        }
-
-                        base += ecoFx.corrosiveGasSpreadDelta;
-                        base = std::clamp(base, 0, static_cast<int>(s));
-
-                        for (const Vec2i& d : kDirs) {
-                            const int nx = x + d.x;
-                            const int ny = y + d.y;
-                            if (!passable(nx, ny)) continue;
-
-                            int spread = base;
-
-                            if (windStr > 0) {
-                                const int bonus = std::max(0, windStr - 2);
-                                if (d.x == wind.x && d.y == wind.y) {
-                                    spread = std::min(static_cast<int>(s), spread + bonus);
-                                } else if (d.x == upWind.x && d.y == upWind.y) {
-                                    spread = std::max(0, spread - bonus);
-                                }
-                            }
-
-                            const TileType nt = dung.at(nx, ny).type;
-
-                            // Acid fumes are the heaviest: they strongly pool into pits.
-                            if (nt == TileType::Chasm && tt != TileType::Chasm) {
-                                spread = std::min(static_cast<int>(s), spread + 3);
-                            } else if (tt == TileType::Chasm && nt != TileType::Chasm) {
-                                spread = std::max(0, spread - 3);
-                            }
-
-                            if (spread <= 0) continue;
-                            const size_t j = idx2(nx, ny);
-                            const uint8_t su = static_cast<uint8_t>(std::clamp(spread, 0, 255));
-                            if (next[j] < su) next[j] = su;
-                        }
-                    }
-                }
-            }
-
-            corrosiveGas_.swap(next);
+            hazard::GasRule rule;
+            rule.keep = 4;
+            rule.wind = wind;
+            // Wind bias is weaker: this vapor tends to cling.
+            rule.windBonus = (windStr > 0) ? std::max(0, windStr - 2) : 0;
+            // Acid fumes are the heaviest: they strongly pool into pits.
+            rule.intoChasm = 3;
+            rule.outOfChasm = -3;
+            hazard::diffuseGas(hazardPlanes(), hazard::Gas::Corrosive, rule, corrosiveGas_, corrosiveActive_, hazardScratch_);
         }
     }
 
@@ -7314,13 +7071,20 @@ void Game::applyEndOfTurnEffects() {
         if (expect > 0 && poisonGas_.size() == expect && corrosiveGas_.size() == expect) {
             auto idx2 = [&](int x, int y) -> size_t { return static_cast<size_t>(y * w + x); };
 
-            auto leakAcrossVentedDoors = [&](std::vector<uint8_t>& f, int minDiff, int div, int maxLeak) {
+            auto leakAcrossVentedDoors = [&](std::vector<uint8_t>& f, hazard::ActiveRect& active, int minDiff, int div,
+                                             int maxLeak) {
                 if (f.size() != expect) return;
 
+                // A door only leaks if gas sits on one of its sides, i.e. within a tile of the
+                // box; the receiving side is at most two tiles out.
+                const hazard::ActiveRect doors = active.clipped(w, h, 1);
+                if (doors.empty()) return;
+                const hazard::ActiveRect reach = active.clipped(w, h, 2);
+
                 std::vector<int16_t> delta(expect, 0);
 
-                for (int y = 0; y < h; ++y) {
-                    for (int x = 0; x < w; ++x) {
+                for (int y = doors.y0; y <= doors.y1; ++y) {
+                    for (int x = doors.x0; x <= doors.x1; ++x) {
                         const TileType tt = dung.at(x, y).type;
                         if (tt != TileType::DoorClosed && tt != TileType::DoorLocked) continue;
 
@@ -7344,22 +7108,27 @@ void Game::applyEndOfTurnEffects() {
                         if (diff > 0) {
                             delta[ia] -= static_cast<int16_t>(amt);
                             delta[ib] += static_cast<int16_t>(amt);
+                            active.include(b.x, b.y);
                         } else {
                             delta[ib] -= static_cast<int16_t>(amt);
                             delta[ia] += static_cast<int16_t>(amt);
+                            active.include(a.x, a.y);
                         }
                     }
                 }
 
-                for (size_t i = 0; i < expect; ++i) {
-                    const int nv = std::clamp(static_cast<int>(f[i]) + static_cast<int>(delta[i]), 0, 255);
-                    f[i] = static_cast<uint8_t>(nv);
+                for (int y = reach.y0; y <= reach.y1; ++y) {
+                    for (int x = reach.x0; x <= reach.x1; ++x) {
+                        const size_t i = idx2(x, y);
+                        const int nv = std::clamp(static_cast<int>(f[i]) + static_cast<int>(delta[i]), 0, 255);
+                        f[i] = static_cast<uint8_t>(nv);
+                    }
                 }
             };
 
             // Poison vapor is lighter/more mobile than acid fumes.
-            leakAcrossVentedDoors(poisonGas_, 8, 24, 6);
-            leakAcrossVentedDoors(corrosiveGas_, 8, 26, 5);
+            leakAcrossVentedDoors(poisonGas_, poisonActive_, 8, 24, 6);
+            leakAcrossVentedDoors(corrosiveGas_, corrosiveActive_, 8, 26, 5);
         }
     }
 
@@ -7385,11 +7154,14 @@ void Game::applyEndOfTurnEffects() {
             };
 
             // Doors: high acid exposure can unlock locks and eventually force doors open.
+            // Only doors next to the acid box can see any gas; the bounds are re-read because
+            // a door bursting open puffs gas along, which later doors in the scan may see.
             int unlockSeen = 0;
             int openSeen = 0;
+            const hazard::ActiveRect& acid = corrosiveActive_;
 
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
+            for (int y = std::max(0, acid.y0 - 1); y <= std::min(h - 1, acid.y1 + 1); ++y) {
+                for (int x = std::max(0, acid.x0 - 1); x <= std::min(w - 1, acid.x1 + 1); ++x) {
                     const TileType tt = dung.at(x, y).type;
                     if (tt != TileType::DoorLocked && tt != TileType::DoorClosed) continue;
 
@@ -7424,7 +7196,7 @@ void Game::applyEndOfTurnEffects() {
                         chancePct = clampi(chancePct, 2, maxChance);
 
                         if (rng.range(1, 100) <= chancePct) {
-                            dung.at(x, y).type = TileType::DoorClosed;
+                            dung.setTileType(x, y, TileType::DoorClosed);
                             emitNoise({x, y}, 8);
 
                             if (dung.at(x, y).visible) ++unlockSeen;
@@ -7435,7 +7207,7 @@ void Game::applyEndOfTurnEffects() {
                         chancePct = clampi(chancePct, 2, maxChance);
 
                         if (rng.range(1, 100) <= chancePct) {
-                            dung.at(x, y).type = TileType::DoorOpen;
+                            dung.setTileType(x, y, TileType::DoorOpen);
                             emitNoise({x, y}, 10);
 
                             // Opening a door can cause a pressure/gas puff (esp. airlocks).
@@ -7499,7 +7271,8 @@ void Game::applyEndOfTurnEffects() {
             fireField_.assign(expect, uint8_t{0});
         }
 
-        if (!fireField_.empty()) {
+        // Nothing burns while the fire box is empty.
+        if (!fireField_.empty() && !fireActive_.clipped(dung.width, dung.height).empty()) {
             // Fire burns away any web traps it overlaps.
             int websBurnedSeen = 0;
             for (size_t ti = 0; ti < trapsCur.size(); ) {
@@ -7520,9 +7293,12 @@ void Game::applyEndOfTurnEffects() {
 
             const int w = dung.width;
             const int h = dung.height;
-            const size_t n = static_cast<size_t>(w * h);
 
-            std::vector<uint8_t> next(n, uint8_t{0});
+            // Ecosystem microclimate + overworld weather can quench or sustain fires.
+            const hazard::ActiveRect burning = fireActive_.clipped(w, h);
+            std::vector<uint8_t> next;
+            hazard::decayFire(hazardPlanes(), wxFireQuench, fireField_, next, fireActive_);
+
             auto idx2 = [&](int x, int y) -> size_t { return static_cast<size_t>(y * w + x); };
             auto passable = [&](int x, int y) -> bool {
                 if (!dung.inBounds(x, y)) return false;
@@ -7532,56 +7308,42 @@ void Game::applyEndOfTurnEffects() {
 
             constexpr Vec2i kDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
 
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
+            for (int y = burning.y0; y <= burning.y1; ++y) {
+                for (int x = burning.x0; x <= burning.x1; ++x) {
                     const size_t i = idx2(x, y);
                     const uint8_t s = fireField_[i];
-                    if (s == 0u) continue;
+                    if (s < 8u) continue; // decay was applied above
                     if (!passable(x, y)) continue;
 
-                    // Ecosystem microclimate + overworld weather can quench or sustain fires.
-                    const EcosystemKind eco = dung.ecosystemAtCached(x, y);
-                    const EcosystemFx ecoFx = ecosystemFx(eco);
-
-                    int decay = 1 + wxFireQuench;
-                    if (ecoFx.fireQuenchDelta > 0) decay += ecoFx.fireQuenchDelta;
-
-                    uint8_t self = (s > static_cast<uint8_t>(decay)) ? static_cast<uint8_t>(s - static_cast<uint8_t>(decay)) : 0u;
-                    // In hot/dry regions, strong fires can linger a bit longer before guttering out.
-                    if (ecoFx.fireQuenchDelta < 0 && s >= 6u) {
-                        const int boost = -ecoFx.fireQuenchDelta;
-                        self = static_cast<uint8_t>(clampi(static_cast<int>(self) + boost, 0, 255));
-                    }
-                    if (next[i] < self) next[i] = self;
+                    const EcosystemFx ecoFx = ecosystemFx(dung.ecosystemAtCached(x, y));
 
                     // Strong fires can spread a bit, but we keep this rare to avoid runaway map-wide burns.
-                    if (s >= 8u) {
-                        const float baseChance = std::min(0.12f, 0.02f * static_cast<float>(s - 7u));
-                        const uint8_t spread = static_cast<uint8_t>(std::max(1, static_cast<int>(s) - 3));
-                        for (const Vec2i& d : kDirs) {
-                            const int nx = x + d.x;
-                            const int ny = y + d.y;
-                            if (!passable(nx, ny)) continue;
-                            const size_t j = idx2(nx, ny);
-                            if (fireField_[j] != 0u) continue;
-
-                            float chance = baseChance * (static_cast<float>(ecoFx.fireSpreadMulPct) / 100.0f);
-                            if (windStr > 0) {
-                                // Downwind flames jump more readily; upwind spread is suppressed.
-                                if (d.x == wind.x && d.y == wind.y) {
-                                    chance *= (1.0f + 0.35f * static_cast<float>(windStr));
-                                } else if (d.x == upWind.x && d.y == upWind.y) {
-                                    chance *= std::max(0.20f, (1.0f - 0.25f * static_cast<float>(windStr)));
-                                }
-                            }
-                            if (wxFireQuench > 0) {
-                                chance *= std::max(0.10f, 1.0f - 0.25f * static_cast<float>(wxFireQuench));
+                    const float baseChance = std::min(0.12f, 0.02f * static_cast<float>(s - 7u));
+                    const uint8_t spread = static_cast<uint8_t>(std::max(1, static_cast<int>(s) - 3));
+                    for (const Vec2i& d : kDirs) {
+                        const int nx = x + d.x;
+                        const int ny = y + d.y;
+                        if (!passable(nx, ny)) continue;
+                        const size_t j = idx2(nx, ny);
+                        if (fireField_[j] != 0u) continue;
+
+                        float chance = baseChance * (static_cast<float>(ecoFx.fireSpreadMulPct) / 100.0f);
+                        if (windStr > 0) {
+                            // Downwind flames jump more readily; upwind spread is suppressed.
+                            if (d.x == wind.x && d.y == wind.y) {
+                                chance *= (1.0f + 0.35f * static_cast<float>(windStr));
+                            } else if (d.x == upWind.x && d.y == upWind.y) {
+                                chance *= std::max(0.20f, (1.0f - 0.25f * static_cast<float>(windStr)));
                             }
-                            chance = std::min(0.35f, std::max(0.0f, chance));
+                        }
+                        if (wxFireQuench > 0) {
+                            chance *= std::max(0.10f, 1.0f - 0.25f * static_cast<float>(wxFireQuench));
+                        }
+                        chance = std::min(0.35f, std::max(0.0f, chance));
 
-                            if (rng.chance(chance)) {
-                                if (next[j] < spread) next[j] = spread;
-                            }
+                        if (rng.chance(chance)) {
+                            if (next[j] < spread) next[j] = spread;
+                            fireActive_.include(nx, ny);
                         }
                     }
                 }
@@ -7942,6 +7704,7 @@ void Game::cleanupDead() {
     ents.erase(std::remove_if(ents.begin(), ents.end(), [&](const Entity& e) {
         return (e.id != playerId_) && (e.hp <= 0);
     }), ents.end());
+    invalidateEntityIndex();
 
     // Player death handled in attack functions
 }
@@ -7993,7 +7756,7 @@ void Game::spawnAltars() {
 
         for (const auto& p : cand) {
             if (!canPlace(p)) continue;
-            dung.at(p.x, p.y).type = TileType::Altar;
+            dung.setTileType(p.x, p.y, TileType::Altar);
             break;
         }
     }
@@ -8125,7 +7888,7 @@ void Game::spawnFountains() {
         Vec2i p{rng.range(x0, x1), rng.range(y0, y1)};
         if (isBadPos(p)) continue;
 
-        dung.at(p.x, p.y).type = TileType::Fountain;
+        dung.setTileType(p.x, p.y, TileType::Fountain);
         placed += 1;
     }
 }
@@ -176,7 +176,7 @@ bool Game::checkSpellFailure(SpellKind k, Vec2i intendedTarget, bool hasTarget)
         }
         if (placed && (dst.x != src.x || dst.y != src.y)) {
             pushFxParticle(FXParticlePreset::Blink, src, intensity, 0.18f);
-            p.pos = dst;
+            setEntityPos(p, dst);
             pushFxParticle(FXParticlePreset::Blink, dst, intensity, 0.18f, 0.03f);
             pushMsg("YOUR BLINK GOES AWRY!", MessageKind::Warning, true);
             emitNoise(p.pos, 10);
@@ -206,6 +206,7 @@ bool Game::checkSpellFailure(SpellKind k, Vec2i intendedTarget, bool hasTarget)
             constexpr int r = 1;
             std::vector<uint8_t> mask;
             dung.computeFovMask(p.pos.x, p.pos.y, r, mask);
+            markHazard(fireField_, p.pos.x, p.pos.y, r);
             const uint8_t base = static_cast<uint8_t>(clampi(14 + sd.manaCost * 2, 14, 32));
             for (int y = std::max(0, p.pos.y - r); y <= std::min(dung.height - 1, p.pos.y + r); ++y) {
                 for (int x = std::max(0, p.pos.x - r); x <= std::min(dung.width - 1, p.pos.x + r); ++x) {
@@ -235,6 +236,7 @@ bool Game::checkSpellFailure(SpellKind k, Vec2i intendedTarget, bool hasTarget)
             constexpr int r = 1;
             std::vector<uint8_t> mask;
             dung.computeFovMask(p.pos.x, p.pos.y, r, mask);
+            markHazard(poisonGas_, p.pos.x, p.pos.y, r);
             const uint8_t base = static_cast<uint8_t>(clampi(10 + focus / 2, 8, 16));
             for (int y = std::max(0, p.pos.y - r); y <= std::min(dung.height - 1, p.pos.y + r); ++y) {
                 for (int x = std::max(0, p.pos.x - r); x <= std::min(dung.width - 1, p.pos.x + r); ++x) {
@@ -347,7 +349,7 @@ bool Game::castSpell(SpellKind k) {
                     ++found;
                 }
                 if (dung.inBounds(tr.pos.x, tr.pos.y)) {
-                    dung.at(tr.pos.x, tr.pos.y).explored = true;
+                    dung.setExplored(tr.pos.x, tr.pos.y, true);
                 }
             }
             if (found > 0) {
@@ -460,7 +462,7 @@ bool Game::castSpellAt(SpellKind k, Vec2i target) {
             const int intensity = clampi(30 + focus * 2, 30, 90);
             const Vec2i src = p.pos;
             pushFxParticle(FXParticlePreset::Blink, src, intensity, 0.18f);
-            p.pos = target;
+            setEntityPos(p, target);
             pushFxParticle(FXParticlePreset::Blink, target, intensity, 0.18f, 0.03f);
             pushMsg("YOU BLINK.", MessageKind::System, true);
             emitNoise(p.pos, 10);
@@ -496,6 +498,7 @@ bool Game::castSpellAt(SpellKind k, Vec2i target) {
 
             std::vector<uint8_t> mask;
             dung.computeFovMask(target.x, target.y, radius, mask);
+            markHazard(poisonGas_, target.x, target.y, radius);
 
             const int minX = std::max(0, target.x - radius);
             const int maxX = std::min(dung.width - 1, target.x + radius);
@@ -894,6 +897,7 @@ bool Game::castProcSpellAt(uint32_t procId, Vec2i target) {
 
             std::vector<uint8_t> mask;
             dung.computeFovMask(finalTarget.x, finalTarget.y, radius, mask);
+            markHazard(*field, finalTarget.x, finalTarget.y, radius);
 
             const int minX = std::max(0, finalTarget.x - radius);
             const int maxX = std::min(dung.width - 1, finalTarget.x + radius);
@@ -2,6 +2,8 @@
 
 #include "scent_field.hpp"
 
+#include <iterator>
+
 void Game::dropGroundItem(Vec2i pos, ItemKind k, int count, int enchant) {
     count = std::max(1, count);
 
@@ -92,118 +94,73 @@ void Game::recomputeLightMap() {
 
     // Always keep caches sized correctly (even when lighting is "off") so the renderer
     // can safely query light color without special-casing.
-    lightMap_.assign(n, uint8_t{255});
-    lightColorMap_.assign(n, Color{ 255, 255, 255, 255 });
-
     if (!darknessActive()) {
         // Treat early depths as fully lit for accessibility.
+        lightCache_.fillBright(dung, lightMap_, lightColorMap_);
         return;
     }
 
     // Darkness mode: build a per-tile brightness map (for gameplay) + a per-tile RGB light
-    // modulation map (for rendering).
-    lightMap_.assign(n, uint8_t{0});
-    lightColorMap_.assign(n, Color{ 0, 0, 0, 255 });
-
-    auto idx = [&](int x, int y) -> size_t { return static_cast<size_t>(y * dung.width + x); };
-
-    auto setAmbient = [&](int x, int y, uint8_t amb, Color tint) {
-        if (!dung.inBounds(x, y)) return;
-        const size_t i = idx(x, y);
-        if (i >= lightMap_.size() || i >= lightColorMap_.size()) return;
-
-        if (lightMap_[i] < amb) lightMap_[i] = amb;
-
-        // Encode ambient color as "already intensity-scaled" modulation.
-        const auto scale = [&](uint8_t c) -> uint8_t {
-            const int v = (static_cast<int>(amb) * static_cast<int>(c)) / 255;
-            return static_cast<uint8_t>(clampi(v, 0, 255));
-        };
-
-        const Color ambC{ scale(tint.r), scale(tint.g), scale(tint.b), 255 };
-        Color& dst = lightColorMap_[i];
-        dst.r = std::max(dst.r, ambC.r);
-        dst.g = std::max(dst.g, ambC.g);
-        dst.b = std::max(dst.b, ambC.b);
-    };
-
-    auto addLight = [&](int x, int y, uint8_t b, Color tint) {
-        if (!dung.inBounds(x, y)) return;
-        const size_t i = idx(x, y);
-        if (i >= lightMap_.size() || i >= lightColorMap_.size()) return;
-
-        if (lightMap_[i] < b) lightMap_[i] = b;
-
-        // Additive RGB lighting. Each channel is scaled by intensity and saturates at 255.
-        auto addChan = [&](uint8_t& dst, uint8_t srcChan) {
-            const int add = (static_cast<int>(b) * static_cast<int>(srcChan)) / 255;
-            const int v = static_cast<int>(dst) + add;
-            dst = static_cast<uint8_t>((v > 255) ? 255 : v);
-        };
-
-        Color& dst = lightColorMap_[i];
-        addChan(dst.r, tint.r);
-        addChan(dst.g, tint.g);
-        addChan(dst.b, tint.b);
-    };
+    // modulation map (for rendering). LightMapCache keeps the room light and every source's
+    // contribution, so only sources that changed are recomputed (see light_map.hpp).
+    if (lightMap_.size() != n || lightColorMap_.size() != n) lightCache_.clear();
 
-    // Ambient room light: rooms are softly lit, corridors/caverns are dark.
-    for (const Room& r : dung.rooms) {
-        uint8_t amb = 140;
-        Color ambTint{ 255, 246, 236, 255 }; // warm stone by default
-        switch (r.type) {
-            case RoomType::Shrine:
-                amb = 190;
-                ambTint = Color{ 206, 222, 255, 255 }; // cool/holy
-                break;
-            case RoomType::Treasure:
-                amb = 170;
-                ambTint = Color{ 255, 238, 200, 255 }; // warm/golden
-                break;
-            case RoomType::Vault:
-                amb = 175;
-                ambTint = Color{ 224, 232, 255, 255 }; // cold steel
-                break;
-            case RoomType::Secret:
-                amb = 120;
-                ambTint = Color{ 220, 206, 190, 255 }; // dusty
-                break;
-            case RoomType::Shop:
-                amb = 175;
-                ambTint = Color{ 255, 232, 205, 255 }; // cozy
-                break;
-            case RoomType::Armory:
-                amb = 165;
-                ambTint = Color{ 234, 240, 255, 255 }; // cool steel
-                break;
-            case RoomType::Library:
-                amb = 160;
-                ambTint = Color{ 255, 242, 220, 255 }; // parchment/candles
-                break;
-            case RoomType::Laboratory:
-                amb = 155;
-                ambTint = Color{ 220, 255, 236, 255 }; // odd green
-                break;
-            default:
-                amb = 140;
-                ambTint = Color{ 255, 246, 236, 255 };
-                break;
-        }
+    // Ensure terrain caches exist (biolum is computed in Dungeon::ensureMaterials).
+    dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
 
-        for (int y = r.y; y < r.y + r.h; ++y) {
-            for (int x = r.x; x < r.x + r.w; ++x) {
-                setAmbient(x, y, amb, ambTint);
+    const uint32_t lvlSeed = hashCombine(levelGenSeed(LevelId{branch_, depth_}), tag32("BIOLUM"));
+    const bool newLayout = lightCache_.begin(dung, hashCombine(lvlSeed, static_cast<uint32_t>(branch_),
+                                                               static_cast<uint32_t>(depth_)));
+
+    // Ambient room light: rooms are softly lit, corridors/caverns are dark. It only
+    // depends on the layout, so the cache keeps it until the level changes.
+    if (newLayout) {
+        for (const Room& r : dung.rooms) {
+            uint8_t amb = 140;
+            Color ambTint{ 255, 246, 236, 255 }; // warm stone by default
+            switch (r.type) {
+                case RoomType::Shrine:
+                    amb = 190;
+                    ambTint = Color{ 206, 222, 255, 255 }; // cool/holy
+                    break;
+                case RoomType::Treasure:
+                    amb = 170;
+                    ambTint = Color{ 255, 238, 200, 255 }; // warm/golden
+                    break;
+                case RoomType::Vault:
+                    amb = 175;
+                    ambTint = Color{ 224, 232, 255, 255 }; // cold steel
+                    break;
+                case RoomType::Secret:
+                    amb = 120;
+                    ambTint = Color{ 220, 206, 190, 255 }; // dusty
+                    break;
+                case RoomType::Shop:
+                    amb = 175;
+                    ambTint = Color{ 255, 232, 205, 255 }; // cozy
+                    break;
+                case RoomType::Armory:
+                    amb = 165;
+                    ambTint = Color{ 234, 240, 255, 255 }; // cool steel
+                    break;
+                case RoomType::Library:
+                    amb = 160;
+                    ambTint = Color{ 255, 242, 220, 255 }; // parchment/candles
+                    break;
+                case RoomType::Laboratory:
+                    amb = 155;
+                    ambTint = Color{ 220, 255, 236, 255 }; // odd green
+                    break;
+                default:
+                    amb = 140;
+                    ambTint = Color{ 255, 246, 236, 255 };
+                    break;
             }
+
+            lightCache_.addAmbient(r.x, r.y, r.w, r.h, amb, ambTint);
         }
     }
 
-    struct LightSource {
-        Vec2i pos;
-        int radius;
-        uint8_t intensity;
-        Color tint;
-    };
-
     std::vector<LightSource> sources;
 
     // Player light sources (carried lit torches).
@@ -254,8 +211,10 @@ void Game::recomputeLightMap() {
             std::vector<FireSrc> fires;
             fires.reserve(24);
 
-            for (int y = 0; y < dung.height; ++y) {
-                for (int x = 0; x < dung.width; ++x) {
+            // Flames only exist inside the fire field's active box.
+            const hazard::ActiveRect box = fireActive_.clipped(dung.width, dung.height);
+            for (int y = box.y0; y <= box.y1; ++y) {
+                for (int x = box.x0; x <= box.x1; ++x) {
                     const uint8_t f = fireField_[static_cast<size_t>(y * dung.width + x)];
                     if (f == 0u) continue;
                     if (!dung.isWalkable(x, y)) continue;
@@ -351,15 +310,13 @@ void Game::recomputeLightMap() {
         }
     }
 
-
-
     // Procedural bioluminescent terrain (lichen/crystal) emitters.
     // These are cosmetic light sources derived from the deterministic per-level
     // biolum cache (computed alongside terrain materials). The intent is to create
     // occasional dim navigation landmarks in darkness without replacing torches.
-    {
-        // Ensure terrain caches exist (biolum is computed in Dungeon::ensureMaterials).
-        dung.ensureMaterials(materialWorldSeed(), branch_, materialDepth(), dungeonMaxDepth());
+    // They form the static layer: re-selected only after terrain/material changes.
+    if (lightCache_.staticStale()) {
+        std::vector<LightSource> glows;
 
         struct GlowCand {
             Vec2i pos;
@@ -371,8 +328,6 @@ void Game::recomputeLightMap() {
         std::vector<GlowCand> cands;
         cands.reserve(128);
 
-        const uint32_t lvlSeed = hashCombine(levelGenSeed(LevelId{branch_, depth_}), tag32("BIOLUM"));
-
         for (int y = 0; y < dung.height; ++y) {
             for (int x = 0; x < dung.width; ++x) {
                 if (dung.at(x, y).type != TileType::Floor) continue;
@@ -467,53 +422,15 @@ void Game::recomputeLightMap() {
                         break;
                 }
 
-                sources.push_back({ c.pos, radius, static_cast<uint8_t>(intensity), tint });
+                glows.push_back({ c.pos, radius, static_cast<uint8_t>(intensity), tint });
             }
         }
-    }
-    // Apply each source using shadowcasting LOS from the source.
-    std::vector<uint8_t> mask;
-    for (const auto& s : sources) {
-        dung.computeFovMask(s.pos.x, s.pos.y, s.radius, mask);
-        if (mask.size() != lightMap_.size()) continue;
-
-        const int r  = std::max(1, s.radius);
-        const int r2 = r * r;
-
-        for (int y = 0; y < dung.height; ++y) {
-            for (int x = 0; x < dung.width; ++x) {
-                const size_t i = idx(x, y);
-                if (!mask[i]) continue;
-
-                const int dx = x - s.pos.x;
-                const int dy = y - s.pos.y;
-                const int d2 = dx * dx + dy * dy;
-                if (d2 > r2) continue;
 
-                // Smooth quadratic falloff (0 at edge) for nicer, round torchlight.
-                const float t = static_cast<float>(d2) / static_cast<float>(r2);
-                float atten = 1.0f - t;
-                atten = atten * atten;
-
-                int b = static_cast<int>(static_cast<float>(s.intensity) * atten + 0.5f);
-                b = clampi(b, 0, 255);
-
-                addLight(x, y, static_cast<uint8_t>(b), s.tint);
-            }
-        }
+        lightCache_.setSources(dung, LightMapCache::Layer::Static, std::move(glows));
     }
 
-    // If a tile has brightness but ended up with no RGB tint (should be rare),
-    // fall back to grayscale to avoid a "black light" edge case.
-    for (size_t i = 0; i < lightMap_.size() && i < lightColorMap_.size(); ++i) {
-        if (lightMap_[i] == uint8_t{0}) continue;
-        Color& c = lightColorMap_[i];
-        if (c.r == 0 && c.g == 0 && c.b == 0) {
-            c.r = lightMap_[i];
-            c.g = lightMap_[i];
-            c.b = lightMap_[i];
-        }
-    }
+    lightCache_.setSources(dung, LightMapCache::Layer::Dynamic, std::move(sources));
+    lightCache_.compose(lightMap_, lightColorMap_);
 }
 
 
@@ -546,30 +463,58 @@ void Game::recomputeFov() {
     } else {
         // If darkness is active, compute FOV without auto-explore marking so we can
         // apply a light-threshold filter first.
+        //
+        // computeFov() diffs against last turn's *filtered* flags, so every dark tile in
+        // view shows up as lit by it and then hidden again by the filter. Only the net
+        // result counts as a fog update; the previous update is put back when nothing
+        // changed, so a still darkness turn leaves fovRevision alone. (It is copied, not
+        // moved: computeFov() syncs the tile planes, which may still need it.)
+        const uint32_t fogRevision = dung.fovRevision;
+        std::vector<int> prevChanges = dung.fovChanges;
         dung.computeFov(p.pos.x, p.pos.y, radius, false);
+        std::vector<int> raw;
+        if (dung.fovRevision != fogRevision) raw.swap(dung.fovChanges);
 
         // Then apply a light threshold: only tiles lit above a minimum are visible.
+        // computeFov() leaves every visible tile inside dung.fovX0..fovX1 x fovY0..fovY1.
+        // Both lists come out in ascending index order (row-major scan).
         const float minLight = 0.35f;
-        for (int y = 0; y < dung.height; ++y) {
-            for (int x = 0; x < dung.width; ++x) {
-                if (!dung.at(x, y).visible) continue;
+        std::vector<int> hidden;
+        std::vector<int> explored;
+        for (int y = dung.fovY0; y <= dung.fovY1; ++y) {
+            for (int x = dung.fovX0; x <= dung.fovX1; ++x) {
+                Tile& t = dung.at(x, y);
+                if (!t.visible) continue;
 
                 // lightMap_ stores 0..255 brightness per-tile.
                 const size_t i = static_cast<size_t>(y * dung.width + x);
                 const float lit = (i < lightMap_.size()) ? (static_cast<float>(lightMap_[i]) / 255.0f) : 0.0f;
                 if (lit < minLight) {
-                    dung.at(x, y).visible = false;
+                    t.visible = false;
+                    hidden.push_back(static_cast<int>(i));
+                } else if (!t.explored) {
+                    // Mark explored tiles after darkness filtering.
+                    t.explored = true;
+                    explored.push_back(static_cast<int>(i));
                 }
             }
         }
 
-        // Mark explored tiles after darkness filtering.
-        for (int y = 0; y < dung.height; ++y) {
-            for (int x = 0; x < dung.width; ++x) {
-                if (dung.at(x, y).visible) {
-                    dung.at(x, y).explored = true;
-                }
-            }
+        // A tile both lit by computeFov() and hidden by the filter ends where it started;
+        // one hidden without being lit was visible last turn.
+        std::sort(raw.begin(), raw.end());
+        std::vector<int> net;
+        std::set_symmetric_difference(raw.begin(), raw.end(), hidden.begin(), hidden.end(), std::back_inserter(net));
+        const size_t mid = net.size();
+        std::set_difference(explored.begin(), explored.end(), raw.begin(), raw.end(), std::back_inserter(net));
+        std::inplace_merge(net.begin(), net.begin() + static_cast<std::ptrdiff_t>(mid), net.end());
+
+        if (net.empty()) {
+            dung.fovChanges.swap(prevChanges);
+            dung.fovRevision = fogRevision;
+        } else {
+            dung.fovChanges.swap(net);
+            dung.fovRevision = fogRevision + 1u;
         }
     }
 
@@ -609,6 +554,48 @@ uint8_t Game::corrosiveGasAt(int x, int y) const {
 }
 
 
+const MonsterNavGrid& Game::monsterNavGrid() const {
+    monsterNav_.sync(dung, trapsCur);
+    return monsterNav_;
+}
+
+const hazard::HazardPlanes& Game::hazardPlanes() const {
+    hazardPlanes_.sync(dung);
+    return hazardPlanes_;
+}
+
+void Game::markHazard(const std::vector<uint8_t>& field, int x, int y, int radius) {
+    if (&field == &confusionGas_) confusionActive_.include(x, y, radius);
+    else if (&field == &poisonGas_) poisonActive_.include(x, y, radius);
+    else if (&field == &corrosiveGas_) corrosiveActive_.include(x, y, radius);
+    else if (&field == &fireField_) fireActive_.include(x, y, radius);
+    else if (&field == &scentField_) scentActive_.include(x, y, radius);
+}
+
+void Game::resetHazardActivity() {
+    confusionActive_ = hazard::ActiveRect{};
+    poisonActive_ = hazard::ActiveRect{};
+    corrosiveActive_ = hazard::ActiveRect{};
+    fireActive_ = hazard::ActiveRect{};
+    scentActive_ = hazard::ActiveRect{};
+}
+
+bool Game::validateHazardActivity() const {
+    const std::pair<const std::vector<uint8_t>*, const hazard::ActiveRect*> fields[] = {
+        {&confusionGas_, &confusionActive_}, {&poisonGas_, &poisonActive_}, {&corrosiveGas_, &corrosiveActive_},
+        {&fireField_, &fireActive_},         {&scentField_, &scentActive_},
+    };
+    const int w = dung.width;
+    if (w <= 0) return true;
+    for (const auto& [field, active] : fields) {
+        for (size_t i = 0; i < field->size(); ++i) {
+            if ((*field)[i] == 0u) continue;
+            if (!active->contains(static_cast<int>(i) % w, static_cast<int>(i) / w)) return false;
+        }
+    }
+    return true;
+}
+
 uint8_t Game::fireAt(int x, int y) const {
     if (!dung.inBounds(x, y)) return uint8_t{0};
     const size_t i = static_cast<size_t>(y * dung.width + x);
@@ -665,8 +652,6 @@ void Game::updateScentMap() {
         deposit = static_cast<uint8_t>(d);
     }
 
-    // Use the shared helper so we can unit-test the logic and keep it consistent
-    // across gameplay and headless builds.
     ScentFieldParams params;
     params.baseDecay = 2;
     params.baseSpreadDrop = 14;
@@ -676,23 +661,9 @@ void Game::updateScentMap() {
     params.windDir = windDir();
     params.windStrength = windStrength();
 
-    auto isWalkable = [&](int x, int y) -> bool {
-        return dung.inBounds(x, y) && dung.isWalkable(x, y);
-    };
-
-    auto fxAt = [&](int x, int y) -> ScentCellFx {
-        const TerrainMaterial m = dung.materialAtCached(x, y);
-        const TerrainMaterialFx matFx = terrainMaterialFx(m);
-        const EcosystemKind eco = dung.ecosystemAtCached(x, y);
-        const EcosystemFx ecoFx = ecosystemFx(eco);
-
-        ScentCellFx out;
-        out.decayDelta = matFx.scentDecayDelta + ecoFx.scentDecayDelta;
-        out.spreadDropDelta = matFx.scentSpreadDropDelta + ecoFx.scentSpreadDropDelta;
-        return out;
-    };
-
-    updateScentField(W, H, scentField_, p.pos, deposit, isWalkable, fxAt, params);
+    // Walkability and the material/ecosystem deltas come from the cached hazard planes;
+    // the kernel matches updateScentField() bit for bit.
+    hazard::updateScent(hazardPlanes(), scentField_, scentActive_, p.pos, deposit, params, hazardScratch_);
 }
 
 uint8_t Game::scentAt(int x, int y) const {
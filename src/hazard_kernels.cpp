@@ -0,0 +1,506 @@
+#include "hazard_kernels.hpp"
+
+#include "dungeon.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PROCROGUE_HAZARD_SSE2 1
+#include <emmintrin.h>
+#else
+#define PROCROGUE_HAZARD_SSE2 0
+#endif
+
+namespace hazard {
+
+namespace {
+
+// Substrate chemistry: porous materials absorb fumes; smooth sealed surfaces let
+// vapors drift a little farther; corrosive vapor condenses on some stone/metal.
+int gasAbsorb(TerrainMaterial m) {
+    switch (m) {
+        case TerrainMaterial::Moss:
+        case TerrainMaterial::Dirt:
+        case TerrainMaterial::Wood:
+        case TerrainMaterial::Bone:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int gasSlick(TerrainMaterial m) {
+    switch (m) {
+        case TerrainMaterial::Metal:
+        case TerrainMaterial::Crystal:
+        case TerrainMaterial::Obsidian:
+        case TerrainMaterial::Marble:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int gasSticky(TerrainMaterial m) {
+    return (m == TerrainMaterial::Metal || m == TerrainMaterial::Obsidian || m == TerrainMaterial::Basalt) ? 1 : 0;
+}
+
+uint8_t u8(int v) { return static_cast<uint8_t>(std::clamp(v, 0, 255)); }
+int8_t i8(int v) { return static_cast<int8_t>(std::clamp(v, -128, 127)); }
+
+// Lane operations. Flags are 0x00/0xFF masks; arithmetic saturates like _mm_*s_epu8.
+struct ScalarOps {
+    using V = uint8_t;
+    static constexpr size_t kLanes = 1;
+    static V load(const uint8_t* p) { return *p; }
+    static void store(uint8_t* p, V v) { *p = v; }
+    static V splat(uint8_t v) { return v; }
+    static V subs(V a, V b) { return static_cast<V>(a > b ? a - b : 0); }
+    static V adds(V a, V b) { return static_cast<V>(std::min(255, a + b)); }
+    static V min(V a, V b) { return a < b ? a : b; }
+    static V max(V a, V b) { return a < b ? b : a; }
+    static V and_(V a, V b) { return static_cast<V>(a & b); }
+    static V andNot(V a, V b) { return static_cast<V>(~a & b); } // ~a & b
+    static V or_(V a, V b) { return static_cast<V>(a | b); }
+    static V ge(V a, V b) { return static_cast<V>(a >= b ? 0xFFu : 0u); }
+};
+
+#if PROCROGUE_HAZARD_SSE2
+struct Sse2Ops {
+    using V = __m128i;
+    static constexpr size_t kLanes = 16;
+    static V load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint8_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V splat(uint8_t v) { return _mm_set1_epi8(static_cast<char>(v)); }
+    static V subs(V a, V b) { return _mm_subs_epu8(a, b); }
+    static V adds(V a, V b) { return _mm_adds_epu8(a, b); }
+    static V min(V a, V b) { return _mm_min_epu8(a, b); }
+    static V max(V a, V b) { return _mm_max_epu8(a, b); }
+    static V and_(V a, V b) { return _mm_and_si128(a, b); }
+    static V andNot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V or_(V a, V b) { return _mm_or_si128(a, b); }
+    static V ge(V a, V b) { return _mm_cmpeq_epi8(_mm_max_epu8(a, b), a); }
+};
+#endif
+
+// Runs body(ops, i) over [0, n): full vectors first, then the scalar tail.
+template <typename Body>
+void forLanes(size_t n, const Body& body) {
+    size_t i = 0;
+#if PROCROGUE_HAZARD_SSE2
+    for (; i + Sse2Ops::kLanes <= n; i += Sse2Ops::kLanes) body(Sse2Ops{}, i);
+#endif
+    for (; i < n; ++i) body(ScalarOps{}, i);
+}
+
+// v + a clamped to 0..cap, with the signed adjustment split into add/sub bytes (at most
+// one of which is non-zero) and v <= cap on entry.
+template <typename O>
+typename O::V adjust(typename O::V v, typename O::V add, typename O::V sub, typename O::V cap) {
+    return O::min(O::subs(O::adds(v, add), sub), cap);
+}
+
+uint8_t posPart(int v) { return u8(v); }
+uint8_t negPart(int v) { return u8(-v); }
+
+} // namespace
+
+bool simdEnabled() { return PROCROGUE_HAZARD_SSE2 != 0; }
+
+void HazardPlanes::resize(int w, int h) {
+    w_ = w;
+    h_ = h;
+    const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
+    walkable_.assign(n, uint8_t{0});
+    gasOpen_.assign(n, uint8_t{0});
+    chasm_.assign(n, uint8_t{0});
+    for (GasCoeffs& g : gas_) {
+        g.decay.assign(n, uint8_t{0});
+        g.boost.assign(n, uint8_t{0});
+        g.spreadAdd.assign(n, uint8_t{0});
+        g.spreadSub.assign(n, uint8_t{0});
+    }
+    fireDecay_.assign(n, uint8_t{0});
+    fireBoost_.assign(n, uint8_t{0});
+    scentDecay_.assign(n, int8_t{0});
+    scentDrop_.assign(n, int8_t{0});
+}
+
+void HazardPlanes::update(const Dungeon& d, int i) {
+    const size_t ii = static_cast<size_t>(i);
+    const int x = i % w_;
+    const int y = i / w_;
+    const TileType t = d.tiles[ii].type;
+    const bool walk = TilePlanes::walkableType(t);
+    const bool pit = (t == TileType::Chasm);
+    walkable_[ii] = walk ? 0xFFu : 0u;
+    chasm_[ii] = pit ? 0xFFu : 0u;
+    gasOpen_[ii] = (walk || pit) ? 0xFFu : 0u;
+
+    const TerrainMaterial mat = d.materialAtCached(x, y);
+    const EcosystemFx eco = ecosystemFx(d.ecosystemAtCached(x, y));
+    const int absorb = gasAbsorb(mat);
+
+    auto setGas = [&](Gas g, int decay, int quench, int spread) {
+        GasCoeffs& c = gas_[static_cast<int>(g)];
+        c.decay[ii] = u8(decay + std::max(0, quench));
+        c.boost[ii] = u8(-quench);
+        c.spreadAdd[ii] = posPart(spread);
+        c.spreadSub[ii] = negPart(spread);
+    };
+    // Light haze also disperses quickly over open pits.
+    setGas(Gas::Confusion, 1 + absorb + (pit ? 1 : 0), eco.confusionGasQuenchDelta,
+           -absorb + gasSlick(mat) + eco.confusionGasSpreadDelta);
+    setGas(Gas::Poison, 1 + absorb, eco.poisonGasQuenchDelta, -absorb + gasSlick(mat) + eco.poisonGasSpreadDelta);
+    setGas(Gas::Corrosive, 1 + absorb, eco.corrosiveGasQuenchDelta,
+           -absorb - gasSticky(mat) + eco.corrosiveGasSpreadDelta);
+
+    fireDecay_[ii] = u8(eco.fireQuenchDelta);
+    fireBoost_[ii] = u8(-eco.fireQuenchDelta);
+
+    const TerrainMaterialFx mfx = terrainMaterialFx(mat);
+    scentDecay_[ii] = i8(mfx.scentDecayDelta + eco.scentDecayDelta);
+    scentDrop_[ii] = i8(mfx.scentSpreadDropDelta + eco.scentSpreadDropDelta);
+}
+
+void HazardPlanes::rebuild(const Dungeon& d) {
+    resize(std::max(0, d.width), std::max(0, d.height));
+    const int n = w_ * h_;
+    for (int i = 0; i < n; ++i) update(d, i);
+
+    epoch_ = d.terrainEpoch;
+    journalPos_ = d.terrainJournal.size();
+    materialRevision_ = d.materialRevision;
+    valid_ = true;
+}
+
+void HazardPlanes::sync(const Dungeon& d) {
+    const size_t n = static_cast<size_t>(std::max(0, d.width)) * static_cast<size_t>(std::max(0, d.height));
+    if (d.tiles.size() != n) {
+        clear();
+        return;
+    }
+
+    if (!valid_ || d.width != w_ || d.height != h_ || d.terrainEpoch != epoch_ ||
+        d.materialRevision != materialRevision_ || journalPos_ > d.terrainJournal.size()) {
+        rebuild(d);
+        return;
+    }
+
+    for (size_t j = journalPos_; j < d.terrainJournal.size(); ++j) {
+        const int i = d.terrainJournal[j];
+        if (i >= 0 && static_cast<size_t>(i) < n) update(d, i);
+    }
+    journalPos_ = d.terrainJournal.size();
+}
+
+void HazardPlanes::clear() {
+    for (GasCoeffs& g : gas_) {
+        std::vector<uint8_t>().swap(g.decay);
+        std::vector<uint8_t>().swap(g.boost);
+        std::vector<uint8_t>().swap(g.spreadAdd);
+        std::vector<uint8_t>().swap(g.spreadSub);
+    }
+    std::vector<uint8_t>().swap(walkable_);
+    std::vector<uint8_t>().swap(gasOpen_);
+    std::vector<uint8_t>().swap(chasm_);
+    std::vector<uint8_t>().swap(fireDecay_);
+    std::vector<uint8_t>().swap(fireBoost_);
+    std::vector<int8_t>().swap(scentDecay_);
+    std::vector<int8_t>().swap(scentDrop_);
+    w_ = 0;
+    h_ = 0;
+    valid_ = false;
+}
+
+size_t HazardPlanes::memoryBytes() const {
+    size_t n = walkable_.capacity() + gasOpen_.capacity() + chasm_.capacity() + fireDecay_.capacity() +
+               fireBoost_.capacity() + scentDecay_.capacity() + scentDrop_.capacity();
+    for (const GasCoeffs& g : gas_) {
+        n += g.decay.capacity() + g.boost.capacity() + g.spreadAdd.capacity() + g.spreadSub.capacity();
+    }
+    return n;
+}
+
+void ActiveRect::include(int x, int y, int radius) {
+    if (empty()) {
+        x0 = x - radius;
+        y0 = y - radius;
+        x1 = x + radius;
+        y1 = y + radius;
+        return;
+    }
+    x0 = std::min(x0, x - radius);
+    y0 = std::min(y0, y - radius);
+    x1 = std::max(x1, x + radius);
+    y1 = std::max(y1, y + radius);
+}
+
+ActiveRect ActiveRect::clipped(int w, int h, int halo) const {
+    if (empty()) return none();
+    ActiveRect r;
+    r.x0 = std::max(0, x0 - halo);
+    r.y0 = std::max(0, y0 - halo);
+    r.x1 = std::min(w - 1, std::min(x1, kUnbounded) + halo);
+    r.y1 = std::min(h - 1, std::min(y1, kUnbounded) + halo);
+    return r;
+}
+
+ActiveRect tightBounds(const std::vector<uint8_t>& field, int w, const ActiveRect& within) {
+    ActiveRect out = ActiveRect::none();
+    for (int y = within.y0; y <= within.y1; ++y) {
+        const uint8_t* row = field.data() + static_cast<size_t>(y) * static_cast<size_t>(w);
+        int first = within.x0;
+        while (first <= within.x1 && row[first] == 0u) ++first;
+        if (first > within.x1) continue;
+        int last = within.x1;
+        while (row[last] == 0u) --last;
+        out.include(first, y);
+        out.include(last, y);
+    }
+    return out;
+}
+
+void diffuseGas(const HazardPlanes& p, Gas g, const GasRule& rule, std::vector<uint8_t>& field,
+                ActiveRect& active, std::vector<uint8_t>& scratch) {
+    const int w = p.width();
+    const int h = p.height();
+    const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
+    if (n == 0 || field.size() != n) return;
+    if (active.clipped(w, h).empty()) {
+        active = ActiveRect::none();
+        return;
+    }
+
+    // Everything outside the box is 0 and nothing can reach past its one-tile halo, so
+    // the passes only cover `r`.
+    const ActiveRect r = active.clipped(w, h, 1);
+    const size_t rw = static_cast<size_t>(r.x1 - r.x0 + 1);
+
+    // Sources go to three planes with a one-tile zero border, so neighbor reads never
+    // leave the buffer and sources outside `r` contribute nothing (their cap is 0).
+    const size_t pw = rw + 2u;
+    const size_t pn = pw * static_cast<size_t>(r.y1 - r.y0 + 3);
+    scratch.assign(pn * 3, uint8_t{0});
+    uint8_t* basePad = scratch.data();
+    uint8_t* capPad = basePad + pn;
+    uint8_t* pitPad = capPad + pn;
+    auto padRow = [&](int y) { return static_cast<size_t>(y - r.y0 + 1) * pw + 1u; };
+    auto fieldRow = [&](int y) { return static_cast<size_t>(y) * static_cast<size_t>(w) + static_cast<size_t>(r.x0); };
+
+    const HazardPlanes::GasCoeffs& c = p.gas(g);
+    const uint8_t* open = p.gasOpen();
+    const uint8_t* pit = p.chasm();
+    const uint8_t keep = u8(rule.keep);
+    const uint8_t minSpread = u8(rule.keep + 1);
+
+    // Pass 1: decay in place, and record each tile's spread power (0 unless it spreads).
+    for (int y = r.y0; y <= r.y1; ++y) {
+        const size_t row = fieldRow(y);
+        const size_t prow = padRow(y);
+        forLanes(rw, [&](auto ops, size_t x) {
+            using O = decltype(ops);
+            const size_t i = row + x;
+            const typename O::V s = O::load(&field[i]);
+            const typename O::V isOpen = O::load(open + i);
+            const typename O::V spreads = O::and_(isOpen, O::ge(s, O::splat(minSpread)));
+
+            const typename O::V power = adjust<O>(O::subs(s, O::splat(keep)), O::load(&c.spreadAdd[i]),
+                                                  O::load(&c.spreadSub[i]), s);
+            O::store(basePad + prow + x, O::and_(power, spreads));
+            O::store(capPad + prow + x, O::and_(s, spreads));
+            O::store(pitPad + prow + x, O::load(pit + i));
+
+            typename O::V self = O::subs(s, O::load(&c.decay[i]));
+            self = O::adds(self, O::and_(O::load(&c.boost[i]), O::ge(s, O::splat(8u))));
+            O::store(&field[i], O::and_(self, isOpen));
+        });
+    }
+
+    // Pass 2: every open tile takes the strongest push from its four neighbors.
+    struct Source {
+        int dx;
+        int dy;
+        uint8_t windAdd;
+        uint8_t windSub;
+    };
+    Source sources[4] = {{-1, 0, 0, 0}, {1, 0, 0, 0}, {0, -1, 0, 0}, {0, 1, 0, 0}};
+    for (Source& s : sources) {
+        // Travel direction is source -> tile, i.e. the negated offset.
+        if (-s.dx == rule.wind.x && -s.dy == rule.wind.y) {
+            s.windAdd = posPart(rule.windBonus);
+            s.windSub = negPart(rule.windBonus);
+        } else if (s.dx == rule.wind.x && s.dy == rule.wind.y) {
+            s.windAdd = negPart(rule.windBonus);
+            s.windSub = posPart(rule.windBonus);
+        }
+    }
+    const uint8_t intoAdd = posPart(rule.intoChasm);
+    const uint8_t intoSub = negPart(rule.intoChasm);
+    const uint8_t outAdd = posPart(rule.outOfChasm);
+    const uint8_t outSub = negPart(rule.outOfChasm);
+    const std::ptrdiff_t pws = static_cast<std::ptrdiff_t>(pw);
+
+    for (int y = r.y0; y <= r.y1; ++y) {
+        const size_t row = fieldRow(y);
+        const size_t prow = padRow(y);
+        forLanes(rw, [&](auto ops, size_t x) {
+            using O = decltype(ops);
+            const size_t i = row + x;
+            const typename O::V pj = O::load(pit + i);
+            typename O::V best = O::load(&field[i]);
+            for (const Source& s : sources) {
+                const size_t k = static_cast<size_t>(static_cast<std::ptrdiff_t>(prow + x) + s.dy * pws + s.dx);
+                const typename O::V cap = O::load(capPad + k);
+                const typename O::V pi = O::load(pitPad + k);
+                typename O::V v = adjust<O>(O::load(basePad + k), O::splat(s.windAdd), O::splat(s.windSub), cap);
+
+                const typename O::V into = O::andNot(pi, pj);
+                const typename O::V out = O::andNot(pj, pi);
+                const typename O::V add = O::or_(O::and_(into, O::splat(intoAdd)), O::and_(out, O::splat(outAdd)));
+                const typename O::V sub = O::or_(O::and_(into, O::splat(intoSub)), O::and_(out, O::splat(outSub)));
+                best = O::max(best, adjust<O>(v, add, sub, cap));
+            }
+            O::store(&field[i], O::and_(best, O::load(open + i)));
+        });
+    }
+
+    active = tightBounds(field, w, r);
+}
+
+void decayFire(const HazardPlanes& p, int quench, const std::vector<uint8_t>& field, std::vector<uint8_t>& next,
+               ActiveRect& active) {
+    const int w = p.width();
+    const int h = p.height();
+    const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
+    next.assign(field.size(), uint8_t{0});
+    if (n == 0 || field.size() != n) return;
+
+    const ActiveRect r = active.clipped(w, h);
+    if (r.empty()) {
+        active = ActiveRect::none();
+        return;
+    }
+
+    const uint8_t base = u8(1 + quench);
+    const uint8_t* walk = p.walkable();
+    const uint8_t* eco = p.fireDecay();
+    const uint8_t* boost = p.fireBoost();
+    for (int y = r.y0; y <= r.y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * static_cast<size_t>(w) + static_cast<size_t>(r.x0);
+        forLanes(static_cast<size_t>(r.x1 - r.x0 + 1), [&](auto ops, size_t x) {
+            using O = decltype(ops);
+            const size_t i = row + x;
+            const typename O::V s = O::load(&field[i]);
+            typename O::V self = O::subs(s, O::adds(O::splat(base), O::load(eco + i)));
+            // In hot/dry regions, strong fires linger a bit longer before guttering out.
+            self = O::adds(self, O::and_(O::load(boost + i), O::ge(s, O::splat(6u))));
+            O::store(&next[i], O::and_(self, O::load(walk + i)));
+        });
+    }
+
+    active = tightBounds(next, w, r);
+}
+
+void updateScent(const HazardPlanes& p, std::vector<uint8_t>& field, ActiveRect& active, Vec2i depositPos,
+                 uint8_t depositStrength, const ScentFieldParams& params, std::vector<uint8_t>& scratch) {
+    const int w = p.width();
+    const int h = p.height();
+    const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
+    if (n == 0) return;
+    if (field.size() != n) {
+        field.assign(n, uint8_t{0});
+        active = ActiveRect::none();
+    }
+
+    const uint8_t* walk = p.walkable();
+    const int8_t* decayDelta = p.scentDecayDelta();
+    const int8_t* dropDelta = p.scentDropDelta();
+
+    const bool depositing = depositStrength > uint8_t{0} && depositPos.x >= 0 && depositPos.y >= 0 &&
+                            depositPos.x < w && depositPos.y < h;
+    if (depositing) active.include(depositPos.x, depositPos.y);
+    const ActiveRect a = active.clipped(w, h);
+    if (a.empty()) {
+        active = ActiveRect::none();
+        return;
+    }
+    const ActiveRect r = active.clipped(w, h, 1);
+    const size_t rw = static_cast<size_t>(r.x1 - r.x0 + 1);
+
+    // Per-row derived bytes over `r`: the decay and the four spread drops (clamped like
+    // updateScentField(), then truncated to a byte the same way).
+    std::vector<uint8_t> rowBuf(rw * 5u);
+    uint8_t* decayRow = rowBuf.data();
+    uint8_t* dropRow[4] = {decayRow + rw, decayRow + 2 * rw, decayRow + 3 * rw, decayRow + 4 * rw};
+    auto fieldRow = [&](int y, int x0) { return static_cast<size_t>(y) * static_cast<size_t>(w) + static_cast<size_t>(x0); };
+
+    // Phase 1: global decay (non-walkable tiles are cleared). Only `a` holds scent.
+    const size_t aw = static_cast<size_t>(a.x1 - a.x0 + 1);
+    for (int y = a.y0; y <= a.y1; ++y) {
+        const size_t row = fieldRow(y, a.x0);
+        for (size_t x = 0; x < aw; ++x) {
+            decayRow[x] = static_cast<uint8_t>(clampi(params.baseDecay + decayDelta[row + x], 0, params.maxDecay));
+        }
+        forLanes(aw, [&](auto ops, size_t x) {
+            using O = decltype(ops);
+            const typename O::V v = O::subs(O::load(&field[row + x]), O::load(decayRow + x));
+            O::store(&field[row + x], O::and_(v, O::load(walk + row + x)));
+        });
+    }
+
+    // Phase 2: deposit at source.
+    if (depositing) {
+        const size_t pi = fieldRow(depositPos.y, depositPos.x);
+        if (walk[pi]) field[pi] = std::max(field[pi], depositStrength);
+    }
+
+    // Phase 3: one relaxation pass over `r` from a zero-bordered copy.
+    const size_t pw = rw + 2u;
+    scratch.assign(pw * static_cast<size_t>(r.y1 - r.y0 + 3), uint8_t{0});
+    for (int y = r.y0; y <= r.y1; ++y) {
+        std::copy_n(field.data() + fieldRow(y, r.x0), rw, scratch.data() + static_cast<size_t>(y - r.y0 + 1) * pw + 1u);
+    }
+
+    const bool windy = (params.windStrength > 0) && !(params.windDir.x == 0 && params.windDir.y == 0);
+    constexpr int kOffsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    int windAdj[4] = {0, 0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        // Scent travels from the neighbor to the tile: the negated offset.
+        const int tdx = -kOffsets[k][0];
+        const int tdy = -kOffsets[k][1];
+        if (!windy) continue;
+        if (tdx == params.windDir.x && tdy == params.windDir.y) {
+            windAdj[k] = -params.tailwindDropBiasPerStrength * params.windStrength;
+        } else if (tdx == -params.windDir.x && tdy == -params.windDir.y) {
+            windAdj[k] = params.headwindDropBiasPerStrength * params.windStrength;
+        }
+    }
+    const std::ptrdiff_t pws = static_cast<std::ptrdiff_t>(pw);
+
+    for (int y = r.y0; y <= r.y1; ++y) {
+        const size_t row = fieldRow(y, r.x0);
+        const size_t prow = static_cast<size_t>(y - r.y0 + 1) * pw + 1u;
+        for (size_t x = 0; x < rw; ++x) {
+            const int baseDrop = params.baseSpreadDrop + dropDelta[row + x];
+            for (int k = 0; k < 4; ++k) {
+                dropRow[k][x] = static_cast<uint8_t>(
+                    clampi(baseDrop + windAdj[k], params.minSpreadDrop, params.maxSpreadDrop));
+            }
+        }
+        forLanes(rw, [&](auto ops, size_t x) {
+            using O = decltype(ops);
+            typename O::V best = O::load(&field[row + x]);
+            for (int k = 0; k < 4; ++k) {
+                const size_t j = static_cast<size_t>(static_cast<std::ptrdiff_t>(prow + x) + kOffsets[k][1] * pws +
+                                                     kOffsets[k][0]);
+                best = O::max(best, O::subs(O::load(scratch.data() + j), O::load(dropRow[k] + x)));
+            }
+            O::store(&field[row + x], O::and_(best, O::load(walk + row + x)));
+        });
+    }
+
+    active = tightBounds(field, w, r);
+}
+
+} // namespace hazard
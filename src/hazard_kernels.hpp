@@ -0,0 +1,155 @@
+#pragma once
+
+// Row kernels for the per-turn hazard field updates (Game::applyEndOfTurnEffects(),
+// Game::updateScentMap()).
+//
+// The gas/fire/scent passes used to walk every tile and ask the Dungeon for the tile
+// type, material and ecosystem of the tile (and its neighbors) on the way. Everything
+// they ask depends on the floor only, so HazardPlanes keeps the answers as per-tile
+// byte planes, and the passes become straight-line byte arithmetic over rows:
+//   - Gas spread is computed "gather" style: each tile takes the max of its own decayed
+//     value and what its four neighbors push into it. That is the same max the old
+//     scatter loop produced, but every output byte is written once.
+//   - All arithmetic is saturating unsigned byte math (subs/adds/min/max + masks), so
+//     one kernel body runs either 16 lanes at a time (SSE2) or one lane at a time
+//     (scalar tail, non-x86 builds). Results are bit-identical to the old loops.
+//   - Fire spread draws from the game RNG in scan order and stays a scalar pass; only
+//     its decay runs here.
+//
+// HazardPlanes follows the Dungeon like AcousticGrid does: terrain edits replay
+// Dungeon::terrainJournal; a new epoch, a resize or a rebuilt material/ecosystem cache
+// (Dungeon::materialRevision) re-derives everything.
+//
+// Most of a field is zero most of the time, so every kernel also takes the field's
+// ActiveRect: only the box plus a one-tile halo (where spread can reach) is visited, and
+// the box is shrunk to the nonzero tiles of the result. An empty box costs nothing.
+
+#include "scent_field.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Dungeon;
+
+namespace hazard {
+
+enum class Gas : uint8_t {
+    Confusion = 0,
+    Poison,
+    Corrosive,
+};
+inline constexpr int kGasCount = 3;
+
+// Inclusive bounding box of the nonzero tiles of a field; everything outside it is 0.
+// A default-constructed box is unbounded ("not tracked yet"): the next kernel pass sweeps
+// the whole field once and tightens it.
+struct ActiveRect {
+    static constexpr int kUnbounded = 1 << 28;
+
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = kUnbounded;
+    int y1 = kUnbounded;
+
+    static ActiveRect none() {
+        ActiveRect r;
+        r.x1 = -1;
+        r.y1 = -1;
+        return r;
+    }
+
+    bool empty() const { return x1 < x0 || y1 < y0; }
+    bool contains(int x, int y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+
+    // Grows the box to cover the square of `radius` around (x, y).
+    void include(int x, int y, int radius = 0);
+
+    // This box grown by `halo` and clipped to a w x h map (possibly empty).
+    ActiveRect clipped(int w, int h, int halo = 0) const;
+};
+
+// The bounding box of the nonzero bytes of a w-wide field inside `within`.
+ActiveRect tightBounds(const std::vector<uint8_t>& field, int w, const ActiveRect& within);
+
+class HazardPlanes {
+public:
+    // One byte per tile: flags are 0x00/0xFF lane masks, coefficients are small counts.
+    struct GasCoeffs {
+        std::vector<uint8_t> decay;     // in-place decay per turn
+        std::vector<uint8_t> boost;     // re-added to dense (>= 8) tiles where clouds linger
+        std::vector<uint8_t> spreadAdd; // per-tile spread power delta, split by sign
+        std::vector<uint8_t> spreadSub;
+    };
+
+    // Brings every plane up to date with `d`. Cheap when nothing changed.
+    void sync(const Dungeon& d);
+
+    // Releases the planes; the next sync() rebuilds from scratch.
+    void clear();
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    const uint8_t* walkable() const { return walkable_.data(); }
+    const uint8_t* gasOpen() const { return gasOpen_.data(); } // walkable or chasm
+    const uint8_t* chasm() const { return chasm_.data(); }
+    const GasCoeffs& gas(Gas g) const { return gas_[static_cast<int>(g)]; }
+    const uint8_t* fireDecay() const { return fireDecay_.data(); } // ecosystem part only
+    const uint8_t* fireBoost() const { return fireBoost_.data(); }
+    const int8_t* scentDecayDelta() const { return scentDecay_.data(); }
+    const int8_t* scentDropDelta() const { return scentDrop_.data(); }
+
+    size_t memoryBytes() const;
+
+private:
+    void resize(int w, int h);
+    void rebuild(const Dungeon& d);
+    void update(const Dungeon& d, int i);
+
+    std::vector<uint8_t> walkable_;
+    std::vector<uint8_t> gasOpen_;
+    std::vector<uint8_t> chasm_;
+    GasCoeffs gas_[kGasCount];
+    std::vector<uint8_t> fireDecay_;
+    std::vector<uint8_t> fireBoost_;
+    std::vector<int8_t> scentDecay_;
+    std::vector<int8_t> scentDrop_;
+
+    int w_ = 0;
+    int h_ = 0;
+    uint32_t epoch_ = 0u;
+    size_t journalPos_ = 0;
+    uint32_t materialRevision_ = 0u;
+    bool valid_ = false;
+};
+
+// The per-gas constants of the spread rule. A source tile s spreads when s >= keep + 1,
+// with power clamp(s - keep + tile delta, 0, s); each step into a neighbor then adds the
+// wind and chasm adjustments (each clamped to 0..s).
+struct GasRule {
+    int keep = 2;
+    int windBonus = 0; // + downwind, - upwind
+    Vec2i wind{0, 0};
+    int intoChasm = 0;  // spreading from solid ground into a chasm
+    int outOfChasm = 0; // spreading out of a chasm onto solid ground
+};
+
+// One decay + spread step of a gas field. `scratch` is reused between calls.
+void diffuseGas(const HazardPlanes& p, Gas g, const GasRule& rule, std::vector<uint8_t>& field,
+                ActiveRect& active, std::vector<uint8_t>& scratch);
+
+// Decay of the fire field into `next` (the spread pass is left to the caller):
+// next = walkable ? s - (1 + quench + eco decay), plus the linger boost for s >= 6 : 0.
+// `active` is updated to cover `next`.
+void decayFire(const HazardPlanes& p, int quench, const std::vector<uint8_t>& field, std::vector<uint8_t>& next,
+               ActiveRect& active);
+
+// updateScentField() over HazardPlanes (walkability + combined material/ecosystem fx).
+void updateScent(const HazardPlanes& p, std::vector<uint8_t>& field, ActiveRect& active, Vec2i depositPos,
+                 uint8_t depositStrength, const ScentFieldParams& params, std::vector<uint8_t>& scratch);
+
+// True when the vector path is compiled in (diagnostics/tests).
+bool simdEnabled();
+
+} // namespace hazard
@@ -1,14 +1,18 @@
 #include "replay.hpp"
 #include "replay_runner.hpp"
 #include "content.hpp"
+#include "thread_pool.hpp"
 #include "version.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -17,14 +21,25 @@ static void printUsage(const char* argv0) {
     std::cout
         << "Usage:\n"
         << "  " << argv0 << " --replay <file.prr> [options]\n"
-        << "  " << argv0 << " --replay-dir <dir> [options]\n\n"
+        << "  " << argv0 << " --replay-dir <dir> [options]\n"
+        << "  " << argv0 << " --convert <in> <out>\n\n"
         << "Options:\n"
         << "  --replay <path>         Replay file to verify/play headlessly.\n"
-        << "  --replay-dir <path>     Verify all .prr files in a directory (non-recursive).\n"
+        << "  --replay-dir <path>     Verify all .prr/.prrb files in a directory (non-recursive).\n"
+        << "  --convert <in> <out>    Convert a replay between the text (.prr) and binary (.prrb) encodings;\n"
+        << "                          the output encoding follows the <out> extension.\n"
+        << "  --until-turn <n>        Stop each replay once turn n is reached (binary replays only load that far).\n"
+        << "  --snapshot-every <n>    Keep an in-memory snapshot every n turns; a replay that desyncs is re-run\n"
+        << "                          from the last snapshot before the failure to confirm it reproduces.\n"
+        << "  --bisect                With --replay: find the first divergent checkpoint and the subsystems\n"
+        << "                          that changed on that turn (snapshot interval: --snapshot-every, default 200).\n"
         << "  --stop-after-first-fail Stop after the first failing replay in --replay-dir mode.\n"
+        << "  --jobs <n>              In --replay-dir mode, verify up to n replays in parallel (0 = all cores).\n"
+        << "                          Results are reported in file order, as with --jobs 1 (default).\n"
         << "  --content <path>        Optional content override INI to load.\n"
         << "  --frame-ms <n>          Fixed simulation step in milliseconds (1..100). Default: 16.\n"
         << "  --no-verify-hashes      Do not verify StateHash checkpoints, even if present.\n"
+        << "  --pregen                Pre-generate the next floor / adjacent chunks in the background (must not change hashes).\n"
         << "  --max-ms <n>            Safety cap for simulated time in ms (0 = auto).\n"
         << "  --max-frames <n>        Safety cap for frames (0 = auto).\n"
         << "  --trim-on-fail <path>   If a single replay fails due to hash mismatch, write a trimmed replay.\n"
@@ -95,7 +110,7 @@ static std::vector<std::filesystem::path> listReplayFiles(const std::filesystem:
         if (ec) break;
         if (!ent.is_regular_file(ec)) continue;
         const std::filesystem::path p = ent.path();
-        if (p.extension() == ".prr") {
+        if (p.extension() == ".prr" || p.extension() == kReplayBinaryExtension) {
             out.push_back(p);
         }
     }
@@ -138,67 +153,30 @@ static bool buildTrimmedReplay(const ReplayFile& src, uint32_t checkpointTurn, R
     return true;
 }
 
-static bool writeReplayFile(const std::filesystem::path& outPath, const ReplayFile& rf, std::string* err) {
-    ReplayWriter w;
-    if (!w.open(outPath, rf.meta, err)) return false;
-
-    for (const auto& ev : rf.events) {
-        switch (ev.kind) {
-            case ReplayEventType::Action:
-                w.writeAction(ev.tMs, ev.action);
-                break;
-            case ReplayEventType::StateHash:
-                w.writeStateHash(ev.tMs, ev.turn, ev.hash);
-                break;
-            case ReplayEventType::TextInput:
-                w.writeTextInput(ev.tMs, ev.text);
-                break;
-            case ReplayEventType::CommandBackspace:
-                w.writeCommandBackspace(ev.tMs);
-                break;
-            case ReplayEventType::CommandAutocomplete:
-                w.writeCommandAutocomplete(ev.tMs);
-                break;
-            case ReplayEventType::MessageHistoryBackspace:
-                w.writeMessageHistoryBackspace(ev.tMs);
-                break;
-            case ReplayEventType::MessageHistoryToggleSearch:
-                w.writeMessageHistoryToggleSearchMode(ev.tMs);
-                break;
-            case ReplayEventType::MessageHistoryClearSearch:
-                w.writeMessageHistoryClearSearch(ev.tMs);
-                break;
-            case ReplayEventType::AutoTravel:
-                w.writeAutoTravel(ev.tMs, ev.pos);
-                break;
-            case ReplayEventType::BeginLook:
-                w.writeBeginLook(ev.tMs, ev.pos);
-                break;
-            case ReplayEventType::TargetCursor:
-                w.writeTargetCursor(ev.tMs, ev.pos);
-                break;
-            case ReplayEventType::LookCursor:
-                w.writeLookCursor(ev.tMs, ev.pos);
-                break;
-        }
-    }
-
-    w.close();
-    return true;
-}
-
 struct ReplayRunResult {
     std::filesystem::path file;
     bool ok = false;
     ReplayRunStats stats;
     std::string error;
     std::filesystem::path trimmedPath;
+    double wallMs = 0.0; // load + prepare + run
+
+    // --snapshot-every: the failure re-run from the snapshot at resumedFromTurn.
+    bool resumed = false;
+    bool reproduced = false;
+    uint32_t resumedFromTurn = 0;
 };
 
+static double turnsPerSec(const ReplayRunResult& r) {
+    return (r.wallMs > 0.0) ? (static_cast<double>(r.stats.turns) * 1000.0 / r.wallMs) : 0.0;
+}
+
 static bool writeJsonReport(const std::filesystem::path& path,
                             const std::vector<ReplayRunResult>& results,
                             const ReplayRunOptions& opt,
                             bool verifyHashes,
+                            uint32_t jobs,
+                            double totalWallMs,
                             std::string* err) {
     std::ofstream f(path);
     if (!f) {
@@ -216,12 +194,15 @@ static bool writeJsonReport(const std::filesystem::path& path,
     f << "    \"frameMs\": " << opt.frameMs << ",\n";
     f << "    \"verifyHashes\": " << (verifyHashes ? "true" : "false") << ",\n";
     f << "    \"maxSimMs\": " << opt.maxSimMs << ",\n";
-    f << "    \"maxFrames\": " << opt.maxFrames << "\n";
+    f << "    \"maxFrames\": " << opt.maxFrames << ",\n";
+    f << "    \"untilTurn\": " << opt.stopAtTurn << ",\n";
+    f << "    \"jobs\": " << jobs << "\n";
     f << "  },\n";
     f << "  \"summary\": {\n";
     f << "    \"total\": " << results.size() << ",\n";
     f << "    \"ok\": " << okCount << ",\n";
-    f << "    \"failed\": " << (results.size() - okCount) << "\n";
+    f << "    \"failed\": " << (results.size() - okCount) << ",\n";
+    f << "    \"wallMs\": " << totalWallMs << "\n";
     f << "  },\n";
     f << "  \"results\": [\n";
 
@@ -233,7 +214,11 @@ static bool writeJsonReport(const std::filesystem::path& path,
         f << "      \"turns\": " << r.stats.turns << ",\n";
         f << "      \"eventsDispatched\": " << r.stats.eventsDispatched << ",\n";
         f << "      \"simulatedMs\": " << r.stats.simulatedMs << ",\n";
-        f << "      \"frames\": " << r.stats.frames;
+        f << "      \"frames\": " << r.stats.frames << ",\n";
+        f << "      \"costCacheHits\": " << r.stats.costCacheHits << ",\n";
+        f << "      \"costCacheMisses\": " << r.stats.costCacheMisses << ",\n";
+        f << "      \"wallMs\": " << r.wallMs << ",\n";
+        f << "      \"turnsPerSec\": " << turnsPerSec(r);
 
         if (!r.ok) {
             f << ",\n";
@@ -274,8 +259,15 @@ int main(int argc, char** argv) {
     std::filesystem::path trimOnFailPath;
     std::filesystem::path trimDir;
     std::filesystem::path jsonReport;
+    std::filesystem::path convertIn;
+    std::filesystem::path convertOut;
     bool stopAfterFirstFail = false;
+    uint32_t jobs = 1;
+    uint32_t untilTurn = 0;
+    uint32_t snapshotEvery = 0;
+    bool bisect = false;
     bool verify = true;
+    bool pregen = false;
     uint32_t frameMs = 16;
     uint32_t maxMs = 0;
     uint32_t maxFrames = 0;
@@ -302,8 +294,51 @@ int main(int argc, char** argv) {
                 return 2;
             }
             replayDir = v;
+        } else if (a == "--convert") {
+            std::string in;
+            std::string out;
+            if (!argValue(i, argc, argv, in) || !argValue(i, argc, argv, out)) {
+                std::cerr << "--convert requires an input and an output path\n";
+                return 2;
+            }
+            convertIn = in;
+            convertOut = out;
+        } else if (a == "--until-turn") {
+            std::string v;
+            if (!argValue(i, argc, argv, v)) {
+                std::cerr << "--until-turn requires a value\n";
+                return 2;
+            }
+            if (!parseU32(v, untilTurn)) {
+                std::cerr << "Invalid --until-turn: " << v << "\n";
+                return 2;
+            }
+        } else if (a == "--snapshot-every") {
+            std::string v;
+            if (!argValue(i, argc, argv, v)) {
+                std::cerr << "--snapshot-every requires a value\n";
+                return 2;
+            }
+            if (!parseU32(v, snapshotEvery)) {
+                std::cerr << "Invalid --snapshot-every: " << v << "\n";
+                return 2;
+            }
+        } else if (a == "--bisect") {
+            bisect = true;
         } else if (a == "--stop-after-first-fail") {
             stopAfterFirstFail = true;
+        } else if (a == "--jobs" || a == "-j") {
+            std::string v;
+            if (!argValue(i, argc, argv, v)) {
+                std::cerr << "--jobs requires a value\n";
+                return 2;
+            }
+            uint32_t n = 0;
+            if (!parseU32(v, n)) {
+                std::cerr << "Invalid --jobs: " << v << "\n";
+                return 2;
+            }
+            jobs = (n == 0) ? std::max(1u, std::thread::hardware_concurrency()) : n;
         } else if (a == "--content") {
             std::string v;
             if (!argValue(i, argc, argv, v)) {
@@ -349,6 +384,8 @@ int main(int argc, char** argv) {
             maxFrames = n;
         } else if (a == "--no-verify-hashes") {
             verify = false;
+        } else if (a == "--pregen") {
+            pregen = true;
         } else if (a == "--trim-on-fail") {
             std::string v;
             if (!argValue(i, argc, argv, v)) {
@@ -377,6 +414,22 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (!convertIn.empty()) {
+        ReplayFile rf;
+        std::string err;
+        if (!loadReplayFile(convertIn, rf, &err) || !writeReplayFile(convertOut, rf, &err)) {
+            std::cerr << "Convert failed: " << err << "\n";
+            return 1;
+        }
+        std::error_code ec;
+        const auto inBytes = std::filesystem::file_size(convertIn, ec);
+        const auto outBytes = std::filesystem::file_size(convertOut, ec);
+        std::cout << "Converted " << convertIn.generic_string() << " -> " << convertOut.generic_string()
+                  << " events=" << rf.events.size()
+                  << " bytes=" << inBytes << " -> " << outBytes << "\n";
+        return 0;
+    }
+
     if (!replayPath.empty() && !replayDir.empty()) {
         std::cerr << "Specify only one of --replay or --replay-dir\n";
         return 2;
@@ -387,6 +440,11 @@ int main(int argc, char** argv) {
         return 2;
     }
 
+    if (bisect && replayPath.empty()) {
+        std::cerr << "--bisect requires --replay <file>\n";
+        return 2;
+    }
+
     // Optional content overrides (same mechanism as the main game).
     if (!contentPath.empty()) {
         ContentOverrides co;
@@ -407,16 +465,45 @@ int main(int argc, char** argv) {
     opt.verifyHashes = verify;
     opt.maxSimMs = maxMs;
     opt.maxFrames = maxFrames;
+    opt.stopAtTurn = untilTurn;
 
     std::vector<ReplayRunResult> results;
 
-    auto runOne = [&](const std::filesystem::path& p) -> ReplayRunResult {
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    };
+    const Clock::time_point runStart = Clock::now();
+
+    // Every replay gets its own Game, so this may run on several threads at once (--jobs).
+    // Each one also gets its own scratch save directory: in-replay saves/loads, bones and
+    // scores would otherwise share files across threads (and leak between replays).
+    std::mutex logMutex;
+    const std::string scratchTag = std::to_string(static_cast<unsigned long long>(runStart.time_since_epoch().count()));
+    auto scratchSaveDir = [&](size_t job) {
+        std::error_code ec;
+        std::filesystem::path base = std::filesystem::temp_directory_path(ec);
+        if (ec || base.empty()) base = std::filesystem::path(".");
+        return base / ("procrogue_replay_" + scratchTag + "_" + std::to_string(job));
+    };
+    auto runReplay = [&](const std::filesystem::path& p, size_t job) -> ReplayRunResult {
         ReplayRunResult rr;
         rr.file = p;
 
+        const std::filesystem::path saveDir = scratchSaveDir(job);
+        struct ScratchDirGuard {
+            std::filesystem::path dir;
+            ~ScratchDirGuard() {
+                std::error_code ec;
+                std::filesystem::remove_all(dir, ec);
+            }
+        } scratchGuard{saveDir};
+        const std::string savePath = (saveDir / "procrogue_save.dat").string();
+
         ReplayFile rf;
         std::string err;
-        if (!loadReplayFile(p, rf, &err)) {
+        const bool loaded = (untilTurn != 0) ? loadReplayPrefix(p, untilTurn, rf, &err) : loadReplayFile(p, rf, &err);
+        if (!loaded) {
             rr.ok = false;
             rr.error = err;
             rr.stats.failure = ReplayFailureKind::Unknown;
@@ -424,6 +511,8 @@ int main(int argc, char** argv) {
         }
 
         Game game;
+        game.setFloorPrefetchEnabled(pregen);
+        game.setSavePath(savePath);
         if (!prepareGameForReplay(game, rf, &err)) {
             rr.ok = false;
             rr.error = err.empty() ? "prepareGameForReplay failed" : err;
@@ -431,13 +520,37 @@ int main(int argc, char** argv) {
             return rr;
         }
 
+        ReplaySnapshots snapshots;
+        snapshots.everyTurns = snapshotEvery;
+        ReplayRunOptions runOpt = opt;
+        if (snapshotEvery != 0) runOpt.snapshots = &snapshots;
+
         ReplayRunStats stats;
-        const bool ok = runReplayHeadless(game, rf, opt, &stats, &err);
+        const bool ok = runReplayHeadless(game, rf, runOpt, &stats, &err);
         rr.ok = ok;
         rr.stats = stats;
         rr.error = err;
         rr.stats.failure = ok ? ReplayFailureKind::None : stats.failure;
 
+        // Seek back to the last snapshot before the failing checkpoint and play it again:
+        // a desync that does not reproduce points at nondeterminism rather than a changed rule.
+        if (!ok && stats.failure == ReplayFailureKind::HashMismatch && stats.failedCheckpointTurn > 0) {
+            if (const ReplaySnapshot* snap = snapshots.atOrBefore(stats.failedCheckpointTurn - 1)) {
+                Game again;
+                again.setFloorPrefetchEnabled(pregen);
+                again.setSavePath(savePath);
+                ReplayRunStats againStats;
+                std::string againErr;
+                const bool againOk = prepareGameForReplay(again, rf, &againErr) &&
+                                     resumeReplayHeadless(again, rf, *snap, opt, &againStats, &againErr);
+                rr.resumed = true;
+                rr.resumedFromTurn = snap->turn;
+                rr.reproduced = !againOk && againStats.failure == ReplayFailureKind::HashMismatch &&
+                                againStats.failedCheckpointTurn == stats.failedCheckpointTurn &&
+                                againStats.gotHash == stats.gotHash;
+            }
+        }
+
         // Optional: trim failing replay to the first failing checkpoint.
         if (!ok && stats.failure == ReplayFailureKind::HashMismatch) {
             std::filesystem::path outPath;
@@ -458,6 +571,7 @@ int main(int argc, char** argv) {
                     rr.trimmedPath = outPath;
                 } else {
                     // Don't fail the run just because trimming failed.
+                    std::lock_guard<std::mutex> lock(logMutex);
                     std::cerr << "Trim failed for " << p.generic_string() << ": " << terr << "\n";
                 }
             }
@@ -466,8 +580,45 @@ int main(int argc, char** argv) {
         return rr;
     };
 
+    auto runOne = [&](const std::filesystem::path& p, size_t job) -> ReplayRunResult {
+        const Clock::time_point t0 = Clock::now();
+        ReplayRunResult rr = runReplay(p, job);
+        rr.wallMs = msSince(t0);
+        return rr;
+    };
+
+    if (bisect) {
+        ReplayFile rf;
+        std::string err;
+        Game game;
+        game.setFloorPrefetchEnabled(pregen);
+        ReplayBisectResult br;
+        if (!loadReplayFile(replayPath, rf, &err) || !prepareGameForReplay(game, rf, &err) ||
+            !bisectReplayDesync(game, rf, opt, snapshotEvery != 0 ? snapshotEvery : 200u, br, &err)) {
+            std::cout << "Bisect FAILED: " << replayPath.generic_string() << "\n";
+            std::cout << "  " << err << "\n";
+            return 1;
+        }
+
+        std::cout << "Bisect: " << replayPath.generic_string()
+                  << " snapshots=" << br.snapshots << " (" << br.snapshotBytes << " bytes)"
+                  << " resumedFrom=" << br.resumedFromTurn
+                  << " wallMs=" << static_cast<uint64_t>(msSince(runStart)) << "\n";
+        if (!br.diverged) {
+            std::cout << "  No divergence: every checkpoint matches.\n";
+            return 0;
+        }
+        std::cout << "  First divergent checkpoint: turn " << br.turn
+                  << " (expected " << hex64(br.expectedHash) << ", got " << hex64(br.gotHash) << ")\n";
+        std::cout << "  Changed between turn " << br.beforeTurn << " and " << br.turn << ":";
+        if (br.changedParts.empty()) std::cout << " (nothing)";
+        for (Game::HashPart part : br.changedParts) std::cout << " " << Game::hashPartName(part);
+        std::cout << "\n";
+        return 1;
+    }
+
     if (!replayPath.empty()) {
-        ReplayRunResult rr = runOne(replayPath);
+        ReplayRunResult rr = runOne(replayPath, 0);
         results.push_back(rr);
 
         if (rr.ok) {
@@ -476,10 +627,16 @@ int main(int argc, char** argv) {
                       << " events=" << rr.stats.eventsDispatched
                       << " simMs=" << rr.stats.simulatedMs
                       << " frames=" << rr.stats.frames
+                      << " costCache=" << rr.stats.costCacheHits << "/"
+                      << (rr.stats.costCacheHits + rr.stats.costCacheMisses)
                       << "\n";
         } else {
             std::cout << "Replay FAILED: " << replayPath.generic_string() << "\n";
             std::cout << "  " << rr.error << "\n";
+            if (rr.resumed) {
+                std::cout << "  Re-run from snapshot at turn " << rr.resumedFromTurn << ": "
+                          << (rr.reproduced ? "reproduced" : "NOT reproduced (nondeterministic?)") << "\n";
+            }
             if (!rr.trimmedPath.empty()) {
                 std::cout << "  Trimmed replay written: " << rr.trimmedPath.generic_string() << "\n";
             }
@@ -487,7 +644,7 @@ int main(int argc, char** argv) {
 
         if (!jsonReport.empty()) {
             std::string jerr;
-            if (!writeJsonReport(jsonReport, results, opt, verify, &jerr)) {
+            if (!writeJsonReport(jsonReport, results, opt, verify, 1u, msSince(runStart), &jerr)) {
                 std::cerr << jerr << "\n";
             }
         }
@@ -503,10 +660,8 @@ int main(int argc, char** argv) {
     }
 
     size_t okCount = 0;
-    for (const auto& p : files) {
-        ReplayRunResult rr = runOne(p);
-        results.push_back(rr);
-
+    auto report = [&](const ReplayRunResult& rr) {
+        const std::filesystem::path& p = rr.file;
         if (rr.ok) {
             ++okCount;
             std::cout << "OK   " << p.filename().generic_string()
@@ -516,11 +671,38 @@ int main(int argc, char** argv) {
         } else {
             std::cout << "FAIL " << p.filename().generic_string()
                       << "  " << rr.error << "\n";
+            if (rr.resumed) {
+                std::cout << "     re-run from turn " << rr.resumedFromTurn << ": "
+                          << (rr.reproduced ? "reproduced" : "NOT reproduced") << "\n";
+            }
             if (!rr.trimmedPath.empty()) {
                 std::cout << "     trimmed: " << rr.trimmedPath.filename().generic_string() << "\n";
             }
-            if (stopAfterFirstFail) break;
         }
+    };
+
+    const size_t workers = std::min<size_t>(jobs, files.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            ReplayRunResult rr = runOne(files[i], i);
+            results.push_back(rr);
+            report(rr);
+            if (!rr.ok && stopAfterFirstFail) break;
+        }
+    } else {
+        // Results are reported in file order, so the log (and the stop point with
+        // --stop-after-first-fail) reads exactly like a --jobs 1 run.
+        ThreadPool pool(workers - 1); // the calling thread claims replays too
+        results.reserve(files.size());
+        parallelForOrdered(
+            pool, files.size(), stopAfterFirstFail,
+            [&](size_t i) { return runOne(files[i], i); },
+            [](const ReplayRunResult& rr) { return !rr.ok; },
+            [&](size_t, ReplayRunResult& rr) {
+                std::lock_guard<std::mutex> lock(logMutex);
+                report(rr);
+                results.push_back(std::move(rr));
+            });
     }
 
     const size_t total = results.size();
@@ -529,7 +711,7 @@ int main(int argc, char** argv) {
 
     if (!jsonReport.empty()) {
         std::string jerr;
-        if (!writeJsonReport(jsonReport, results, opt, verify, &jerr)) {
+        if (!writeJsonReport(jsonReport, results, opt, verify, jobs, msSince(runStart), &jerr)) {
             std::cerr << jerr << "\n";
         }
     }
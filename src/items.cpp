@@ -12,6 +12,8 @@
 #include "rng.hpp"
 #include "artifact_gen.hpp"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <sstream>
 
 namespace {
@@ -231,47 +233,54 @@ const ItemDef& itemDef(ItemKind k) {
         { ItemKind::FireBomb,        "FIRE BOMB",        true,  false, false, EquipSlot::None, 0, 0, 0, 0, AmmoKind::None, ProjectileKind::Rock, 0, 0, 0, 4,  90 },
 };
 
+    // Rebuilt when the content overrides change (startup/config time). The generation is
+    // checked atomically and the rebuild is locked, so games running on several threads
+    // (parallel replay verification) can share the table.
     static std::vector<ItemDef> defs;
-    static uint32_t appliedGen = 0;
+    static std::atomic<uint32_t> appliedGen{0xFFFFFFFFu};
+    static std::mutex rebuildMutex;
 
     const uint32_t gen = contentOverridesGeneration();
-    if (defs.empty() || appliedGen != gen) {
-        defs.assign(baseDefs, baseDefs + (sizeof(baseDefs) / sizeof(baseDefs[0])));
-
-        // Apply optional balance/content overrides (runtime).
-        const auto& ovs = contentOverrides().items;
-        for (const auto& kv : ovs) {
-            const ItemKind kind = kv.first;
-            const ItemDefOverride& o = kv.second;
-            const size_t j = static_cast<size_t>(kind);
-            if (j >= defs.size()) continue;
-            ItemDef& d = defs[j];
-            if (d.kind != kind) continue;
-
-            if (o.meleeAtk) d.meleeAtk = *o.meleeAtk;
-            if (o.rangedAtk) d.rangedAtk = *o.rangedAtk;
-            if (o.defense) d.defense = *o.defense;
-            if (o.range) d.range = *o.range;
-            if (o.maxCharges) d.maxCharges = *o.maxCharges;
-            if (o.healAmount) d.healAmount = *o.healAmount;
-            if (o.hungerRestore) d.hungerRestore = *o.hungerRestore;
-            if (o.weight) d.weight = *o.weight;
-            if (o.value) d.value = *o.value;
-            if (o.modMight) d.modMight = *o.modMight;
-            if (o.modAgility) d.modAgility = *o.modAgility;
-            if (o.modVigor) d.modVigor = *o.modVigor;
-            if (o.modFocus) d.modFocus = *o.modFocus;
-
-            // Basic safety clamps.
-            d.range = std::max(0, d.range);
-            d.maxCharges = std::max(0, d.maxCharges);
-            d.healAmount = std::max(0, d.healAmount);
-            d.hungerRestore = std::max(0, d.hungerRestore);
-            d.weight = std::max(0, d.weight);
-            d.value = std::max(0, d.value);
-        }
+    if (appliedGen.load(std::memory_order_acquire) != gen) {
+        std::lock_guard<std::mutex> lock(rebuildMutex);
+        if (appliedGen.load(std::memory_order_relaxed) != gen) {
+            defs.assign(baseDefs, baseDefs + (sizeof(baseDefs) / sizeof(baseDefs[0])));
+
+            // Apply optional balance/content overrides (runtime).
+            const auto& ovs = contentOverrides().items;
+            for (const auto& kv : ovs) {
+                const ItemKind kind = kv.first;
+                const ItemDefOverride& o = kv.second;
+                const size_t j = static_cast<size_t>(kind);
+                if (j >= defs.size()) continue;
+                ItemDef& d = defs[j];
+                if (d.kind != kind) continue;
+
+                if (o.meleeAtk) d.meleeAtk = *o.meleeAtk;
+                if (o.rangedAtk) d.rangedAtk = *o.rangedAtk;
+                if (o.defense) d.defense = *o.defense;
+                if (o.range) d.range = *o.range;
+                if (o.maxCharges) d.maxCharges = *o.maxCharges;
+                if (o.healAmount) d.healAmount = *o.healAmount;
+                if (o.hungerRestore) d.hungerRestore = *o.hungerRestore;
+                if (o.weight) d.weight = *o.weight;
+                if (o.value) d.value = *o.value;
+                if (o.modMight) d.modMight = *o.modMight;
+                if (o.modAgility) d.modAgility = *o.modAgility;
+                if (o.modVigor) d.modVigor = *o.modVigor;
+                if (o.modFocus) d.modFocus = *o.modFocus;
+
+                // Basic safety clamps.
+                d.range = std::max(0, d.range);
+                d.maxCharges = std::max(0, d.maxCharges);
+                d.healAmount = std::max(0, d.healAmount);
+                d.hungerRestore = std::max(0, d.hungerRestore);
+                d.weight = std::max(0, d.weight);
+                d.value = std::max(0, d.value);
+            }
 
-        appliedGen = gen;
+            appliedGen.store(gen, std::memory_order_release);
+        }
     }
 
     const size_t idx = static_cast<size_t>(k);
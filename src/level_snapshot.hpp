@@ -0,0 +1,165 @@
+#pragma once
+
+// Packed in-memory form of inactive levels (Game::levels / Game::overworldChunks_).
+//
+// A stored level used to keep every per-tile vector fully expanded: the tile grid, the
+// Dungeon's material/ecosystem caches and six hazard/scent fields. Most of that is long
+// runs (walls, one material per room, all-zero gas), so LevelState::pack() moves those
+// vectors into the byte-RLE streams below and frees the originals. Sparse lists
+// (monsters, items, traps, ...) stay as they are.
+//
+// Stream format (encodeBytes): a sequence of tokens, each a LEB128 varint header
+// `(count << 1) | repeat` followed by either one value byte (repeat: `count` copies) or
+// `count` literal bytes. visitBytes() walks the runs without materializing the vector,
+// which lets Game::determinismHash() hash a packed level directly.
+
+#include "dungeon.hpp"
+#include "varint.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace levelpack {
+
+// Runs shorter than this are folded into the surrounding literal.
+inline constexpr size_t kMinRepeat = 3;
+
+inline void encodeBytes(const uint8_t* p, size_t n, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t litStart = 0;
+    size_t i = 0;
+    auto flushLiteral = [&](size_t end) {
+        if (end <= litStart) return;
+        varint::put(out, static_cast<uint64_t>(end - litStart) << 1);
+        out.insert(out.end(), p + litStart, p + end);
+    };
+    while (i < n) {
+        size_t j = i + 1;
+        while (j < n && p[j] == p[i]) ++j;
+        if (j - i >= kMinRepeat) {
+            flushLiteral(i);
+            varint::put(out, (static_cast<uint64_t>(j - i) << 1) | 1u);
+            out.push_back(p[i]);
+            litStart = j;
+        }
+        i = j;
+    }
+    flushLiteral(n);
+    out.shrink_to_fit();
+}
+
+// Calls onRun(value, count) / onLiteral(ptr, count) in order. Returns false if the
+// stream is malformed or does not decode to exactly `n` bytes.
+template <typename RunFn, typename LiteralFn>
+bool visitBytes(const std::vector<uint8_t>& in, size_t n, RunFn&& onRun, LiteralFn&& onLiteral) {
+    size_t pos = 0;
+    size_t produced = 0;
+    while (pos < in.size()) {
+        uint64_t h = 0;
+        if (!varint::get(in, pos, h)) return false;
+        const uint64_t count = h >> 1;
+        if (count > n - produced) return false;
+        if (h & 1u) {
+            if (pos >= in.size()) return false;
+            onRun(in[pos++], static_cast<size_t>(count));
+        } else {
+            if (count > in.size() - pos) return false;
+            onLiteral(in.data() + pos, static_cast<size_t>(count));
+            pos += static_cast<size_t>(count);
+        }
+        produced += static_cast<size_t>(count);
+    }
+    return produced == n;
+}
+
+inline bool decodeBytes(const std::vector<uint8_t>& in, size_t n, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(n);
+    const bool ok = visitBytes(
+        in, n,
+        [&](uint8_t v, size_t count) { out.insert(out.end(), count, v); },
+        [&](const uint8_t* p, size_t count) { out.insert(out.end(), p, p + count); });
+    if (!ok) out.assign(n, uint8_t{0});
+    return ok;
+}
+
+// One byte per tile: type in the low 6 bits, fog-of-war flags on top.
+inline constexpr uint8_t kTileTypeMask = 0x3Fu;
+
+inline bool tilePackable(const Tile& t) { return static_cast<uint8_t>(t.type) <= kTileTypeMask; }
+
+inline uint8_t packTile(const Tile& t) {
+    return static_cast<uint8_t>((static_cast<uint8_t>(t.type) & kTileTypeMask) | (t.visible ? 0x40u : 0u) |
+                                (t.explored ? 0x80u : 0u));
+}
+
+inline Tile unpackTile(uint8_t b) {
+    Tile t;
+    t.type = static_cast<TileType>(b & kTileTypeMask);
+    t.visible = (b & 0x40u) != 0;
+    t.explored = (b & 0x80u) != 0;
+    return t;
+}
+
+} // namespace levelpack
+
+// One packed byte vector: its original length plus the encoded stream.
+struct PackedBytes {
+    uint32_t size = 0;
+    std::vector<uint8_t> data;
+
+    void pack(std::vector<uint8_t>& v) {
+        size = static_cast<uint32_t>(v.size());
+        levelpack::encodeBytes(v.data(), v.size(), data);
+        std::vector<uint8_t>().swap(v);
+    }
+
+    // pack() of `n` zero bytes, without materializing them.
+    void packZeros(size_t n) {
+        size = static_cast<uint32_t>(n);
+        data.clear();
+        if (n >= levelpack::kMinRepeat) {
+            varint::put(data, (static_cast<uint64_t>(n) << 1) | 1u);
+            data.push_back(uint8_t{0});
+        } else if (n > 0) {
+            varint::put(data, static_cast<uint64_t>(n) << 1);
+            data.insert(data.end(), n, uint8_t{0});
+        }
+        data.shrink_to_fit();
+    }
+
+    void unpack(std::vector<uint8_t>& v) {
+        levelpack::decodeBytes(data, size, v);
+        std::vector<uint8_t>().swap(data);
+        size = 0;
+    }
+
+    template <typename RunFn, typename LiteralFn>
+    bool visit(RunFn&& onRun, LiteralFn&& onLiteral) const {
+        return levelpack::visitBytes(data, size, onRun, onLiteral);
+    }
+};
+
+struct LevelSnapshot {
+    static constexpr int kFieldCount = 6; // LevelState hazard/scent fields, in declaration order
+
+    bool valid = false;
+    PackedBytes tiles; // levelpack::packTile() bytes of Dungeon::tiles
+
+    // Dungeon's derived caches; kept (rather than dropped) so a restored level is
+    // byte-identical and *Cached() lookups never depend on an ensureMaterials() call.
+    PackedBytes materialCache;
+    PackedBytes biolumCache;
+    PackedBytes ecosystemCache;
+    PackedBytes leylineCache;
+
+    PackedBytes fields[kFieldCount];
+
+    size_t bytes() const {
+        size_t n = tiles.data.capacity() + materialCache.data.capacity() + biolumCache.data.capacity() +
+                   ecosystemCache.data.capacity() + leylineCache.data.capacity();
+        for (const auto& f : fields) n += f.data.capacity();
+        return n;
+    }
+};
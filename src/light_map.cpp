@@ -0,0 +1,275 @@
+#include "light_map.hpp"
+
+#include "dungeon.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+auto sourceKey(const LightSource& s) {
+    return std::make_tuple(s.pos.y, s.pos.x, s.radius, s.intensity, s.tint.r, s.tint.g, s.tint.b, s.tint.a);
+}
+
+bool sourceLess(const LightSource& a, const LightSource& b) { return sourceKey(a) < sourceKey(b); }
+bool sourceEqual(const LightSource& a, const LightSource& b) { return sourceKey(a) == sourceKey(b); }
+
+LightRect unite(const LightRect& a, const LightRect& b) {
+    return LightRect{std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+}
+
+LightRect intersect(const LightRect& a, const LightRect& b) {
+    return LightRect{std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1)};
+}
+
+} // namespace
+
+void LightMapCache::clear() {
+    for (auto& layer : layers_) std::vector<Record>().swap(layer);
+    std::vector<uint8_t>().swap(ambLevel_);
+    std::vector<Color>().swap(ambColor_);
+    dirty_.clear();
+    w_ = 0;
+    h_ = 0;
+    valid_ = false;
+    bright_ = false;
+    staticStale_ = true;
+}
+
+void LightMapCache::markDirty(const LightRect& r) {
+    if (!r.empty()) dirty_.push_back(r);
+}
+
+void LightMapCache::fillBright(const Dungeon& d, std::vector<uint8_t>& level, std::vector<Color>& color) {
+    dirty_.clear();
+    recomputed_ = 0;
+
+    const size_t n = static_cast<size_t>(std::max(0, d.width)) * static_cast<size_t>(std::max(0, d.height));
+    if (bright_ && d.width == w_ && d.height == h_ && level.size() == n && color.size() == n) return;
+
+    clear();
+    bright_ = true;
+    w_ = std::max(0, d.width);
+    h_ = std::max(0, d.height);
+    level.assign(n, uint8_t{255});
+    color.assign(n, Color{ 255, 255, 255, 255 });
+    markDirty(LightRect{0, 0, w_ - 1, h_ - 1});
+    ++revision_;
+}
+
+void LightMapCache::reset(const Dungeon& d) {
+    clear();
+    w_ = std::max(0, d.width);
+    h_ = std::max(0, d.height);
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    ambLevel_.assign(n, uint8_t{0});
+    ambColor_.assign(n, Color{ 0, 0, 0, 255 });
+
+    epoch_ = d.terrainEpoch;
+    journalPos_ = d.terrainJournal.size();
+    materialRevision_ = d.materialRevision;
+    valid_ = true;
+    markDirty(LightRect{0, 0, w_ - 1, h_ - 1});
+}
+
+bool LightMapCache::begin(const Dungeon& d, uint32_t levelKey) {
+    dirty_.clear();
+    recomputed_ = 0;
+
+    const size_t n = static_cast<size_t>(std::max(0, d.width)) * static_cast<size_t>(std::max(0, d.height));
+    if (!valid_ || d.width != w_ || d.height != h_ || d.tiles.size() != n || d.terrainEpoch != epoch_ ||
+        levelKey != levelKey_ || journalPos_ > d.terrainJournal.size()) {
+        reset(d);
+        levelKey_ = levelKey;
+        return true;
+    }
+
+    if (journalPos_ < d.terrainJournal.size()) {
+        // Opacity changed somewhere: sources whose box holds an edit may see differently.
+        // Terrain can also create or remove static emitters anywhere.
+        staticStale_ = true;
+        const auto first = d.terrainJournal.begin() + static_cast<std::ptrdiff_t>(journalPos_);
+        for (auto& layer : layers_) {
+            auto stale = [&](const Record& r) {
+                if (r.box.empty()) return false;
+                for (auto it = first; it != d.terrainJournal.end(); ++it) {
+                    const int x = *it % w_;
+                    const int y = *it / w_;
+                    if (x >= r.box.x0 && x <= r.box.x1 && y >= r.box.y0 && y <= r.box.y1) return true;
+                }
+                return false;
+            };
+            for (const Record& r : layer) {
+                if (stale(r)) markDirty(r.box);
+            }
+            layer.erase(std::remove_if(layer.begin(), layer.end(), stale), layer.end());
+        }
+        journalPos_ = d.terrainJournal.size();
+    }
+
+    if (d.materialRevision != materialRevision_) {
+        staticStale_ = true;
+        materialRevision_ = d.materialRevision;
+    }
+    return false;
+}
+
+void LightMapCache::addAmbient(int x, int y, int w, int h, uint8_t amb, Color tint) {
+    // Encode ambient color as "already intensity-scaled" modulation.
+    const auto scale = [&](uint8_t c) -> uint8_t {
+        const int v = (static_cast<int>(amb) * static_cast<int>(c)) / 255;
+        return static_cast<uint8_t>(std::clamp(v, 0, 255));
+    };
+    const Color ambC{ scale(tint.r), scale(tint.g), scale(tint.b), 255 };
+
+    for (int yy = std::max(0, y); yy < std::min(h_, y + h); ++yy) {
+        for (int xx = std::max(0, x); xx < std::min(w_, x + w); ++xx) {
+            const size_t i = static_cast<size_t>(yy * w_ + xx);
+            if (ambLevel_[i] < amb) ambLevel_[i] = amb;
+            Color& dst = ambColor_[i];
+            dst.r = std::max(dst.r, ambC.r);
+            dst.g = std::max(dst.g, ambC.g);
+            dst.b = std::max(dst.b, ambC.b);
+        }
+    }
+}
+
+LightMapCache::Record LightMapCache::build(const Dungeon& d, const LightSource& s) {
+    Record r;
+    r.src = s;
+    ++recomputed_;
+
+    int x0 = 0;
+    int y0 = 0;
+    int w = 0;
+    int h = 0;
+    d.computeFovWindow(s.pos.x, s.pos.y, s.radius, fovScratch_, x0, y0, w, h);
+    if (w <= 0 || h <= 0) return r;
+
+    r.box = LightRect{x0, y0, x0 + w - 1, y0 + h - 1};
+    r.level.assign(static_cast<size_t>(w * h), uint8_t{0});
+
+    const int rad = std::max(1, s.radius);
+    const int r2 = rad * rad;
+    for (int wy = 0; wy < h; ++wy) {
+        for (int wx = 0; wx < w; ++wx) {
+            const size_t i = static_cast<size_t>(wy * w + wx);
+            if (!fovScratch_[i]) continue;
+
+            const int dx = x0 + wx - s.pos.x;
+            const int dy = y0 + wy - s.pos.y;
+            const int d2 = dx * dx + dy * dy;
+            if (d2 > r2) continue;
+
+            // Smooth quadratic falloff (0 at edge) for nicer, round torchlight.
+            const float t = static_cast<float>(d2) / static_cast<float>(r2);
+            float atten = 1.0f - t;
+            atten = atten * atten;
+
+            const int b = static_cast<int>(static_cast<float>(s.intensity) * atten + 0.5f);
+            r.level[i] = static_cast<uint8_t>(std::clamp(b, 0, 255));
+        }
+    }
+    return r;
+}
+
+void LightMapCache::setSources(const Dungeon& d, Layer layer, std::vector<LightSource> sources) {
+    std::sort(sources.begin(), sources.end(), sourceLess);
+
+    std::vector<Record>& old = layers_[static_cast<int>(layer)];
+    std::vector<Record> next;
+    next.reserve(sources.size());
+
+    size_t i = 0;
+    for (const LightSource& s : sources) {
+        while (i < old.size() && sourceLess(old[i].src, s)) markDirty(old[i++].box);
+        if (i < old.size() && sourceEqual(old[i].src, s)) {
+            next.push_back(std::move(old[i++]));
+            continue;
+        }
+        Record r = build(d, s);
+        markDirty(r.box);
+        next.push_back(std::move(r));
+    }
+    for (; i < old.size(); ++i) markDirty(old[i].box);
+    old.swap(next);
+
+    if (layer == Layer::Static) staticStale_ = false;
+}
+
+void LightMapCache::compose(std::vector<uint8_t>& level, std::vector<Color>& color) {
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    if (level.size() != n) level.assign(n, uint8_t{0});
+    if (color.size() != n) color.assign(n, Color{ 0, 0, 0, 255 });
+
+    // Coalesce: the old and new box of a moving source overlap almost entirely.
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t a = 0; a < dirty_.size() && !merged; ++a) {
+            for (size_t b = a + 1; b < dirty_.size(); ++b) {
+                const LightRect u = unite(dirty_[a], dirty_[b]);
+                if (u.area() > dirty_[a].area() + dirty_[b].area()) continue;
+                dirty_[a] = u;
+                dirty_.erase(dirty_.begin() + static_cast<std::ptrdiff_t>(b));
+                merged = true;
+                break;
+            }
+        }
+    }
+    if (dirty_.empty()) return;
+    ++revision_;
+
+    for (const LightRect& rect : dirty_) {
+        const int rw = rect.x1 - rect.x0 + 1;
+        // Four ints per cell: brightness, then unsaturated r/g/b.
+        accum_.assign(static_cast<size_t>(rect.area()) * 4u, 0);
+        for (int y = rect.y0; y <= rect.y1; ++y) {
+            for (int x = rect.x0; x <= rect.x1; ++x) {
+                const size_t i = static_cast<size_t>(y * w_ + x);
+                int* a = &accum_[static_cast<size_t>(((y - rect.y0) * rw + (x - rect.x0)) * 4)];
+                a[0] = ambLevel_[i];
+                a[1] = ambColor_[i].r;
+                a[2] = ambColor_[i].g;
+                a[3] = ambColor_[i].b;
+            }
+        }
+
+        for (const auto& layer : layers_) {
+            for (const Record& r : layer) {
+                const LightRect o = intersect(rect, r.box);
+                if (o.empty()) continue;
+                const int bw = r.box.x1 - r.box.x0 + 1;
+                for (int y = o.y0; y <= o.y1; ++y) {
+                    for (int x = o.x0; x <= o.x1; ++x) {
+                        const int b = r.level[static_cast<size_t>((y - r.box.y0) * bw + (x - r.box.x0))];
+                        if (b == 0) continue;
+                        int* a = &accum_[static_cast<size_t>(((y - rect.y0) * rw + (x - rect.x0)) * 4)];
+                        a[0] = std::max(a[0], b);
+                        // Additive RGB lighting, scaled by intensity; saturated below.
+                        a[1] += (b * static_cast<int>(r.src.tint.r)) / 255;
+                        a[2] += (b * static_cast<int>(r.src.tint.g)) / 255;
+                        a[3] += (b * static_cast<int>(r.src.tint.b)) / 255;
+                    }
+                }
+            }
+        }
+
+        for (int y = rect.y0; y <= rect.y1; ++y) {
+            for (int x = rect.x0; x <= rect.x1; ++x) {
+                const size_t i = static_cast<size_t>(y * w_ + x);
+                const int* a = &accum_[static_cast<size_t>(((y - rect.y0) * rw + (x - rect.x0)) * 4)];
+                const uint8_t l = static_cast<uint8_t>(a[0]);
+                Color c{ static_cast<uint8_t>(std::min(a[1], 255)), static_cast<uint8_t>(std::min(a[2], 255)),
+                         static_cast<uint8_t>(std::min(a[3], 255)), 255 };
+
+                // If a tile has brightness but ended up with no RGB tint (should be rare),
+                // fall back to grayscale to avoid a "black light" edge case.
+                if (l != 0 && c.r == 0 && c.g == 0 && c.b == 0) c = Color{ l, l, l, 255 };
+
+                level[i] = l;
+                color[i] = c;
+            }
+        }
+    }
+}
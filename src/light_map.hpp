@@ -0,0 +1,121 @@
+#pragma once
+
+// Incremental light map for Game::recomputeLightMap().
+//
+// The light map used to be rebuilt from nothing on every FOV update: room ambient light,
+// then one shadowcast per light source over the whole map. Almost all of that repeats
+// from one turn to the next, so LightMapCache keeps the pieces:
+//   - the ambient plane (room light), derived once per layout;
+//   - a static layer (terrain emitters such as bioluminescent floors), whose source list
+//     is only re-gathered when the terrain or the material cache changes;
+//   - a dynamic layer (torches, fire, burning creatures, flaming weapons), re-gathered
+//     every update but diffed against the previous list.
+// Every source keeps its contribution inside its own bounding box (the radius square
+// clipped to the map). A source is recomputed only when it is new, moved, changed its
+// radius/intensity/tint, or a terrain edit landed inside its box (its LOS may differ).
+//
+// Composition is order independent: brightness is the max of the ambient level and every
+// contribution, and color is the ambient color plus the sum of all contributions,
+// saturated at 255. So only the boxes of sources that appeared or disappeared (the dirty
+// rects) are re-composed, and the result is bit-identical to the full rebuild.
+//
+// The dirty rects of the most recent update are exposed for the renderer; revision()
+// advances with every update that changed something, so a consumer that skipped an
+// update can fall back to redrawing everything.
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Dungeon;
+
+struct LightSource {
+    Vec2i pos;
+    int radius = 0;
+    uint8_t intensity = 0;
+    Color tint;
+};
+
+// Inclusive tile rectangle.
+struct LightRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = -1;
+    int y1 = -1;
+
+    bool empty() const { return x1 < x0 || y1 < y0; }
+    int area() const { return empty() ? 0 : (x1 - x0 + 1) * (y1 - y0 + 1); }
+};
+
+class LightMapCache {
+public:
+    enum class Layer : uint8_t {
+        Static = 0,
+        Dynamic,
+    };
+
+    // Forgets everything; the next update rebuilds the whole map.
+    void clear();
+
+    // Lighting off: the map is uniformly white. Only the first call after a lit update (or
+    // a resize) rewrites the outputs.
+    void fillBright(const Dungeon& d, std::vector<uint8_t>& level, std::vector<Color>& color);
+
+    // Starts a darkness update against `d`. `levelKey` stands for everything else the
+    // static sources depend on (branch, depth, seeds). Returns true when the layout is new:
+    // the caller must then re-add the ambient light with addAmbient().
+    bool begin(const Dungeon& d, uint32_t levelKey);
+
+    // Room light over the w x h block at (x, y): max-combined with what is there.
+    void addAmbient(int x, int y, int w, int h, uint8_t amb, Color tint);
+
+    // True when the static sources must be re-gathered and passed to setSources().
+    bool staticStale() const { return staticStale_; }
+
+    // Replaces the sources of `layer`; unchanged ones keep their cached contribution.
+    void setSources(const Dungeon& d, Layer layer, std::vector<LightSource> sources);
+
+    // Re-composes the dirty rects into the output planes.
+    void compose(std::vector<uint8_t>& level, std::vector<Color>& color);
+
+    // Rectangles whose light changed in the most recent update (coalesced).
+    const std::vector<LightRect>& dirtyRects() const { return dirty_; }
+    uint32_t revision() const { return revision_; }
+
+    // Sources recomputed by the most recent update (diagnostics/tests).
+    int recomputedSources() const { return recomputed_; }
+
+private:
+    struct Record {
+        LightSource src;
+        LightRect box;
+        std::vector<uint8_t> level; // per box cell, 0 outside LOS/radius
+    };
+
+    void reset(const Dungeon& d);
+    void markDirty(const LightRect& r);
+    Record build(const Dungeon& d, const LightSource& s);
+
+    int w_ = 0;
+    int h_ = 0;
+    uint32_t epoch_ = 0u;
+    size_t journalPos_ = 0;
+    uint32_t materialRevision_ = 0u;
+    uint32_t levelKey_ = 0u;
+    bool valid_ = false;
+    bool bright_ = false;
+    bool staticStale_ = true;
+
+    std::vector<uint8_t> ambLevel_;
+    std::vector<Color> ambColor_;
+    std::vector<Record> layers_[2]; // sorted by source
+
+    std::vector<LightRect> dirty_;
+    uint32_t revision_ = 0u;
+    int recomputed_ = 0;
+
+    std::vector<uint8_t> fovScratch_;
+    std::vector<int> accum_;
+};
@@ -404,6 +404,7 @@ int main(int argc, char** argv) {
     const int winH = viewH * tileSize + hudHeight;
 
     Renderer renderer(winW, winH, tileSize, hudHeight, settings.vsync, settings.textureCacheMB);
+    renderer.setSpriteDiskCache(baseDir / "procrogue_sprites.cache", settings.spriteCacheMB);
     if (!renderer.init()) {
         SDL_Quit();
         return 1;
@@ -485,6 +486,8 @@ int main(int argc, char** argv) {
     game.setBonesEnabled(settings.bonesEnabled);
     game.setInfiniteWorldEnabled(settings.infiniteWorld);
     game.setInfiniteKeepWindow(settings.infiniteKeepWindow);
+    game.setFloorCandidates(settings.floorCandidates);
+    game.setFloorPrefetchEnabled(settings.pregenNextFloor);
     game.setVoxelSpritesEnabled(settings.voxelSprites);
     game.setIsoVoxelRaytraceEnabled(settings.isoVoxelRaytrace);
     game.setIsoTerrainVoxelBlocksEnabled(settings.isoTerrainVoxelBlocks);
@@ -514,6 +517,7 @@ int main(int argc, char** argv) {
         game.setLightingEnabled(replayFile.meta.lightingEnabled);
         game.setYendorDoomEnabled(replayFile.meta.yendorDoomEnabled);
         game.setBonesEnabled(replayFile.meta.bonesEnabled);
+        game.setFloorCandidates(replayFile.meta.floorCandidates);
     }
 
     game.setPlayerName(settings.playerName);
@@ -798,6 +802,7 @@ int main(int argc, char** argv) {
         meta.lightingEnabled = game.lightingEnabled();
         meta.yendorDoomEnabled = game.yendorDoomEnabled();
         meta.bonesEnabled = game.bonesEnabled();
+        meta.floorCandidates = game.floorCandidates();
 
         std::string err;
         if (!recorder.open(outPath, meta, &err)) {
@@ -0,0 +1,161 @@
+#pragma once
+
+// Cross-turn cache of monster cost-to-target fields.
+//
+// Game::monsterTurn() asks for a full-map "cost to reach target" field per
+// (target tile, capability mask). When the player stands still, or monsters
+// chase a stationary ally, the very same field used to be recomputed every turn.
+//
+// Entries are keyed by everything the field depends on:
+//   - target tile index and capability mask,
+//   - MonsterNavGrid::generation() (terrain, doors and discovered traps),
+//   - the hazard layout id (internHazards()): fire/gas only enter the field through
+//     monsterHazardStepPenalty(), so the layout is that penalty per tile over the box
+//     holding every hazard tile (the union of the fields' active rects). It is built
+//     from that box only, costs nothing on a hazard-free level, and a gas tick that
+//     decays values without crossing a penalty step keeps the same id.
+// so a lookup can only hit when the inputs are identical and no explicit
+// invalidation is needed when the level changes.
+//
+// The cache is LRU-bounded. Entries touched during the current turn are pinned
+// (never evicted until the next beginTurn()), so references handed out during a
+// turn stay valid for the whole turn.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct MonsterCostCacheKey {
+    int target = -1;        // tile index (y * width + x)
+    int caps = 0;           // MonsterPathCaps mask (0..7)
+    uint32_t navGen = 0u;   // MonsterNavGrid::generation()
+    uint32_t hazardId = 0u; // MonsterCostCache::internHazards()
+
+    bool operator==(const MonsterCostCacheKey& o) const {
+        return target == o.target && caps == o.caps && navGen == o.navGen && hazardId == o.hazardId;
+    }
+};
+
+struct MonsterCostCacheKeyHash {
+    size_t operator()(const MonsterCostCacheKey& k) const {
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(k.target)) |
+                     (static_cast<uint64_t>(static_cast<uint32_t>(k.caps)) << 32);
+        h ^= (static_cast<uint64_t>(k.navGen) << 35) ^ (static_cast<uint64_t>(k.hazardId) * 0x9E3779B97F4A7C15ull);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
+
+// Hazard step penalties over the box [x0, x1] x [y0, y1] (inclusive, row-major).
+// Every tile outside the box has no hazard; an empty box means a hazard-free level.
+struct MonsterHazardLayout {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = -1;
+    int y1 = -1;
+    std::vector<uint8_t> penalty;
+
+    bool empty() const { return x1 < x0 || y1 < y0; }
+
+    bool operator==(const MonsterHazardLayout& o) const {
+        if (empty() || o.empty()) return empty() == o.empty();
+        return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1 && penalty == o.penalty;
+    }
+};
+
+class MonsterCostCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    // Starts a new monster turn: unpins everything touched during the previous one.
+    void beginTurn() { ++turn_; }
+
+    // Id of a hazard layout for MonsterCostCacheKey::hazardId. A hazard-free layout (empty
+    // box or all-zero penalties) is always 0; any other layout keeps its id while it stays
+    // the same from call to call. Ids are never reused, so equal ids mean equal layouts.
+    uint32_t internHazards(MonsterHazardLayout&& layout) {
+        if (layout.empty() || std::all_of(layout.penalty.begin(), layout.penalty.end(), [](uint8_t p) { return p == 0u; })) {
+            return 0u;
+        }
+        if (hazardId_ == 0u || !(layout == hazards_)) {
+            hazards_ = std::move(layout);
+            hazardId_ = ++lastHazardId_;
+        }
+        return hazardId_;
+    }
+
+    // Returns the cached field for `key`, computing it with compute(std::vector<int>&) on a miss.
+    // The returned reference stays valid until the next beginTurn().
+    template <typename ComputeFn>
+    const std::vector<int>& getOrCompute(const MonsterCostCacheKey& key, ComputeFn&& compute) {
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            ++stats_.hits;
+            it->second.lastUse = ++clock_;
+            it->second.turn = turn_;
+            return it->second.cost;
+        }
+
+        ++stats_.misses;
+        if (entries_.size() >= capacity_) evictOne();
+
+        Entry& e = entries_[key];
+        e.lastUse = ++clock_;
+        e.turn = turn_;
+        compute(e.cost);
+        return e.cost;
+    }
+
+    void clear() {
+        entries_.clear();
+        hazards_ = MonsterHazardLayout{};
+        hazardId_ = 0u;
+    }
+
+    void setCapacity(size_t cap) { capacity_ = (cap > 0) ? cap : 1; }
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return entries_.size(); }
+
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats{}; }
+
+private:
+    struct Entry {
+        std::vector<int> cost;
+        uint64_t lastUse = 0;
+        uint64_t turn = 0;
+    };
+
+    // Drops the least recently used entry that is not pinned by the current turn.
+    // If every entry is pinned the cache temporarily grows past its capacity.
+    void evictOne() {
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.turn == turn_) continue;
+            if (victim == entries_.end() || it->second.lastUse < victim->second.lastUse) victim = it;
+        }
+        if (victim == entries_.end()) return;
+        entries_.erase(victim);
+        ++stats_.evictions;
+    }
+
+    std::unordered_map<MonsterCostCacheKey, Entry, MonsterCostCacheKeyHash> entries_;
+    MonsterHazardLayout hazards_; // layout behind hazardId_
+    uint32_t hazardId_ = 0u;
+    uint32_t lastHazardId_ = 0u;
+    size_t capacity_ = DEFAULT_CAPACITY;
+    uint64_t clock_ = 0;
+    uint64_t turn_ = 1;
+    Stats stats_{};
+};
@@ -0,0 +1,127 @@
+#include "monster_nav_grid.hpp"
+
+#include "monster_pathing.hpp"
+
+#include <algorithm>
+
+void MonsterNavGrid::collectTrapPenalties(const Dungeon& dung, const std::vector<Trap>& traps,
+                                          std::vector<std::pair<int, uint8_t>>& out) const {
+    out.clear();
+    for (const auto& tr : traps) {
+        if (!tr.discovered) continue;
+        if (!dung.inBounds(tr.pos.x, tr.pos.y)) continue;
+        const int p = trapPenaltyForMonsterPathing(tr.kind);
+        out.emplace_back(tr.pos.y * dung.width + tr.pos.x, static_cast<uint8_t>(std::clamp(p, 0, 255)));
+    }
+
+    // Keep the highest penalty per tile (matches buildDiscoveredTrapPenaltyGrid()).
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+        return (a.first != b.first) ? (a.first < b.first) : (a.second > b.second);
+    });
+    out.erase(std::unique(out.begin(), out.end(), [](const auto& a, const auto& b) {
+        return a.first == b.first;
+    }), out.end());
+}
+
+void MonsterNavGrid::updateTile(const Dungeon& dung, int i) {
+    const int x = i % w_;
+    const int y = i / w_;
+    const size_t ii = static_cast<size_t>(i);
+
+    walkable_[ii] = dung.isWalkable(x, y) ? uint8_t{1} : uint8_t{0};
+
+    const int trap = static_cast<int>(trapPenalty_[ii]);
+    for (int caps = 0; caps < CAPS_COMBOS; ++caps) {
+        int v = 0;
+        if (monsterTerrainPassableForCaps(dung, x, y, caps)) {
+            const int c = monsterTerrainStepCostForCaps(dung, x, y, caps);
+            if (c > 0) v = std::min(255, c + trap);
+        }
+        planes_[static_cast<size_t>(caps)][ii] = static_cast<uint8_t>(v);
+    }
+}
+
+void MonsterNavGrid::rebuild(const Dungeon& dung) {
+    w_ = std::max(0, dung.width);
+    h_ = std::max(0, dung.height);
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+
+    for (auto& p : planes_) p.assign(n, uint8_t{0});
+    walkable_.assign(n, uint8_t{0});
+    trapPenalty_.assign(n, uint8_t{0});
+
+    for (const auto& tp : trapList_) {
+        if (static_cast<size_t>(tp.first) < n) trapPenalty_[static_cast<size_t>(tp.first)] = tp.second;
+    }
+
+    for (size_t i = 0; i < n; ++i) updateTile(dung, static_cast<int>(i));
+
+    epoch_ = dung.terrainEpoch;
+    journalPos_ = dung.terrainJournal.size();
+    valid_ = true;
+    ++generation_;
+}
+
+bool MonsterNavGrid::replayJournal(const Dungeon& dung) {
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    bool changed = false;
+    for (size_t j = journalPos_; j < dung.terrainJournal.size(); ++j) {
+        const int i = dung.terrainJournal[j];
+        if (i < 0 || static_cast<size_t>(i) >= n) continue;
+        updateTile(dung, i);
+        changed = true;
+    }
+    journalPos_ = dung.terrainJournal.size();
+    return changed;
+}
+
+void MonsterNavGrid::syncTerrain(const Dungeon& dung) {
+    if (!valid_ || dung.width != w_ || dung.height != h_ ||
+        dung.terrainEpoch != epoch_ || journalPos_ > dung.terrainJournal.size()) {
+        rebuild(dung);
+        return;
+    }
+
+    if (replayJournal(dung)) ++generation_;
+}
+
+void MonsterNavGrid::sync(const Dungeon& dung, const std::vector<Trap>& traps) {
+    if (!valid_ || dung.width != w_ || dung.height != h_ ||
+        dung.terrainEpoch != epoch_ || journalPos_ > dung.terrainJournal.size()) {
+        collectTrapPenalties(dung, traps, trapList_);
+        rebuild(dung);
+        return;
+    }
+
+    bool changed = replayJournal(dung);
+
+    collectTrapPenalties(dung, traps, trapScratch_);
+    if (trapScratch_ != trapList_) {
+        // Walk both sorted lists; any tile present in either with a different
+        // penalty gets re-derived.
+        size_t a = 0;
+        size_t b = 0;
+        while (a < trapList_.size() || b < trapScratch_.size()) {
+            int i = 0;
+            if (b >= trapScratch_.size() || (a < trapList_.size() && trapList_[a].first < trapScratch_[b].first)) {
+                i = trapList_[a++].first;
+                trapPenalty_[static_cast<size_t>(i)] = 0;
+            } else if (a >= trapList_.size() || trapScratch_[b].first < trapList_[a].first) {
+                i = trapScratch_[b].first;
+                trapPenalty_[static_cast<size_t>(i)] = trapScratch_[b++].second;
+            } else {
+                i = trapScratch_[b].first;
+                const bool same = trapList_[a].second == trapScratch_[b].second;
+                trapPenalty_[static_cast<size_t>(i)] = trapScratch_[b].second;
+                ++a;
+                ++b;
+                if (same) continue;
+            }
+            updateTile(dung, i);
+        }
+        trapList_.swap(trapScratch_);
+        changed = true;
+    }
+
+    if (changed) ++generation_;
+}
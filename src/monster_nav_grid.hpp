@@ -0,0 +1,78 @@
+#pragma once
+
+// Per-level monster navigation grid.
+//
+// monsterPassableForCaps()/monsterStepCostForCaps() re-derive tile type, door
+// state, chasm checks and the discovered-trap penalty on every node expansion.
+// The nav grid caches that static part of the rules once per level as one byte
+// plane per MonsterPathCaps combination (8 planes), so the pathfinder reads a
+// single contiguous array per neighbor instead of calling back into Game.
+//
+// Plane value: 0 = impassable for that capability set, otherwise the terrain
+// enter cost plus the discovered-trap penalty (always well below 256). Fire and
+// gas change every turn and are still added at query time (see
+// MonsterNavView in monster_pathing.hpp).
+//
+// Updates:
+//   - Tile changes are replayed from Dungeon::terrainJournal (dig, door helpers,
+//     setTileType), re-deriving only the touched tiles.
+//   - Trap discovery is detected by diffing the discovered-trap list (O(traps)).
+//   - A different terrain epoch (new/restored level, journal overflow) or a
+//     resized map triggers a full rebuild.
+
+#include "dungeon.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct Trap;
+
+class MonsterNavGrid {
+public:
+    static constexpr int CAPS_COMBOS = 8;
+
+    // Brings the grid up to date with `dung` and `traps`. Cheap when nothing changed.
+    void sync(const Dungeon& dung, const std::vector<Trap>& traps);
+
+    // Replays terrain changes only, keeping the discovered-trap snapshot from the
+    // last sync(). Monster turns snapshot trap knowledge once per turn but must see
+    // doors opened by earlier movers immediately.
+    void syncTerrain(const Dungeon& dung);
+
+    // Forces a full rebuild on the next sync().
+    void invalidate() { valid_ = false; }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    // Increments whenever any plane value changes. Useful as a cache key for
+    // derived cost fields.
+    uint32_t generation() const { return generation_; }
+
+    const uint8_t* plane(int caps) const { return planes_[static_cast<size_t>(caps & 7)].data(); }
+    const uint8_t* walkable() const { return walkable_.data(); }
+
+private:
+    void rebuild(const Dungeon& dung);
+    bool replayJournal(const Dungeon& dung);
+    void updateTile(const Dungeon& dung, int i);
+    void collectTrapPenalties(const Dungeon& dung, const std::vector<Trap>& traps,
+                              std::vector<std::pair<int, uint8_t>>& out) const;
+
+    std::array<std::vector<uint8_t>, CAPS_COMBOS> planes_{};
+    std::vector<uint8_t> walkable_;
+    std::vector<uint8_t> trapPenalty_;
+
+    // Sorted (tile index, penalty) list of discovered traps at the last sync.
+    std::vector<std::pair<int, uint8_t>> trapList_;
+    std::vector<std::pair<int, uint8_t>> trapScratch_;
+
+    int w_ = 0;
+    int h_ = 0;
+    uint32_t epoch_ = 0u;
+    size_t journalPos_ = 0;
+    uint32_t generation_ = 0u;
+    bool valid_ = false;
+};
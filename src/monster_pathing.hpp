@@ -8,6 +8,7 @@
 
 #include "game.hpp"
 
+#include "dijkstra_engine.hpp"
 #include "grid_utils.hpp"
 #include "pathfinding.hpp"
 
@@ -75,8 +76,9 @@ inline std::vector<int> buildDiscoveredTrapPenaltyGrid(const Game& g) {
     return out;
 }
 
-inline bool monsterPassableForCaps(const Game& g, int x, int y, int caps) {
-    const Dungeon& dung = g.dungeon();
+// Terrain-only part of monsterPassableForCaps(). Shared with MonsterNavGrid so the
+// cached planes can never drift from the direct rules.
+inline bool monsterTerrainPassableForCaps(const Dungeon& dung, int x, int y, int caps) {
     if (!dung.inBounds(x, y)) return false;
 
     // Phasing ignores terrain (but cannot leave the map).
@@ -91,60 +93,63 @@ inline bool monsterPassableForCaps(const Game& g, int x, int y, int caps) {
     return false;
 }
 
-inline int monsterStepCostForCaps(const Game& g, int x, int y, int caps, const std::vector<int>* discoveredTrapPenalty) {
-    const Dungeon& dung = g.dungeon();
+// Terrain-only part of monsterStepCostForCaps() (no hazards, no trap penalty).
+inline int monsterTerrainStepCostForCaps(const Dungeon& dung, int x, int y, int caps) {
     if (!dung.inBounds(x, y)) return 0;
 
-    int cost = 1;
-
     if (caps & MPC_Phase) {
         // Bias: prefer open corridors over "living" inside walls.
-        cost = dung.isWalkable(x, y) ? 1 : 2;
-    } else {
-        const TileType t = dung.at(x, y).type;
-        switch (t) {
-            case TileType::DoorClosed:
-                // Monsters open doors as an action, then step through next.
-                cost = 2;
-                break;
-            case TileType::DoorLocked:
-                // Smashing locks is much slower than opening an unlocked door.
-                cost = (caps & MPC_SmashLock) ? 4 : 0;
-                break;
-            default:
-                cost = 1;
-                break;
-        }
+        return dung.isWalkable(x, y) ? 1 : 2;
     }
 
-    if (cost <= 0) return cost;
+    switch (dung.at(x, y).type) {
+        case TileType::DoorClosed:
+            // Monsters open doors as an action, then step through next.
+            return 2;
+        case TileType::DoorLocked:
+            // Smashing locks is much slower than opening an unlocked door.
+            return (caps & MPC_SmashLock) ? 4 : 0;
+        default:
+            return 1;
+    }
+}
 
-    // Environmental hazards:
-    // - Fire is an obvious hazard: monsters generally try to route around it.
-    // - Confusion gas is undesirable.
-    // - Poison gas is also undesirable.
-    //
-    // NOTE: Even phasing monsters still prefer to avoid hazards; this keeps the
-    // ETA preview conservative and aligns with the AI.
-    const uint8_t f = g.fireAt(x, y);
+// Environmental hazard surcharge for entering a tile:
+// - Fire is an obvious hazard: monsters generally try to route around it.
+// - Confusion gas is undesirable.
+// - Poison gas is also undesirable.
+//
+// NOTE: Even phasing monsters still prefer to avoid hazards; this keeps the
+// ETA preview conservative and aligns with the AI.
+inline int monsterHazardStepPenalty(uint8_t f, uint8_t cg, uint8_t pg, uint8_t ag) {
+    int cost = 0;
     if (f > 0u) {
         cost += 10 + static_cast<int>(f) / 16; // +10..+25
     }
-
-    const uint8_t cg = g.confusionGasAt(x, y);
     if (cg > 0u) {
         cost += 6 + static_cast<int>(cg) / 32; // +6..+13
     }
-
-    const uint8_t pg = g.poisonGasAt(x, y);
     if (pg > 0u) {
         cost += 7 + static_cast<int>(pg) / 32; // +7..+14
     }
-
-    const uint8_t ag = g.corrosiveGasAt(x, y);
     if (ag > 0u) {
         cost += 8 + static_cast<int>(ag) / 32; // +8..+15
     }
+    return cost;
+}
+
+inline bool monsterPassableForCaps(const Game& g, int x, int y, int caps) {
+    return monsterTerrainPassableForCaps(g.dungeon(), x, y, caps);
+}
+
+inline int monsterStepCostForCaps(const Game& g, int x, int y, int caps, const std::vector<int>* discoveredTrapPenalty) {
+    const Dungeon& dung = g.dungeon();
+    if (!dung.inBounds(x, y)) return 0;
+
+    int cost = monsterTerrainStepCostForCaps(dung, x, y, caps);
+    if (cost <= 0) return cost;
+
+    cost += monsterHazardStepPenalty(g.fireAt(x, y), g.confusionGasAt(x, y), g.poisonGasAt(x, y), g.corrosiveGasAt(x, y));
 
     if (discoveredTrapPenalty && !discoveredTrapPenalty->empty()) {
         const int W = std::max(1, dung.width);
@@ -193,3 +198,84 @@ inline DiagonalOkFn monsterDiagonalOkFn(const Game& g, int caps) {
         return monsterDiagonalOkForCaps(g, fromX, fromY, dx, dy, caps);
     };
 }
+
+// Nav-grid backed view of the monster pathing rules for one capability set.
+//
+// Produces exactly the same answers as monsterPassableForCaps() /
+// monsterStepCostForCaps() (with the discovered-trap penalty grid) /
+// monsterDiagonalOkForCaps(), but reads the cached MonsterNavGrid planes plus the
+// raw hazard fields. Coordinates must be in bounds.
+struct MonsterNavView {
+    const uint8_t* plane = nullptr;
+    const uint8_t* walk = nullptr;
+    const uint8_t* fire = nullptr;
+    const uint8_t* confusion = nullptr;
+    const uint8_t* poison = nullptr;
+    const uint8_t* corrosive = nullptr;
+    int width = 0;
+    int caps = MPC_None;
+
+    bool passable(int x, int y) const {
+        return plane[static_cast<size_t>(y * width + x)] != 0u;
+    }
+
+    int stepCost(int x, int y) const {
+        const size_t i = static_cast<size_t>(y * width + x);
+        const int base = static_cast<int>(plane[i]);
+        if (base <= 0) return 0;
+        return base + monsterHazardStepPenalty(fire ? fire[i] : uint8_t{0},
+                                               confusion ? confusion[i] : uint8_t{0},
+                                               poison ? poison[i] : uint8_t{0},
+                                               corrosive ? corrosive[i] : uint8_t{0});
+    }
+
+    bool diagonalOk(int fromX, int fromY, int dx, int dy) const {
+        if (dx == 0 || dy == 0) return true;
+        if (caps & MPC_Phase) return true;
+        if (caps & MPC_Levitate) {
+            return passable(fromX + dx, fromY) && passable(fromX, fromY + dy);
+        }
+        // Same rule as diagonalPassable(): one walkable orthogonal is enough.
+        return walk[static_cast<size_t>(fromY * width + fromX + dx)] != 0u ||
+               walk[static_cast<size_t>((fromY + dy) * width + fromX)] != 0u;
+    }
+};
+
+// Builds a view over an already-synced nav grid.
+inline MonsterNavView monsterNavView(const Game& g, const MonsterNavGrid& nav, int caps) {
+    const size_t n = static_cast<size_t>(nav.width()) * static_cast<size_t>(nav.height());
+    auto field = [n](const std::vector<uint8_t>& f) -> const uint8_t* {
+        return (f.size() >= n) ? f.data() : nullptr;
+    };
+
+    MonsterNavView v;
+    v.plane = nav.plane(caps);
+    v.walk = nav.walkable();
+    v.fire = field(g.fireField());
+    v.confusion = field(g.confusionGasField());
+    v.poison = field(g.poisonGasField());
+    v.corrosive = field(g.corrosiveGasField());
+    v.width = nav.width();
+    v.caps = caps & 7;
+    return v;
+}
+
+// Cost-to-target field over a nav view (see dijkstraCostToTarget).
+inline void monsterCostToTarget(const MonsterNavView& v, int height, Vec2i target,
+                                std::vector<int>& out, int maxCost = -1) {
+    dijkstra::costToTarget(v.width, height, target,
+                           [&v](int x, int y) { return v.passable(x, y); },
+                           [&v](int x, int y) { return v.stepCost(x, y); },
+                           [&v](int fx, int fy, int dx, int dy) { return v.diagonalOk(fx, fy, dx, dy); },
+                           out, maxCost);
+}
+
+// Cost-from-nearest-source field over a nav view (see dijkstraCostFromSources).
+inline void monsterCostFromSources(const MonsterNavView& v, int height, const std::vector<Vec2i>& sources,
+                                   std::vector<int>& out, int maxCost = -1) {
+    dijkstra::costFromSources(v.width, height, sources,
+                              [&v](int x, int y) { return v.passable(x, y); },
+                              [&v](int x, int y) { return v.stepCost(x, y); },
+                              [&v](int fx, int fy, int dx, int dy) { return v.diagonalOk(fx, fy, dx, dy); },
+                              out, maxCost);
+}
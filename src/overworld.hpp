@@ -190,13 +190,15 @@ inline void ensureBorderGates(Dungeon& d, uint32_t runSeed, int chunkX, int chun
     auto carveGate = [&](Vec2i p, uint8_t bit) {
         if (!d.inBounds(p.x, p.y)) return;
 
-        d.at(p.x, p.y).type = TileType::Floor;
+        // setTileType(): this also runs on live levels (camp/chunk restore), so the carve
+        // must reach the terrain journal like any other runtime terrain change.
+        d.setTileType(p.x, p.y, TileType::Floor);
 
         // Carve a 1-tile throat inward so you can step through without hugging the border.
-        if (p.y == 0 && d.inBounds(p.x, p.y + 1)) d.at(p.x, p.y + 1).type = TileType::Floor;
-        if (p.y == d.height - 1 && d.inBounds(p.x, p.y - 1)) d.at(p.x, p.y - 1).type = TileType::Floor;
-        if (p.x == 0 && d.inBounds(p.x + 1, p.y)) d.at(p.x + 1, p.y).type = TileType::Floor;
-        if (p.x == d.width - 1 && d.inBounds(p.x - 1, p.y)) d.at(p.x - 1, p.y).type = TileType::Floor;
+        if (p.y == 0 && d.inBounds(p.x, p.y + 1)) d.setTileType(p.x, p.y + 1, TileType::Floor);
+        if (p.y == d.height - 1 && d.inBounds(p.x, p.y - 1)) d.setTileType(p.x, p.y - 1, TileType::Floor);
+        if (p.x == 0 && d.inBounds(p.x + 1, p.y)) d.setTileType(p.x + 1, p.y, TileType::Floor);
+        if (p.x == d.width - 1 && d.inBounds(p.x - 1, p.y)) d.setTileType(p.x - 1, p.y, TileType::Floor);
 
         d.gateMask |= (1u << bit);
         d.gatePositions.push_back(p);
@@ -0,0 +1,187 @@
+#pragma once
+
+// Background generation of the wilderness chunks around the current one (opt-in, shares
+// the switch with FloorPrefetch; see Game::setFloorPrefetchEnabled()).
+//
+// A never-visited chunk's terrain is a pure function of OverworldChunkParams: the run
+// seed, chunk coordinates, chunk size and the material/ecosystem inputs. While the player
+// walks around a chunk, the four gate-adjacent neighbors are generated on the shared
+// worker pool and parked in a small ring. Game::tryOverworldStep() asks take() for an
+// exact match and falls back to generating synchronously; population (monsters, items,
+// traps) always runs on arrival, so the result is identical either way.
+//
+// Memory is bounded twice over: visited chunks live in Game::overworldChunks_ (pruned by
+// radius), and the ring holds at most kCapacity pristine, never-visited terrains. When the
+// ring is full, or the player moves on, the pristine entries farthest from the player are
+// evicted first; visited chunks are never touched by the streamer.
+
+#include "dungeon.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <utility>
+#include <vector>
+
+struct OverworldChunkParams {
+    uint32_t runSeed = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    uint32_t materialSeed = 0; // Game::materialWorldSeed() once standing in the chunk
+    int materialDepth = 0;     // Game::materialDepth() once standing in the chunk
+    int maxDepth = 0;
+
+    bool operator==(const OverworldChunkParams& o) const {
+        return runSeed == o.runSeed && x == o.x && y == o.y && width == o.width && height == o.height &&
+               materialSeed == o.materialSeed && materialDepth == o.materialDepth && maxDepth == o.maxDepth;
+    }
+};
+
+class OverworldChunkPrefetch {
+public:
+    static constexpr size_t kCapacity = 8;
+
+    struct Stats {
+        uint64_t started = 0;
+        uint64_t used = 0;
+        uint64_t evicted = 0;
+    };
+
+    OverworldChunkPrefetch() = default;
+    OverworldChunkPrefetch(const OverworldChunkPrefetch&) = delete;
+    OverworldChunkPrefetch& operator=(const OverworldChunkPrefetch&) = delete;
+
+    // Running workers must not outlive the generator's function-local statics.
+    ~OverworldChunkPrefetch() {
+        clear();
+        for (auto& f : retired_) f.wait();
+    }
+
+    bool pendingFor(const OverworldChunkParams& params) const { return find(params.x, params.y, &params) != nullptr; }
+    size_t size() const { return slots_.size(); }
+
+    // Queues `params` on the shared worker pool unless it is already pending. `generate`
+    // must be a pure function of its argument. Evicts the pristine entry farthest from
+    // (focusX, focusY) if the ring is full.
+    template <typename GenFn>
+    void start(const OverworldChunkParams& params, int focusX, int focusY, GenFn generate) {
+        if (pendingFor(params)) return;
+        drop(params.x, params.y);
+        while (slots_.size() >= kCapacity) evictFarthest(focusX, focusY);
+
+        Slot s;
+        s.params = params;
+        s.result = ThreadPool::shared().submit([params, generate] { return generate(params); });
+        slots_.push_back(std::move(s));
+        ++stats_.started;
+    }
+
+    // Hands over prefetched terrain generated for exactly `params`, waiting for the worker
+    // if it is still running. Stale entries for the same chunk are dropped either way.
+    bool take(const OverworldChunkParams& params, Dungeon& out) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].params.x != params.x || slots_[i].params.y != params.y) continue;
+            Slot s = std::move(slots_[i]);
+            slots_.erase(slots_.begin() + static_cast<std::ptrdiff_t>(i));
+            if (!(s.params == params) || !s.result.valid()) {
+                retire(std::move(s));
+                return false;
+            }
+            try {
+                out = s.result.get();
+            } catch (const std::exception&) {
+                return false; // Caller regenerates synchronously.
+            }
+            ++stats_.used;
+            return true;
+        }
+        return false;
+    }
+
+    // Drops every entry farther than `radius` (Chebyshev) from (cx, cy).
+    void retainAround(int cx, int cy, int radius) {
+        for (size_t i = 0; i < slots_.size();) {
+            const Slot& s = slots_[i];
+            if (std::abs(s.params.x - cx) > radius || std::abs(s.params.y - cy) > radius) {
+                evictAt(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void clear() {
+        while (!slots_.empty()) evictAt(slots_.size() - 1);
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Slot {
+        OverworldChunkParams params;
+        std::future<Dungeon> result;
+    };
+
+    const Slot* find(int x, int y, const OverworldChunkParams* exact) const {
+        for (const Slot& s : slots_) {
+            if (s.params.x != x || s.params.y != y) continue;
+            if (exact && !(s.params == *exact)) return nullptr;
+            return &s;
+        }
+        return nullptr;
+    }
+
+    void drop(int x, int y) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].params.x == x && slots_[i].params.y == y) {
+                evictAt(i);
+                return;
+            }
+        }
+    }
+
+    // Same Chebyshev metric as retainAround(), so eviction order matches the retain radius.
+    void evictFarthest(int cx, int cy) {
+        size_t victim = 0;
+        int best = -1;
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            const int d = std::max(std::abs(slots_[i].params.x - cx), std::abs(slots_[i].params.y - cy));
+            if (d > best) {
+                best = d;
+                victim = i;
+            }
+        }
+        evictAt(victim);
+    }
+
+    void evictAt(size_t i) {
+        Slot s = std::move(slots_[i]);
+        slots_.erase(slots_.begin() + static_cast<std::ptrdiff_t>(i));
+        retire(std::move(s));
+        ++stats_.evicted;
+    }
+
+    // Abandoned jobs keep running; remember them so the destructor can wait.
+    void retire(Slot&& s) {
+        if (s.result.valid()) retired_.push_back(std::move(s.result));
+        for (size_t i = 0; i < retired_.size();) {
+            if (retired_[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                retired_[i] = std::move(retired_.back());
+                retired_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<std::future<Dungeon>> retired_;
+    Stats stats_{};
+};
@@ -157,7 +157,7 @@ KnockbackResult applyKnockback(Dungeon& dung,
                 out.doorPos = to;
                 out.doorFrom = t;
                 out.doorTo = TileType::DoorOpen;
-                dung.at(to.x, to.y).type = TileType::DoorOpen;
+                dung.setTileType(to.x, to.y, TileType::DoorOpen);
 
                 // Continue moving into the doorway.
                 defender->pos = to;
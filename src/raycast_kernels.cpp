@@ -0,0 +1,93 @@
+#include "raycast_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PROCROGUE_RAYCAST_SSE2 1
+#include <emmintrin.h>
+#else
+#define PROCROGUE_RAYCAST_SSE2 0
+#endif
+
+namespace raycast {
+
+void ShadeSpan::reset(size_t n) {
+    for (std::vector<uint8_t>* p : {&r, &g, &b, &modR, &modG, &modB, &addR, &addG, &addB}) p->assign(n, uint8_t{0});
+    shade.assign(n, 0.0f);
+}
+
+void ShadeSpan::setSpecular(size_t i, int ar, int ag, int ab) {
+    addR[i] = static_cast<uint8_t>(std::clamp(ar, 0, 255));
+    addG[i] = static_cast<uint8_t>(std::clamp(ag, 0, 255));
+    addB[i] = static_cast<uint8_t>(std::clamp(ab, 0, 255));
+}
+
+uint32_t shadePixel(const ShadeSpan& span, size_t i, const PixelShifts& shifts) {
+    const float s = std::clamp(span.shade[i], 0.0f, 1.25f);
+    auto channel = [&](uint8_t c, uint8_t mod, uint8_t add) -> uint32_t {
+        const int lit = (static_cast<int>(c) * static_cast<int>(mod)) / 255;
+        const int v = std::clamp(static_cast<int>(std::round(static_cast<float>(lit) * s)), 0, 255);
+        return static_cast<uint32_t>(std::min(255, v + static_cast<int>(add)));
+    };
+    return (channel(span.r[i], span.modR[i], span.addR[i]) << shifts.r)
+         | (channel(span.g[i], span.modG[i], span.addG[i]) << shifts.g)
+         | (channel(span.b[i], span.modB[i], span.addB[i]) << shifts.b)
+         | (255u << shifts.a);
+}
+
+void shadeSpan(const ShadeSpan& span, size_t n, const PixelShifts& shifts, uint32_t* out, size_t stride) {
+    n = std::min(n, span.size());
+    size_t i = 0;
+#if PROCROGUE_RAYCAST_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sMin = _mm_setzero_ps();
+    const __m128 sMax = _mm_set1_ps(1.25f);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(255u << shifts.a));
+
+    // Four bytes -> four 32-bit lanes, and back (saturating to 0..255).
+    auto bytes4 = [&](const std::vector<uint8_t>& p) -> __m128i {
+        int v = 0;
+        std::memcpy(&v, p.data() + i, sizeof(v));
+        return _mm_cvtsi32_si128(v);
+    };
+    auto widen = [&](__m128i v8) { return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v8, zero), zero); };
+    auto narrow = [&](__m128i v32) {
+        const __m128i v16 = _mm_packs_epi32(v32, v32);
+        return _mm_packus_epi16(v16, v16);
+    };
+
+    for (; i + 4 <= n; i += 4) {
+        const __m128 s = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(span.shade.data() + i), sMin), sMax);
+        auto channel = [&](const std::vector<uint8_t>& c, const std::vector<uint8_t>& mod,
+                           const std::vector<uint8_t>& add, int shift) -> __m128i {
+            // c * mod < 2^16 and the high halves of the lanes are zero, so the 16-bit
+            // multiply yields the full product; x / 255 == (x + 1 + (x >> 8)) >> 8 there.
+            const __m128i x = _mm_mullo_epi16(widen(bytes4(c)), widen(bytes4(mod)));
+            const __m128i lit = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, one), _mm_srli_epi32(x, 8)), 8);
+            // std::round for x >= 0: truncate, then add one when the (exact) fraction is >= 0.5.
+            // Adding 0.5 before truncating would round up values just below a tie.
+            const __m128 xf = _mm_mul_ps(_mm_cvtepi32_ps(lit), s);
+            const __m128i t = _mm_cvttps_epi32(xf);
+            const __m128 up = _mm_cmpge_ps(_mm_sub_ps(xf, _mm_cvtepi32_ps(t)), half);
+            const __m128i v = _mm_sub_epi32(t, _mm_castps_si128(up));
+            const __m128i sum = _mm_adds_epu8(narrow(v), bytes4(add));
+            return _mm_sll_epi32(widen(sum), _mm_cvtsi32_si128(shift));
+        };
+        const __m128i px = _mm_or_si128(_mm_or_si128(channel(span.r, span.modR, span.addR, shifts.r),
+                                                     channel(span.g, span.modG, span.addG, shifts.g)),
+                                        _mm_or_si128(channel(span.b, span.modB, span.addB, shifts.b), alpha));
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), px);
+        for (size_t k = 0; k < 4; ++k) out[(i + k) * stride] = lanes[k];
+    }
+#endif
+    for (; i < n; ++i) out[i * stride] = shadePixel(span, i, shifts);
+}
+
+bool simdEnabled() { return PROCROGUE_RAYCAST_SSE2 != 0; }
+
+} // namespace raycast
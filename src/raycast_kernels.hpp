@@ -0,0 +1,71 @@
+#pragma once
+
+// Column shading kernel for the Raycast3D view (Renderer::drawRaycast3DView()).
+//
+// The raycaster walks every screen column (DDA, then wall strip, ceiling and floor
+// casting) and used to light and pack each pixel on the spot. The per-pixel work that
+// does not depend on the ray is the same for all three surfaces:
+//
+//   c = texel * lightMod / 255        (per-tile light map, integer)
+//   c = clamp(round(c * shade))        (distance fog / bump diffuse, shade in 0..1.25)
+//   c = saturate(c + specular)
+//   pixel = pack(c, alpha 255)
+//
+// so a column now records its texels, light mods, shades and specular adds into a
+// ShadeSpan, and shadeSpan() runs that tail across the span: four pixels at a time with
+// SSE2, one at a time otherwise. Both paths are bit-identical to the scalar formula
+// (std::round is matched as trunc(x) + (x - trunc(x) >= 0.5), exact for 0 <= x < 2^23).
+//
+// The kernel is SDL-free; the caller passes the channel shifts of its pixel format.
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace raycast {
+
+// One screen column's worth of unlit pixels, as planes.
+struct ShadeSpan {
+    std::vector<uint8_t> r, g, b;          // texel color
+    std::vector<uint8_t> modR, modG, modB; // light modulation (255 = unlit texel as-is)
+    std::vector<float> shade;               // clamped to 0..1.25 by the kernel
+    std::vector<uint8_t> addR, addG, addB;  // additive specular highlight
+
+    // Sizes the planes to n pixels, all black.
+    void reset(size_t n);
+
+    void set(size_t i, const Color& c, const Color& mod, float s) {
+        r[i] = c.r;
+        g[i] = c.g;
+        b[i] = c.b;
+        modR[i] = mod.r;
+        modG[i] = mod.g;
+        modB[i] = mod.b;
+        shade[i] = s;
+    }
+    void setSpecular(size_t i, int ar, int ag, int ab);
+    void setGray(size_t i, uint8_t v) { set(i, Color{v, v, v, 255}, Color{255, 255, 255, 255}, 1.0f); }
+    void setBlack(size_t i) { set(i, Color{0, 0, 0, 255}, Color{0, 0, 0, 255}, 0.0f); }
+
+    size_t size() const { return shade.size(); }
+};
+
+struct PixelShifts {
+    int r = 0;
+    int g = 8;
+    int b = 16;
+    int a = 24;
+};
+
+// Shades span pixels [0, n) and writes them to out[0], out[stride], out[2 * stride], ...
+void shadeSpan(const ShadeSpan& span, size_t n, const PixelShifts& shifts, uint32_t* out, size_t stride);
+
+// The scalar formula, one pixel (reference for tests).
+uint32_t shadePixel(const ShadeSpan& span, size_t i, const PixelShifts& shifts);
+
+// True when shadeSpan() uses the SSE2 path.
+bool simdEnabled();
+
+} // namespace raycast
@@ -10,6 +10,9 @@
 #include "artifact_gen.hpp"
 #include "shop_profile_gen.hpp"
 #include "shrine_profile_gen.hpp"
+#include "sprite_batch.hpp"
+#include "raycast_kernels.hpp"
+#include "thread_pool.hpp"
 
 #include <algorithm>
 #include <cctype>
@@ -1506,6 +1509,8 @@ bool Renderer::init() {
     }
     spriteTex.setBudgetBytes(budgetBytes);
     spriteTex.resetStats();
+    // Placeholders are 16px: 1 MB holds a few hundred, more than are ever pending at once.
+    spritePlaceholderTex.setBudgetBytes(1024ull * 1024ull);
 
     // Configure the UI preview cache budget.
     // These are larger (e.g. 128x128+) and rotate through multiple yaws.
@@ -1538,13 +1543,17 @@ bool Renderer::init() {
     fountainOverlayVar.resize(static_cast<size_t>(tileVars));
     altarOverlayVar.resize(static_cast<size_t>(tileVars));
 
+    // The generators below are pure; they only queue jobs here and run in parallel at the
+    // end of the tileset setup (see SpriteBatch).
+    SpriteBatch<SDL_Texture*> tiles;
+
     for (int i = 0; i < tileVars; ++i) {
         // Floor: build a full themed tileset so special rooms pop.
         for (int st = 0; st < ROOM_STYLES; ++st) {
             const uint32_t fSeed = hashCombine(hashCombine(0xF1000u, static_cast<uint32_t>(st)), static_cast<uint32_t>(i));
             for (int f = 0; f < FRAMES; ++f) {
-                floorThemeVar[static_cast<size_t>(st)][static_cast<size_t>(i)][static_cast<size_t>(f)] =
-                    textureFromSprite(generateThemedFloorTile(fSeed, static_cast<uint8_t>(st), f, spritePx));
+                tiles.add(&floorThemeVar[static_cast<size_t>(st)][static_cast<size_t>(i)][static_cast<size_t>(f)],
+                          [=] { return generateThemedFloorTile(fSeed, static_cast<uint8_t>(st), f, spritePx); });
             }
         }
 
@@ -1556,32 +1565,46 @@ bool Renderer::init() {
         const uint32_t foSeed = hashCombine(0xF017A1u, static_cast<uint32_t>(i));
         const uint32_t alSeed = hashCombine(0xA17A12u, static_cast<uint32_t>(i));
         for (int f = 0; f < FRAMES; ++f) {
-            wallVar[static_cast<size_t>(i)][static_cast<size_t>(f)]  = textureFromSprite(generateWallTile(wSeed, f, spritePx));
-            chasmVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateChasmTile(cSeed, f, spritePx));
+            tiles.add(&wallVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generateWallTile(wSeed, f, spritePx); });
+            tiles.add(&chasmVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generateChasmTile(cSeed, f, spritePx); });
             // Pillar is generated as a transparent overlay; it will be layered over the
             // underlying themed floor at render-time.
-            pillarOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generatePillarTile(pSeed, f, spritePx));
-            boulderOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateBoulderTile(bSeed, f, spritePx));
-            fountainOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateFountainTile(foSeed, f, spritePx));
-            altarOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateAltarTile(alSeed, f, spritePx));
+            tiles.add(&pillarOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generatePillarTile(pSeed, f, spritePx); });
+            tiles.add(&boulderOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generateBoulderTile(bSeed, f, spritePx); });
+            tiles.add(&fountainOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generateFountainTile(foSeed, f, spritePx); });
+            tiles.add(&altarOverlayVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                      [=] { return generateAltarTile(alSeed, f, spritePx); });
         }
     }
 
     for (int f = 0; f < FRAMES; ++f) {
         // Doors and stairs are rendered as overlays layered over the underlying themed floor.
-        stairsUpOverlayTex[static_cast<size_t>(f)]   = textureFromSprite(generateStairsTile(0x515A1u, true, f, spritePx));
-        stairsDownOverlayTex[static_cast<size_t>(f)] = textureFromSprite(generateStairsTile(0x515A2u, false, f, spritePx));
-        doorClosedOverlayTex[static_cast<size_t>(f)] = textureFromSprite(generateDoorTile(0xD00Du, false, f, spritePx));
-        doorLockedOverlayTex[static_cast<size_t>(f)] = textureFromSprite(generateLockedDoorTile(0xD00Du, f, spritePx));
-        doorOpenOverlayTex[static_cast<size_t>(f)]   = textureFromSprite(generateDoorTile(0xD00Du, true, f, spritePx));
+        tiles.add(&stairsUpOverlayTex[static_cast<size_t>(f)],
+                  [=] { return generateStairsTile(0x515A1u, true, f, spritePx); });
+        tiles.add(&stairsDownOverlayTex[static_cast<size_t>(f)],
+                  [=] { return generateStairsTile(0x515A2u, false, f, spritePx); });
+        tiles.add(&doorClosedOverlayTex[static_cast<size_t>(f)],
+                  [=] { return generateDoorTile(0xD00Du, false, f, spritePx); });
+        tiles.add(&doorLockedOverlayTex[static_cast<size_t>(f)],
+                  [=] { return generateLockedDoorTile(0xD00Du, f, spritePx); });
+        tiles.add(&doorOpenOverlayTex[static_cast<size_t>(f)],
+                  [=] { return generateDoorTile(0xD00Du, true, f, spritePx); });
     }
 
 // Default UI skin assets (will refresh if theme changes at runtime).
 uiThemeCached = UITheme::DarkStone;
 uiAssetsValid = true;
+const UITheme uiTheme = uiThemeCached;
 for (int f = 0; f < FRAMES; ++f) {
-    uiPanelTileTex[static_cast<size_t>(f)] = textureFromSprite(generateUIPanelTile(uiThemeCached, 0x51A11u, f, 16));
-    uiOrnamentTex[static_cast<size_t>(f)]  = textureFromSprite(generateUIOrnamentTile(uiThemeCached, 0x0ABCDu, f, 16));
+    tiles.add(&uiPanelTileTex[static_cast<size_t>(f)],
+              [=] { return generateUIPanelTile(uiTheme, 0x51A11u, f, 16); });
+    tiles.add(&uiOrnamentTex[static_cast<size_t>(f)],
+              [=] { return generateUIOrnamentTile(uiTheme, 0x0ABCDu, f, 16); });
 }
 
 // Pre-generate decal overlays (small transparent patterns blended onto tiles).
@@ -1595,8 +1618,10 @@ for (int st = 0; st < DECAL_STYLES; ++st) {
         const uint32_t wSeed = hashCombine(0xBADC0DEu + static_cast<uint32_t>(st) * 191u, static_cast<uint32_t>(i));
         const size_t idx = static_cast<size_t>(st * decalsPerStyleUsed + i);
         for (int f = 0; f < FRAMES; ++f) {
-            floorDecalVar[idx][static_cast<size_t>(f)] = textureFromSprite(generateFloorDecalTile(fSeed, static_cast<uint8_t>(st), f, spritePx));
-            wallDecalVar[idx][static_cast<size_t>(f)]  = textureFromSprite(generateWallDecalTile(wSeed, static_cast<uint8_t>(st), f, spritePx));
+            tiles.add(&floorDecalVar[idx][static_cast<size_t>(f)],
+                      [=] { return generateFloorDecalTile(fSeed, static_cast<uint8_t>(st), f, spritePx); });
+            tiles.add(&wallDecalVar[idx][static_cast<size_t>(f)],
+                      [=] { return generateWallDecalTile(wSeed, static_cast<uint8_t>(st), f, spritePx); });
         }
     }
 }
@@ -1613,10 +1638,10 @@ for (size_t mi = 0; mi < TERRAIN_MATERIAL_COUNT; ++mi) {
         const uint32_t fSeed = hashCombine(0x1A7E11u + static_cast<uint32_t>(mi) * 131u, static_cast<uint32_t>(v));
         const uint32_t wSeed = hashCombine(0x4411E1u + static_cast<uint32_t>(mi) * 191u, static_cast<uint32_t>(v));
         for (int f = 0; f < FRAMES; ++f) {
-            floorMaterialOverlayVar[mi][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                textureFromSprite(generateFloorMaterialOverlay(fSeed, mat, f, spritePx));
-            wallMaterialOverlayVar[mi][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                textureFromSprite(generateWallMaterialOverlay(wSeed, mat, f, spritePx));
+            tiles.add(&floorMaterialOverlayVar[mi][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                      [=] { return generateFloorMaterialOverlay(fSeed, mat, f, spritePx); });
+            tiles.add(&wallMaterialOverlayVar[mi][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                      [=] { return generateWallMaterialOverlay(wSeed, mat, f, spritePx); });
         }
     }
     // Ensure unused variants are nullptr (materialOverlayVarsUsed may be < MATERIAL_OVERLAY_VARS at large tile sizes).
@@ -1636,8 +1661,12 @@ for (size_t mi = 0; mi < TERRAIN_MATERIAL_COUNT; ++mi) {
                 const uint32_t bSeed = hashCombine(0xB0BDE3D0u + static_cast<uint32_t>(st) * 131u + static_cast<uint32_t>(mask) * 17u,
                                                    static_cast<uint32_t>(v));
                 for (int f = 0; f < FRAMES; ++f) {
-                    floorBorderVar[static_cast<size_t>(st)][static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                        (st == 0 || mask == 0) ? nullptr : textureFromSprite(generateFloorBorderOverlay(bSeed, static_cast<uint8_t>(st), static_cast<uint8_t>(mask), v, f, spritePx));
+                    if (st == 0 || mask == 0) {
+                        floorBorderVar[static_cast<size_t>(st)][static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] = nullptr;
+                    } else {
+                        tiles.add(&floorBorderVar[static_cast<size_t>(st)][static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                                  [=] { return generateFloorBorderOverlay(bSeed, static_cast<uint8_t>(st), static_cast<uint8_t>(mask), v, f, spritePx); });
+                    }
                 }
             }
             // Ensure unused variants are nullptr (borderVarsUsed may be < BORDER_VARS at large tile sizes).
@@ -1657,12 +1686,18 @@ for (int mask = 0; mask < AUTO_MASKS; ++mask) {
         const uint32_t cSeed = hashCombine(0xC0A5E00u + static_cast<uint32_t>(mask) * 191u, static_cast<uint32_t>(v));
         const uint32_t sSeed = hashCombine(0x5EAD0DEu + static_cast<uint32_t>(mask) * 227u, static_cast<uint32_t>(v));
         for (int f = 0; f < FRAMES; ++f) {
-            wallEdgeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                (mask == 0) ? nullptr : textureFromSprite(generateWallEdgeOverlay(wSeed, static_cast<uint8_t>(mask), v, f, spritePx));
-            chasmRimVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                (mask == 0) ? nullptr : textureFromSprite(generateChasmRimOverlay(cSeed, static_cast<uint8_t>(mask), v, f, spritePx));
-            topDownWallShadeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] =
-                (mask == 0) ? nullptr : textureFromSprite(generateTopDownWallShadeOverlay(sSeed, static_cast<uint8_t>(mask), v, f, spritePx));
+            if (mask == 0) {
+                wallEdgeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] = nullptr;
+                chasmRimVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] = nullptr;
+                topDownWallShadeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)] = nullptr;
+                continue;
+            }
+            tiles.add(&wallEdgeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                      [=] { return generateWallEdgeOverlay(wSeed, static_cast<uint8_t>(mask), v, f, spritePx); });
+            tiles.add(&chasmRimVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                      [=] { return generateChasmRimOverlay(cSeed, static_cast<uint8_t>(mask), v, f, spritePx); });
+            tiles.add(&topDownWallShadeVar[static_cast<size_t>(mask)][static_cast<size_t>(v)][static_cast<size_t>(f)],
+                      [=] { return generateTopDownWallShadeOverlay(sSeed, static_cast<uint8_t>(mask), v, f, spritePx); });
         }
     }
 }
@@ -1671,7 +1706,8 @@ for (int mask = 0; mask < AUTO_MASKS; ++mask) {
 for (int i = 0; i < GAS_VARS; ++i) {
     const uint32_t gSeed = hashCombine(0x6A5u, static_cast<uint32_t>(i));
     for (int f = 0; f < FRAMES; ++f) {
-        gasVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateConfusionGasTile(gSeed, f, spritePx));
+        tiles.add(&gasVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                  [=] { return generateConfusionGasTile(gSeed, f, spritePx); });
     }
 }
 
@@ -1679,7 +1715,8 @@ for (int i = 0; i < GAS_VARS; ++i) {
 for (int i = 0; i < FIRE_VARS; ++i) {
     const uint32_t fSeed = hashCombine(0xF17Eu, static_cast<uint32_t>(i));
     for (int f = 0; f < FRAMES; ++f) {
-        fireVar[static_cast<size_t>(i)][static_cast<size_t>(f)] = textureFromSprite(generateFireTile(fSeed, f, spritePx));
+        tiles.add(&fireVar[static_cast<size_t>(i)][static_cast<size_t>(f)],
+                  [=] { return generateFireTile(fSeed, f, spritePx); });
     }
 }
 
@@ -1687,17 +1724,23 @@ for (int i = 0; i < FIRE_VARS; ++i) {
 for (int k = 0; k < EFFECT_KIND_COUNT; ++k) {
     const EffectKind ek = static_cast<EffectKind>(k);
     for (int f = 0; f < FRAMES; ++f) {
-        effectIconTex[static_cast<size_t>(k)][static_cast<size_t>(f)] = textureFromSprite(generateEffectIcon(ek, f, 16));
+        tiles.add(&effectIconTex[static_cast<size_t>(k)][static_cast<size_t>(f)],
+                  [=] { return generateEffectIcon(ek, f, 16); });
     }
 }
 
 
 // Pre-generate cursor / targeting reticle overlays (map-space UI).
 for (int f = 0; f < FRAMES; ++f) {
-    cursorReticleTex[static_cast<size_t>(f)] = textureFromSprite(generateCursorReticleTile(0xC0A51Eu, /*isometric=*/false, f, spritePx));
-    cursorReticleIsoTex[static_cast<size_t>(f)] = textureFromSprite(generateCursorReticleTile(0xC0A51Eu, /*isometric=*/true, f, spritePx));
+    tiles.add(&cursorReticleTex[static_cast<size_t>(f)],
+              [=] { return generateCursorReticleTile(0xC0A51Eu, /*isometric=*/false, f, spritePx); });
+    tiles.add(&cursorReticleIsoTex[static_cast<size_t>(f)],
+              [=] { return generateCursorReticleTile(0xC0A51Eu, /*isometric=*/true, f, spritePx); });
 }
 
+// Generate everything queued above on the worker pool; textures are created here, in order.
+tiles.run([this](SDL_Texture*& slot, const SpritePixels& px) { slot = textureFromSprite(px); });
+
 // Reset room-type cache (rebuilt lazily in render()).
 roomTypeCache.clear();
 roomCacheDungeon = nullptr;
@@ -2040,7 +2083,10 @@ uiAssetsValid = false;
     cursorReticleIsoTex.fill(nullptr);
 
     // Entity/item/projectile textures are budget-cached in spriteTex.
+    spriteJobs_.cancelAll();
+    spriteJobs_.waitIdle();
     spriteTex.clear();
+    spritePlaceholderTex.clear();
 
     // CPU-side billboard sprite cache (raycast 3D view).
     raycast3DSpriteCache_.clear();
@@ -2072,6 +2118,14 @@ void Renderer::toggleFullscreen() {
 }
 
 
+void Renderer::setSpriteDiskCache(const std::filesystem::path& path, int maxMB) {
+    spriteDisk_.close();
+    if (maxMB <= 0) return;
+    if (!spriteDisk_.open(path, SpriteDiskCache::defaultStamp(), static_cast<size_t>(maxMB) * 1024u * 1024u)) {
+        std::cerr << "Sprite cache unavailable (" << path.string() << "); sprites will be regenerated.\n";
+    }
+}
+
 void Renderer::setRaycast3DScale(int scale) {
     scale = std::clamp(scale, 1, 4);
     if (scale == raycast3DScale_) return;
@@ -3740,6 +3794,28 @@ namespace {
                static_cast<uint64_t>(flags);
     }
 
+    // Texture bytes of finished async sprites uploaded per rendered frame (at least one
+    // sprite always goes through). 4 MB is four 256px 2D sprites or ~256 32px voxel ones.
+    constexpr size_t SPRITE_UPLOAD_BUDGET_BYTES = 4u * 1024u * 1024u;
+
+    // On-disk sprite cache key: the full set of generator inputs. Categories share the
+    // values above; isometric terrain blocks use their own.
+    constexpr uint8_t CAT_ISO_BLOCK = 16;
+
+    inline SpriteCacheKey makeDiskKey(uint8_t cat, uint8_t kind, uint32_t seed, int frame, int pxSize,
+                                      bool use3d, bool isometric, bool isoRaytrace) {
+        SpriteCacheKey k;
+        k.category = cat;
+        k.kind = kind;
+        k.seed = seed;
+        k.frame = static_cast<uint8_t>(frame);
+        k.pxSize = static_cast<uint16_t>(pxSize);
+        k.flags = static_cast<uint8_t>((use3d ? SpriteCacheKey::kUse3D : 0u) |
+                                       (isometric ? SpriteCacheKey::kIsometric : 0u) |
+                                       (isoRaytrace ? SpriteCacheKey::kIsoRaytrace : 0u));
+        return k;
+    }
+
     // For NetHack-style identification, identifiable items have randomized
     // *appearances* each run (e.g., "ruby potion", "scroll labeled KLAATU").
     // If we rendered their true item-kind sprites, you'd be able to ID them
@@ -3791,6 +3867,72 @@ namespace {
 	}
 }
 
+SDL_Texture* Renderer::cachedSpriteTexture(uint64_t key, SpriteCacheKey diskKey, int frame,
+                                           SpriteFrameGen gen, const SpriteFrameGen& placeholder) {
+    const size_t fi = static_cast<size_t>(frame % FRAMES);
+    if (auto arr = spriteTex.get(key)) return (*arr)[fi];
+
+    if (!spriteJobs_.pending(key)) {
+        // Reading frames back from the disk cache is cheap, so only sprites that really
+        // need generating go through the worker pool.
+        std::vector<SpritePixels> frames(static_cast<size_t>(FRAMES));
+        int missing = 0;
+        for (int f = 0; f < FRAMES; ++f) {
+            diskKey.frame = static_cast<uint8_t>(f);
+            if (!spriteDisk_.get(diskKey, frames[static_cast<size_t>(f)])) ++missing;
+        }
+        if (missing == 0) {
+            putSpriteFrames(spriteTex, key, frames);
+            auto arr = spriteTex.get(key);
+            return arr ? (*arr)[fi] : nullptr;
+        }
+
+        SpriteDiskCache* disk = &spriteDisk_;
+        spriteJobs_.request(key, [disk, diskKey, gen = std::move(gen), frames = std::move(frames)]() mutable {
+            for (int f = 0; f < FRAMES; ++f) {
+                SpritePixels& px = frames[static_cast<size_t>(f)];
+                if (!px.px.empty()) continue;
+                px = gen(f);
+                SpriteCacheKey dk = diskKey;
+                dk.frame = static_cast<uint8_t>(f);
+                disk->put(dk, px);
+            }
+            return std::move(frames);
+        });
+    }
+
+    // The placeholder does not depend on the sprite mode, so it outlives mode toggles.
+    const uint64_t placeholderKey = key & ~uint64_t{0xFFFFu};
+    auto ph = spritePlaceholderTex.get(placeholderKey);
+    if (!ph) {
+        std::vector<SpritePixels> frames;
+        frames.reserve(static_cast<size_t>(FRAMES));
+        for (int f = 0; f < FRAMES; ++f) frames.push_back(placeholder(f));
+        putSpriteFrames(spritePlaceholderTex, placeholderKey, frames);
+        ph = spritePlaceholderTex.get(placeholderKey);
+        if (!ph) return nullptr;
+    }
+    return (*ph)[fi];
+}
+
+void Renderer::putSpriteFrames(LRUTextureCache<FRAMES>& cache, uint64_t key, const std::vector<SpritePixels>& frames) {
+    std::array<SDL_Texture*, FRAMES> tex{};
+    tex.fill(nullptr);
+    size_t bytes = 0;
+    for (size_t f = 0; f < tex.size() && f < frames.size(); ++f) {
+        tex[f] = textureFromSprite(frames[f]);
+        bytes += static_cast<size_t>(frames[f].w) * static_cast<size_t>(frames[f].h) * sizeof(uint32_t);
+    }
+    cache.put(key, tex, bytes);
+}
+
+void Renderer::uploadFinishedSprites() {
+    spriteJobs_.drain(SPRITE_UPLOAD_BUDGET_BYTES, [&](uint64_t key, const std::vector<SpritePixels>& frames) {
+        // A failed job comes back empty; the next lookup simply queues it again.
+        if (frames.size() == static_cast<size_t>(FRAMES)) putSpriteFrames(spriteTex, key, frames);
+    });
+}
+
 SDL_Texture* Renderer::entityTexture(const Entity& e, int frame) {
     // In 2D sprite mode (voxel sprites disabled), generate at 256x256 by default
     // to maximize detail, then scale down at render-time using nearest-neighbor.
@@ -3801,21 +3943,16 @@ SDL_Texture* Renderer::entityTexture(const Entity& e, int frame) {
         : 0u;
     const uint64_t key = makeSpriteKey(CAT_ENTITY, static_cast<uint8_t>(e.kind), e.spriteSeed, flags);
 
-    auto arr = spriteTex.get(key);
-    if (!arr) {
-        std::array<SDL_Texture*, FRAMES> tex{};
-        tex.fill(nullptr);
-        for (int f = 0; f < FRAMES; ++f) {
-            tex[static_cast<size_t>(f)] = textureFromSprite(generateEntitySprite(e.kind, e.spriteSeed, f, voxelSpritesCached, spritePx, viewMode_ == ViewMode::Isometric, isoVoxelRaytraceCached));
-        }
-        const size_t bytes = static_cast<size_t>(spritePx) * static_cast<size_t>(spritePx)
-            * sizeof(uint32_t) * static_cast<size_t>(FRAMES);
-
-        spriteTex.put(key, tex, bytes);
-        arr = spriteTex.get(key);
-        if (!arr) return nullptr;
-    }
-    return (*arr)[static_cast<size_t>(frame % FRAMES)];
+    const bool iso = viewMode_ == ViewMode::Isometric;
+    const SpriteCacheKey dk = makeDiskKey(CAT_ENTITY, static_cast<uint8_t>(e.kind), e.spriteSeed, 0, spritePx,
+                                          voxelSpritesCached, iso, isoVoxelRaytraceCached);
+    const EntityKind kind = e.kind;
+    const uint32_t seed = e.spriteSeed;
+    const bool use3d = voxelSpritesCached;
+    const bool raytrace = isoVoxelRaytraceCached;
+    return cachedSpriteTexture(key, dk, frame,
+        [=](int f) { return generateEntitySprite(kind, seed, f, use3d, spritePx, iso, raytrace); },
+        [=](int f) { return generateEntitySprite(kind, seed, f, false, 16); });
 }
 
 SDL_Texture* Renderer::itemTexture(const Item& it, int frame) {
@@ -3829,22 +3966,15 @@ SDL_Texture* Renderer::itemTexture(const Item& it, int frame) {
 	const uint32_t seed = itemVisualSpriteSeed(it);
 	const uint64_t key = makeSpriteKey(CAT_ITEM, static_cast<uint8_t>(it.kind), seed, flags);
 
-    auto arr = spriteTex.get(key);
-    if (!arr) {
-        std::array<SDL_Texture*, FRAMES> tex{};
-        tex.fill(nullptr);
-		for (int f = 0; f < FRAMES; ++f) {
-			tex[static_cast<size_t>(f)] = textureFromSprite(generateItemSprite(it.kind, seed, f, voxelSpritesCached, spritePx, viewMode_ == ViewMode::Isometric, isoVoxelRaytraceCached));
-		}
-
-        const size_t bytes = static_cast<size_t>(spritePx) * static_cast<size_t>(spritePx)
-            * sizeof(uint32_t) * static_cast<size_t>(FRAMES);
-
-        spriteTex.put(key, tex, bytes);
-        arr = spriteTex.get(key);
-        if (!arr) return nullptr;
-    }
-    return (*arr)[static_cast<size_t>(frame % FRAMES)];
+    const bool iso = viewMode_ == ViewMode::Isometric;
+    const SpriteCacheKey dk = makeDiskKey(CAT_ITEM, static_cast<uint8_t>(it.kind), seed, 0, spritePx,
+                                          voxelSpritesCached, iso, isoVoxelRaytraceCached);
+    const ItemKind kind = it.kind;
+    const bool use3d = voxelSpritesCached;
+    const bool raytrace = isoVoxelRaytraceCached;
+    return cachedSpriteTexture(key, dk, frame,
+        [=](int f) { return generateItemSprite(kind, seed, f, use3d, spritePx, iso, raytrace); },
+        [=](int f) { return generateItemSprite(kind, seed, f, false, 16); });
 }
 
 void Renderer::drawItemIcon(const Game& game, const Item& it, int x, int y, int px) {
@@ -3909,22 +4039,14 @@ SDL_Texture* Renderer::projectileTexture(ProjectileKind k, int frame) {
         : 0u;
     const uint64_t key = makeSpriteKey(CAT_PROJECTILE, static_cast<uint8_t>(k), 0u, flags);
 
-    auto arr = spriteTex.get(key);
-    if (!arr) {
-        std::array<SDL_Texture*, FRAMES> tex{};
-        tex.fill(nullptr);
-        for (int f = 0; f < FRAMES; ++f) {
-            tex[static_cast<size_t>(f)] = textureFromSprite(generateProjectileSprite(k, 0u, f, voxelSpritesCached, spritePx, viewMode_ == ViewMode::Isometric, isoVoxelRaytraceCached));
-        }
-
-        const size_t bytes = static_cast<size_t>(spritePx) * static_cast<size_t>(spritePx)
-            * sizeof(uint32_t) * static_cast<size_t>(FRAMES);
-
-        spriteTex.put(key, tex, bytes);
-        arr = spriteTex.get(key);
-        if (!arr) return nullptr;
-    }
-    return (*arr)[static_cast<size_t>(frame % FRAMES)];
+    const bool iso = viewMode_ == ViewMode::Isometric;
+    const SpriteCacheKey dk = makeDiskKey(CAT_PROJECTILE, static_cast<uint8_t>(k), 0u, 0, spritePx,
+                                          voxelSpritesCached, iso, isoVoxelRaytraceCached);
+    const bool use3d = voxelSpritesCached;
+    const bool raytrace = isoVoxelRaytraceCached;
+    return cachedSpriteTexture(key, dk, frame,
+        [=](int f) { return generateProjectileSprite(k, 0u, f, use3d, spritePx, iso, raytrace); },
+        [=](int f) { return generateProjectileSprite(k, 0u, f, false, 16); });
 }
 
 void Renderer::ensureUIAssets(const Game& game) {
@@ -3976,6 +4098,13 @@ void Renderer::ensureIsoTerrainAssets(uint32_t styleSeed, bool voxelBlocks, bool
         && isoTerrainVoxelBlocksCached_ == voxelBlocks
         && isoTerrainVoxelBlocksRaytraceCached_ == useRaytraceBlocks) return;
 
+    // Voxel blocks are the expensive part of this setup; they go through the disk cache.
+    auto voxelBlock = [&](IsoTerrainBlockKind kind, uint32_t seed, int f) {
+        const SpriteCacheKey dk = makeDiskKey(CAT_ISO_BLOCK, static_cast<uint8_t>(kind), seed, f, spritePx,
+                                              /*use3d=*/true, /*isometric=*/true, useRaytraceBlocks);
+        return spriteDisk_.getOrGenerate(dk, [&] { return renderIsoTerrainBlockVoxel(kind, seed, f, spritePx, useRaytraceBlocks); });
+    };
+
     // Defensive cleanup in case we ever re-generate (e.g., future runtime tile-size changes).
     for (auto& styleVec : floorThemeVarIso) {
         for (auto& arr : styleVec) {
@@ -4136,7 +4265,7 @@ void Renderer::ensureIsoTerrainAssets(uint32_t styleSeed, bool voxelBlocks, bool
         for (int f = 0; f < FRAMES; ++f) {
             SpritePixels sp;
             if (voxelBlocks) {
-                sp = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::Wall, seed, f, spritePx, useRaytraceBlocks);
+                sp = voxelBlock(IsoTerrainBlockKind::Wall, seed, f);
             } else {
                 sp = generateIsometricWallBlockTile(seed, f, spritePx);
             }
@@ -4157,9 +4286,9 @@ void Renderer::ensureIsoTerrainAssets(uint32_t styleSeed, bool voxelBlocks, bool
             SpritePixels open;
 
             if (voxelBlocks) {
-                closed = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::DoorClosed, baseSeed ^ 0xC105EDu, f, spritePx, useRaytraceBlocks);
-                locked = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::DoorLocked, baseSeed ^ 0x10CCEDu, f, spritePx, useRaytraceBlocks);
-                open   = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::DoorOpen,   baseSeed ^ 0x0B0A1u, f, spritePx, useRaytraceBlocks);
+                closed = voxelBlock(IsoTerrainBlockKind::DoorClosed, baseSeed ^ 0xC105EDu, f);
+                locked = voxelBlock(IsoTerrainBlockKind::DoorLocked, baseSeed ^ 0x10CCEDu, f);
+                open   = voxelBlock(IsoTerrainBlockKind::DoorOpen,   baseSeed ^ 0x0B0A1u, f);
             } else {
                 closed = generateIsometricDoorBlockTile(baseSeed ^ 0xC105EDu, /*locked=*/false, f, spritePx);
                 locked = generateIsometricDoorBlockTile(baseSeed ^ 0x10CCEDu, /*locked=*/true, f, spritePx);
@@ -4185,8 +4314,8 @@ void Renderer::ensureIsoTerrainAssets(uint32_t styleSeed, bool voxelBlocks, bool
             SpritePixels bsp;
 
             if (voxelBlocks) {
-                psp = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::Pillar, pSeed, f, spritePx, useRaytraceBlocks);
-                bsp = renderIsoTerrainBlockVoxel(IsoTerrainBlockKind::Boulder, bSeed, f, spritePx, useRaytraceBlocks);
+                psp = voxelBlock(IsoTerrainBlockKind::Pillar, pSeed, f);
+                bsp = voxelBlock(IsoTerrainBlockKind::Boulder, bSeed, f);
             } else {
                 psp = generateIsometricPillarBlockTile(pSeed, f, spritePx);
                 bsp = generateIsometricBoulderBlockTile(bSeed, f, spritePx);
@@ -4997,9 +5126,13 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
         const float s = f * std::pow(ndoth, mp.shininess);
         return std::clamp(s, 0.0f, 1.0f);
     };
+    const uint32_t wallVarSeed = hashCombine(styleSeed, tag32("RC3D_WVAR"));
+    const uint32_t floorVarSeed = hashCombine(styleSeed, tag32("RC3D_FVAR"));
+    const uint32_t ceilingVarSeed = hashCombine(styleSeed, tag32("RC3D_CVAR"));
+
     auto wallTexture = [&](TileType tt, int tx, int ty) -> const SpritePixels& {
         // Doors use dedicated textures; everything else uses the material wall atlas.
-        const size_t v = pickCoherentVariantIndex(tx, ty, hashCombine(styleSeed, tag32("RC3D_WVAR")), RAYCAST3D_VARIANTS);
+        const size_t v = pickCoherentVariantIndex(tx, ty, wallVarSeed, RAYCAST3D_VARIANTS);
         if (tt == TileType::DoorClosed) {
             return raycast3DDoorClosedTex_[v];
         }
@@ -5013,7 +5146,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
     };
 
     auto floorTexture = [&](TileType tt, int tx, int ty) -> const SpritePixels& {
-        const size_t v = pickCoherentVariantIndex(tx, ty, hashCombine(styleSeed, tag32("RC3D_FVAR")), RAYCAST3D_VARIANTS);
+        const size_t v = pickCoherentVariantIndex(tx, ty, floorVarSeed, RAYCAST3D_VARIANTS);
         if (tt == TileType::Chasm) {
             return raycast3DChasmTex_[v];
         }
@@ -5024,7 +5157,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
     };
 
     auto ceilingTexture = [&](int tx, int ty) -> const SpritePixels& {
-        const size_t v = pickCoherentVariantIndex(tx, ty, hashCombine(styleSeed, tag32("RC3D_CVAR")), RAYCAST3D_VARIANTS);
+        const size_t v = pickCoherentVariantIndex(tx, ty, ceilingVarSeed, RAYCAST3D_VARIANTS);
         const TerrainMaterial mat = d.materialAtCached(tx, ty);
         const int mi = std::clamp(static_cast<int>(mat), 0, matCount - 1);
         const int style = std::clamp(floorStyleAt(tx, ty), 0, ROOM_STYLES - 1);
@@ -5232,14 +5365,21 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
         }
     }
 
-    // Clear frame (baseline) as we draw columns.
-    raycast3DFramePixels_.assign(static_cast<size_t>(w) * static_cast<size_t>(h), pack(0, 0, 0, 255));
+    // Every column shades all of its pixels (see drawColumn), so no clear is needed.
+    raycast3DFramePixels_.resize(static_cast<size_t>(w) * static_cast<size_t>(h));
 
     // Per-column depth buffer (used for billboard sprite occlusion).
     std::vector<float> zBuffer(static_cast<size_t>(w), 1e9f);
 
-    // Draw each vertical column.
-    for (int x = 0; x < w; ++x) {
+    const raycast::PixelShifts shifts{pixfmt->Rshift, pixfmt->Gshift, pixfmt->Bshift, pixfmt->Ashift};
+    const uint32_t bumpSeed = hashCombine(lvlSeed, tag32("RC3D_BUMP"));
+
+    // Casts column x: the wall strip, ceiling and floor texels of the column are
+    // collected (with their light mods, shades and specular) into `span`, which
+    // raycast::shadeSpan() then lights and packs into the frame. A column only writes
+    // its own pixels and zBuffer entry, so columns can run in parallel.
+    auto drawColumn = [&](int x, raycast::ShadeSpan& span) {
+        span.reset(static_cast<size_t>(h));
         const float cameraX = 2.0f * static_cast<float>(x) / static_cast<float>(w) - 1.0f;
         const float rayDirX = dir.x + plane.x * cameraX;
         const float rayDirY = dir.y + plane.y * cameraX;
@@ -5362,7 +5502,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 const float t = static_cast<float>(y) / static_cast<float>(std::max(1, h / 2));
                 const float cs = 0.15f + 0.25f * (1.0f - t);
                 const uint8_t c = static_cast<uint8_t>(std::clamp(static_cast<int>(std::round(255.0f * cs)), 0, 255));
-                raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(c, c, c, 255);
+                span.setGray(static_cast<size_t>(y), c);
             }
         }
 
@@ -5404,9 +5544,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 u = uIt;
             }
 
-            Color c = texel(wtex, u, texY);
-            c = mulColorMod(c, wallMod);
-
+            const Color c = texel(wtex, u, texY);
             float s = shade;
 
             Vec3fLocal nrm{0.0f, 0.0f, 1.0f};
@@ -5416,7 +5554,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 s *= (0.72f + 0.28f * diff);
             }
 
-            c = shadeColor(c, s);
+            span.set(static_cast<size_t>(y), c, wallMod, s);
 
             if (enableSpecular && hitVisible) {
                 const float sp = specularFromNormal(nrm, vWall, wmp) * specularGlobal * shade * 0.90f;
@@ -5426,12 +5564,8 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 const int addR = static_cast<int>(std::lround(255.0f * sp * lr));
                 const int addG = static_cast<int>(std::lround(255.0f * sp * lg));
                 const int addB = static_cast<int>(std::lround(255.0f * sp * lb));
-                c.r = static_cast<uint8_t>(std::clamp(static_cast<int>(c.r) + addR, 0, 255));
-                c.g = static_cast<uint8_t>(std::clamp(static_cast<int>(c.g) + addG, 0, 255));
-                c.b = static_cast<uint8_t>(std::clamp(static_cast<int>(c.b) + addB, 0, 255));
+                span.setSpecular(static_cast<size_t>(y), addR, addG, addB);
             }
-
-            raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(c.r, c.g, c.b, 255);
         }
 
         // Floor casting (textured).
@@ -5471,13 +5605,13 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 const float fy = curY - static_cast<float>(ty);
 
                 if (!d.inBounds(tx, ty)) {
-                    raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(0, 0, 0, 255);
+                    span.setBlack(static_cast<size_t>(y));
                     continue;
                 }
 
                 const Tile& ct = d.at(tx, ty);
                 if (!ct.explored) {
-                    raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(0, 0, 0, 255);
+                    span.setBlack(static_cast<size_t>(y));
                     continue;
                 }
 
@@ -5508,9 +5642,8 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                     v = std::clamp(static_cast<int>(fyP * static_cast<float>(cH)), 0, cH - 1);
                 }
 
-                Color c = texel(ctex, u, v);
+                const Color c = texel(ctex, u, v);
                 const Color cMod = tileModCache[idxTile(tx, ty)];
-                c = mulColorMod(c, cMod);
 
                 float cShade = 1.0f / (1.0f + currentDist * currentDist * 0.05f);
                 cShade *= 0.85f; // ceilings are naturally darker
@@ -5528,7 +5661,7 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
 
                 cShade = std::clamp(cShade, 0.0f, 1.15f);
 
-                c = shadeColor(c, cShade);
+                span.set(static_cast<size_t>(y), c, cMod, cShade);
 
                 if (enableSpecular && ct.visible) {
                     const float sp = specularFromNormal(nrm, vDir, cmp) * specularGlobal * cShade * 0.75f;
@@ -5538,12 +5671,8 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                     const int addR = static_cast<int>(std::lround(255.0f * sp * lr));
                     const int addG = static_cast<int>(std::lround(255.0f * sp * lg));
                     const int addB = static_cast<int>(std::lround(255.0f * sp * lb));
-                    c.r = static_cast<uint8_t>(std::clamp(static_cast<int>(c.r) + addR, 0, 255));
-                    c.g = static_cast<uint8_t>(std::clamp(static_cast<int>(c.g) + addG, 0, 255));
-                    c.b = static_cast<uint8_t>(std::clamp(static_cast<int>(c.b) + addB, 0, 255));
+                    span.setSpecular(static_cast<size_t>(y), addR, addG, addB);
                 }
-
-                raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(c.r, c.g, c.b, 255);
             }
         }
 
@@ -5561,13 +5690,13 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
             const float fy = curY - static_cast<float>(ty);
 
             if (!d.inBounds(tx, ty)) {
-                raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(0, 0, 0, 255);
+                span.setBlack(static_cast<size_t>(y));
                 continue;
             }
 
             const Tile& ft = d.at(tx, ty);
             if (!ft.explored) {
-                raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(0, 0, 0, 255);
+                span.setBlack(static_cast<size_t>(y));
                 continue;
             }
 
@@ -5604,9 +5733,8 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 v = std::clamp(static_cast<int>(fyP * static_cast<float>(fH)), 0, fH - 1);
             }
 
-            Color c = texel(ftex, u, v);
+            const Color c = texel(ftex, u, v);
             const Color fMod = tileModCache[idxTile(tx, ty)];
-            c = mulColorMod(c, fMod);
 
             float fShade = 1.0f / (1.0f + currentDist * currentDist * 0.04f);
 
@@ -5622,14 +5750,13 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
             }
 
             // Optional micro-variation bump to break up large flat spans.
-            const uint32_t bumpSeed = hashCombine(lvlSeed, tag32("RC3D_BUMP"));
             const int bx = tx * 17 + static_cast<int>(std::floor(fxP * 64.0f));
             const int by = ty * 17 + static_cast<int>(std::floor(fyP * 64.0f));
             const float bump = fractalNoise2D01(bx, by, bumpSeed) * 0.06f; // 0..~0.06
 
             fShade = std::clamp(fShade + bump, 0.0f, 1.15f);
 
-            c = shadeColor(c, fShade);
+            span.set(static_cast<size_t>(y), c, fMod, fShade);
 
             if (enableSpecular && ft.visible) {
                 float sp = specularFromNormal(nrm, vDir, fmp) * specularGlobal * fShade;
@@ -5640,16 +5767,23 @@ void Renderer::drawRaycast3DView(const Game& game, uint32_t styleSeed, uint32_t
                 const int addR = static_cast<int>(std::lround(255.0f * sp * lr));
                 const int addG = static_cast<int>(std::lround(255.0f * sp * lg));
                 const int addB = static_cast<int>(std::lround(255.0f * sp * lb));
-                c.r = static_cast<uint8_t>(std::clamp(static_cast<int>(c.r) + addR, 0, 255));
-                c.g = static_cast<uint8_t>(std::clamp(static_cast<int>(c.g) + addG, 0, 255));
-                c.b = static_cast<uint8_t>(std::clamp(static_cast<int>(c.b) + addB, 0, 255));
+                span.setSpecular(static_cast<size_t>(y), addR, addG, addB);
             }
-
-            raycast3DFramePixels_[static_cast<size_t>(y * w + x)] = pack(c.r, c.g, c.b, 255);
         }
-    }
 
+        raycast::shadeSpan(span, static_cast<size_t>(h), shifts, raycast3DFramePixels_.data() + x, static_cast<size_t>(w));
+    };
 
+    // Bands of adjacent columns on the worker pool (the caller takes bands too). 16
+    // columns of 32-bit pixels keep neighbouring bands out of each other's cache lines.
+    constexpr int kBandColumns = 16;
+    const int bands = (w + kBandColumns - 1) / kBandColumns;
+    parallelFor(static_cast<size_t>(bands), [&](size_t band) {
+        raycast::ShadeSpan span;
+        const int x0 = static_cast<int>(band) * kBandColumns;
+        const int x1 = std::min(w, x0 + kBandColumns);
+        for (int x = x0; x < x1; ++x) drawColumn(x, span);
+    });
 
     // ---------------------------------------------------------------------
     // Billboard sprites (entities + ground items)
@@ -6005,6 +6139,9 @@ void Renderer::render(const Game& game) {
         l2 << "SPRITES " << spriteTex.size() << "  VRAM " << usedMB;
         if (budgetMB > 0) l2 << "/" << budgetMB;
         l2 << "MB  H/M " << spriteTex.hits() << "/" << spriteTex.misses() << "  E " << spriteTex.evictions();
+        const SpriteJobQueue::Stats js = spriteJobs_.stats();
+        l2.setf(std::ios::fixed); l2.precision(1);
+        l2 << "  Q " << js.depth << "  GEN " << js.avgMs << "ms";
         perfLine2_ = l2.str();
 
         std::ostringstream l3;
@@ -6062,6 +6199,7 @@ void Renderer::render(const Game& game) {
     if (wantVoxelSprites != voxelSpritesCached) {
         // Entity/item/projectile textures are budget-cached in spriteTex.
         spriteTex.clear();
+        spriteJobs_.cancelAll();
 
         // CPU-side billboard sprites (raycast 3D view) are generated from spritegen, so invalidate too.
         raycast3DSpriteCache_.clear();
@@ -6077,12 +6215,15 @@ void Renderer::render(const Game& game) {
     const bool wantIsoRaytrace = game.isoVoxelRaytraceEnabled();
     if (wantIsoRaytrace != isoVoxelRaytraceCached) {
         spriteTex.clear();
+        spriteJobs_.cancelAll();
         spriteTex.resetStats();
         uiPreviewTex.clear();
         uiPreviewTex.resetStats();
         isoVoxelRaytraceCached = wantIsoRaytrace;
     }
 
+    uploadFinishedSprites();
+
     // Background clear
     SDL_SetRenderDrawColor(renderer, 8, 8, 12, 255);
     SDL_RenderClear(renderer);
@@ -13301,6 +13442,9 @@ void Renderer::drawStatsOverlay(const Game& game) {
         else ss << budgetMB << "MB";
         ss << "  (E:" << ent << " I:" << item << " P:" << proj << ")"
            << "  H:" << spriteTex.hits() << " M:" << spriteTex.misses() << " EV:" << spriteTex.evictions();
+        const SpriteJobQueue::Stats js = spriteJobs_.stats();
+        ss.setf(std::ios::fixed); ss.precision(1);
+        ss << "  QUEUE:" << js.depth << " GEN:" << js.avgMs << "/" << js.lastMs << "MS";
 
         drawText5x7(renderer, x0 + pad, y, 2, gray, ss.str());
         y += 22;
@@ -5,11 +5,14 @@
 #include "game.hpp"
 #include "items.hpp"
 #include "spritegen.hpp"
+#include "sprite_disk_cache.hpp"
+#include "sprite_jobs.hpp"
 
 #include <array>
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -185,6 +188,10 @@ public:
     // Window controls
     void toggleFullscreen();
 
+    // Persistent cache for generated sprites (entity/item/projectile sprites and voxel
+    // terrain blocks). maxMB <= 0 disables it. Call before init().
+    void setSpriteDiskCache(const std::filesystem::path& path, int maxMB);
+
     // View controls
     void setViewMode(ViewMode mode) { viewMode_ = mode; }
     ViewMode viewMode() const { return viewMode_; }
@@ -552,6 +559,14 @@ private:
     // Key layout is free-form but we reserve the top byte for category.
     LRUTextureCache<1> uiPreviewTex;
     int textureCacheMB = 0;
+    SpriteDiskCache spriteDisk_;
+
+    // spriteTex misses are generated on the worker pool (spriteJobs_ writes to
+    // spriteDisk_, so it is declared after it and shut down first). Until the frames
+    // land, the cheap 2D 16px sprite is drawn from spritePlaceholderTex, keyed like
+    // spriteTex without the mode flags.
+    SpriteJobQueue spriteJobs_;
+    LRUTextureCache<FRAMES> spritePlaceholderTex;
     size_t spriteEntryBytes = 0;
 
     // Map-space -> screen-space helpers (respect camera + screen shake).
@@ -569,6 +584,15 @@ private:
 
     SDL_Texture* textureFromSprite(const SpritePixels& s);
 
+    // Sprite cache lookup shared by entity/item/projectile textures: returns the cached
+    // frame, or queues gen() for every frame and returns placeholder()'s frame meanwhile.
+    using SpriteFrameGen = std::function<SpritePixels(int frame)>;
+    SDL_Texture* cachedSpriteTexture(uint64_t key, SpriteCacheKey diskKey, int frame,
+                                     SpriteFrameGen gen, const SpriteFrameGen& placeholder);
+    void putSpriteFrames(LRUTextureCache<FRAMES>& cache, uint64_t key, const std::vector<SpritePixels>& frames);
+    // Uploads finished sprite jobs into spriteTex, within the per-frame upload budget.
+    void uploadFinishedSprites();
+
     SDL_Texture* tileTexture(TileType t, int x, int y, int level, int frame, int roomStyle);
     SDL_Texture* entityTexture(const Entity& e, int frame);
     SDL_Texture* itemTexture(const Item& it, int frame);
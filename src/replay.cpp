@@ -55,6 +55,103 @@ static void setErr(std::string* err, const std::string& msg) {
     if (err) *err = msg;
 }
 
+// Applies one "@key value" header line to `meta`. Unknown keys are kept in
+// meta.extraHeaderLines.
+static bool applyHeaderLine(const std::string& line, int lineNo, ReplayMeta& meta, std::string* err) {
+    // Header line: @key value...
+    std::istringstream iss(line);
+    std::string key;
+    iss >> key;
+    std::string value;
+    std::getline(iss, value);
+    value = trimCopy(value);
+
+    if (key == "@procrogue_replay") {
+        auto v = parseInt(value);
+        if (!v.has_value() || *v <= 0) {
+            setErr(err, "Replay parse error (bad format version) line " + std::to_string(lineNo));
+            return false;
+        }
+        meta.formatVersion = *v;
+        return true;
+    }
+    if (key == "@game_version") {
+        meta.gameVersion = value;
+        return true;
+    }
+    if (key == "@seed") {
+        auto v = parseU32(value);
+        if (!v.has_value()) {
+            setErr(err, "Replay parse error (bad seed) line " + std::to_string(lineNo));
+            return false;
+        }
+        meta.seed = *v;
+        return true;
+    }
+    if (key == "@class") {
+        meta.playerClassId = value;
+        return true;
+    }
+
+    if (key == "@auto_pickup") {
+        auto v = parseInt(value);
+        if (!v.has_value()) return true;
+        const int iv = *v;
+        if (iv < 0 || iv > 3) return true;
+        meta.autoPickup = static_cast<AutoPickupMode>(iv);
+        return true;
+    }
+    if (key == "@auto_step_delay_ms") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.autoStepDelayMs = *v;
+        return true;
+    }
+    if (key == "@auto_explore_search") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.autoExploreSearch = (*v != 0);
+        return true;
+    }
+    if (key == "@identify_items") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.identifyItems = (*v != 0);
+        return true;
+    }
+    if (key == "@hunger_enabled") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.hungerEnabled = (*v != 0);
+        return true;
+    }
+    if (key == "@encumbrance_enabled") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.encumbranceEnabled = (*v != 0);
+        return true;
+    }
+    if (key == "@lighting_enabled") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.lightingEnabled = (*v != 0);
+        return true;
+    }
+    if (key == "@yendor_doom_enabled") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.yendorDoomEnabled = (*v != 0);
+        return true;
+    }
+    if (key == "@bones_enabled") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.bonesEnabled = (*v != 0);
+        return true;
+    }
+    if (key == "@floor_candidates") {
+        auto v = parseInt(value);
+        if (v.has_value()) meta.floorCandidates = *v;
+        return true;
+    }
+
+    // Unknown header keys are carried through for forward compat.
+    meta.extraHeaderLines.push_back(line);
+    return true;
+}
+
 } // namespace
 
 std::string replayHexEncode(const std::string& bytes) {
@@ -89,6 +186,32 @@ bool replayHexDecode(const std::string& hex, std::string& outBytes) {
     return true;
 }
 
+std::string replayHeaderText(const ReplayMeta& meta) {
+    std::ostringstream out;
+    out << "@procrogue_replay " << meta.formatVersion << "\n";
+    out << "@game_version " << meta.gameVersion << "\n";
+    out << "@seed " << meta.seed << "\n";
+    if (!meta.playerClassId.empty()) {
+        out << "@class " << meta.playerClassId << "\n";
+    }
+
+    out << "@auto_pickup " << static_cast<int>(meta.autoPickup) << "\n";
+    out << "@auto_step_delay_ms " << meta.autoStepDelayMs << "\n";
+    out << "@auto_explore_search " << (meta.autoExploreSearch ? 1 : 0) << "\n";
+    out << "@identify_items " << (meta.identifyItems ? 1 : 0) << "\n";
+    out << "@hunger_enabled " << (meta.hungerEnabled ? 1 : 0) << "\n";
+    out << "@encumbrance_enabled " << (meta.encumbranceEnabled ? 1 : 0) << "\n";
+    out << "@lighting_enabled " << (meta.lightingEnabled ? 1 : 0) << "\n";
+    out << "@yendor_doom_enabled " << (meta.yendorDoomEnabled ? 1 : 0) << "\n";
+    out << "@bones_enabled " << (meta.bonesEnabled ? 1 : 0) << "\n";
+    if (meta.floorCandidates != 0) {
+        out << "@floor_candidates " << meta.floorCandidates << "\n";
+    }
+    for (const auto& line : meta.extraHeaderLines) out << line << "\n";
+    out << "@end_header\n";
+    return out.str();
+}
+
 bool ReplayWriter::open(const std::filesystem::path& path, const ReplayMeta& meta, std::string* err) {
     close();
     path_ = path;
@@ -98,24 +221,7 @@ bool ReplayWriter::open(const std::filesystem::path& path, const ReplayMeta& met
         return false;
     }
 
-    // Header
-    f_ << "@procrogue_replay " << meta.formatVersion << "\n";
-    f_ << "@game_version " << meta.gameVersion << "\n";
-    f_ << "@seed " << meta.seed << "\n";
-    if (!meta.playerClassId.empty()) {
-        f_ << "@class " << meta.playerClassId << "\n";
-    }
-
-    f_ << "@auto_pickup " << static_cast<int>(meta.autoPickup) << "\n";
-    f_ << "@auto_step_delay_ms " << meta.autoStepDelayMs << "\n";
-    f_ << "@auto_explore_search " << (meta.autoExploreSearch ? 1 : 0) << "\n";
-    f_ << "@identify_items " << (meta.identifyItems ? 1 : 0) << "\n";
-    f_ << "@hunger_enabled " << (meta.hungerEnabled ? 1 : 0) << "\n";
-    f_ << "@encumbrance_enabled " << (meta.encumbranceEnabled ? 1 : 0) << "\n";
-    f_ << "@lighting_enabled " << (meta.lightingEnabled ? 1 : 0) << "\n";
-    f_ << "@yendor_doom_enabled " << (meta.yendorDoomEnabled ? 1 : 0) << "\n";
-    f_ << "@bones_enabled " << (meta.bonesEnabled ? 1 : 0) << "\n";
-    f_ << "@end_header\n";
+    f_ << replayHeaderText(meta);
     f_.flush();
 
     return true;
@@ -185,9 +291,88 @@ void ReplayWriter::writeLookCursor(uint32_t tMs, Vec2i p) {
     writeLine_(std::to_string(tMs) + " LC " + std::to_string(p.x) + " " + std::to_string(p.y));
 }
 
+bool parseReplayHeaderText(const std::string& text, ReplayMeta& out, std::string* err) {
+    out = ReplayMeta{};
+
+    std::istringstream iss(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(iss, line)) {
+        ++lineNo;
+        line = trimCopy(line);
+        if (line.empty()) continue;
+        if (line[0] == '#') {
+            out.extraHeaderLines.push_back(line);
+            continue;
+        }
+        if (line == "@end_header") return true;
+        if (!startsWith(line, "@")) {
+            setErr(err, "Replay parse error (expected header @key): line " + std::to_string(lineNo));
+            return false;
+        }
+        if (!applyHeaderLine(line, lineNo, out, err)) return false;
+    }
+
+    setErr(err, "Replay parse error (missing @end_header)");
+    return false;
+}
+
+bool writeReplayFile(const std::filesystem::path& path, const ReplayFile& rf, std::string* err) {
+    if (path.extension() == kReplayBinaryExtension) return writeReplayBinaryFile(path, rf, err);
+
+    ReplayWriter w;
+    if (!w.open(path, rf.meta, err)) return false;
+
+    for (const auto& ev : rf.events) {
+        switch (ev.kind) {
+            case ReplayEventType::Action:
+                w.writeAction(ev.tMs, ev.action);
+                break;
+            case ReplayEventType::StateHash:
+                w.writeStateHash(ev.tMs, ev.turn, ev.hash);
+                break;
+            case ReplayEventType::TextInput:
+                w.writeTextInput(ev.tMs, ev.text);
+                break;
+            case ReplayEventType::CommandBackspace:
+                w.writeCommandBackspace(ev.tMs);
+                break;
+            case ReplayEventType::CommandAutocomplete:
+                w.writeCommandAutocomplete(ev.tMs);
+                break;
+            case ReplayEventType::MessageHistoryBackspace:
+                w.writeMessageHistoryBackspace(ev.tMs);
+                break;
+            case ReplayEventType::MessageHistoryToggleSearch:
+                w.writeMessageHistoryToggleSearchMode(ev.tMs);
+                break;
+            case ReplayEventType::MessageHistoryClearSearch:
+                w.writeMessageHistoryClearSearch(ev.tMs);
+                break;
+            case ReplayEventType::AutoTravel:
+                w.writeAutoTravel(ev.tMs, ev.pos);
+                break;
+            case ReplayEventType::BeginLook:
+                w.writeBeginLook(ev.tMs, ev.pos);
+                break;
+            case ReplayEventType::TargetCursor:
+                w.writeTargetCursor(ev.tMs, ev.pos);
+                break;
+            case ReplayEventType::LookCursor:
+                w.writeLookCursor(ev.tMs, ev.pos);
+                break;
+        }
+    }
+
+    w.close();
+    return true;
+}
+
 bool loadReplayFile(const std::filesystem::path& path, ReplayFile& out, std::string* err) {
     out = ReplayFile{};
 
+    if (isBinaryReplayFile(path)) return loadReplayBinaryFile(path, out, err);
+
     std::ifstream f(path);
     if (!f) {
         setErr(err, "Failed to open replay for reading: " + path.string());
@@ -201,7 +386,10 @@ bool loadReplayFile(const std::filesystem::path& path, ReplayFile& out, std::str
         ++lineNo;
         line = trimCopy(line);
         if (line.empty()) continue;
-        if (line[0] == '#') continue;
+        if (line[0] == '#') {
+            if (inHeader) out.meta.extraHeaderLines.push_back(line);
+            continue;
+        }
 
         if (inHeader) {
             if (line == "@end_header") {
@@ -214,91 +402,7 @@ bool loadReplayFile(const std::filesystem::path& path, ReplayFile& out, std::str
                 return false;
             }
 
-            // Header line: @key value...
-            std::istringstream iss(line);
-            std::string key;
-            iss >> key;
-            std::string value;
-            std::getline(iss, value);
-            value = trimCopy(value);
-
-            if (key == "@procrogue_replay") {
-                auto v = parseInt(value);
-                if (!v.has_value() || *v <= 0) {
-                    setErr(err, "Replay parse error (bad format version) line " + std::to_string(lineNo));
-                    return false;
-                }
-                out.meta.formatVersion = *v;
-                continue;
-            }
-            if (key == "@game_version") {
-                out.meta.gameVersion = value;
-                continue;
-            }
-            if (key == "@seed") {
-                auto v = parseU32(value);
-                if (!v.has_value()) {
-                    setErr(err, "Replay parse error (bad seed) line " + std::to_string(lineNo));
-                    return false;
-                }
-                out.meta.seed = *v;
-                continue;
-            }
-            if (key == "@class") {
-                out.meta.playerClassId = value;
-                continue;
-            }
-
-            if (key == "@auto_pickup") {
-                auto v = parseInt(value);
-                if (!v.has_value()) continue;
-                const int iv = *v;
-                if (iv < 0 || iv > 3) continue;
-                out.meta.autoPickup = static_cast<AutoPickupMode>(iv);
-                continue;
-            }
-            if (key == "@auto_step_delay_ms") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.autoStepDelayMs = *v;
-                continue;
-            }
-            if (key == "@auto_explore_search") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.autoExploreSearch = (*v != 0);
-                continue;
-            }
-            if (key == "@identify_items") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.identifyItems = (*v != 0);
-                continue;
-            }
-            if (key == "@hunger_enabled") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.hungerEnabled = (*v != 0);
-                continue;
-            }
-            if (key == "@encumbrance_enabled") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.encumbranceEnabled = (*v != 0);
-                continue;
-            }
-            if (key == "@lighting_enabled") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.lightingEnabled = (*v != 0);
-                continue;
-            }
-            if (key == "@yendor_doom_enabled") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.yendorDoomEnabled = (*v != 0);
-                continue;
-            }
-            if (key == "@bones_enabled") {
-                auto v = parseInt(value);
-                if (v.has_value()) out.meta.bonesEnabled = (*v != 0);
-                continue;
-            }
-
-            // Unknown header keys are ignored for forward compat.
+            if (!applyHeaderLine(line, lineNo, out.meta, err)) return false;
             continue;
         }
 
@@ -326,7 +430,7 @@ bool loadReplayFile(const std::filesystem::path& path, ReplayFile& out, std::str
                 setErr(err, "Replay parse error (bad action) line " + std::to_string(lineNo));
                 return false;
             }
-            if (ai < 0 || ai > 255) {
+            if (ai < 0 || ai > static_cast<int>(kReplayLastAction)) {
                 setErr(err, "Replay parse error (action out of range) line " + std::to_string(lineNo));
                 return false;
             }
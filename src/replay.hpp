@@ -64,6 +64,10 @@ enum class ReplayEventType : uint8_t {
     LookCursor,
 };
 
+// Last Action value a replay may carry (Action is append-only; move this along with it).
+// Both decoders reject larger bytes rather than casting them into the enum.
+inline constexpr Action kReplayLastAction = Action::OverworldAutoTravelTogglePause;
+
 struct ReplayMeta {
     int formatVersion = 1;
     std::string gameVersion;
@@ -80,6 +84,11 @@ struct ReplayMeta {
     bool lightingEnabled = false;
     bool yendorDoomEnabled = true;
     bool bonesEnabled = true;
+    int floorCandidates = 0; // Missing in older replays: default generation.
+
+    // Header lines this build does not understand ("@key value" from newer versions and
+    // "# ..." comments), kept verbatim so re-encoding a replay does not drop them.
+    std::vector<std::string> extraHeaderLines;
 };
 
 struct ReplayEvent {
@@ -105,6 +114,10 @@ struct ReplayFile {
 std::string replayHexEncode(const std::string& bytes);
 bool replayHexDecode(const std::string& hex, std::string& outBytes);
 
+// The "@key value" header block, through @end_header (shared by both encodings).
+std::string replayHeaderText(const ReplayMeta& meta);
+bool parseReplayHeaderText(const std::string& text, ReplayMeta& out, std::string* err = nullptr);
+
 // ------------------------------------------------------------
 // Writer (streaming)
 // ------------------------------------------------------------
@@ -143,4 +156,78 @@ private:
 // ------------------------------------------------------------
 // Reader (loads all events)
 // ------------------------------------------------------------
+// Accepts both encodings: binary files are recognized by their magic, not the extension.
 bool loadReplayFile(const std::filesystem::path& path, ReplayFile& out, std::string* err = nullptr);
+
+// Writes a whole replay: binary when the extension is kReplayBinaryExtension, text otherwise.
+// Text <-> binary conversion is lossless in both directions.
+bool writeReplayFile(const std::filesystem::path& path, const ReplayFile& rf, std::string* err = nullptr);
+
+// ------------------------------------------------------------
+// Binary container (.prrb)
+// ------------------------------------------------------------
+//
+// The text format spends ~40 bytes on an action + per-turn hash pair and has to be
+// parsed line by line. The binary container stores the same events compactly and
+// carries an index of its checkpoints, so a reader can load a prefix (or resume from a
+// checkpoint) without decoding the whole stream.
+//
+// Layout (integers are LEB128 varints unless noted; zigzag = signed varint):
+//
+//   "PRRB" u8:version
+//   header:  varint:length + the text header block (replayHeaderText)
+//   events:  varint:count, then per event:
+//              u8:kind  zigzag:(tMs - previous event tMs)  payload
+//            payloads:  A   u8:action
+//                       H   zigzag:(turn - previous checkpoint turn)  u64le:hash
+//                       TI  varint:length + UTF-8 bytes
+//                       TR/BL/TC/LC  zigzag:x zigzag:y
+//                       others: none
+//   index:   varint:count, then per entry: varint eventIndex, turn, tMs, offset,
+//            prevMs, prevTurn
+//   trailer: u64le:absolute offset of the index, "PRRX"
+//
+// Hashes are effectively random, so they are stored raw; the turn and time fields
+// around them are the delta-coded part.
+
+inline constexpr const char* kReplayBinaryExtension = ".prrb";
+
+// Every kReplayIndexStride-th StateHash event gets an index entry (the first one always).
+inline constexpr uint32_t kReplayIndexStride = 32;
+
+struct ReplayIndexEntry {
+    uint32_t eventIndex = 0; // of the StateHash event in ReplayFile::events
+    uint32_t turn = 0;
+    uint32_t tMs = 0;
+    uint32_t offset = 0;     // of the event's record, from the start of the event stream
+    uint32_t prevMs = 0;     // delta bases for decoding from this record on
+    uint32_t prevTurn = 0;
+};
+
+struct ReplayIndex {
+    uint32_t eventCount = 0;
+    std::vector<ReplayIndexEntry> entries; // ascending eventIndex
+
+    // The last entry at or before `turn` (nullptr if the first indexed turn is later).
+    const ReplayIndexEntry* findAtOrBefore(uint32_t turn) const;
+    // The first entry at or after `turn` (nullptr if every indexed turn is earlier).
+    const ReplayIndexEntry* findAtOrAfter(uint32_t turn) const;
+};
+
+void encodeReplayBinary(const ReplayFile& rf, std::vector<uint8_t>& out);
+bool decodeReplayBinary(const std::vector<uint8_t>& in, ReplayFile& out, ReplayIndex* outIndex = nullptr,
+                        std::string* err = nullptr);
+
+bool isBinaryReplayFile(const std::filesystem::path& path);
+bool writeReplayBinaryFile(const std::filesystem::path& path, const ReplayFile& rf, std::string* err = nullptr);
+bool loadReplayBinaryFile(const std::filesystem::path& path, ReplayFile& out, std::string* err = nullptr);
+
+// Reads only the header and the checkpoint index of a binary replay.
+bool readReplayIndex(const std::filesystem::path& path, ReplayMeta& meta, ReplayIndex& index,
+                     std::string* err = nullptr);
+
+// Loads the events up to and including the first StateHash checkpoint at or after
+// `untilTurn` (everything if there is none). For binary replays only the part of the
+// event stream before that checkpoint's index entry is read and decoded.
+bool loadReplayPrefix(const std::filesystem::path& path, uint32_t untilTurn, ReplayFile& out,
+                      std::string* err = nullptr);
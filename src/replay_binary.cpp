@@ -0,0 +1,435 @@
+#include "replay.hpp"
+#include "varint.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+// Binary replay container; see the layout in replay.hpp.
+
+namespace {
+
+constexpr uint8_t kMagic[4] = { 'P', 'R', 'R', 'B' };
+constexpr uint8_t kTrailerMagic[4] = { 'P', 'R', 'R', 'X' };
+constexpr uint8_t kBinaryVersion = 1;
+constexpr size_t kTrailerBytes = 12;
+
+// Upper bound of one encoded StateHash record (kind + two 33-bit zigzags + hash).
+constexpr size_t kMaxHashRecordBytes = 1 + 5 + 5 + 8;
+
+void setErr(std::string* err, const std::string& msg) {
+    if (err) *err = msg;
+}
+
+void putSigned(std::vector<uint8_t>& out, int64_t v) {
+    varint::put(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+bool getSigned(const std::vector<uint8_t>& in, size_t& pos, int64_t& v) {
+    uint64_t u = 0;
+    if (!varint::get(in, pos, u)) return false;
+    v = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1u);
+    return true;
+}
+
+bool getU32(const std::vector<uint8_t>& in, size_t& pos, uint32_t& v) {
+    uint64_t u = 0;
+    if (!varint::get(in, pos, u) || u > 0xFFFFFFFFull) return false;
+    v = static_cast<uint32_t>(u);
+    return true;
+}
+
+// base + delta, rejecting results outside uint32_t.
+bool applyDelta(uint32_t base, int64_t delta, uint32_t& out) {
+    const int64_t v = static_cast<int64_t>(base) + delta;
+    if (v < 0 || v > 0xFFFFFFFFll) return false;
+    out = static_cast<uint32_t>(v);
+    return true;
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+uint64_t getU64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+bool hasPosition(ReplayEventType k) {
+    return k == ReplayEventType::AutoTravel || k == ReplayEventType::BeginLook ||
+           k == ReplayEventType::TargetCursor || k == ReplayEventType::LookCursor;
+}
+
+// Where the sections of a binary replay start (byte offsets into the file).
+struct Layout {
+    ReplayMeta meta;
+    uint32_t eventCount = 0;
+    size_t eventsStart = 0;
+    size_t indexStart = 0;
+};
+
+// Parses magic, version, header and event count from the first bytes of a file. `in`
+// must hold at least everything up to the event stream; `size` is the whole file size.
+bool parseHead(const std::vector<uint8_t>& in, size_t size, Layout& out, std::string* err) {
+    if (in.size() < sizeof(kMagic) + 1 || !std::equal(kMagic, kMagic + 4, in.begin())) {
+        setErr(err, "Replay parse error (not a binary replay)");
+        return false;
+    }
+    if (in[4] != kBinaryVersion) {
+        setErr(err, "Replay parse error (unsupported binary replay version " + std::to_string(in[4]) + ")");
+        return false;
+    }
+
+    size_t pos = 5;
+    uint32_t headerLen = 0;
+    if (!getU32(in, pos, headerLen) || in.size() - pos < headerLen) {
+        setErr(err, "Replay parse error (truncated header)");
+        return false;
+    }
+    const std::string header(reinterpret_cast<const char*>(in.data() + pos), headerLen);
+    pos += headerLen;
+    if (!parseReplayHeaderText(header, out.meta, err)) return false;
+
+    if (!getU32(in, pos, out.eventCount)) {
+        setErr(err, "Replay parse error (truncated event count)");
+        return false;
+    }
+    out.eventsStart = pos;
+    if (size < out.eventsStart + kTrailerBytes) {
+        setErr(err, "Replay parse error (truncated binary replay)");
+        return false;
+    }
+    return true;
+}
+
+bool parseTrailer(const uint8_t* trailer, size_t size, Layout& layout, std::string* err) {
+    if (!std::equal(kTrailerMagic, kTrailerMagic + 4, trailer + 8)) {
+        setErr(err, "Replay parse error (missing binary replay index)");
+        return false;
+    }
+    const uint64_t indexStart = getU64(trailer);
+    if (indexStart < layout.eventsStart || indexStart > size - kTrailerBytes) {
+        setErr(err, "Replay parse error (bad binary replay index offset)");
+        return false;
+    }
+    layout.indexStart = static_cast<size_t>(indexStart);
+    return true;
+}
+
+// `in` holds the index section exactly.
+bool parseIndex(const std::vector<uint8_t>& in, uint32_t eventCount, ReplayIndex& out, std::string* err) {
+    out = ReplayIndex{};
+    out.eventCount = eventCount;
+
+    size_t pos = 0;
+    uint32_t n = 0;
+    if (!getU32(in, pos, n)) {
+        setErr(err, "Replay parse error (bad binary replay index)");
+        return false;
+    }
+    out.entries.reserve(std::min<size_t>(n, in.size()));
+    for (uint32_t i = 0; i < n; ++i) {
+        ReplayIndexEntry e;
+        if (!getU32(in, pos, e.eventIndex) || !getU32(in, pos, e.turn) || !getU32(in, pos, e.tMs) ||
+            !getU32(in, pos, e.offset) || !getU32(in, pos, e.prevMs) || !getU32(in, pos, e.prevTurn) ||
+            e.eventIndex >= eventCount) {
+            setErr(err, "Replay parse error (bad binary replay index)");
+            return false;
+        }
+        out.entries.push_back(e);
+    }
+    return true;
+}
+
+// Decodes up to `count` events from in[pos, end). With `untilTurn`, stops right after the
+// first StateHash event at or after that turn.
+bool decodeEvents(const std::vector<uint8_t>& in, size_t pos, size_t end, uint32_t count, uint32_t prevMs,
+                  uint32_t prevTurn, const std::optional<uint32_t>& untilTurn, std::vector<ReplayEvent>& out,
+                  std::string* err) {
+    auto fail = [&](const char* what) {
+        setErr(err, std::string("Replay parse error (") + what + ") event " + std::to_string(out.size()));
+        return false;
+    };
+
+    out.reserve(out.size() + std::min<size_t>(count, end - pos));
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos >= end) return fail("truncated event stream");
+
+        ReplayEvent ev;
+        const uint8_t kind = in[pos++];
+        if (kind > static_cast<uint8_t>(ReplayEventType::LookCursor)) return fail("unknown event kind");
+        ev.kind = static_cast<ReplayEventType>(kind);
+
+        int64_t dt = 0;
+        if (!getSigned(in, pos, dt) || !applyDelta(prevMs, dt, ev.tMs)) return fail("bad time");
+        prevMs = ev.tMs;
+
+        if (ev.kind == ReplayEventType::Action) {
+            if (pos >= end) return fail("truncated action");
+            if (in[pos] > static_cast<uint8_t>(kReplayLastAction)) return fail("unknown action");
+            ev.action = static_cast<Action>(in[pos++]);
+        } else if (ev.kind == ReplayEventType::StateHash) {
+            int64_t dTurn = 0;
+            if (!getSigned(in, pos, dTurn) || !applyDelta(prevTurn, dTurn, ev.turn)) return fail("bad turn");
+            if (end - pos < 8) return fail("truncated state hash");
+            ev.hash = getU64(in.data() + pos);
+            pos += 8;
+            prevTurn = ev.turn;
+        } else if (ev.kind == ReplayEventType::TextInput) {
+            uint32_t len = 0;
+            if (!getU32(in, pos, len) || end - pos < len) return fail("bad text payload");
+            ev.text.assign(reinterpret_cast<const char*>(in.data() + pos), len);
+            pos += len;
+        } else if (hasPosition(ev.kind)) {
+            int64_t x = 0;
+            int64_t y = 0;
+            if (!getSigned(in, pos, x) || !getSigned(in, pos, y)) return fail("bad position payload");
+            ev.pos = Vec2i{ static_cast<int>(x), static_cast<int>(y) };
+        }
+        if (pos > end) return fail("truncated event stream");
+
+        const bool stop = untilTurn.has_value() && ev.kind == ReplayEventType::StateHash && ev.turn >= *untilTurn;
+        out.push_back(std::move(ev));
+        if (stop) return true;
+    }
+    if (!untilTurn.has_value() && pos != end) return fail("trailing bytes after events");
+    return true;
+}
+
+bool readBytes(std::ifstream& f, size_t offset, size_t n, std::vector<uint8_t>& out) {
+    out.resize(n);
+    f.clear();
+    f.seekg(static_cast<std::streamoff>(offset));
+    if (n == 0) return static_cast<bool>(f);
+    f.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(n));
+    return static_cast<size_t>(f.gcount()) == n;
+}
+
+// Opens a binary replay and reads its head, trailer and index.
+bool openBinary(const std::filesystem::path& path, std::ifstream& f, size_t& size, Layout& layout,
+                ReplayIndex& index, std::string* err) {
+    f.open(path, std::ios::in | std::ios::binary);
+    if (!f) {
+        setErr(err, "Failed to open replay for reading: " + path.string());
+        return false;
+    }
+    f.seekg(0, std::ios::end);
+    size = static_cast<size_t>(f.tellg());
+
+    // Magic, version and the header length come first; then read through the event count.
+    std::vector<uint8_t> head;
+    if (!readBytes(f, 0, std::min<size_t>(size, 16), head)) {
+        setErr(err, "Failed to read replay: " + path.string());
+        return false;
+    }
+    size_t pos = 5;
+    uint32_t headerLen = 0;
+    if (head.size() > pos && getU32(head, pos, headerLen)) {
+        const size_t want = std::min<size_t>(size, pos + static_cast<size_t>(headerLen) + 5);
+        if (!readBytes(f, 0, want, head)) {
+            setErr(err, "Failed to read replay: " + path.string());
+            return false;
+        }
+    }
+    if (!parseHead(head, size, layout, err)) return false;
+
+    std::vector<uint8_t> buf;
+    if (!readBytes(f, size - kTrailerBytes, kTrailerBytes, buf)) {
+        setErr(err, "Failed to read replay: " + path.string());
+        return false;
+    }
+    if (!parseTrailer(buf.data(), size, layout, err)) return false;
+    if (!readBytes(f, layout.indexStart, size - kTrailerBytes - layout.indexStart, buf)) {
+        setErr(err, "Failed to read replay: " + path.string());
+        return false;
+    }
+    return parseIndex(buf, layout.eventCount, index, err);
+}
+
+} // namespace
+
+const ReplayIndexEntry* ReplayIndex::findAtOrBefore(uint32_t turn) const {
+    const ReplayIndexEntry* best = nullptr;
+    for (const ReplayIndexEntry& e : entries) {
+        if (e.turn > turn) break;
+        best = &e;
+    }
+    return best;
+}
+
+const ReplayIndexEntry* ReplayIndex::findAtOrAfter(uint32_t turn) const {
+    for (const ReplayIndexEntry& e : entries) {
+        if (e.turn >= turn) return &e;
+    }
+    return nullptr;
+}
+
+void encodeReplayBinary(const ReplayFile& rf, std::vector<uint8_t>& out) {
+    out.clear();
+    out.insert(out.end(), kMagic, kMagic + 4);
+    out.push_back(kBinaryVersion);
+
+    const std::string header = replayHeaderText(rf.meta);
+    varint::put(out, header.size());
+    out.insert(out.end(), header.begin(), header.end());
+
+    varint::put(out, rf.events.size());
+    const size_t eventsStart = out.size();
+    out.reserve(out.size() + rf.events.size() * 4);
+
+    std::vector<ReplayIndexEntry> entries;
+    uint32_t prevMs = 0;
+    uint32_t prevTurn = 0;
+    uint32_t checkpoints = 0;
+    for (size_t i = 0; i < rf.events.size(); ++i) {
+        const ReplayEvent& ev = rf.events[i];
+        if (ev.kind == ReplayEventType::StateHash && (checkpoints++ % kReplayIndexStride) == 0) {
+            ReplayIndexEntry e;
+            e.eventIndex = static_cast<uint32_t>(i);
+            e.turn = ev.turn;
+            e.tMs = ev.tMs;
+            e.offset = static_cast<uint32_t>(out.size() - eventsStart);
+            e.prevMs = prevMs;
+            e.prevTurn = prevTurn;
+            entries.push_back(e);
+        }
+
+        out.push_back(static_cast<uint8_t>(ev.kind));
+        putSigned(out, static_cast<int64_t>(ev.tMs) - static_cast<int64_t>(prevMs));
+        prevMs = ev.tMs;
+
+        if (ev.kind == ReplayEventType::Action) {
+            out.push_back(static_cast<uint8_t>(ev.action));
+        } else if (ev.kind == ReplayEventType::StateHash) {
+            putSigned(out, static_cast<int64_t>(ev.turn) - static_cast<int64_t>(prevTurn));
+            putU64(out, ev.hash);
+            prevTurn = ev.turn;
+        } else if (ev.kind == ReplayEventType::TextInput) {
+            varint::put(out, ev.text.size());
+            out.insert(out.end(), ev.text.begin(), ev.text.end());
+        } else if (hasPosition(ev.kind)) {
+            putSigned(out, ev.pos.x);
+            putSigned(out, ev.pos.y);
+        }
+    }
+
+    const uint64_t indexStart = out.size();
+    varint::put(out, entries.size());
+    for (const ReplayIndexEntry& e : entries) {
+        varint::put(out, e.eventIndex);
+        varint::put(out, e.turn);
+        varint::put(out, e.tMs);
+        varint::put(out, e.offset);
+        varint::put(out, e.prevMs);
+        varint::put(out, e.prevTurn);
+    }
+
+    putU64(out, indexStart);
+    out.insert(out.end(), kTrailerMagic, kTrailerMagic + 4);
+}
+
+bool decodeReplayBinary(const std::vector<uint8_t>& in, ReplayFile& out, ReplayIndex* outIndex, std::string* err) {
+    out = ReplayFile{};
+
+    Layout layout;
+    if (!parseHead(in, in.size(), layout, err)) return false;
+    if (!parseTrailer(in.data() + in.size() - kTrailerBytes, in.size(), layout, err)) return false;
+
+    if (outIndex) {
+        const std::vector<uint8_t> idx(in.begin() + static_cast<std::ptrdiff_t>(layout.indexStart),
+                                       in.end() - static_cast<std::ptrdiff_t>(kTrailerBytes));
+        if (!parseIndex(idx, layout.eventCount, *outIndex, err)) return false;
+    }
+
+    out.meta = layout.meta;
+    return decodeEvents(in, layout.eventsStart, layout.indexStart, layout.eventCount, 0u, 0u, std::nullopt,
+                        out.events, err);
+}
+
+bool isBinaryReplayFile(const std::filesystem::path& path) {
+    std::ifstream f(path, std::ios::in | std::ios::binary);
+    char magic[4] = {};
+    if (!f.read(magic, 4)) return false;
+    return std::equal(kMagic, kMagic + 4, reinterpret_cast<const uint8_t*>(magic));
+}
+
+bool writeReplayBinaryFile(const std::filesystem::path& path, const ReplayFile& rf, std::string* err) {
+    std::vector<uint8_t> bytes;
+    encodeReplayBinary(rf, bytes);
+
+    std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f) {
+        setErr(err, "Failed to open replay for writing: " + path.string());
+        return false;
+    }
+    f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!f) {
+        setErr(err, "Failed to write replay: " + path.string());
+        return false;
+    }
+    return true;
+}
+
+bool loadReplayBinaryFile(const std::filesystem::path& path, ReplayFile& out, std::string* err) {
+    out = ReplayFile{};
+
+    std::ifstream f(path, std::ios::in | std::ios::binary);
+    if (!f) {
+        setErr(err, "Failed to open replay for reading: " + path.string());
+        return false;
+    }
+    f.seekg(0, std::ios::end);
+    const size_t size = static_cast<size_t>(f.tellg());
+    std::vector<uint8_t> bytes;
+    if (!readBytes(f, 0, size, bytes)) {
+        setErr(err, "Failed to read replay: " + path.string());
+        return false;
+    }
+    return decodeReplayBinary(bytes, out, nullptr, err);
+}
+
+bool readReplayIndex(const std::filesystem::path& path, ReplayMeta& meta, ReplayIndex& index, std::string* err) {
+    std::ifstream f;
+    size_t size = 0;
+    Layout layout;
+    if (!openBinary(path, f, size, layout, index, err)) return false;
+    meta = layout.meta;
+    return true;
+}
+
+bool loadReplayPrefix(const std::filesystem::path& path, uint32_t untilTurn, ReplayFile& out, std::string* err) {
+    out = ReplayFile{};
+
+    if (!isBinaryReplayFile(path)) {
+        if (!loadReplayFile(path, out, err)) return false;
+        for (size_t i = 0; i < out.events.size(); ++i) {
+            const ReplayEvent& ev = out.events[i];
+            if (ev.kind == ReplayEventType::StateHash && ev.turn >= untilTurn) {
+                out.events.resize(i + 1);
+                break;
+            }
+        }
+        return true;
+    }
+
+    std::ifstream f;
+    size_t size = 0;
+    Layout layout;
+    ReplayIndex index;
+    if (!openBinary(path, f, size, layout, index, err)) return false;
+    out.meta = layout.meta;
+
+    // The first checkpoint at or after untilTurn is no later than the first indexed one.
+    size_t end = layout.indexStart;
+    if (const ReplayIndexEntry* e = index.findAtOrAfter(untilTurn)) {
+        end = std::min(end, layout.eventsStart + e->offset + kMaxHashRecordBytes);
+    }
+
+    std::vector<uint8_t> bytes;
+    if (!readBytes(f, 0, end, bytes)) {
+        setErr(err, "Failed to read replay: " + path.string());
+        return false;
+    }
+    return decodeEvents(bytes, layout.eventsStart, end, layout.eventCount, 0u, 0u, untilTurn, out.events, err);
+}
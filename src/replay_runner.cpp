@@ -1,6 +1,7 @@
 #include "replay_runner.hpp"
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <sstream>
 #include <vector>
@@ -115,6 +116,183 @@ static void dispatchReplayEvent(Game& game, const ReplayEvent& rev) {
     }
 }
 
+// Runner position inside a replay: the next event to dispatch and the simulated clock.
+struct RunCursor {
+    size_t idx = 0;
+    uint32_t elapsedMs = 0;
+    uint32_t frames = 0;
+    uint32_t dispatched = 0;
+};
+
+static std::vector<TurnHashCheckpoint> collectCheckpoints(const ReplayFile& replay) {
+    std::vector<TurnHashCheckpoint> checkpoints;
+    checkpoints.reserve(256);
+    for (const auto& ev : replay.events) {
+        if (ev.kind == ReplayEventType::StateHash) {
+            checkpoints.push_back(TurnHashCheckpoint{ev.turn, ev.hash});
+        }
+    }
+    std::sort(checkpoints.begin(), checkpoints.end(),
+              [](const TurnHashCheckpoint& a, const TurnHashCheckpoint& b) { return a.turn < b.turn; });
+    return checkpoints;
+}
+
+static void fillRunStats(ReplayRunStats* outStats, const Game& game, const RunCursor& c) {
+    if (!outStats) return;
+    outStats->simulatedMs = c.elapsedMs;
+    outStats->frames = c.frames;
+    outStats->eventsDispatched = c.dispatched;
+    outStats->turns = game.turns();
+}
+
+static bool failHashMismatch(const TurnHashVerifyCtx& verify, const Game& game, const RunCursor* c,
+                             ReplayRunStats* outStats, std::string* err) {
+    if (outStats) {
+        outStats->failure = ReplayFailureKind::HashMismatch;
+        outStats->failedTurn = verify.failedTurn;
+        outStats->failedCheckpointTurn = verify.expectedTurn;
+        outStats->expectedHash = verify.expectedHash;
+        outStats->gotHash = verify.gotHash;
+        if (c) fillRunStats(outStats, game, *c);
+    }
+    if (err) formatHashMismatch(verify, *err);
+    return false;
+}
+
+static void captureSnapshot(Game& game, const RunCursor& c, ReplaySnapshots& store) {
+    ReplaySnapshot snap;
+    snap.turn = game.turns();
+    snap.eventIndex = c.idx;
+    snap.elapsedMs = c.elapsedMs;
+    snap.frames = c.frames;
+    snap.eventsDispatched = c.dispatched;
+    game.saveToMemory(snap.save);
+    snap.hash = game.determinismHash();
+    store.list.push_back(std::move(snap));
+}
+
+// The playback loop shared by runReplayHeadless() and resumeReplayHeadless(): feeds the
+// recorded events by simulated time from `c` on. `verify` is inactive when it has no
+// expected checkpoints.
+static bool runFrom(Game& game, const ReplayFile& replay, const ReplayRunOptions& opt, RunCursor c,
+                    TurnHashVerifyCtx& verify, ReplayRunStats* outStats, std::string* err) {
+    const uint32_t frameMs = clampFrameMs(opt.frameMs);
+
+    uint32_t lastEventMs = 0;
+    if (!replay.events.empty()) {
+        lastEventMs = replay.events.back().tMs;
+    }
+
+    // Safety: unless caller explicitly overrides, cap runtime to avoid infinite loops
+    // if something goes wrong (e.g., auto-move stuck). Still large enough for typical
+    // replays; callers can set maxSimMs=0 to disable or set a larger value.
+    uint32_t maxSimMs = opt.maxSimMs;
+    if (maxSimMs == 0) {
+        // Default: last event time + 5 seconds (and at least 5 seconds).
+        const uint32_t slack = 5000;
+        maxSimMs = (lastEventMs > (std::numeric_limits<uint32_t>::max() - slack))
+                 ? std::numeric_limits<uint32_t>::max()
+                 : (lastEventMs + slack);
+        if (maxSimMs < 5000) maxSimMs = 5000;
+    }
+
+    const uint32_t maxFrames = (opt.maxFrames == 0) ? (maxSimMs / frameMs + 10) : opt.maxFrames;
+
+    // Snapshots are taken at the first quiet frame once each interval has passed.
+    ReplaySnapshots* store = (opt.snapshots && opt.snapshots->everyTurns != 0) ? opt.snapshots : nullptr;
+    uint32_t nextSnapshotTurn = 0;
+    if (store) nextSnapshotTurn = (game.turns() / store->everyTurns + 1u) * store->everyTurns;
+
+    while (c.frames < maxFrames && c.elapsedMs <= maxSimMs) {
+        // Dispatch all events that are due at this time (mirrors main.cpp behavior).
+        while (c.idx < replay.events.size() && replay.events[c.idx].tMs <= c.elapsedMs) {
+            dispatchReplayEvent(game, replay.events[c.idx]);
+            ++c.idx;
+            ++c.dispatched;
+
+            if (verify.failed) return failHashMismatch(verify, game, &c, outStats, err);
+        }
+
+        // Done once all replay events were processed AND (if verifying) all checkpoints were consumed.
+        const bool allEventsDone = (c.idx >= replay.events.size());
+        const bool hashesDone = (!verify.expected) || (verify.idx >= verify.expected->size());
+        if (allEventsDone && hashesDone) {
+            break;
+        }
+        if (opt.stopAtTurn != 0 && game.turns() >= opt.stopAtTurn) {
+            break;
+        }
+
+        if (store && game.turns() >= nextSnapshotTurn && game.isSnapshotSafe()) {
+            if (store->list.empty() || store->list.back().turn < game.turns()) captureSnapshot(game, c, *store);
+            nextSnapshotTurn = (game.turns() / store->everyTurns + 1u) * store->everyTurns;
+        }
+
+        // Advance simulated time by one fixed step.
+        uint32_t stepMs = frameMs;
+        if (c.elapsedMs + stepMs > maxSimMs) stepMs = maxSimMs - c.elapsedMs;
+        if (stepMs == 0) break;
+
+        float dt = stepMs / 1000.0f;
+        if (dt > 0.1f) dt = 0.1f;
+
+        game.update(dt);
+
+        c.elapsedMs += stepMs;
+        ++c.frames;
+
+        if (verify.failed) return failHashMismatch(verify, game, &c, outStats, err);
+    }
+
+    if (c.frames >= maxFrames || c.elapsedMs > maxSimMs) {
+        if (outStats) {
+            outStats->failure = ReplayFailureKind::SafetyLimit;
+            fillRunStats(outStats, game, c);
+        }
+        if (err) {
+            std::ostringstream ss;
+            ss << "Replay runner exceeded safety limit (elapsedMs=" << c.elapsedMs
+               << ", frames=" << c.frames << ", maxSimMs=" << maxSimMs << ").";
+            *err = ss.str();
+        }
+        return false;
+    }
+
+    if (outStats) {
+        fillRunStats(outStats, game, c);
+        outStats->costCacheHits = game.monsterCostCache().stats().hits;
+        outStats->costCacheMisses = game.monsterCostCache().stats().misses;
+    }
+
+    return true;
+}
+
+// Restores `snap` into `game`; the hash check catches state a save does not carry.
+static bool restoreSnapshot(Game& game, const ReplaySnapshot& snap, std::string* err) {
+    if (game.loadFromMemory(snap.save, false) && game.determinismHash() == snap.hash) return true;
+    if (err) *err = "Replay snapshot at turn " + std::to_string(snap.turn) + " could not be restored.";
+    return false;
+}
+
+// Turn hook for the bisect report: subsystem hashes at the two turns of interest.
+struct PartsCaptureCtx {
+    uint32_t beforeTurn = 0;
+    uint32_t atTurn = 0;
+    std::array<uint64_t, Game::kHashPartCount> before{};
+    std::array<uint64_t, Game::kHashPartCount> at{};
+    bool haveAt = false;
+    const Game* game = nullptr;
+};
+
+static void onTurnCaptureParts(void* user, uint32_t turn, uint64_t /*hash*/) {
+    auto* ctx = static_cast<PartsCaptureCtx*>(user);
+    if (turn == ctx->beforeTurn) ctx->before = ctx->game->determinismHashParts();
+    if (turn == ctx->atTurn) {
+        ctx->at = ctx->game->determinismHashParts();
+        ctx->haveAt = true;
+    }
+}
+
 } // namespace
 
 bool prepareGameForReplay(Game& game, const ReplayFile& replay, std::string* err) {
@@ -136,6 +314,7 @@ bool prepareGameForReplay(Game& game, const ReplayFile& replay, std::string* err
     game.setLightingEnabled(replay.meta.lightingEnabled);
     game.setYendorDoomEnabled(replay.meta.yendorDoomEnabled);
     game.setBonesEnabled(replay.meta.bonesEnabled);
+    game.setFloorCandidates(replay.meta.floorCandidates);
 
     // Starting class is recorded for determinism.
     PlayerClass pc = PlayerClass::Adventurer;
@@ -164,18 +343,8 @@ bool runReplayHeadless(Game& game,
                        std::string* err) {
     if (outStats) *outStats = ReplayRunStats{};
 
-    const uint32_t frameMs = clampFrameMs(opt.frameMs);
-
     // Collect hash checkpoints (if any).
-    std::vector<TurnHashCheckpoint> checkpoints;
-    checkpoints.reserve(256);
-    for (const auto& ev : replay.events) {
-        if (ev.kind == ReplayEventType::StateHash) {
-            checkpoints.push_back(TurnHashCheckpoint{ev.turn, ev.hash});
-        }
-    }
-    std::sort(checkpoints.begin(), checkpoints.end(),
-              [](const TurnHashCheckpoint& a, const TurnHashCheckpoint& b) { return a.turn < b.turn; });
+    const std::vector<TurnHashCheckpoint> checkpoints = collectCheckpoints(replay);
 
     TurnHashVerifyCtx verify{};
     if (opt.verifyHashes && !checkpoints.empty()) {
@@ -184,131 +353,195 @@ bool runReplayHeadless(Game& game,
 
         // Validate initial state (turn 0) immediately, if present in the replay.
         onTurnHashVerify(&verify, game.turns(), game.determinismHash());
-        if (verify.failed) {
-            if (outStats) {
-                outStats->failure = ReplayFailureKind::HashMismatch;
-                outStats->failedTurn = verify.failedTurn;
-                outStats->failedCheckpointTurn = verify.expectedTurn;
-                outStats->expectedHash = verify.expectedHash;
-                outStats->gotHash = verify.gotHash;
-            }
-            if (err) formatHashMismatch(verify, *err);
-            return false;
-        }
+        if (verify.failed) return failHashMismatch(verify, game, nullptr, outStats, err);
     } else {
         game.clearTurnHook();
     }
 
-    // Replay playback state: feed recorded input events based on elapsed simulated time.
-    size_t idx = 0;
-    uint32_t elapsedMs = 0;
-    uint32_t frames = 0;
-    uint32_t dispatched = 0;
+    const bool ok = runFrom(game, replay, opt, RunCursor{}, verify, outStats, err);
+    game.clearTurnHook();
+    return ok;
+}
 
-    uint32_t lastEventMs = 0;
-    if (!replay.events.empty()) {
-        lastEventMs = replay.events.back().tMs;
+const ReplaySnapshot* ReplaySnapshots::atOrBefore(uint32_t turn) const {
+    const ReplaySnapshot* best = nullptr;
+    for (const ReplaySnapshot& s : list) {
+        if (s.turn > turn) break;
+        best = &s;
     }
+    return best;
+}
 
-    // Safety: unless caller explicitly overrides, cap runtime to avoid infinite loops
-    // if something goes wrong (e.g., auto-move stuck). Still large enough for typical
-    // replays; callers can set maxSimMs=0 to disable or set a larger value.
-    uint32_t maxSimMs = opt.maxSimMs;
-    if (maxSimMs == 0) {
-        // Default: last event time + 5 seconds (and at least 5 seconds).
-        const uint32_t slack = 5000;
-        maxSimMs = (lastEventMs > (std::numeric_limits<uint32_t>::max() - slack))
-                 ? std::numeric_limits<uint32_t>::max()
-                 : (lastEventMs + slack);
-        if (maxSimMs < 5000) maxSimMs = 5000;
+size_t ReplaySnapshots::memoryBytes() const {
+    size_t n = 0;
+    for (const ReplaySnapshot& s : list) n += s.save.size();
+    return n;
+}
+
+bool resumeReplayHeadless(Game& game,
+                          const ReplayFile& replay,
+                          const ReplaySnapshot& from,
+                          const ReplayRunOptions& opt,
+                          ReplayRunStats* outStats,
+                          std::string* err) {
+    if (outStats) *outStats = ReplayRunStats{};
+
+    if (!restoreSnapshot(game, from, err)) {
+        if (outStats) outStats->failure = ReplayFailureKind::Unknown;
+        return false;
     }
 
-    const uint32_t maxFrames = (opt.maxFrames == 0) ? (maxSimMs / frameMs + 10) : opt.maxFrames;
+    const std::vector<TurnHashCheckpoint> checkpoints = collectCheckpoints(replay);
 
-    while (frames < maxFrames && elapsedMs <= maxSimMs) {
-        // Dispatch all events that are due at this time (mirrors main.cpp behavior).
-        while (idx < replay.events.size() && replay.events[idx].tMs <= elapsedMs) {
-            dispatchReplayEvent(game, replay.events[idx]);
-            ++idx;
-            ++dispatched;
-
-            if (verify.failed) {
-                if (outStats) {
-                    outStats->failure = ReplayFailureKind::HashMismatch;
-                    outStats->failedTurn = verify.failedTurn;
-                    outStats->failedCheckpointTurn = verify.expectedTurn;
-                    outStats->expectedHash = verify.expectedHash;
-                    outStats->gotHash = verify.gotHash;
-                    outStats->simulatedMs = elapsedMs;
-                    outStats->frames = frames;
-                    outStats->eventsDispatched = dispatched;
-                    outStats->turns = game.turns();
-                }
-                if (err) formatHashMismatch(verify, *err);
-                return false;
-            }
-        }
+    TurnHashVerifyCtx verify{};
+    if (opt.verifyHashes && !checkpoints.empty()) {
+        verify.expected = &checkpoints;
+        while (verify.idx < checkpoints.size() && checkpoints[verify.idx].turn <= from.turn) ++verify.idx;
+        game.setTurnHook(&onTurnHashVerify, &verify);
+    } else {
+        game.clearTurnHook();
+    }
 
-        // Done once all replay events were processed AND (if verifying) all checkpoints were consumed.
-        const bool allEventsDone = (idx >= replay.events.size());
-        const bool hashesDone = (!verify.expected) || (verify.idx >= verify.expected->size());
-        if (allEventsDone && hashesDone) {
-            break;
-        }
+    RunCursor c;
+    c.idx = from.eventIndex;
+    c.elapsedMs = from.elapsedMs;
+    c.frames = from.frames;
+    c.dispatched = from.eventsDispatched;
+    const bool ok = runFrom(game, replay, opt, c, verify, outStats, err);
+    game.clearTurnHook();
+    return ok;
+}
 
-        // Advance simulated time by one fixed step.
-        uint32_t stepMs = frameMs;
-        if (elapsedMs + stepMs > maxSimMs) stepMs = maxSimMs - elapsedMs;
-        if (stepMs == 0) break;
+bool bisectReplayDesync(Game& game,
+                        const ReplayFile& replay,
+                        const ReplayRunOptions& opt,
+                        uint32_t everyTurns,
+                        ReplayBisectResult& out,
+                        std::string* err) {
+    out = ReplayBisectResult{};
+    everyTurns = std::max<uint32_t>(1u, everyTurns);
+
+    const std::vector<TurnHashCheckpoint> all = collectCheckpoints(replay);
+    if (all.empty()) {
+        if (err) *err = "Replay has no StateHash checkpoints to bisect against.";
+        return false;
+    }
 
-        float dt = stepMs / 1000.0f;
-        if (dt > 0.1f) dt = 0.1f;
+    // Pass 1: the whole replay, but hashed only on checkpoint turns that are multiples of
+    // everyTurns (falling back to every checkpoint if none are), taking snapshots as it goes.
+    std::vector<TurnHashCheckpoint> sparse;
+    for (const TurnHashCheckpoint& cp : all) {
+        if (cp.turn % everyTurns == 0u) sparse.push_back(cp);
+    }
+    const uint32_t hookEvery = sparse.empty() ? 1u : everyTurns;
+    if (sparse.empty()) sparse = all;
+
+    ReplaySnapshots store;
+    store.everyTurns = everyTurns;
+    ReplayRunOptions scanOpt = opt;
+    scanOpt.snapshots = &store;
+
+    TurnHashVerifyCtx scan{};
+    scan.expected = &sparse;
+    game.setTurnHook(&onTurnHashVerify, &scan, hookEvery);
+    onTurnHashVerify(&scan, game.turns(), game.determinismHash());
+
+    ReplayRunStats stats;
+    std::string scanErr;
+    const bool scanOk = !scan.failed && runFrom(game, replay, scanOpt, RunCursor{}, scan, &stats, &scanErr);
+    game.clearTurnHook();
+    if (!scanOk && !scan.failed) {
+        if (err) *err = scanErr;
+        return false;
+    }
 
-        game.update(dt);
+    // Everything up to the last sparse checkpoint that matched is known good; resume from
+    // the latest snapshot no later than that.
+    uint32_t goodTurn = 0;
+    bool haveGood = false;
+    for (const TurnHashCheckpoint& cp : sparse) {
+        if (scan.failed && cp.turn >= scan.expectedTurn) break;
+        goodTurn = cp.turn;
+        haveGood = true;
+    }
+    const ReplaySnapshot* from = haveGood ? store.atOrBefore(goodTurn) : nullptr;
 
-        elapsedMs += stepMs;
-        ++frames;
-
-        if (verify.failed) {
-            if (outStats) {
-                outStats->failure = ReplayFailureKind::HashMismatch;
-                outStats->failedTurn = verify.failedTurn;
-                outStats->failedCheckpointTurn = verify.expectedTurn;
-                outStats->expectedHash = verify.expectedHash;
-                outStats->gotHash = verify.gotHash;
-                outStats->simulatedMs = elapsedMs;
-                outStats->frames = frames;
-                outStats->eventsDispatched = dispatched;
-                outStats->turns = game.turns();
-            }
-            if (err) formatHashMismatch(verify, *err);
-            return false;
-        }
+    out.snapshots = store.list.size();
+    out.snapshotBytes = store.memoryBytes();
+
+    // Pass 2: every checkpoint from there on.
+    auto restart = [&](std::string* e) -> bool {
+        if (from) return restoreSnapshot(game, *from, e);
+        return prepareGameForReplay(game, replay, e);
+    };
+    if (!restart(err)) return false;
+    out.resumedFromTurn = from ? from->turn : game.turns();
+
+    TurnHashVerifyCtx verify{};
+    verify.expected = &all;
+    game.setTurnHook(&onTurnHashVerify, &verify);
+    if (from) {
+        // The snapshot was taken after its turn's hook had already run.
+        while (verify.idx < all.size() && all[verify.idx].turn <= from->turn) ++verify.idx;
+    } else {
+        onTurnHashVerify(&verify, game.turns(), game.determinismHash());
     }
 
-    if (frames >= maxFrames || elapsedMs > maxSimMs) {
-        if (outStats) {
-            outStats->failure = ReplayFailureKind::SafetyLimit;
-            outStats->simulatedMs = elapsedMs;
-            outStats->frames = frames;
-            outStats->eventsDispatched = dispatched;
-            outStats->turns = game.turns();
-        }
-        if (err) {
-            std::ostringstream ss;
-            ss << "Replay runner exceeded safety limit (elapsedMs=" << elapsedMs
-               << ", frames=" << frames << ", maxSimMs=" << maxSimMs << ").";
-            *err = ss.str();
+    RunCursor c;
+    if (from) {
+        c.idx = from->eventIndex;
+        c.elapsedMs = from->elapsedMs;
+        c.frames = from->frames;
+        c.dispatched = from->eventsDispatched;
+    }
+    std::string runErr;
+    const bool ok = !verify.failed && runFrom(game, replay, opt, c, verify, &stats, &runErr);
+    game.clearTurnHook();
+    if (ok) {
+        if (scan.failed) {
+            // The same replay diverged in one run but not in the other.
+            if (err) *err = "Replay diverged during the scan but not when re-run from turn " +
+                            std::to_string(out.resumedFromTurn) + " (nondeterministic run?).";
+            return false;
         }
+        return true;
+    }
+    if (!verify.failed) {
+        if (err) *err = runErr;
         return false;
     }
 
-    if (outStats) {
-        outStats->simulatedMs = elapsedMs;
-        outStats->frames = frames;
-        outStats->eventsDispatched = dispatched;
-        outStats->turns = game.turns();
+    out.diverged = true;
+    out.turn = verify.expectedTurn;
+    out.expectedHash = verify.expectedHash;
+    out.gotHash = verify.gotHash;
+
+    // Pass 3: subsystem hashes across the divergent turn.
+    if (!restart(err)) return false;
+    PartsCaptureCtx parts;
+    parts.game = &game;
+    parts.atTurn = out.turn;
+    parts.beforeTurn = (out.turn > game.turns()) ? out.turn - 1u : out.turn;
+    out.beforeTurn = parts.beforeTurn;
+    if (parts.beforeTurn == game.turns()) parts.before = game.determinismHashParts();
+    if (parts.atTurn == game.turns()) {
+        parts.at = game.determinismHashParts();
+        parts.haveAt = true;
     }
 
+    if (!parts.haveAt) {
+        ReplayRunOptions partsOpt = opt;
+        partsOpt.stopAtTurn = out.turn;
+        game.setTurnHook(&onTurnCaptureParts, &parts);
+        TurnHashVerifyCtx none{};
+        (void)runFrom(game, replay, partsOpt, c, none, nullptr, nullptr);
+        game.clearTurnHook();
+    }
+
+    out.partsBefore = parts.before;
+    out.partsAt = parts.at;
+    for (size_t i = 0; i < Game::kHashPartCount; ++i) {
+        if (parts.before[i] != parts.at[i]) out.changedParts.push_back(static_cast<Game::HashPart>(i));
+    }
     return true;
 }
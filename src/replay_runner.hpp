@@ -1,16 +1,26 @@
 #pragma once
 
+#include "game.hpp"
 #include "replay.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 // Headless replay runner: drives the simulation using the recorded input stream
 // and (optionally) validates deterministic state-hash checkpoints.
 //
+// A run can also keep in-memory snapshots (the save serializer writing into a buffer)
+// every N turns, so a later run can resume from the middle of the replay instead of
+// replaying it from turn 0; bisectReplayDesync() builds on that to locate a desync.
+//
 // This is useful for CI/regression testing and for diagnosing desyncs without
 // needing SDL2 or a renderer.
 
+struct ReplaySnapshots;
+
 struct ReplayRunOptions {
     // Fixed "frame" step used for update() when simulating wall-clock time.
     // Must be in [1, 100] to match the game's dt clamp behavior (0.1s).
@@ -22,6 +32,34 @@ struct ReplayRunOptions {
     // Optional safety limits (0 = unlimited).
     uint32_t maxSimMs = 0;
     uint32_t maxFrames = 0;
+
+    // Stop successfully once the game reaches this turn (0 = play the whole replay).
+    // Pair with loadReplayPrefix() to avoid loading the rest of a long replay.
+    uint32_t stopAtTurn = 0;
+
+    // If set (and its everyTurns != 0), the run appends a snapshot to it at the first
+    // quiet frame (see Game::isSnapshotSafe()) at or after every multiple of everyTurns.
+    ReplaySnapshots* snapshots = nullptr;
+};
+
+// A saved game plus the runner position it was taken at.
+struct ReplaySnapshot {
+    uint32_t turn = 0;
+    uint64_t hash = 0; // determinismHash() at capture, checked again on restore
+    size_t eventIndex = 0;
+    uint32_t elapsedMs = 0;
+    uint32_t frames = 0;
+    uint32_t eventsDispatched = 0;
+    std::string save;
+};
+
+struct ReplaySnapshots {
+    uint32_t everyTurns = 0;
+    std::vector<ReplaySnapshot> list; // ascending turn
+
+    // The latest snapshot taken at or before `turn`, or nullptr.
+    const ReplaySnapshot* atOrBefore(uint32_t turn) const;
+    size_t memoryBytes() const;
 };
 
 // If a replay run fails, we categorize the failure for tooling/CI purposes.
@@ -50,6 +88,10 @@ struct ReplayRunStats {
     uint32_t eventsDispatched = 0;
     uint32_t turns = 0;
 
+    // Monster AI cost-map cache effectiveness (see MonsterCostCache).
+    uint64_t costCacheHits = 0;
+    uint64_t costCacheMisses = 0;
+
     // Filled if the run fails (best-effort). Tools should not rely on the
     // presence of these fields unless the run returned false.
     ReplayFailureKind failure = ReplayFailureKind::None;
@@ -68,7 +110,9 @@ struct ReplayRunStats {
 // with the recorded seed.
 //
 // This mirrors the main executable's replay mode setup: it disables autosaves,
-// mortems, and backups to keep verification non-destructive.
+// mortems, and backups to keep verification non-destructive. Saves go to the
+// "__replay__" slot next to game.defaultSavePath(), so callers running several
+// replays at once should give each Game its own save path (setSavePath) first.
 bool prepareGameForReplay(Game& game, const ReplayFile& replay, std::string* err = nullptr);
 
 // Run a replay against an already-initialized game (typically prepared via
@@ -78,3 +122,51 @@ bool runReplayHeadless(Game& game,
                        const ReplayRunOptions& opt = {},
                        ReplayRunStats* outStats = nullptr,
                        std::string* err = nullptr);
+
+// Continue a replay from a snapshot taken by an earlier run of the same replay. Prepare
+// `game` first (prepareGameForReplay): settings that are not part of a save come from
+// there. Checkpoints up to the snapshot turn are not re-checked.
+bool resumeReplayHeadless(Game& game,
+                          const ReplayFile& replay,
+                          const ReplaySnapshot& from,
+                          const ReplayRunOptions& opt = {},
+                          ReplayRunStats* outStats = nullptr,
+                          std::string* err = nullptr);
+
+struct ReplayBisectResult {
+    bool diverged = false;
+
+    // First checkpoint turn whose hash differs from the recording.
+    uint32_t turn = 0;
+    uint64_t expectedHash = 0;
+    uint64_t gotHash = 0;
+
+    // Turn the exact search resumed from (the snapshot, or the start of the replay).
+    uint32_t resumedFromTurn = 0;
+    size_t snapshots = 0;
+    size_t snapshotBytes = 0;
+
+    // Subsystem hashes at beforeTurn (normally turn - 1) and at turn. A recording only
+    // holds whole-state hashes, so this lists what changed on the divergent turn, which
+    // is where to start looking.
+    uint32_t beforeTurn = 0;
+    std::array<uint64_t, Game::kHashPartCount> partsBefore{};
+    std::array<uint64_t, Game::kHashPartCount> partsAt{};
+    std::vector<Game::HashPart> changedParts;
+};
+
+// Locate the first divergent checkpoint of a replay. `game` must be freshly prepared
+// (prepareGameForReplay). One pass plays the whole replay checking only the checkpoints
+// on multiples of `everyTurns` while taking snapshots at the same interval; a second
+// pass resumes from the last snapshot before the first failure and checks every
+// checkpoint; a third one records the subsystem hashes around the divergent turn.
+//
+// Returns true when the search completed: out.diverged tells whether the replay
+// desynced at all. Returns false (with `err`) when the replay could not be searched,
+// including when the two passes disagree (the run itself is nondeterministic).
+bool bisectReplayDesync(Game& game,
+                        const ReplayFile& replay,
+                        const ReplayRunOptions& opt,
+                        uint32_t everyTurns,
+                        ReplayBisectResult& out,
+                        std::string* err = nullptr);
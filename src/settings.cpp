@@ -281,6 +281,12 @@ Settings loadSettings(const std::string& path) {
                 if (v <= 0) s.textureCacheMB = 0;
                 else s.textureCacheMB = std::clamp(v, 16, 2048);
             }
+        } else if (key == "sprite_cache_mb") {
+            int v = 0;
+            if (parseInt(val, v)) {
+                if (v <= 0) s.spriteCacheMB = 0;
+                else s.spriteCacheMB = std::clamp(v, 16, 4096);
+            }
         } else if (key == "vsync") {
             bool b = true;
             if (parseBool(val, b)) s.vsync = b;
@@ -356,6 +362,14 @@ Settings loadSettings(const std::string& path) {
             int v = 0;
             if (parseInt(val, v)) s.infiniteKeepWindow = std::clamp(v, 0, 200);
         }
+        else if (key == "floor_candidates") {
+            int v = 0;
+            if (parseInt(val, v)) s.floorCandidates = std::clamp(v, 0, Dungeon::MAX_FLOOR_CANDIDATES);
+        }
+        else if (key == "pregen_next_floor") {
+            bool b = false;
+            if (parseBool(val, b)) s.pregenNextFloor = b;
+        }
     }
 
     return s;
@@ -484,6 +498,11 @@ proc_palette_spatial = 35
 # 0 disables eviction (unlimited). If you use huge tile sizes, consider lowering this.
 texture_cache_mb = 256
 
+# sprite_cache_mb: 0 or 16..4096
+# Size cap of the on-disk cache of generated sprites (procrogue_sprites.cache), which
+# makes warm starts skip sprite generation. 0 disables it. Delete the file to reset it.
+sprite_cache_mb = 256
+
 # Rendering / performance
 # vsync: true/false  (true = lower CPU usage, smoother rendering)
 vsync = true
@@ -535,6 +554,13 @@ infinite_world = false
 # infinite_keep_window: 0 disables pruning; otherwise keeps N post-quest depths cached
 infinite_keep_window = 12
 
+# Floor generation
+# floor_candidates: 0 = default (1..3 candidate layouts by depth); 4..16 scores more
+# candidates per floor (built in parallel on spare cores). Changes which floors you get.
+floor_candidates = 0
+# pregen_next_floor: true/false (build the next floor and nearby wilderness chunks in the background; same maps either way)
+pregen_next_floor = false
+
 # Item identification
 # identify_items: true/false  (true = potions/scrolls start unidentified)
 identify_items = true
@@ -94,6 +94,9 @@ struct Settings {
     // - textureCacheMB: approximate VRAM budget for cached entity/item/projectile textures.
     //   0 disables eviction (unlimited).
     int textureCacheMB = 256;
+    // - spriteCacheMB: size cap of the on-disk cache of generated sprites
+    //   (procrogue_sprites.cache next to the settings file). 0 disables it.
+    int spriteCacheMB = 256;
     bool vsync = true;
     int maxFps = 0; // 0 or 30..240
 
@@ -145,6 +148,16 @@ struct Settings {
     // Infinite world memory cap: keep a sliding window of post-quest levels cached.
     // 0 disables pruning.
     int infiniteKeepWindow = 12;
+
+    // Floor generation: candidate layouts scored per floor (0 = default 1..3 by depth).
+    // Candidates are built in parallel, so higher values mostly cost idle cores.
+    // Changes the generated floors; recorded in replays.
+    int floorCandidates = 0;
+
+    // Generate the next floor's terrain (and, on the surface, the adjacent wilderness
+    // chunks) on worker threads while you explore. Same maps either way; trades a spare
+    // core for shorter stair/edge transitions.
+    bool pregenNextFloor = false;
 };
 
 // Loads settings from disk. If the file is missing or invalid, defaults are used.
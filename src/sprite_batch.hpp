@@ -0,0 +1,59 @@
+#pragma once
+
+// Parallel generation of a batch of procedural sprites (Renderer::init() tilesets).
+//
+// The spritegen functions are pure and SDL-free, so a batch of them can run on the
+// shared ThreadPool. Only the upload (texture creation) has to stay on the thread that
+// owns the SDL renderer: run() generates the sprites in chunks on the pool and hands
+// every result to `upload` on the calling thread, in the order the jobs were added.
+// A chunk's pixels are released before the next one starts, so a batch of thousands of
+// large tiles never holds more than one chunk in memory.
+//
+// The slot type is a template parameter (SDL_Texture* in the renderer) so the batch
+// itself stays testable without SDL.
+
+#include "spritegen.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+template <typename Slot>
+class SpriteBatch {
+public:
+    using Generator = std::function<SpritePixels()>;
+
+    void add(Slot* slot, Generator gen) { jobs_.push_back(Job{slot, std::move(gen)}); }
+
+    size_t size() const { return jobs_.size(); }
+
+    // Generates every sprite and calls upload(*slot, pixels) for each, in add() order.
+    // `chunk` bounds how many finished sprites are held at once. Clears the batch.
+    template <typename Upload>
+    void run(ThreadPool& pool, Upload&& upload, size_t chunk = 256) {
+        chunk = std::max<size_t>(1, chunk);
+        std::vector<SpritePixels> done;
+        for (size_t first = 0; first < jobs_.size(); first += chunk) {
+            const size_t n = std::min(chunk, jobs_.size() - first);
+            done.assign(n, SpritePixels{});
+            parallelFor(pool, n, [&](size_t i) { done[i] = jobs_[first + i].gen(); });
+            for (size_t i = 0; i < n; ++i) upload(*jobs_[first + i].slot, done[i]);
+        }
+        jobs_.clear();
+    }
+
+    template <typename Upload>
+    void run(Upload&& upload, size_t chunk = 256) {
+        run(ThreadPool::shared(), std::forward<Upload>(upload), chunk);
+    }
+
+private:
+    struct Job {
+        Slot* slot = nullptr;
+        Generator gen;
+    };
+    std::vector<Job> jobs_;
+};
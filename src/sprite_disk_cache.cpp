@@ -0,0 +1,328 @@
+#include "sprite_disk_cache.hpp"
+
+#include "rng.hpp"
+#include "version.hpp"
+
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'R', 'S', 'C'};
+constexpr uint32_t kFormat = 1u;
+constexpr size_t kKeyBytes = 12;
+constexpr size_t kRecordHeaderBytes = kKeyBytes + 2 + 2 + 4;
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v & 0xFFu));
+    out.push_back(static_cast<uint8_t>((v >> 8) & 0xFFu));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xFFu));
+}
+
+uint16_t getU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+uint32_t getU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void putKey(std::vector<uint8_t>& out, const SpriteCacheKey& k) {
+    out.push_back(k.category);
+    out.push_back(k.kind);
+    out.push_back(k.frame);
+    out.push_back(k.flags);
+    putU16(out, k.pxSize);
+    putU32(out, k.seed);
+    putU16(out, 0u); // reserved
+}
+
+SpriteCacheKey getKey(const uint8_t* p) {
+    SpriteCacheKey k;
+    k.category = p[0];
+    k.kind = p[1];
+    k.frame = p[2];
+    k.flags = p[3];
+    k.pxSize = getU16(p + 4);
+    k.seed = getU32(p + 6);
+    return k;
+}
+
+uint32_t pixelChecksum(const uint8_t* rgba, size_t bytes) {
+    return fnv1a32(reinterpret_cast<const char*>(rgba), bytes);
+}
+
+bool writeHeader(const std::filesystem::path& path, const std::string& stamp) {
+    std::vector<uint8_t> head(kMagic, kMagic + 4);
+    putU32(head, kFormat);
+    putU32(head, static_cast<uint32_t>(stamp.size()));
+    head.insert(head.end(), stamp.begin(), stamp.end());
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(head.data()), static_cast<std::streamsize>(head.size()));
+    return static_cast<bool>(f);
+}
+
+} // namespace
+
+size_t SpriteCacheKeyHash::operator()(const SpriteCacheKey& k) const {
+    uint32_t h = hashCombine(k.seed, static_cast<uint32_t>(k.pxSize) | (static_cast<uint32_t>(k.frame) << 16));
+    h = hashCombine(h, static_cast<uint32_t>(k.category) | (static_cast<uint32_t>(k.kind) << 8) |
+                           (static_cast<uint32_t>(k.flags) << 16));
+    return static_cast<size_t>(h);
+}
+
+// Read-only view of the whole cache file as it was when opened.
+struct SpriteDiskCache::MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    bool open(const std::filesystem::path& path) {
+#if defined(_WIN32)
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz{};
+        if (!GetFileSizeEx(file, &sz)) return false;
+        size = static_cast<size_t>(sz.QuadPart);
+        if (size == 0) return true;
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const uint8_t*>(p);
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) ::munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+};
+
+SpriteDiskCache::SpriteDiskCache() = default;
+
+SpriteDiskCache::~SpriteDiskCache() { close(); }
+
+std::string SpriteDiskCache::defaultStamp() {
+    return std::string(PROCROGUE_APPNAME) + " " + PROCROGUE_VERSION + " spritegen/" + std::to_string(SPRITEGEN_REVISION);
+}
+
+bool SpriteDiskCache::indexMapped(size_t& validEnd, bool& stampOk) {
+    index_.clear();
+    validEnd = 0;
+    stampOk = false;
+
+    const uint8_t* d = map_->data;
+    const size_t n = map_->size;
+    if (n < 12 || std::memcmp(d, kMagic, 4) != 0 || getU32(d + 4) != kFormat) return true;
+    const size_t stampLen = getU32(d + 8);
+    if (n < 12 + stampLen || stampLen != stamp_.size() || std::memcmp(d + 12, stamp_.data(), stampLen) != 0) {
+        return true;
+    }
+    stampOk = true;
+
+    size_t pos = 12 + stampLen;
+    while (pos + kRecordHeaderBytes <= n) {
+        const uint8_t* r = d + pos;
+        Entry e;
+        e.w = getU16(r + kKeyBytes);
+        e.h = getU16(r + kKeyBytes + 2);
+        e.checksum = getU32(r + kKeyBytes + 4);
+        const size_t bytes = static_cast<size_t>(e.w) * static_cast<size_t>(e.h) * 4u;
+        if (pos + kRecordHeaderBytes + bytes > n) break;
+        e.offset = pos + kRecordHeaderBytes;
+        index_[getKey(r)] = e;
+        pos += kRecordHeaderBytes + bytes;
+    }
+    validEnd = pos;
+    return true;
+}
+
+bool SpriteDiskCache::open(const std::filesystem::path& path, const std::string& stamp, size_t maxBytes) {
+    close();
+    std::lock_guard<std::mutex> lock(mu_);
+
+    path_ = path;
+    stamp_ = stamp;
+    maxBytes_ = maxBytes;
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    if (!std::filesystem::exists(path, ec) && !writeHeader(path, stamp)) return false;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        map_ = std::make_unique<MappedFile>();
+        size_t validEnd = 0;
+        bool stampOk = false;
+        if (!map_->open(path) || !indexMapped(validEnd, stampOk)) {
+            map_.reset();
+            index_.clear();
+            return false;
+        }
+        if (stampOk && validEnd == map_->size) break;
+
+        // Another build's cache, or a torn tail: fix the file while nothing maps it.
+        map_.reset();
+        index_.clear();
+        if (!stampOk) {
+            if (!writeHeader(path, stamp)) return false;
+        } else {
+            std::filesystem::resize_file(path, validEnd, ec);
+            if (ec) return false;
+        }
+    }
+    if (!map_) return false;
+
+    mappedBytes_ = map_->size;
+    fileBytes_ = map_->size;
+    out_.open(path, std::ios::binary | std::ios::app);
+    in_.open(path, std::ios::binary);
+    if (!out_ || !in_) {
+        out_.close();
+        in_.close();
+        map_.reset();
+        index_.clear();
+        return false;
+    }
+    stats_ = Stats{};
+    return true;
+}
+
+void SpriteDiskCache::close() {
+    std::lock_guard<std::mutex> lock(mu_);
+    out_.close();
+    in_.close();
+    map_.reset();
+    index_.clear();
+    fileBytes_ = 0;
+    mappedBytes_ = 0;
+}
+
+bool SpriteDiskCache::isOpen() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return map_ != nullptr;
+}
+
+bool SpriteDiskCache::readEntry(const Entry& e, SpritePixels& out) {
+    const size_t bytes = static_cast<size_t>(e.w) * static_cast<size_t>(e.h) * 4u;
+    const uint8_t* src = nullptr;
+    std::vector<uint8_t> buf;
+    if (e.offset + bytes <= mappedBytes_) {
+        src = map_->data + e.offset;
+    } else {
+        buf.resize(bytes);
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(e.offset));
+        if (!in_.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(bytes))) return false;
+        src = buf.data();
+    }
+    if (pixelChecksum(src, bytes) != e.checksum) return false;
+
+    out.w = e.w;
+    out.h = e.h;
+    out.px.resize(static_cast<size_t>(e.w) * static_cast<size_t>(e.h));
+    for (size_t i = 0; i < out.px.size(); ++i) {
+        out.px[i] = Color{src[i * 4], src[i * 4 + 1], src[i * 4 + 2], src[i * 4 + 3]};
+    }
+    return true;
+}
+
+bool SpriteDiskCache::get(const SpriteCacheKey& key, SpritePixels& out) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!map_) return false;
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return false;
+    }
+    if (!readEntry(it->second, out)) {
+        index_.erase(it);
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.hits;
+    return true;
+}
+
+void SpriteDiskCache::put(const SpriteCacheKey& key, const SpritePixels& px) {
+    if (px.w <= 0 || px.h <= 0 || px.w > 0xFFFF || px.h > 0xFFFF) return;
+    if (px.px.size() != static_cast<size_t>(px.w) * static_cast<size_t>(px.h)) return;
+
+    std::vector<uint8_t> rec;
+    rec.reserve(kRecordHeaderBytes + px.px.size() * 4u);
+    putKey(rec, key);
+    putU16(rec, static_cast<uint16_t>(px.w));
+    putU16(rec, static_cast<uint16_t>(px.h));
+    putU32(rec, 0u); // checksum, patched below
+    for (const Color& c : px.px) {
+        rec.push_back(c.r);
+        rec.push_back(c.g);
+        rec.push_back(c.b);
+        rec.push_back(c.a);
+    }
+    const uint32_t checksum = pixelChecksum(rec.data() + kRecordHeaderBytes, rec.size() - kRecordHeaderBytes);
+    for (int i = 0; i < 4; ++i) rec[kKeyBytes + 4 + i] = static_cast<uint8_t>((checksum >> (8 * i)) & 0xFFu);
+
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!map_ || index_.count(key) != 0) return;
+    if (maxBytes_ != 0 && fileBytes_ + rec.size() > maxBytes_) return;
+
+    out_.write(reinterpret_cast<const char*>(rec.data()), static_cast<std::streamsize>(rec.size()));
+    out_.flush();
+    if (!out_) return;
+
+    Entry e;
+    e.offset = fileBytes_ + kRecordHeaderBytes;
+    e.w = static_cast<uint16_t>(px.w);
+    e.h = static_cast<uint16_t>(px.h);
+    e.checksum = checksum;
+    index_[key] = e;
+    fileBytes_ += rec.size();
+    ++stats_.writes;
+}
+
+SpriteDiskCache::Stats SpriteDiskCache::stats() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    Stats s = stats_;
+    s.entries = index_.size();
+    s.fileBytes = fileBytes_;
+    return s;
+}
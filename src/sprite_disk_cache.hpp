@@ -0,0 +1,119 @@
+#pragma once
+
+// Persistent cache of generated sprites (see Renderer::setSpriteDiskCache()).
+//
+// Every procedural sprite is a pure function of its generator inputs (category, kind,
+// seed, frame, pixel size, 3D/isometric/raytrace flags) and of the generator code. The
+// voxel paths (renderSprite3D*, the isometric raytracer) are expensive, so the renderer
+// keeps their output in a single append-only file keyed by those inputs:
+//
+//   header:  "PRSC", u32 format, u32 stamp length, stamp bytes
+//   records: 12-byte key, u16 w, u16 h, u32 checksum, w*h RGBA pixels
+//
+// The stamp is the game version plus SPRITEGEN_REVISION; a file with any other stamp is
+// discarded and rebuilt. The file is memory-mapped on open and only indexed (key ->
+// offset), so a warm start costs a page-in per sprite that is actually drawn. Sprites
+// generated during the session are appended; a torn tail (crash mid-write) is cut off
+// on the next open, and a record whose checksum fails is treated as a miss.
+//
+// All member functions are thread safe.
+
+#include "spritegen.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct SpriteCacheKey {
+    // flags bits
+    static constexpr uint8_t kUse3D = 1u << 0;
+    static constexpr uint8_t kIsometric = 1u << 1;
+    static constexpr uint8_t kIsoRaytrace = 1u << 2;
+
+    uint8_t category = 0; // owner-defined namespace (entity, item, terrain block, ...)
+    uint8_t kind = 0;
+    uint8_t frame = 0;
+    uint8_t flags = 0;
+    uint16_t pxSize = 0;
+    uint32_t seed = 0;
+
+    bool operator==(const SpriteCacheKey& o) const {
+        return category == o.category && kind == o.kind && frame == o.frame && flags == o.flags &&
+               pxSize == o.pxSize && seed == o.seed;
+    }
+};
+
+struct SpriteCacheKeyHash {
+    size_t operator()(const SpriteCacheKey& k) const;
+};
+
+class SpriteDiskCache {
+public:
+    SpriteDiskCache();
+    ~SpriteDiskCache();
+
+    SpriteDiskCache(const SpriteDiskCache&) = delete;
+    SpriteDiskCache& operator=(const SpriteDiskCache&) = delete;
+
+    // Version stamp for this build (PROCROGUE_VERSION + SPRITEGEN_REVISION).
+    static std::string defaultStamp();
+
+    // Opens (creating if needed) the cache at `path`. New sprites are appended until the
+    // file reaches maxBytes (0 = no limit). Returns false (cache disabled) if the file is
+    // unusable.
+    bool open(const std::filesystem::path& path, const std::string& stamp, size_t maxBytes);
+    void close();
+    bool isOpen() const;
+
+    bool get(const SpriteCacheKey& key, SpritePixels& out);
+    void put(const SpriteCacheKey& key, const SpritePixels& px);
+
+    // get(), or gen() followed by put() on a miss. A closed cache just calls gen().
+    template <typename Gen>
+    SpritePixels getOrGenerate(const SpriteCacheKey& key, Gen&& gen) {
+        SpritePixels px;
+        if (get(key, px)) return px;
+        px = gen();
+        put(key, px);
+        return px;
+    }
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writes = 0;
+        size_t entries = 0;
+        size_t fileBytes = 0;
+    };
+    Stats stats() const;
+
+private:
+    struct MappedFile;
+
+    struct Entry {
+        uint64_t offset = 0; // of the pixel data
+        uint16_t w = 0;
+        uint16_t h = 0;
+        uint32_t checksum = 0;
+    };
+
+    bool indexMapped(size_t& validEnd, bool& stampOk);
+    bool readEntry(const Entry& e, SpritePixels& out);
+
+    mutable std::mutex mu_;
+    std::filesystem::path path_;
+    std::string stamp_;
+    size_t maxBytes_ = 0;
+    size_t fileBytes_ = 0;
+    size_t mappedBytes_ = 0;
+    std::unique_ptr<MappedFile> map_;
+    std::ofstream out_;
+    std::ifstream in_; // records appended after the file was mapped
+    std::unordered_map<SpriteCacheKey, Entry, SpriteCacheKeyHash> index_;
+    Stats stats_;
+};
@@ -0,0 +1,76 @@
+#include "sprite_jobs.hpp"
+
+#include <exception>
+
+SpriteJobQueue::SpriteJobQueue(ThreadPool& pool) : pool_(pool) {}
+
+SpriteJobQueue::~SpriteJobQueue() {
+    cancelAll();
+    waitIdle();
+}
+
+bool SpriteJobQueue::request(uint64_t key, Generator gen) {
+    uint64_t epoch = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (pending_.count(key) != 0) return false;
+        epoch = epoch_;
+        pending_.emplace(key, epoch);
+        ++running_;
+        ++stats_.queued;
+    }
+
+    const Clock::time_point queuedAt = Clock::now();
+    pool_.submit([this, key, epoch, queuedAt, gen = std::move(gen)] {
+        Frames frames;
+        try {
+            frames = gen();
+        } catch (const std::exception&) {
+            // Delivered empty: the caller keeps its placeholder and may request again.
+            frames.clear();
+        }
+        finish(key, epoch, queuedAt, std::move(frames));
+    });
+    return true;
+}
+
+bool SpriteJobQueue::pending(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return pending_.count(key) != 0;
+}
+
+void SpriteJobQueue::cancelAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++epoch_;
+    stats_.cancelled += pending_.size();
+    pending_.clear();
+    done_.clear();
+}
+
+void SpriteJobQueue::waitIdle() {
+    std::unique_lock<std::mutex> lock(mu_);
+    idleCv_.wait(lock, [this] { return running_ == 0; });
+}
+
+void SpriteJobQueue::finish(uint64_t key, uint64_t epoch, Clock::time_point queuedAt, Frames frames) {
+    const float ms = std::chrono::duration<float, std::milli>(Clock::now() - queuedAt).count();
+
+    std::lock_guard<std::mutex> lock(mu_);
+    if (epoch == epoch_) {
+        size_t bytes = 0;
+        for (const SpritePixels& s : frames) bytes += s.px.size() * sizeof(Color);
+        done_.push_back(Done{key, std::move(frames), bytes});
+
+        const float a = 0.1f; // EMA alpha, as for the renderer's frame-time readout
+        stats_.lastMs = ms;
+        stats_.avgMs = (stats_.avgMs <= 0.0f) ? ms : stats_.avgMs * (1.0f - a) + ms * a;
+    }
+    if (--running_ == 0) idleCv_.notify_all();
+}
+
+SpriteJobQueue::Stats SpriteJobQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    Stats s = stats_;
+    s.depth = pending_.size();
+    return s;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// Asynchronous generation of sprite frame sets (Renderer sprite cache misses).
+//
+// A miss in the renderer's texture cache used to generate every animation frame on the
+// spot, so the first frame a new monster or item came into view could stall for the
+// whole voxel/raytrace cost. Instead the renderer request()s the frames here: the
+// generator runs on the shared ThreadPool while the caller draws a cheap placeholder,
+// and finished frame sets are handed back by drain() on the thread that owns the SDL
+// renderer, a bounded number of bytes per call so a burst of misses (entering a level,
+// toggling voxel sprites) spreads its texture uploads over several frames.
+//
+// A key is generated at most once while it is pending. cancelAll() forgets pending and
+// undrained work (cache invalidation); jobs already running finish and are discarded.
+// The destructor waits for running jobs, so generators may reference state that outlives
+// the queue.
+
+#include "spritegen.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class SpriteJobQueue {
+public:
+    using Frames = std::vector<SpritePixels>;
+    using Generator = std::function<Frames()>;
+
+    explicit SpriteJobQueue(ThreadPool& pool = ThreadPool::shared());
+    ~SpriteJobQueue();
+
+    SpriteJobQueue(const SpriteJobQueue&) = delete;
+    SpriteJobQueue& operator=(const SpriteJobQueue&) = delete;
+
+    // Queues gen() for `key` unless it is already pending. Returns true if a job was queued.
+    bool request(uint64_t key, Generator gen);
+    bool pending(uint64_t key) const;
+
+    // Drops every pending and undrained job.
+    void cancelAll();
+
+    // Blocks until no job is running (tests, shutdown).
+    void waitIdle();
+
+    // Calls upload(key, frames) for finished jobs, in completion order, on the calling
+    // thread. Stops once `maxBytes` of pixels were handed out (0 = no limit); at least
+    // one finished job is always delivered so progress never stalls. Returns the count.
+    template <typename Upload>
+    size_t drain(size_t maxBytes, Upload&& upload) {
+        size_t count = 0;
+        size_t bytes = 0;
+        for (;;) {
+            Done d;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                if (done_.empty()) break;
+                if (maxBytes > 0 && count > 0 && bytes + done_.front().bytes > maxBytes) break;
+                d = std::move(done_.front());
+                done_.pop_front();
+                pending_.erase(d.key);
+                ++stats_.uploaded;
+            }
+            bytes += d.bytes;
+            ++count;
+            upload(d.key, d.frames);
+        }
+        return count;
+    }
+
+    struct Stats {
+        uint64_t queued = 0;    // jobs submitted
+        uint64_t uploaded = 0;  // finished jobs handed to drain()
+        uint64_t cancelled = 0; // pending jobs dropped by cancelAll()
+        size_t depth = 0;       // pending: queued, running or awaiting drain()
+        float lastMs = 0.0f;    // latency (request -> finished) of the newest job
+        float avgMs = 0.0f;     // moving average (EMA) of the same
+    };
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Done {
+        uint64_t key = 0;
+        Frames frames;
+        size_t bytes = 0;
+    };
+
+    void finish(uint64_t key, uint64_t epoch, Clock::time_point queuedAt, Frames frames);
+
+    ThreadPool& pool_;
+    mutable std::mutex mu_;
+    std::condition_variable idleCv_;
+    uint64_t epoch_ = 0;
+    size_t running_ = 0;
+    std::unordered_map<uint64_t, uint64_t> pending_; // key -> epoch it was requested in
+    std::deque<Done> done_;
+    Stats stats_;
+};
@@ -53,6 +53,11 @@ SpritePixels resampleSpriteToRect(const SpritePixels& src, int outW, int outH);
 // visually identify potion/scroll/ring/wand types from their sprite alone.
 inline constexpr uint32_t SPRITE_SEED_IDENT_APPEARANCE_FLAG = 0x80000000u;
 
+// Revision of the sprite generators' output. Bump it whenever a change alters the pixels
+// any generator produces for the same inputs: it is part of the on-disk sprite cache
+// stamp (sprite_disk_cache.hpp), so stale cached sprites are discarded.
+inline constexpr uint32_t SPRITEGEN_REVISION = 1u;
+
 // Procedural sprites.
 // The underlying generator operates in a tiny, deterministic 16x16 "design grid" and
 // then upscales to the requested pixel size.
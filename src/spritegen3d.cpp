@@ -9,6 +9,10 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <vector>
 
@@ -1456,100 +1460,61 @@ VoxelModel buildEntityModel(EntityKind kind, uint32_t seed, int frame, const Spr
     return {};
 }
 
-SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, float yawScale = 1.0f, float yawBase = 0.0f) {
-    SpritePixels img;
-    img.w = outW;
-    img.h = outH;
-    img.px.assign(static_cast<size_t>(outW * outH), {0,0,0,0});
+// Model-space lighting terms of renderVoxel().
+//
+// The light direction is fixed in model space, so a voxel's smoothed normal, ambient
+// occlusion and shadow transmittance are the same from every camera. Only the few voxels
+// whose occupancy gradient vanishes fall back to the normal of the face the ray entered
+// through, which does depend on the view.
+struct VoxelLighting {
+    const VoxelModel& m;
 
-    // Find bounds of filled voxels to auto-zoom.
-    int minX = m.w, minY = m.h, minZ = m.d;
+    // Light from above-left-front.
+    const Vec3f lightDir = normalize({-0.55f, 0.85f, -0.45f});
+
+    // Bounds of filled voxels, padded a bit to make room for lighting/shadow
+    // (maxX < 0 => empty model).
+    int minX = 0, minY = 0, minZ = 0;
     int maxX = -1, maxY = -1, maxZ = -1;
-    for (int z = 0; z < m.d; ++z) {
-        for (int y = 0; y < m.h; ++y) {
-            for (int x = 0; x < m.w; ++x) {
-                if (m.at(x,y,z).a == 0) continue;
-                minX = std::min(minX, x);
-                minY = std::min(minY, y);
-                minZ = std::min(minZ, z);
-                maxX = std::max(maxX, x);
-                maxY = std::max(maxY, y);
-                maxZ = std::max(maxZ, z);
+    Vec3f boundMin;
+    Vec3f boundMax;
+
+    explicit VoxelLighting(const VoxelModel& model) : m(model) {
+        minX = m.w; minY = m.h; minZ = m.d;
+        for (int z = 0; z < m.d; ++z) {
+            for (int y = 0; y < m.h; ++y) {
+                for (int x = 0; x < m.w; ++x) {
+                    if (m.at(x,y,z).a == 0) continue;
+                    minX = std::min(minX, x);
+                    minY = std::min(minY, y);
+                    minZ = std::min(minZ, z);
+                    maxX = std::max(maxX, x);
+                    maxY = std::max(maxY, y);
+                    maxZ = std::max(maxZ, z);
+                }
             }
         }
-    }
-    if (maxX < 0) return img; // empty
-
-    // Pad bounds a bit to make room for lighting/shadow.
-    const int pad = 1;
-    minX = std::max(minX - pad, 0);
-    minY = std::max(minY - pad, 0);
-    minZ = std::max(minZ - pad, 0);
-    maxX = std::min(maxX + pad, m.w - 1);
-    maxY = std::min(maxY + pad, m.h - 1);
-    maxZ = std::min(maxZ + pad, m.d - 1);
-
-    Vec3f boundMin = {static_cast<float>(minX), static_cast<float>(minY), static_cast<float>(minZ)};
-    Vec3f boundMax = {static_cast<float>(maxX + 1), static_cast<float>(maxY + 1), static_cast<float>(maxZ + 1)};
-    Vec3f center = (boundMin + boundMax) * 0.5f;
-
-    // Camera direction with a tiny frame-based wobble.
-    //
-    // yawBase is used by UI "turntable" previews so we can rotate the camera
-    // smoothly around the model without affecting the main in-game sprite frames.
-    Vec3f dirBase = normalize({0.70f, -0.42f, 1.0f});
-    const float yawWobble = ((frame % 2 == 0) ? -0.10f : +0.10f) * yawScale;
-    const float yaw = yawBase + yawWobble;
-    // Rotate around Y axis: (x,z) plane.
-    const float cy = std::cos(yaw);
-    const float sy = std::sin(yaw);
-    Vec3f dir = normalize({ dirBase.x * cy + dirBase.z * sy, dirBase.y, -dirBase.x * sy + dirBase.z * cy });
-
-    Vec3f upWorld = {0.0f, 1.0f, 0.0f};
-    Vec3f right = normalize(cross(dir, upWorld));
-    Vec3f up = normalize(cross(right, dir));
-
-    // Light from above-left-front.
-    Vec3f lightDir = normalize({-0.55f, 0.85f, -0.45f});
-    const float ambient = 0.32f;
-    const float diffuse = 0.72f;
-    const float specular = 0.38f;
-    const float shininess = 18.0f;
-    const float rimStrength = 0.16f;
+        if (maxX < 0) return; // empty
 
-    // Project bounds to screen plane to find extents along right/up.
-    float minSx = 1e9f, maxSx = -1e9f;
-    float minSy = 1e9f, maxSy = -1e9f;
-    auto considerCorner = [&](Vec3f p){
-        Vec3f v = p - center;
-        float sx2 = dot(v, right);
-        float sy2 = dot(v, up);
-        minSx = std::min(minSx, sx2); maxSx = std::max(maxSx, sx2);
-        minSy = std::min(minSy, sy2); maxSy = std::max(maxSy, sy2);
-    };
-    considerCorner({boundMin.x, boundMin.y, boundMin.z});
-    considerCorner({boundMax.x, boundMin.y, boundMin.z});
-    considerCorner({boundMin.x, boundMax.y, boundMin.z});
-    considerCorner({boundMin.x, boundMin.y, boundMax.z});
-    considerCorner({boundMax.x, boundMax.y, boundMin.z});
-    considerCorner({boundMax.x, boundMin.y, boundMax.z});
-    considerCorner({boundMin.x, boundMax.y, boundMax.z});
-    considerCorner({boundMax.x, boundMax.y, boundMax.z});
+        const int pad = 1;
+        minX = std::max(minX - pad, 0);
+        minY = std::max(minY - pad, 0);
+        minZ = std::max(minZ - pad, 0);
+        maxX = std::min(maxX + pad, m.w - 1);
+        maxY = std::min(maxY + pad, m.h - 1);
+        maxZ = std::min(maxZ + pad, m.d - 1);
 
-    // Give a little breathing room so we don't clip.
-    const float padScreen = 0.28f;
-    minSx -= padScreen; maxSx += padScreen;
-    minSy -= padScreen; maxSy += padScreen;
+        boundMin = {static_cast<float>(minX), static_cast<float>(minY), static_cast<float>(minZ)};
+        boundMax = {static_cast<float>(maxX + 1), static_cast<float>(maxY + 1), static_cast<float>(maxZ + 1)};
+    }
 
-    const int margin = 2;
-    const float dist = 64.0f; // camera backoff
-    const Vec3f cameraPos = center - dir * dist;
+    bool empty() const { return maxX < 0; }
 
-    auto inBounds = [&](int x, int y, int z)->bool {
+    bool inBounds(int x, int y, int z) const {
         return x >= minX && x <= maxX && y >= minY && y <= maxY && z >= minZ && z <= maxZ;
-    };
+    }
 
-    auto aabbHit = [&](const Vec3f& o, const Vec3f& d, float& tEnter, float& tExit, Vec3f& nEnter)->bool {
+    bool aabbHit(const Vec3f& o, const Vec3f& d, float& tEnter, float& tExit, Vec3f& nEnter) const {
         tEnter = -1e9f; tExit = 1e9f;
         int axisEnter = -1;
 
@@ -1578,24 +1543,39 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
         if (axisEnter == 2) nEnter = { 0, 0, static_cast<float>(-signum(d.z)) };
         if (nEnter.x == 0 && nEnter.y == 0 && nEnter.z == 0) nEnter = normalize(d) * -1.0f;
         return true;
-    };
+    }
 
-    auto occ = [&](int x, int y, int z)->float {
+    float occ(int x, int y, int z) const {
         return static_cast<float>(m.at(x,y,z).a) / 255.0f;
-    };
+    }
 
-    auto smoothNormal = [&](int vx, int vy, int vz, const Vec3f& fallback)->Vec3f {
+    // Normalized occupancy gradient; false where it vanishes (fully enclosed voxels).
+    bool modelNormal(int vx, int vy, int vz, Vec3f& out) const {
         Vec3f g {
             occ(vx-1,vy,vz) - occ(vx+1,vy,vz),
             occ(vx,vy-1,vz) - occ(vx,vy+1,vz),
             occ(vx,vy,vz-1) - occ(vx,vy,vz+1)
         };
-        if (len(g) <= 1e-3f) return normalize(fallback);
-        return normalize(g);
-    };
+        if (len(g) <= 1e-3f) return false;
+        out = normalize(g);
+        return true;
+    }
+
+    Vec3f smoothNormal(int vx, int vy, int vz, const Vec3f& fallback) const {
+        Vec3f n;
+        if (!modelNormal(vx, vy, vz, n)) return normalize(fallback);
+        return n;
+    }
+
+    // Where the shadow ray of a voxel shaded with normal nn starts: offset slightly toward
+    // the surface normal and toward the light to reduce acne.
+    Vec3f shadowStart(int vx, int vy, int vz, const Vec3f& nn) const {
+        const Vec3f voxCenter = { static_cast<float>(vx) + 0.5f, static_cast<float>(vy) + 0.5f, static_cast<float>(vz) + 0.5f };
+        return voxCenter + nn * 0.56f + lightDir * 0.02f;
+    }
 
     // Soft shadow by casting a secondary voxel DDA toward the light direction.
-    auto traceShadow = [&](const Vec3f& start)->float {
+    float traceShadow(const Vec3f& start) const {
         float tEnter = 0.0f, tExit = 0.0f;
         Vec3f dummyN{0,0,0};
         if (!aabbHit(start, lightDir, tEnter, tExit, dummyN)) return 1.0f;
@@ -1669,35 +1649,46 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
             if (t > tExit + 1e-3f) break;
         }
         return clampf(T, 0.0f, 1.0f);
-    };
+    }
 
     // Hemisphere-based ambient occlusion sampling around the surface normal.
     // This avoids over-darkening broad flat faces (a common issue when AO is
     // derived from "internal" neighbors), while still deepening concave pockets.
-    struct AOSample { int dx, dy, dz; float w; };
-    static constexpr AOSample AO_SAMPLES[] = {
-        // 1-step axis
-        {  1,  0,  0, 1.00f }, { -1,  0,  0, 1.00f }, {  0,  1,  0, 1.00f }, {  0, -1,  0, 1.00f }, {  0,  0,  1, 1.00f }, {  0,  0, -1, 1.00f },
-        // 1-step edges (sqrt2)
-        {  1,  1,  0, 0.85f }, {  1, -1,  0, 0.85f }, { -1,  1,  0, 0.85f }, { -1, -1,  0, 0.85f },
-        {  1,  0,  1, 0.85f }, {  1,  0, -1, 0.85f }, { -1,  0,  1, 0.85f }, { -1,  0, -1, 0.85f },
-        {  0,  1,  1, 0.85f }, {  0,  1, -1, 0.85f }, {  0, -1,  1, 0.85f }, {  0, -1, -1, 0.85f },
-        // 1-step corners (sqrt3)
-        {  1,  1,  1, 0.70f }, {  1,  1, -1, 0.70f }, {  1, -1,  1, 0.70f }, {  1, -1, -1, 0.70f },
-        { -1,  1,  1, 0.70f }, { -1,  1, -1, 0.70f }, { -1, -1,  1, 0.70f }, { -1, -1, -1, 0.70f },
-        // 2-step axis (softens occlusion a little)
-        {  2,  0,  0, 0.55f }, { -2,  0,  0, 0.55f }, {  0,  2,  0, 0.55f }, {  0, -2,  0, 0.55f }, {  0,  0,  2, 0.55f }, {  0,  0, -2, 0.55f },
-    };
+    float ambientOcclusion(int vx, int vy, int vz, const Vec3f& normal) const {
+        struct AOSample { int dx, dy, dz; float w; };
+        static constexpr AOSample AO_SAMPLES[] = {
+            // 1-step axis
+            {  1,  0,  0, 1.00f }, { -1,  0,  0, 1.00f }, {  0,  1,  0, 1.00f }, {  0, -1,  0, 1.00f }, {  0,  0,  1, 1.00f }, {  0,  0, -1, 1.00f },
+            // 1-step edges (sqrt2)
+            {  1,  1,  0, 0.85f }, {  1, -1,  0, 0.85f }, { -1,  1,  0, 0.85f }, { -1, -1,  0, 0.85f },
+            {  1,  0,  1, 0.85f }, {  1,  0, -1, 0.85f }, { -1,  0,  1, 0.85f }, { -1,  0, -1, 0.85f },
+            {  0,  1,  1, 0.85f }, {  0,  1, -1, 0.85f }, {  0, -1,  1, 0.85f }, {  0, -1, -1, 0.85f },
+            // 1-step corners (sqrt3)
+            {  1,  1,  1, 0.70f }, {  1,  1, -1, 0.70f }, {  1, -1,  1, 0.70f }, {  1, -1, -1, 0.70f },
+            { -1,  1,  1, 0.70f }, { -1,  1, -1, 0.70f }, { -1, -1,  1, 0.70f }, { -1, -1, -1, 0.70f },
+            // 2-step axis (softens occlusion a little)
+            {  2,  0,  0, 0.55f }, { -2,  0,  0, 0.55f }, {  0,  2,  0, 0.55f }, {  0, -2,  0, 0.55f }, {  0,  0,  2, 0.55f }, {  0,  0, -2, 0.55f },
+        };
+        static constexpr size_t AO_SAMPLE_COUNT = sizeof(AO_SAMPLES) / sizeof(AO_SAMPLES[0]);
+
+        // Unit sample directions, normalized once rather than for every shaded voxel.
+        static const std::array<Vec3f, AO_SAMPLE_COUNT> AO_DIRS = [] {
+            std::array<Vec3f, AO_SAMPLE_COUNT> dirs{};
+            for (size_t i = 0; i < AO_SAMPLE_COUNT; ++i) {
+                const AOSample& s = AO_SAMPLES[i];
+                dirs[i] = normalize({ static_cast<float>(s.dx), static_cast<float>(s.dy), static_cast<float>(s.dz) });
+            }
+            return dirs;
+        }();
 
-    auto ambientOcclusion = [&](int vx, int vy, int vz, const Vec3f& normal) -> float {
         const Vec3f nn = normalize(normal);
 
         float occSum = 0.0f;
         float wSum = 0.0f;
 
-        for (const auto& s : AO_SAMPLES) {
-            const Vec3f dir = normalize({ static_cast<float>(s.dx), static_cast<float>(s.dy), static_cast<float>(s.dz) });
-            const float dp = dot(dir, nn);
+        for (size_t i = 0; i < AO_SAMPLE_COUNT; ++i) {
+            const AOSample& s = AO_SAMPLES[i];
+            const float dp = dot(AO_DIRS[i], nn);
 
             // Only sample the hemisphere in front of the surface; a small threshold
             // avoids noisy "side" contributions on flat faces.
@@ -1719,19 +1710,130 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
         ao = clampf(ao, 0.45f, 1.0f);
         ao = std::pow(ao, 1.25f);
         return ao;
+    }
+};
+
+// The VoxelLighting terms of every filled voxel that has a model normal, evaluated once
+// per model. Turntable previews render one model from many camera yaws, and shading --
+// the AO samples and the shadow ray of each hit -- is most of a render's cost.
+struct VoxelLightCache {
+    struct Sample {
+        Vec3f n;            // smoothNormal()
+        float ao = 1.0f;    // ambientOcclusion() around n
+        float shadow = 1.0f; // traceShadow() from shadowStart()
+    };
+
+    int w = 0;
+    int h = 0;
+    std::vector<int32_t> slot; // per voxel: index into samples, -1 = evaluate per hit
+    std::vector<Sample> samples;
+
+    void build(const VoxelLighting& light) {
+        const VoxelModel& m = light.m;
+        w = m.w;
+        h = m.h;
+        slot.assign(m.vox.size(), -1);
+        samples.clear();
+        if (light.empty()) return;
+
+        for (int z = light.minZ; z <= light.maxZ; ++z) {
+            for (int y = light.minY; y <= light.maxY; ++y) {
+                for (int x = light.minX; x <= light.maxX; ++x) {
+                    if (m.at(x,y,z).a == 0) continue;
+                    Sample s;
+                    if (!light.modelNormal(x, y, z, s.n)) continue;
+                    s.ao = light.ambientOcclusion(x, y, z, normalize(s.n));
+                    s.shadow = light.traceShadow(light.shadowStart(x, y, z, s.n));
+                    slot[static_cast<size_t>((z * h + y) * w + x)] = static_cast<int32_t>(samples.size());
+                    samples.push_back(s);
+                }
+            }
+        }
+    }
+
+    const Sample* find(int x, int y, int z) const {
+        const int32_t i = slot[static_cast<size_t>((z * h + y) * w + x)];
+        return (i < 0) ? nullptr : &samples[static_cast<size_t>(i)];
+    }
+};
+
+// lightCache, if given, must have been built for `m`.
+SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, float yawScale = 1.0f, float yawBase = 0.0f,
+                         const VoxelLightCache* lightCache = nullptr) {
+    SpritePixels img;
+    img.w = outW;
+    img.h = outH;
+    img.px.assign(static_cast<size_t>(outW * outH), {0,0,0,0});
+
+    // Bounds of filled voxels to auto-zoom.
+    const VoxelLighting light(m);
+    if (light.empty()) return img;
+
+    const Vec3f boundMin = light.boundMin;
+    const Vec3f boundMax = light.boundMax;
+    Vec3f center = (boundMin + boundMax) * 0.5f;
+
+    // Camera direction with a tiny frame-based wobble.
+    //
+    // yawBase is used by UI "turntable" previews so we can rotate the camera
+    // smoothly around the model without affecting the main in-game sprite frames.
+    Vec3f dirBase = normalize({0.70f, -0.42f, 1.0f});
+    const float yawWobble = ((frame % 2 == 0) ? -0.10f : +0.10f) * yawScale;
+    const float yaw = yawBase + yawWobble;
+    // Rotate around Y axis: (x,z) plane.
+    const float cy = std::cos(yaw);
+    const float sy = std::sin(yaw);
+    Vec3f dir = normalize({ dirBase.x * cy + dirBase.z * sy, dirBase.y, -dirBase.x * sy + dirBase.z * cy });
+
+    Vec3f upWorld = {0.0f, 1.0f, 0.0f};
+    Vec3f right = normalize(cross(dir, upWorld));
+    Vec3f up = normalize(cross(right, dir));
+
+    const Vec3f& lightDir = light.lightDir;
+    const float ambient = 0.32f;
+    const float diffuse = 0.72f;
+    const float specular = 0.38f;
+    const float shininess = 18.0f;
+    const float rimStrength = 0.16f;
+
+    // Project bounds to screen plane to find extents along right/up.
+    float minSx = 1e9f, maxSx = -1e9f;
+    float minSy = 1e9f, maxSy = -1e9f;
+    auto considerCorner = [&](Vec3f p){
+        Vec3f v = p - center;
+        float sx2 = dot(v, right);
+        float sy2 = dot(v, up);
+        minSx = std::min(minSx, sx2); maxSx = std::max(maxSx, sx2);
+        minSy = std::min(minSy, sy2); maxSy = std::max(maxSy, sy2);
     };
+    considerCorner({boundMin.x, boundMin.y, boundMin.z});
+    considerCorner({boundMax.x, boundMin.y, boundMin.z});
+    considerCorner({boundMin.x, boundMax.y, boundMin.z});
+    considerCorner({boundMin.x, boundMin.y, boundMax.z});
+    considerCorner({boundMax.x, boundMax.y, boundMin.z});
+    considerCorner({boundMax.x, boundMin.y, boundMax.z});
+    considerCorner({boundMin.x, boundMax.y, boundMax.z});
+    considerCorner({boundMax.x, boundMax.y, boundMax.z});
 
-    auto shadeVoxel = [&](Color c, const Vec3f& n, const Vec3f& viewDir, float shadow, int vx, int vy, int vz)->Color {
+    // Give a little breathing room so we don't clip.
+    const float padScreen = 0.28f;
+    minSx -= padScreen; maxSx += padScreen;
+    minSy -= padScreen; maxSy += padScreen;
+
+    const int margin = 2;
+    const float dist = 64.0f; // camera backoff
+    const Vec3f cameraPos = center - dir * dist;
+
+    auto shadeVoxel = [&](Color c, const Vec3f& n, const Vec3f& viewDir, float shadow, float ao)->Color {
         Vec3f nn = normalize(n);
         Vec3f vv = normalize(viewDir);
 
         float ndl = std::max(0.0f, dot(nn, lightDir));
         float shade = ambient + diffuse * ndl * shadow;
 
-        // Hemisphere-based ambient occlusion sampling (surface-facing).
+        // Hemisphere-based ambient occlusion (surface-facing, see VoxelLighting).
         // Keeps broad exposed faces from being over-darkened, while still
         // deepening concave pockets and creases.
-        const float ao = ambientOcclusion(vx, vy, vz, nn);
         shade *= ao;
         shade = clampf(shade, 0.0f, 1.25f);
 
@@ -1792,7 +1894,7 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
 
             float tEnter = 0.0f, tExit = 0.0f;
             Vec3f nEnter = {0,0,0};
-            if (!aabbHit(origin, rayDir, tEnter, tExit, nEnter)) continue;
+            if (!light.aabbHit(origin, rayDir, tEnter, tExit, nEnter)) continue;
 
             float t = std::max(tEnter, 0.0f) + 1e-4f;
             Vec3f p = origin + rayDir * t;
@@ -1801,11 +1903,11 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
             int iy = static_cast<int>(std::floor(p.y));
             int iz = static_cast<int>(std::floor(p.z));
 
-            if (!inBounds(ix,iy,iz)) {
+            if (!light.inBounds(ix,iy,iz)) {
                 // Clamp just in case of precision issues.
-                ix = std::clamp(ix, minX, maxX);
-                iy = std::clamp(iy, minY, maxY);
-                iz = std::clamp(iz, minZ, maxZ);
+                ix = std::clamp(ix, light.minX, light.maxX);
+                iy = std::clamp(iy, light.minY, light.maxY);
+                iz = std::clamp(iz, light.minZ, light.maxZ);
             }
 
             const int stepX = (rayDir.x > 0.0f) ? 1 : -1;
@@ -1835,18 +1937,26 @@ SpritePixels renderVoxel(const VoxelModel& m, int outW, int outH, int frame, flo
 
             // Hard cap steps to avoid any infinite loops.
             for (int steps = 0; steps < 256; ++steps) {
-                if (!inBounds(ix,iy,iz)) break;
+                if (!light.inBounds(ix,iy,iz)) break;
 
                 Color c = m.at(ix,iy,iz);
                 if (c.a > 0) {
-                    const Vec3f nn = smoothNormal(ix,iy,iz, faceNormal);
                     const Vec3f voxCenter = { static_cast<float>(ix) + 0.5f, static_cast<float>(iy) + 0.5f, static_cast<float>(iz) + 0.5f };
 
-                    // Shadow: offset slightly toward the surface normal and toward the light to reduce acne.
-                    const Vec3f shadowStart = voxCenter + nn * 0.56f + lightDir * 0.02f;
-                    const float shadow = traceShadow(shadowStart);
+                    Vec3f nn;
+                    float shadow = 1.0f;
+                    float ao = 1.0f;
+                    if (const VoxelLightCache::Sample* cached = lightCache ? lightCache->find(ix,iy,iz) : nullptr) {
+                        nn = cached->n;
+                        shadow = cached->shadow;
+                        ao = cached->ao;
+                    } else {
+                        nn = light.smoothNormal(ix,iy,iz, faceNormal);
+                        shadow = light.traceShadow(light.shadowStart(ix,iy,iz, nn));
+                        ao = light.ambientOcclusion(ix,iy,iz, normalize(nn));
+                    }
 
-                    Color shaded = shadeVoxel(c, nn, (cameraPos - voxCenter), shadow, ix,iy,iz);
+                    Color shaded = shadeVoxel(c, nn, (cameraPos - voxCenter), shadow, ao);
 
                     const float a = shaded.a / 255.0f;
                     const float oneMinusA = (1.0f - outA);
@@ -2046,7 +2156,8 @@ SpritePixels renderModelToSprite(const VoxelModel& model, int frame, float yawSc
     return out;
 }
 
-SpritePixels renderModelToSpriteTurntable(const VoxelModel& model, int frame, float yawRad, int outPx) {
+SpritePixels renderModelToSpriteTurntable(const VoxelModel& model, int frame, float yawRad, int outPx,
+                                          const VoxelLightCache* lightCache = nullptr) {
     outPx = clampOutPx(outPx);
 
     // Same sampling rules as the normal sprite path.
@@ -2055,7 +2166,7 @@ SpritePixels renderModelToSpriteTurntable(const VoxelModel& model, int frame, fl
 
     // Turntable previews want deterministic yaw, not the in-game wobble.
     SpritePixels hi = renderVoxel(model, /*outW=*/hiW, /*outH=*/hiH, frame,
-                                 /*yawScale=*/0.0f, /*yawBase=*/yawRad);
+                                 /*yawScale=*/0.0f, /*yawBase=*/yawRad, lightCache);
     SpritePixels out = (hiW == outPx) ? hi : downscale2x(hi);
 
     if (outPx <= 32) addOutline(out);
@@ -2925,8 +3036,105 @@ SpritePixels renderModelToSpriteIsometric(const VoxelModel& model, int frame, in
     return out;
 }
 
+// Prepared turntable models.
+//
+// The codex turntable renders the same model at every yaw step (24 per revolution).
+// Preparing it -- the procedural build, the nearest upscale, the surface chamfer -- and
+// shading it are the same at every step, so the most recent preparations are kept here
+// together with their VoxelLightCache, keyed by everything they depend on: a previewed
+// sprite is built and lit once per animation frame, and each yaw step only traces its
+// primary rays. Sprites may be generated on worker threads, hence the lock; builds run
+// outside it (two threads racing on one key both build, which is harmless).
+struct PreparedVoxelModel {
+    VoxelModel model;
+    VoxelLightCache lights;
+};
+
+struct TurntableModelKey {
+    uint8_t category = 0; // 0 = extruded, 1 = entity, 2 = item
+    uint32_t kind = 0;
+    uint32_t seed = 0;
+    int frame = 0;
+    int outPx = 0;
+    uint32_t baseHash = 0; // of the 2D sprite the model is derived from
+
+    bool operator==(const TurntableModelKey& o) const {
+        return category == o.category && kind == o.kind && seed == o.seed && frame == o.frame &&
+               outPx == o.outPx && baseHash == o.baseHash;
+    }
+};
+
+// One cache shared by every turntable kind (extruded, entity, item).
+struct TurntableModelCache {
+    static constexpr size_t kCapacity = 8; // the previewed sprite's frames, plus the previous sprite's
+    using Entry = std::pair<TurntableModelKey, std::shared_ptr<const PreparedVoxelModel>>;
+
+    std::mutex mu;
+    std::deque<Entry> recent; // most recently used first
+    VoxelTurntableCacheStats stats;
+};
+
+TurntableModelCache g_turntableModels;
+
+std::shared_ptr<const PreparedVoxelModel> preparedTurntableModel(const TurntableModelKey& key,
+                                                                 const std::function<VoxelModel()>& build) {
+    TurntableModelCache& cache = g_turntableModels;
+    {
+        std::lock_guard<std::mutex> lock(cache.mu);
+        for (auto it = cache.recent.begin(); it != cache.recent.end(); ++it) {
+            if (!(it->first == key)) continue;
+            TurntableModelCache::Entry e = std::move(*it);
+            cache.recent.erase(it);
+            cache.recent.push_front(e);
+            ++cache.stats.hits;
+            return e.second;
+        }
+    }
+
+    auto prepared = std::make_shared<PreparedVoxelModel>();
+    prepared->model = build();
+    prepared->lights.build(VoxelLighting(prepared->model));
+
+    std::lock_guard<std::mutex> lock(cache.mu);
+    ++cache.stats.builds;
+    cache.recent.emplace_front(key, prepared);
+    if (cache.recent.size() > TurntableModelCache::kCapacity) cache.recent.pop_back();
+    return prepared;
+}
+
+// 2D -> 3D extrusion at the detail level for outPx (turntable fallback path).
+VoxelModel buildExtrudedTurntableModel(const SpritePixels& base2d, uint32_t seed, int outPx) {
+    const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
+    constexpr int maxDepth = 6;
+    VoxelModel vox = voxelizeExtrude(base2d, seed, maxDepth);
+    if (detailScale > 1) {
+        vox = scaleVoxelModelNearest(vox, detailScale);
+        applyVoxelSurfaceChamfer(vox, seed ^ 0x51EAA11u, 1.0f);
+    }
+    return vox;
+}
+
 } // namespace
 
+uint32_t hashSpritePixels(const SpritePixels& s) {
+    uint32_t h = hashCombine(static_cast<uint32_t>(s.w), static_cast<uint32_t>(s.h));
+    for (const Color& c : s.px) {
+        h = hashCombine(h, static_cast<uint32_t>(c.r) | (static_cast<uint32_t>(c.g) << 8) |
+                           (static_cast<uint32_t>(c.b) << 16) | (static_cast<uint32_t>(c.a) << 24));
+    }
+    return h;
+}
+
+VoxelTurntableCacheStats voxelTurntableCacheStats() {
+    std::lock_guard<std::mutex> lock(g_turntableModels.mu);
+    return g_turntableModels.stats;
+}
+
+void clearVoxelTurntableCache() {
+    std::lock_guard<std::mutex> lock(g_turntableModels.mu);
+    g_turntableModels.recent.clear();
+}
+
 SpritePixels renderSprite3DExtruded(const SpritePixels& base2d, uint32_t seed, int frame, int outPx) {
     outPx = clampOutPx(outPx);
     if (base2d.w <= 0 || base2d.h <= 0) return base2d;
@@ -2996,63 +3204,48 @@ SpritePixels renderSprite3DExtrudedTurntable(const SpritePixels& base2d, uint32_
     outPx = clampOutPx(outPx);
     if (base2d.w <= 0 || base2d.h <= 0) return base2d;
 
-    const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
-
-    constexpr int maxDepth = 6;
-    VoxelModel vox = voxelizeExtrude(base2d, seed, maxDepth);
-    if (detailScale > 1) {
-        vox = scaleVoxelModelNearest(vox, detailScale);
-        applyVoxelSurfaceChamfer(vox, seed ^ 0x51EAA11u, 1.0f);
-    }
-
-    return renderModelToSpriteTurntable(vox, frame, yawRad, outPx);
+    const TurntableModelKey key{0, 0, seed, frame, outPx, hashSpritePixels(base2d)};
+    const auto prepared = preparedTurntableModel(key, [&] { return buildExtrudedTurntableModel(base2d, seed, outPx); });
+    return renderModelToSpriteTurntable(prepared->model, frame, yawRad, outPx, &prepared->lights);
 }
 
 SpritePixels renderSprite3DEntityTurntable(EntityKind kind, const SpritePixels& base2d, uint32_t seed, int frame, float yawRad, int outPx) {
     // Identical to renderSprite3DEntity() but uses a stable yaw for UI preview rotation.
-    const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
-    VoxelModel m = buildEntityModel(kind, seed, frame, base2d);
-    if (m.w > 0 && m.h > 0 && m.d > 0) {
-        if (detailScale > 1) {
-            m = scaleVoxelModelNearest(m, detailScale);
-            applyVoxelSurfaceChamfer(m, seed ^ 0x51EAA11u, 1.0f);
-        }
-        return renderModelToSpriteTurntable(m, frame, yawRad, outPx);
-    }
-
-    // Fallback: 2D -> 3D extrusion.
     outPx = clampOutPx(outPx);
-    const int d = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
-    constexpr int maxDepth = 6;
-    VoxelModel vox = voxelizeExtrude(base2d, seed, maxDepth);
-    if (d > 1) {
-        vox = scaleVoxelModelNearest(vox, d);
-        applyVoxelSurfaceChamfer(vox, seed ^ 0x51EAA11u, 1.0f);
-    }
-    return renderModelToSpriteTurntable(vox, frame, yawRad, outPx);
+    const TurntableModelKey key{1, static_cast<uint32_t>(kind), seed, frame, outPx, hashSpritePixels(base2d)};
+    const auto prepared = preparedTurntableModel(key, [&] {
+        const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
+        VoxelModel m = buildEntityModel(kind, seed, frame, base2d);
+        if (m.w > 0 && m.h > 0 && m.d > 0) {
+            if (detailScale > 1) {
+                m = scaleVoxelModelNearest(m, detailScale);
+                applyVoxelSurfaceChamfer(m, seed ^ 0x51EAA11u, 1.0f);
+            }
+            return m;
+        }
+        // Fallback: 2D -> 3D extrusion.
+        return buildExtrudedTurntableModel(base2d, seed, outPx);
+    });
+    return renderModelToSpriteTurntable(prepared->model, frame, yawRad, outPx, &prepared->lights);
 }
 
 SpritePixels renderSprite3DItemTurntable(ItemKind kind, const SpritePixels& base2d, uint32_t seed, int frame, float yawRad, int outPx) {
-    const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
-    VoxelModel m = buildItemModel(kind, seed, frame, base2d);
-    if (m.w > 0 && m.h > 0 && m.d > 0) {
-        if (detailScale > 1) {
-            m = scaleVoxelModelNearest(m, detailScale);
-            applyVoxelSurfaceChamfer(m, seed ^ 0x51EAA11u, 1.0f);
-        }
-        return renderModelToSpriteTurntable(m, frame, yawRad, outPx);
-    }
-
-    // Fallback: 2D -> 3D extrusion.
     outPx = clampOutPx(outPx);
-    const int d = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
-    constexpr int maxDepth = 6;
-    VoxelModel vox = voxelizeExtrude(base2d, seed, maxDepth);
-    if (d > 1) {
-        vox = scaleVoxelModelNearest(vox, d);
-        applyVoxelSurfaceChamfer(vox, seed ^ 0x51EAA11u, 1.0f);
-    }
-    return renderModelToSpriteTurntable(vox, frame, yawRad, outPx);
+    const TurntableModelKey key{2, static_cast<uint32_t>(kind), seed, frame, outPx, hashSpritePixels(base2d)};
+    const auto prepared = preparedTurntableModel(key, [&] {
+        const int detailScale = voxelDetailScaleForOutPx(outPx, /*isoRaytrace=*/false);
+        VoxelModel m = buildItemModel(kind, seed, frame, base2d);
+        if (m.w > 0 && m.h > 0 && m.d > 0) {
+            if (detailScale > 1) {
+                m = scaleVoxelModelNearest(m, detailScale);
+                applyVoxelSurfaceChamfer(m, seed ^ 0x51EAA11u, 1.0f);
+            }
+            return m;
+        }
+        // Fallback: 2D -> 3D extrusion.
+        return buildExtrudedTurntableModel(base2d, seed, outPx);
+    });
+    return renderModelToSpriteTurntable(prepared->model, frame, yawRad, outPx, &prepared->lights);
 }
 
 SpritePixels renderSprite3DExtrudedIso(const SpritePixels& base2d, uint32_t seed, int frame, int outPx, bool isoRaytrace) {
@@ -25,6 +25,18 @@ SpritePixels renderSprite3DExtrudedTurntable(const SpritePixels& base2d, uint32_
 SpritePixels renderSprite3DEntityTurntable(EntityKind kind, const SpritePixels& base2d, uint32_t seed, int frame, float yawRad, int outPx = 128);
 SpritePixels renderSprite3DItemTurntable(ItemKind kind, const SpritePixels& base2d, uint32_t seed, int frame, float yawRad, int outPx = 128);
 
+// The turntables keep the most recent prepared voxel models (and their lighting) in
+// one process-wide LRU, so each yaw step only traces primary rays.
+struct VoxelTurntableCacheStats {
+    uint64_t hits = 0;
+    uint64_t builds = 0;
+};
+VoxelTurntableCacheStats voxelTurntableCacheStats();
+void clearVoxelTurntableCache();
+
+// Content hash of a sprite's size and pixels (keys the turntable model cache).
+uint32_t hashSpritePixels(const SpritePixels& s);
+
 // --- Isometric voxel rendering ---
 //
 // In ViewMode::Isometric, the renderer draws terrain in a 2:1 dimetric/isometric
@@ -0,0 +1,195 @@
+#pragma once
+
+// Small shared worker pool for CPU-bound, independent jobs (floor candidates, ...).
+//
+// Determinism rule: work handed to the pool must not depend on which thread runs it
+// or in which order jobs finish. Callers derive per-job inputs (seeds, indices) up
+// front and combine results in index order afterwards.
+//
+// parallelFor() lets the calling thread claim work items too, so it never deadlocks
+// when called from inside another pool job (e.g. nested generation) or when the pool
+// is saturated: in the worst case the caller simply runs every item itself.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads) {
+        threads = std::max<size_t>(1, threads);
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    template <typename Fn>
+    auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using R = std::invoke_result_t<std::decay_t<Fn>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Fn>(fn));
+        std::future<R> fut = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            jobs_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return fut;
+    }
+
+    // Process-wide pool, sized to the machine (one core is left to the caller).
+    static ThreadPool& shared() {
+        static ThreadPool pool(defaultThreadCount());
+        return pool;
+    }
+
+    static size_t defaultThreadCount() {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return (hw > 1u) ? static_cast<size_t>(hw - 1u) : size_t{1};
+    }
+
+private:
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) return; // stopping and drained
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+// Runs fn(i) for i in [0, count) on `pool` plus the calling thread and waits for all of
+// them. The first exception thrown by any item is rethrown here (after every item ran).
+template <typename Fn>
+void parallelFor(ThreadPool& pool, size_t count, Fn&& fn) {
+    if (count == 0) return;
+    if (count == 1) {
+        fn(size_t{0});
+        return;
+    }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::mutex mu;
+        std::condition_variable cv;
+        size_t done = 0;
+        std::exception_ptr error;
+    };
+    auto st = std::make_shared<Shared>();
+
+    auto drain = [st, count, &fn] {
+        for (;;) {
+            const size_t i = st->next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) return;
+            std::exception_ptr err;
+            try {
+                fn(i);
+            } catch (...) {
+                err = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(st->mu);
+            if (err && !st->error) st->error = err;
+            if (++st->done == count) st->cv.notify_all();
+        }
+    };
+
+    // Helpers that start after every item was claimed return immediately, so `fn`
+    // (captured by reference) is never touched once this function has returned.
+    const size_t helpers = std::min(pool.size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) pool.submit(drain);
+    drain();
+
+    std::unique_lock<std::mutex> lock(st->mu);
+    st->cv.wait(lock, [&] { return st->done == count; });
+    if (st->error) std::rethrow_exception(st->error);
+}
+
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn) {
+    parallelFor(ThreadPool::shared(), count, std::forward<Fn>(fn));
+}
+
+// parallelFor() for jobs whose results must be consumed in order (headless --jobs).
+//
+// Runs run(i) for i in [0, count) and hands each result to report(i, result) in index
+// order, one call at a time: a finished result is reported once everything before it
+// has been, so the output matches the serial loop
+//     for (i) { r = run(i); report(i, r); if (stopAtFirstFail && failed(r)) break; }
+// With stopAtFirstFail, nothing after the earliest failure is started, and results past
+// it (already running when it failed) are dropped unreported. Returns the number of
+// results reported.
+template <typename RunFn, typename FailedFn, typename ReportFn>
+size_t parallelForOrdered(ThreadPool& pool, size_t count, bool stopAtFirstFail, RunFn&& run, FailedFn&& failed,
+                          ReportFn&& report) {
+    using Result = std::decay_t<std::invoke_result_t<RunFn&, size_t>>;
+    std::vector<std::optional<Result>> slots(count);
+    std::atomic<size_t> firstFail{count};
+    std::mutex mu;
+    size_t reported = 0;
+
+    auto limit = [&] { return stopAtFirstFail ? std::min(count, firstFail.load() + 1) : count; };
+
+    parallelFor(pool, count, [&](size_t i) {
+        if (stopAtFirstFail && i > firstFail.load(std::memory_order_acquire)) return;
+
+        Result r = run(i);
+        if (failed(static_cast<const Result&>(r))) {
+            size_t cur = firstFail.load(std::memory_order_relaxed);
+            while (i < cur && !firstFail.compare_exchange_weak(cur, i, std::memory_order_acq_rel)) {
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mu);
+        slots[i] = std::move(r);
+        const size_t lim = limit();
+        while (reported < lim && slots[reported]) {
+            report(reported, *slots[reported]);
+            ++reported;
+        }
+    });
+
+    // Every index up to the earliest failure ran (only later ones are ever skipped).
+    const size_t keep = limit();
+    for (; reported < keep; ++reported) report(reported, *slots[reported]);
+    return reported;
+}
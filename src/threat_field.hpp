@@ -63,22 +63,16 @@ inline ThreatFieldResult buildVisibleHostileThreatField(const Game& g, int maxCo
         }
     };
 
-    // Discovered traps are visible information; include them as a soft penalty so ETA
-    // matches what monsters will actually prefer.
-    std::vector<int> trapPenalty = buildDiscoveredTrapPenaltyGrid(g);
-    if (trapPenalty.size() != static_cast<size_t>(W * H)) {
-        trapPenalty.assign(static_cast<size_t>(W * H), 0);
-    }
+    // Discovered traps are visible information; the nav grid includes them as a soft
+    // penalty so ETA matches what monsters will actually prefer.
+    const MonsterNavGrid& nav = g.monsterNavGrid();
 
+    std::vector<int> m;
     for (int caps = 0; caps < 8; ++caps) {
         const auto& srcs = srcByCaps[static_cast<size_t>(caps)];
         if (srcs.empty()) continue;
 
-        PassableFn passable = monsterPassableFn(g, caps);
-        StepCostFn stepCost = monsterStepCostFn(g, caps, &trapPenalty);
-        DiagonalOkFn diagOk = monsterDiagonalOkFn(g, caps);
-
-        const auto m = dijkstraCostFromSources(W, H, srcs, passable, stepCost, diagOk, maxCost);
+        monsterCostFromSources(monsterNavView(g, nav, caps), H, srcs, m, maxCost);
         combineMin(m);
     }
 
@@ -0,0 +1,210 @@
+#include "tile_planes.hpp"
+
+#include "dungeon.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Mask of the valid bits in word `k` of a row `w` tiles wide.
+TilePlanes::Word rowMask(int w, int k) {
+    const int bits = w - k * TilePlanes::kWordBits;
+    if (bits >= TilePlanes::kWordBits) return ~TilePlanes::Word{0};
+    if (bits <= 0) return TilePlanes::Word{0};
+    return (TilePlanes::Word{1} << bits) - 1u;
+}
+
+int popcount64(TilePlanes::Word v) {
+    int n = 0;
+    while (v) {
+        v &= v - 1u;
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+bool TilePlanes::opaqueType(TileType t) {
+    return (t == TileType::Wall || t == TileType::Pillar || t == TileType::DoorClosed || t == TileType::DoorLocked ||
+            t == TileType::DoorSecret);
+}
+
+bool TilePlanes::walkableType(TileType t) {
+    return (t == TileType::Floor || t == TileType::Fountain || t == TileType::Altar || t == TileType::DoorOpen ||
+            t == TileType::StairsDown || t == TileType::StairsUp);
+}
+
+bool TilePlanes::passableType(TileType t) {
+    return walkableType(t) || t == TileType::DoorClosed;
+}
+
+void TilePlanes::setBit(std::vector<Word>& plane, size_t i, bool on) const {
+    const int x = static_cast<int>(i % static_cast<size_t>(w_));
+    const int y = static_cast<int>(i / static_cast<size_t>(w_));
+    Word& word = plane[static_cast<size_t>(y * stride_ + (x >> 6))];
+    const Word bit = Word{1} << (x & 63);
+    word = on ? (word | bit) : (word & ~bit);
+}
+
+void TilePlanes::updateTerrain(const Dungeon& d, int i) {
+    const size_t ii = static_cast<size_t>(i);
+    const TileType t = d.tiles[ii].type;
+    types_[ii] = static_cast<uint8_t>(t);
+    setBit(opaque_, ii, opaqueType(t));
+    setBit(walkable_, ii, walkableType(t));
+    setBit(passable_, ii, passableType(t));
+}
+
+bool TilePlanes::updateFog(const Dungeon& d, int i) {
+    const size_t ii = static_cast<size_t>(i);
+    setBit(visible_, ii, d.tiles[ii].visible);
+    const bool was = test(explored_.data(), i % w_, i / w_);
+    setBit(explored_, ii, d.tiles[ii].explored);
+    return was != d.tiles[ii].explored;
+}
+
+void TilePlanes::updateFrontier(int x, int y) {
+    bool on = false;
+    if (test(explored_.data(), x, y)) {
+        for (int yy = std::max(0, y - 1); yy <= std::min(h_ - 1, y + 1) && !on; ++yy) {
+            for (int xx = std::max(0, x - 1); xx <= std::min(w_ - 1, x + 1); ++xx) {
+                if (!test(explored_.data(), xx, yy)) {
+                    on = true;
+                    break;
+                }
+            }
+        }
+    }
+    setBit(frontier_, static_cast<size_t>(y * w_ + x), on);
+}
+
+void TilePlanes::rebuildTerrain(const Dungeon& d) {
+    w_ = std::max(0, d.width);
+    h_ = std::max(0, d.height);
+    stride_ = (w_ + kWordBits - 1) / kWordBits;
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    const size_t words = static_cast<size_t>(stride_) * static_cast<size_t>(h_);
+
+    types_.assign(n, uint8_t{0});
+    opaque_.assign(words, Word{0});
+    walkable_.assign(words, Word{0});
+    passable_.assign(words, Word{0});
+    for (size_t i = 0; i < n; ++i) updateTerrain(d, static_cast<int>(i));
+
+    epoch_ = d.terrainEpoch;
+    journalPos_ = d.terrainJournal.size();
+    terrainValid_ = true;
+    fogValid_ = false; // Same dimensions are not guaranteed; re-derive with the terrain.
+}
+
+void TilePlanes::rebuildFog(const Dungeon& d) {
+    const size_t n = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    const size_t words = static_cast<size_t>(stride_) * static_cast<size_t>(h_);
+    visible_.assign(words, Word{0});
+    explored_.assign(words, Word{0});
+    for (size_t i = 0; i < n; ++i) updateFog(d, static_cast<int>(i));
+
+    nearClear(explored_.data(), frontier_);
+    for (size_t k = 0; k < words; ++k) frontier_[k] &= explored_[k];
+
+    fogEpoch_ = d.terrainEpoch;
+    fogRevision_ = d.fovRevision;
+    fogValid_ = true;
+}
+
+void TilePlanes::sync(const Dungeon& d) {
+    const size_t n = static_cast<size_t>(std::max(0, d.width)) * static_cast<size_t>(std::max(0, d.height));
+    if (d.tiles.size() != n) {
+        // Packed/hollow level: nothing to mirror.
+        clear();
+        return;
+    }
+
+    if (!terrainValid_ || d.width != w_ || d.height != h_ || d.terrainEpoch != epoch_ ||
+        journalPos_ > d.terrainJournal.size()) {
+        rebuildTerrain(d);
+    } else {
+        for (size_t j = journalPos_; j < d.terrainJournal.size(); ++j) {
+            const int i = d.terrainJournal[j];
+            if (i >= 0 && static_cast<size_t>(i) < n) updateTerrain(d, i);
+        }
+        journalPos_ = d.terrainJournal.size();
+    }
+
+    if (!fogValid_ || fogEpoch_ != d.terrainEpoch) {
+        rebuildFog(d);
+    } else if (d.fovRevision == fogRevision_ + 1u) {
+        exploredFlips_.clear();
+        for (int i : d.fovChanges) {
+            if (i >= 0 && static_cast<size_t>(i) < n && updateFog(d, i)) exploredFlips_.push_back(i);
+        }
+        for (int i : exploredFlips_) {
+            const int x = i % w_;
+            const int y = i / w_;
+            for (int yy = std::max(0, y - 1); yy <= std::min(h_ - 1, y + 1); ++yy) {
+                for (int xx = std::max(0, x - 1); xx <= std::min(w_ - 1, x + 1); ++xx) updateFrontier(xx, yy);
+            }
+        }
+        fogRevision_ = d.fovRevision;
+    } else if (d.fovRevision != fogRevision_) {
+        rebuildFog(d);
+    }
+}
+
+void TilePlanes::clear() {
+    std::vector<uint8_t>().swap(types_);
+    std::vector<Word>().swap(opaque_);
+    std::vector<Word>().swap(walkable_);
+    std::vector<Word>().swap(passable_);
+    std::vector<Word>().swap(visible_);
+    std::vector<Word>().swap(explored_);
+    std::vector<Word>().swap(frontier_);
+    w_ = 0;
+    h_ = 0;
+    stride_ = 0;
+    terrainValid_ = false;
+    fogValid_ = false;
+}
+
+size_t TilePlanes::count(const Word* plane) const {
+    size_t n = 0;
+    const size_t words = static_cast<size_t>(stride_) * static_cast<size_t>(h_);
+    for (size_t k = 0; k < words; ++k) n += static_cast<size_t>(popcount64(plane[k]));
+    return n;
+}
+
+void TilePlanes::nearClear(const Word* plane, std::vector<Word>& out) const {
+    const size_t words = static_cast<size_t>(stride_) * static_cast<size_t>(h_);
+    out.assign(words, Word{0});
+    if (words == 0) return;
+
+    // Horizontal pass: clear tiles, spread one column left and right (within the row).
+    std::vector<Word> horiz(words, Word{0});
+    for (int y = 0; y < h_; ++y) {
+        const Word* src = plane + static_cast<size_t>(y * stride_);
+        Word* dst = horiz.data() + static_cast<size_t>(y * stride_);
+        for (int k = 0; k < stride_; ++k) {
+            const Word c = ~src[k] & rowMask(w_, k);
+            const Word prev = (k > 0) ? (~src[k - 1] & rowMask(w_, k - 1)) : Word{0};
+            const Word next = (k + 1 < stride_) ? (~src[k + 1] & rowMask(w_, k + 1)) : Word{0};
+            dst[k] = c | (c << 1) | (prev >> 63) | (c >> 1) | (next << 63);
+        }
+    }
+
+    // Vertical pass: OR with the rows above and below, then drop the padding bits.
+    for (int y = 0; y < h_; ++y) {
+        Word* dst = out.data() + static_cast<size_t>(y * stride_);
+        for (int k = 0; k < stride_; ++k) {
+            Word v = horiz[static_cast<size_t>(y * stride_ + k)];
+            if (y > 0) v |= horiz[static_cast<size_t>((y - 1) * stride_ + k)];
+            if (y + 1 < h_) v |= horiz[static_cast<size_t>((y + 1) * stride_ + k)];
+            dst[k] = v & rowMask(w_, k);
+        }
+    }
+}
+
+size_t TilePlanes::memoryBytes() const {
+    return types_.capacity() + (opaque_.capacity() + walkable_.capacity() + passable_.capacity() +
+                                visible_.capacity() + explored_.capacity() + frontier_.capacity()) * sizeof(Word);
+}
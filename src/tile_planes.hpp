@@ -0,0 +1,95 @@
+#pragma once
+
+// Structure-of-arrays view of Dungeon::tiles (see Dungeon::planes()).
+//
+// Tile is an array-of-structs (type + visible + explored), so a scan that only needs one
+// property still pulls every struct through the cache: a 105x66 map is ~20KB of Tiles.
+// TilePlanes keeps one byte per tile for the type and one bit per tile for each derived
+// flag. Bit rows are padded to whole 64-bit words, so a plane is ~1KB and row scans and
+// neighborhood tests run a word at a time.
+//
+// Dungeon::tiles stays authoritative; the planes follow it like MonsterNavGrid does:
+//   - type/opaque/walkable/passable replay Dungeon::terrainJournal (dig, door helpers,
+//     setTileType). A new terrain epoch or a resized map rebuilds them.
+//   - visible/explored follow Dungeon::fovRevision. When it advanced by exactly one,
+//     only the tiles listed in Dungeon::fovChanges are re-read; otherwise (several
+//     writers since the last sync, new epoch) both planes are rebuilt.
+//   - frontier (explored tiles with an unexplored 8-neighbor) is kept with explored:
+//     a delta only re-derives the 3x3 blocks around tiles whose explored bit flipped.
+// Padding bits past the right edge of a row are always zero.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Dungeon;
+enum class TileType : uint8_t;
+
+class TilePlanes {
+public:
+    using Word = uint64_t;
+    static constexpr int kWordBits = 64;
+
+    // Brings every plane up to date with `d`. Cheap when nothing changed.
+    void sync(const Dungeon& d);
+
+    // Releases the planes; the next sync() rebuilds from scratch.
+    void clear();
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    int stride() const { return stride_; } // words per bit row
+
+    const uint8_t* types() const { return types_.data(); }
+    const Word* opaque() const { return opaque_.data(); }
+    const Word* walkable() const { return walkable_.data(); }
+    const Word* passable() const { return passable_.data(); }
+    const Word* visible() const { return visible_.data(); }
+    const Word* explored() const { return explored_.data(); }
+    const Word* frontier() const { return frontier_.data(); }
+
+    bool test(const Word* plane, int x, int y) const {
+        return ((plane[static_cast<size_t>(y * stride_ + (x >> 6))] >> (x & 63)) & 1u) != 0;
+    }
+
+    // Number of set bits in `plane`.
+    size_t count(const Word* plane) const;
+
+    // out = tiles whose 3x3 block (clipped to the map) holds a tile NOT set in `plane`.
+    // ANDed with `plane` itself that is "set tiles with a clear 8-neighbor", e.g. explored
+    // tiles bordering the unexplored part of the map.
+    void nearClear(const Word* plane, std::vector<Word>& out) const;
+
+    size_t memoryBytes() const;
+
+    static bool opaqueType(TileType t);
+    static bool walkableType(TileType t);
+    static bool passableType(TileType t);
+
+private:
+    void rebuildTerrain(const Dungeon& d);
+    void rebuildFog(const Dungeon& d);
+    void setBit(std::vector<Word>& plane, size_t i, bool on) const;
+    void updateTerrain(const Dungeon& d, int i);
+    bool updateFog(const Dungeon& d, int i);
+    void updateFrontier(int x, int y);
+
+    std::vector<uint8_t> types_;
+    std::vector<Word> opaque_;
+    std::vector<Word> walkable_;
+    std::vector<Word> passable_;
+    std::vector<Word> visible_;
+    std::vector<Word> explored_;
+    std::vector<Word> frontier_;
+    std::vector<int> exploredFlips_;
+
+    int w_ = 0;
+    int h_ = 0;
+    int stride_ = 0;
+    uint32_t epoch_ = 0u;
+    size_t journalPos_ = 0;
+    uint32_t fogEpoch_ = 0u;
+    uint32_t fogRevision_ = 0u;
+    bool terrainValid_ = false;
+    bool fogValid_ = false;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+// LEB128 varints shared by the byte formats (packed levels in level_snapshot.hpp,
+// binary replays in replay_binary.cpp): 7 bits per byte, low group first, high bit
+// set on every byte but the last.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace varint {
+
+inline void put(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80u) {
+        out.push_back(static_cast<uint8_t>(v | 0x80u));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Reads one varint at `pos` and advances past it. Returns false on truncated or
+// over-long (more than 64 bits) input.
+inline bool get(const std::vector<uint8_t>& in, size_t& pos, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        const uint8_t b = in[pos++];
+        v |= static_cast<uint64_t>(b & 0x7Fu) << shift;
+        if ((b & 0x80u) == 0) return true;
+    }
+    return false;
+}
+
+} // namespace varint
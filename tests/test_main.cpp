@@ -20,6 +20,15 @@
 #include "shrine_profile_gen.hpp"
 #include "victory_gen.hpp"
 #include "spritegen.hpp"
+#include "sprite_batch.hpp"
+#include "sprite_disk_cache.hpp"
+#include "sprite_jobs.hpp"
+#include "raycast_kernels.hpp"
+#include "spritegen3d.hpp"
+#include "dijkstra_engine.hpp"
+#include "monster_pathing.hpp"
+#include "thread_pool.hpp"
+#include "replay_runner.hpp"
 #include <queue>
 #include <unordered_map>
 
@@ -69,14 +78,18 @@ static void clearOverworldChunkCache(Game& g) {
 }
 };
 
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -479,6 +492,2239 @@ bool test_new_game_determinism() {
     return true;
 }
 
+bool test_dijkstra_engine_matches_relaxation() {
+    // The radix-queue engine must produce exactly the same fields as a naive
+    // Bellman-Ford style relaxation over the same policies.
+    const int W = 23;
+    const int H = 17;
+    RNG rng(4242u);
+    std::vector<int> cost(static_cast<size_t>(W * H), 0);
+    for (int& c : cost) c = rng.chance(0.18f) ? 0 : rng.range(1, 40);
+
+    auto passable = [&](int x, int y) { return cost[static_cast<size_t>(y * W + x)] > 0; };
+    auto stepCost = [&](int x, int y) { return cost[static_cast<size_t>(y * W + x)]; };
+    auto diagOk = [&](int fx, int fy, int dx, int dy) { return passable(fx + dx, fy) || passable(fx, fy + dy); };
+
+    const Vec2i target{W / 2, H / 2};
+    cost[static_cast<size_t>(target.y * W + target.x)] = 3;
+
+    for (const int maxCost : {-1, 60}) {
+        // Reference: repeated relaxation until a fixpoint.
+        std::vector<int> ref(static_cast<size_t>(W * H), -1);
+        ref[static_cast<size_t>(target.y * W + target.x)] = 0;
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    const int here = ref[static_cast<size_t>(y * W + x)];
+                    if (here < 0) continue;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            const int nx = x + dx;
+                            const int ny = y + dy;
+                            if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= W || ny >= H) continue;
+                            if (!passable(nx, ny)) continue;
+                            if (dx != 0 && dy != 0 && !diagOk(nx, ny, -dx, -dy)) continue;
+                            const int c = here + stepCost(x, y);
+                            if (maxCost >= 0 && c > maxCost) continue;
+                            int& slot = ref[static_cast<size_t>(ny * W + nx)];
+                            if (slot < 0 || c < slot) { slot = c; changed = true; }
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<int> got;
+        dijkstra::costToTarget(W, H, target, passable, stepCost, diagOk, got, maxCost);
+        CHECK(got == ref);
+        CHECK(dijkstraCostToTarget(W, H, target, passable, stepCost, diagOk, maxCost) == ref);
+    }
+
+    return true;
+}
+
+bool test_monster_nav_grid_tracks_terrain_edits() {
+    // MonsterNavGrid replays the terrain journal instead of rebuilding: after doors are
+    // opened, closed, locked and unlocked, walls dug and tiles retyped, every capability
+    // plane (read through MonsterNavView) must still match the direct Dungeon rules.
+    Dungeon d(16, 10);
+    for (int y = 0; y < d.height; ++y) {
+        for (int x = 0; x < d.width; ++x) {
+            const bool border = x == 0 || y == 0 || x == d.width - 1 || y == d.height - 1;
+            d.at(x, y).type = border ? TileType::Wall : TileType::Floor;
+        }
+    }
+    d.at(5, 3).type = TileType::DoorClosed;
+    d.at(7, 3).type = TileType::DoorLocked;
+    d.at(3, 6).type = TileType::DoorOpen;
+    d.at(9, 5).type = TileType::Chasm;
+    d.at(11, 2).type = TileType::Pillar;
+    d.at(10, 6).type = TileType::Wall;
+
+    std::vector<Trap> traps(2);
+    traps[0].kind = TrapKind::Spike;
+    traps[0].pos = {4, 4};
+    traps[0].discovered = true;
+    traps[1].kind = TrapKind::Web;
+    traps[1].pos = {6, 6};
+
+    auto matchesDungeon = [&](const MonsterNavGrid& nav) {
+        if (nav.width() != d.width || nav.height() != d.height) return false;
+        std::vector<int> trapPenalty(static_cast<size_t>(d.width * d.height), 0);
+        for (const Trap& tr : traps) {
+            if (!tr.discovered) continue;
+            int& p = trapPenalty[static_cast<size_t>(tr.pos.y * d.width + tr.pos.x)];
+            p = std::max(p, trapPenaltyForMonsterPathing(tr.kind));
+        }
+
+        for (int caps = 0; caps < MonsterNavGrid::CAPS_COMBOS; ++caps) {
+            MonsterNavView v;
+            v.plane = nav.plane(caps);
+            v.walk = nav.walkable();
+            v.width = nav.width();
+            v.caps = caps;
+            for (int y = 0; y < d.height; ++y) {
+                for (int x = 0; x < d.width; ++x) {
+                    const bool passable = monsterTerrainPassableForCaps(d, x, y, caps);
+                    if (v.passable(x, y) != passable) return false;
+
+                    int cost = 0;
+                    if (passable) {
+                        const int c = monsterTerrainStepCostForCaps(d, x, y, caps);
+                        if (c > 0) cost = c + trapPenalty[static_cast<size_t>(y * d.width + x)];
+                    }
+                    if (v.stepCost(x, y) != cost) return false;
+                    if ((v.walk[static_cast<size_t>(y * d.width + x)] != 0u) != d.isWalkable(x, y)) return false;
+
+                    if (x == 0 || y == 0 || x == d.width - 1 || y == d.height - 1) continue;
+                    for (int dy = -1; dy <= 1; dy += 2) {
+                        for (int dx = -1; dx <= 1; dx += 2) {
+                            bool ok = true;
+                            if (caps & MPC_Phase) ok = true;
+                            else if (caps & MPC_Levitate) ok = monsterTerrainPassableForCaps(d, x + dx, y, caps) &&
+                                                               monsterTerrainPassableForCaps(d, x, y + dy, caps);
+                            else ok = diagonalPassable(d, {x, y}, dx, dy);
+                            if (v.diagonalOk(x, y, dx, dy) != ok) return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    MonsterNavGrid nav;
+    nav.sync(d, traps);
+    CHECK(matchesDungeon(nav));
+
+    // A sync with nothing new keeps the generation (cost-field cache key).
+    uint32_t gen = nav.generation();
+    nav.sync(d, traps);
+    CHECK(nav.generation() == gen);
+
+    // Each edit goes through the journal; the epoch stays, so these are incremental.
+    const uint32_t epoch = d.terrainEpoch;
+    auto edited = [&](bool viaTerrainOnly) {
+        if (viaTerrainOnly) nav.syncTerrain(d);
+        else nav.sync(d, traps);
+        const bool bumped = nav.generation() != gen;
+        gen = nav.generation();
+        return bumped && matchesDungeon(nav);
+    };
+
+    d.openDoor(5, 3);
+    CHECK(edited(true));
+    d.closeDoor(3, 6);
+    CHECK(edited(true));
+    d.unlockDoor(7, 3);
+    d.lockDoor(3, 6);
+    CHECK(edited(false));
+    CHECK(d.dig(10, 6));
+    CHECK(d.dig(11, 2));
+    CHECK(edited(true));
+    d.setTileType(9, 5, TileType::Floor);
+    d.setTileType(12, 7, TileType::Chasm);
+    CHECK(edited(false));
+    traps[1].discovered = true;
+    CHECK(edited(false));
+    CHECK(d.terrainEpoch == epoch);
+    return true;
+}
+
+bool test_monster_cost_cache_lru() {
+    MonsterCostCache cache;
+    cache.setCapacity(2);
+
+    int computes = 0;
+    auto fill = [&](int v) {
+        return [&computes, v](std::vector<int>& out) {
+            ++computes;
+            out.assign(4, v);
+        };
+    };
+    auto key = [](int target, uint32_t gen) {
+        MonsterCostCacheKey k;
+        k.target = target;
+        k.caps = 0;
+        k.navGen = gen;
+        k.hazardId = 0;
+        return k;
+    };
+
+    cache.beginTurn();
+    const std::vector<int>& a = cache.getOrCompute(key(1, 1), fill(1));
+    const std::vector<int>& b = cache.getOrCompute(key(2, 1), fill(2));
+    // Over capacity within one turn: pinned entries survive and references stay valid.
+    cache.getOrCompute(key(3, 1), fill(3));
+    CHECK(cache.size() == 3);
+    CHECK(a[0] == 1 && b[0] == 2);
+    CHECK(computes == 3);
+
+    // Next turn: a hit refreshes key 1, then a miss evicts the least recently used entry (key 2).
+    cache.beginTurn();
+    CHECK(cache.getOrCompute(key(1, 1), fill(-1))[0] == 1);
+    cache.getOrCompute(key(4, 1), fill(4));
+    CHECK(computes == 4);
+    cache.getOrCompute(key(2, 1), fill(2));
+    CHECK(computes == 5);
+
+    // A different nav generation is a different key.
+    CHECK(cache.getOrCompute(key(1, 2), fill(7))[0] == 7);
+    CHECK(cache.stats().hits == 1);
+    CHECK(cache.stats().misses == 6);
+
+    return true;
+}
+
+bool test_monster_cost_cache_hazard_ids() {
+    // Hazard layouts map to ids: hazard-free is 0, an unchanged layout keeps its id, and
+    // any change (penalty, box) gets an id that was never handed out before.
+    MonsterCostCache cache;
+    auto layout = [](int x0, int y0, int x1, int y1, uint8_t fill) {
+        MonsterHazardLayout l;
+        l.x0 = x0;
+        l.y0 = y0;
+        l.x1 = x1;
+        l.y1 = y1;
+        l.penalty.assign(static_cast<size_t>((x1 - x0 + 1) * (y1 - y0 + 1)), fill);
+        return l;
+    };
+
+    CHECK(cache.internHazards(MonsterHazardLayout{}) == 0u);
+    CHECK(cache.internHazards(layout(2, 2, 4, 3, 0)) == 0u); // box without any penalty
+
+    const uint32_t a = cache.internHazards(layout(2, 2, 4, 3, 10));
+    CHECK(a != 0u);
+    CHECK(cache.internHazards(layout(2, 2, 4, 3, 10)) == a);
+    CHECK(cache.internHazards(MonsterHazardLayout{}) == 0u); // does not forget the layout
+    CHECK(cache.internHazards(layout(2, 2, 4, 3, 10)) == a);
+
+    MonsterHazardLayout moved = layout(2, 2, 4, 3, 0);
+    moved.penalty[5] = 10;
+    const uint32_t b = cache.internHazards(std::move(moved));
+    CHECK(b != 0u && b != a);
+    const uint32_t c = cache.internHazards(layout(3, 2, 5, 3, 10)); // same bytes, shifted box
+    CHECK(c != a && c != b);
+    const uint32_t d = cache.internHazards(layout(2, 2, 4, 3, 10)); // back again: a fresh id
+    CHECK(d != a && d != b && d != c);
+
+    cache.clear();
+    CHECK(cache.internHazards(layout(2, 2, 4, 3, 10)) > d);
+    return true;
+}
+
+bool test_monster_cost_cache_hazard_decay_hits() {
+    // Gas that decays without crossing a penalty step keeps the hazard id, and cached
+    // monster turns keep matching uncached ones while gas sits on the level.
+    auto setup = [](Game& g) {
+        g.newGame(0x6A5u);
+        g.changeLevel(LevelId{DungeonBranch::Main, 2}, true);
+        const Vec2i c = g.player().pos;
+        const int W = g.dung.width;
+        g.poisonGas_.assign(static_cast<size_t>(W * g.dung.height), uint8_t{0});
+        g.resetHazardActivity();
+        for (int dx = 2; dx <= 3; ++dx) {
+            if (!g.dung.inBounds(c.x + dx, c.y)) continue;
+            g.poisonGas_[static_cast<size_t>(c.y * W + c.x + dx)] = 90;
+            g.markHazard(g.poisonGas_, c.x + dx, c.y);
+        }
+    };
+
+    Game cached;
+    Game fresh;
+    setup(cached);
+    setup(fresh);
+    CHECK(cached.validateHazardActivity());
+    for (int t = 0; t < 8; ++t) {
+        cached.handleAction(Action::Wait);
+        fresh.monsterCostCache_.clear();
+        fresh.handleAction(Action::Wait);
+        CHECK(cached.determinismHashUncached() == fresh.determinismHashUncached());
+    }
+
+    MonsterCostCache cache;
+    auto idFor = [&](uint8_t gas) {
+        MonsterHazardLayout l;
+        l.x0 = l.x1 = 3;
+        l.y0 = l.y1 = 1;
+        l.penalty.push_back(static_cast<uint8_t>(monsterHazardStepPenalty(0, 0, gas, 0)));
+        return cache.internHazards(std::move(l));
+    };
+    const uint32_t id0 = idFor(40); // 7 + 40 / 32
+    CHECK(id0 != 0u);
+    CHECK(idFor(33) == id0);
+    CHECK(idFor(31) != id0);
+    return true;
+}
+
+bool test_determinism_hash_cache() {
+    // Segment replay must match plain byte-serial FNV-1a for any incoming state.
+    std::vector<uint8_t> bytes(300, 0);
+    for (size_t i = 0; i < bytes.size(); i += 7) bytes[i] = static_cast<uint8_t>(i * 31u + 1u);
+    auto fnvFrom = [&](uint64_t h) {
+        for (uint8_t b : bytes) h = (h ^ b) * fnv::kPrime64;
+        return h;
+    };
+    FnvSegmentCache seg;
+    uint64_t state = 0x0123456789ABCDEFull;
+    for (int i = 0; i < 64; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        uint64_t h = state;
+        if (!seg.replay(h)) seg.record(state, fnvFrom(state), bytes.size());
+        uint64_t r = state;
+        CHECK(seg.replay(r));
+        CHECK(r == fnvFrom(state));
+        // A different high part with the same low byte replays from the same entry.
+        uint64_t r2 = state ^ 0xFFFF0000ull;
+        CHECK(seg.replay(r2));
+        CHECK(r2 == fnvFrom(state ^ 0xFFFF0000ull));
+    }
+    seg.invalidate();
+    uint64_t h = state;
+    CHECK(!seg.replay(h));
+
+    // The cached hash must stay bit-identical to the uncached one through level changes,
+    // repeated calls (cache hits) and in-place field edits.
+    Game g;
+    g.newGame(0x4A5Bu);
+    for (int d = 1; d <= 4; ++d) {
+        g.changeLevel(d, true);
+        for (int i = 0; i < 3; ++i) {
+            g.handleAction(Action::Wait);
+            CHECK(g.determinismHash() == g.determinismHashUncached());
+            CHECK(g.determinismHash() == g.determinismHashUncached());
+        }
+    }
+    g.changeLevel(2, true);
+    CHECK(g.determinismHash() == g.determinismHashUncached());
+
+    const uint64_t before = g.determinismHash();
+    CHECK(!g.fireField_.empty());
+    g.fireField_[g.fireField_.size() / 2] = 9;
+    CHECK(g.determinismHash() != before);
+    CHECK(g.determinismHash() == g.determinismHashUncached());
+
+    // Stored-level edits are picked up once the level is invalidated.
+    auto it = g.levels.begin();
+    while (it != g.levels.end() && it->first == LevelId{g.branch_, g.depth_}) ++it;
+    CHECK(it != g.levels.end());
+    it->second.unpack(); // stored levels are kept packed
+    it->second.scentField.assign(it->second.scentField.size(), 1);
+    g.invalidateLevelHash(it->first);
+    CHECK(g.determinismHash() == g.determinismHashUncached());
+    return true;
+}
+
+bool test_floor_candidates_parallel() {
+    // parallelFor: every index runs once, nested calls cannot deadlock, errors propagate.
+    ThreadPool pool(2);
+    std::vector<int> hits(64, 0);
+    parallelFor(pool, hits.size(), [&](size_t i) {
+        hits[i] += 1;
+        parallelFor(pool, 3, [](size_t) {});
+    });
+    for (int h : hits) CHECK(h == 1);
+
+    bool threw = false;
+    try {
+        parallelFor(pool, 8, [](size_t i) {
+            if (i == 5) throw std::runtime_error("boom");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Wider candidate searches are deterministic and only ever extend the default one:
+    // the first candidates share seeds, so the winner can only improve.
+    constexpr int W = 80;
+    constexpr int H = 50;
+    constexpr int maxDepth = 20;
+    for (int depth : {3, 7, 11}) {
+        const uint32_t runSeed = 0xF100Du + static_cast<uint32_t>(depth) * 131u;
+        RNG rn(runSeed), ra(runSeed), rb(runSeed);
+        Dungeon narrow(W, H), a(W, H), b(W, H);
+        narrow.generate(rn, DungeonBranch::Main, depth, maxDepth, runSeed);
+        a.generate(ra, DungeonBranch::Main, depth, maxDepth, runSeed, 8);
+        b.generate(rb, DungeonBranch::Main, depth, maxDepth, runSeed, 8);
+
+        CHECK(a.genPickAttempts == 8);
+        CHECK(a.genPickChosenIndex == b.genPickChosenIndex);
+        CHECK(a.genPickSeed == b.genPickSeed);
+        CHECK(a.tiles.size() == b.tiles.size());
+        bool same = true;
+        for (size_t i = 0; i < a.tiles.size() && i < b.tiles.size(); ++i) {
+            if (a.tiles[i].type != b.tiles[i].type) same = false;
+        }
+        CHECK(same);
+
+        CHECK(a.genPickScore >= narrow.genPickScore);
+        if (a.genPickChosenIndex < narrow.genPickAttempts) {
+            CHECK(a.genPickChosenIndex == narrow.genPickChosenIndex);
+            CHECK(a.genPickSeed == narrow.genPickSeed);
+        }
+    }
+    return true;
+}
+
+bool test_parallel_for_ordered() {
+    // Results are reported in index order even when later items finish first.
+    ThreadPool pool(3);
+    constexpr size_t kCount = 40;
+    auto slowFirst = [](size_t i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200 * (kCount - i)));
+        return i;
+    };
+    std::atomic<int> inReport{0};
+    bool overlapped = false;
+    std::vector<size_t> order;
+    size_t n = parallelForOrdered(
+        pool, kCount, false, slowFirst, [](size_t) { return false; },
+        [&](size_t i, size_t& r) {
+            if (inReport.fetch_add(1) != 0) overlapped = true;
+            if (r != i) overlapped = true;
+            order.push_back(r);
+            inReport.fetch_sub(1);
+        });
+    CHECK(n == kCount);
+    CHECK(!overlapped);
+    for (size_t i = 0; i < order.size(); ++i) CHECK(order[i] == i);
+
+    // Stop after the first failure: the earliest failing index wins even if a later one
+    // fails first, nothing past it is reported, and the remaining items are not started.
+    std::atomic<size_t> started{0};
+    order.clear();
+    n = parallelForOrdered(
+        pool, kCount, true,
+        [&](size_t i) {
+            started.fetch_add(1);
+            if (i != 11) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return i;
+        },
+        [](size_t r) { return r == 9 || r == 11; }, [&](size_t, size_t& r) { order.push_back(r); });
+    CHECK(n == 10u);
+    CHECK(order.size() == 10u);
+    for (size_t i = 0; i < order.size(); ++i) CHECK(order[i] == i);
+    CHECK(started.load() < kCount);
+
+    // Without stopping, failures are reported like any other result.
+    order.clear();
+    n = parallelForOrdered(
+        pool, 12, false, [](size_t i) { return i; }, [](size_t r) { return r == 3; },
+        [&](size_t, size_t& r) { order.push_back(r); });
+    CHECK(n == 12u);
+    CHECK(order.size() == 12u);
+    return true;
+}
+
+bool test_floor_prefetch_matches_sync() {
+    // Same run with and without background terrain prefetch: every floor and every
+    // determinism hash along the way must match.
+    Game sync;
+    Game pre;
+    pre.setFloorPrefetchEnabled(true);
+    sync.newGame(0xBEEF5u);
+    pre.newGame(0xBEEF5u);
+    CHECK(sync.determinismHash() == pre.determinismHash());
+
+    for (int d = 1; d <= 6; ++d) {
+        sync.changeLevel(LevelId{DungeonBranch::Main, d}, true);
+        pre.changeLevel(LevelId{DungeonBranch::Main, d}, true);
+        CHECK(sync.determinismHash() == pre.determinismHash());
+        for (int i = 0; i < 4; ++i) {
+            sync.handleAction(Action::Wait);
+            pre.handleAction(Action::Wait);
+        }
+        CHECK(sync.determinismHash() == pre.determinismHash());
+    }
+    CHECK(pre.floorPrefetchStats().used >= 5);
+    CHECK(sync.floorPrefetchStats().started == 0);
+
+    // Going back up leaves the pending prefetch for depth 7 unused; the revisit and the
+    // next fresh descent still agree.
+    sync.changeLevel(LevelId{DungeonBranch::Main, 5}, false);
+    pre.changeLevel(LevelId{DungeonBranch::Main, 5}, false);
+    sync.changeLevel(LevelId{DungeonBranch::Main, 6}, true);
+    pre.changeLevel(LevelId{DungeonBranch::Main, 6}, true);
+    sync.changeLevel(LevelId{DungeonBranch::Main, 7}, true);
+    pre.changeLevel(LevelId{DungeonBranch::Main, 7}, true);
+    CHECK(sync.determinismHash() == pre.determinismHash());
+    return true;
+}
+
+bool test_overworld_prefetch_eviction() {
+    // A full ring evicts the pending chunk farthest (Chebyshev) from the focus; ties go
+    // to the oldest entry.
+    OverworldChunkPrefetch pre;
+    auto params = [](int x, int y) {
+        OverworldChunkParams p;
+        p.runSeed = 0xE71Cu;
+        p.x = x;
+        p.y = y;
+        p.width = 4;
+        p.height = 4;
+        return p;
+    };
+    auto gen = [](const OverworldChunkParams& p) { return Dungeon(p.width, p.height); };
+
+    const Vec2i first[] = {{1, 0}, {0, 1}, {2, 2}, {-1, 0}, {5, -1}, {0, -1}, {1, 1}, {-2, 0}};
+    static_assert(sizeof(first) / sizeof(first[0]) == OverworldChunkPrefetch::kCapacity, "fill the ring");
+    for (const Vec2i& c : first) pre.start(params(c.x, c.y), 0, 0, gen);
+    CHECK(pre.size() == OverworldChunkPrefetch::kCapacity);
+    CHECK(pre.stats().evicted == 0u);
+
+    pre.start(params(0, 2), 0, 0, gen);
+    CHECK(pre.size() == OverworldChunkPrefetch::kCapacity);
+    CHECK(pre.stats().evicted == 1u);
+    CHECK(!pre.pendingFor(params(5, -1)));
+    CHECK(pre.pendingFor(params(0, 2)));
+
+    pre.start(params(-1, 1), 0, 0, gen);
+    CHECK(pre.stats().evicted == 2u);
+    CHECK(!pre.pendingFor(params(2, 2)));
+    CHECK(pre.pendingFor(params(-2, 0)) && pre.pendingFor(params(0, 2)));
+
+    // The focus moves with the player: from (-2, 0), (1, 0) and (1, 1) are farthest and
+    // the older one goes.
+    pre.start(params(-3, 0), -2, 0, gen);
+    CHECK(!pre.pendingFor(params(1, 0)));
+    CHECK(pre.pendingFor(params(1, 1)));
+
+    Dungeon out;
+    CHECK(pre.take(params(0, 2), out));
+    CHECK(out.width == 4 && out.height == 4);
+    CHECK(pre.stats().started == OverworldChunkPrefetch::kCapacity + 3u);
+    return true;
+}
+
+bool test_overworld_prefetch_matches_sync() {
+    // Walk the same wilderness route with and without chunk streaming: every chunk and
+    // every determinism hash along the way must match.
+    Game sync;
+    Game pre;
+    pre.setFloorPrefetchEnabled(true);
+    sync.newGame(0x0C4A1u);
+    pre.newGame(0x0C4A1u);
+    CHECK(pre.overworldPrefetch_.size() == 4);
+
+    auto step = [](Game& g, int dx, int dy) -> bool {
+        const overworld::ChunkGates gates = overworld::gatePositions(g.dung, g.seed_, g.overworldX_, g.overworldY_);
+        const Vec2i gate = (dx > 0) ? gates.east : (dx < 0) ? gates.west : (dy > 0) ? gates.south : gates.north;
+        g.setEntityPos(g.playerMut(), gate);
+        return g.tryOverworldStep(dx, dy);
+    };
+
+    // East twice, south, west (all fresh), then back north into a visited chunk.
+    const int route[5][2] = {{1, 0}, {1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    for (const auto& r : route) {
+        CHECK(step(sync, r[0], r[1]));
+        CHECK(step(pre, r[0], r[1]));
+        CHECK(sync.overworldX_ == pre.overworldX_ && sync.overworldY_ == pre.overworldY_);
+        CHECK(sync.determinismHash() == pre.determinismHash());
+        CHECK(pre.overworldPrefetch_.size() <= OverworldChunkPrefetch::kCapacity);
+    }
+    CHECK(pre.overworldPrefetchStats().used == 4);
+    CHECK(sync.overworldPrefetchStats().started == 0);
+
+    // Into the dungeon: the ring is released.
+    pre.changeLevel(LevelId{DungeonBranch::Main, 1}, true);
+    CHECK(pre.overworldPrefetch_.size() == 0);
+    return true;
+}
+
+bool test_level_snapshot_pack() {
+    // Byte RLE round-trips edge cases and rejects streams of the wrong length.
+    const std::vector<std::vector<uint8_t>> samples = {
+        {},
+        {7},
+        {0, 0},
+        {0, 0, 0},
+        {1, 2, 3, 3, 3, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 5},
+        std::vector<uint8_t>(70000, 0),
+    };
+    for (const auto& v : samples) {
+        std::vector<uint8_t> enc;
+        std::vector<uint8_t> dec;
+        levelpack::encodeBytes(v.data(), v.size(), enc);
+        CHECK(levelpack::decodeBytes(enc, v.size(), dec));
+        CHECK(dec == v);
+        if (!v.empty()) CHECK(!levelpack::decodeBytes(enc, v.size() + 1, dec));
+    }
+
+    Game g;
+    g.newGame(0x5AC4u);
+    for (int d = 1; d <= 4; ++d) {
+        g.changeLevel(LevelId{DungeonBranch::Main, d}, true);
+        g.handleAction(Action::Wait);
+    }
+
+    // Every stored floor except the active one and the one just left is packed, and the
+    // packed form is smaller but hashes exactly like the expanded one.
+    const LevelId justLeft{DungeonBranch::Main, 3};
+    size_t packed = 0;
+    for (const auto& kv : g.levels) {
+        if (kv.second.packed()) ++packed;
+        if (kv.first == LevelId{g.branch_, g.depth_} || kv.first == justLeft) continue;
+        CHECK(kv.second.packed());
+        CHECK(kv.second.dung.tiles.empty());
+    }
+    CHECK(!g.levels[justLeft].packed());
+    CHECK(packed >= 3);
+    const Game::LevelCacheStats st = g.levelCacheStats();
+    CHECK(st.packed == packed);
+    CHECK(st.bytes * 2 < st.expandedBytes);
+
+    const uint64_t h = g.determinismHashUncached();
+    CHECK(g.determinismHash() == h);
+    for (auto& kv : g.levels) kv.second.unpack();
+    CHECK(g.determinismHashUncached() == h);
+    g.packInactiveLevels();
+    CHECK(g.determinismHashUncached() == h);
+
+    // pack() + unpack() is lossless.
+    auto it = g.levels.find(LevelId{DungeonBranch::Main, 2});
+    CHECK(it != g.levels.end());
+    LevelState copy = it->second.expanded();
+    LevelState repacked = copy;
+    repacked.pack();
+    repacked.unpack();
+    CHECK(repacked.dung.tiles.size() == copy.dung.tiles.size());
+    bool same = repacked.dung.materialCache == copy.dung.materialCache &&
+                repacked.dung.leylineCache == copy.dung.leylineCache && repacked.scentField == copy.scentField &&
+                repacked.fireField == copy.fireField;
+    for (size_t i = 0; i < copy.dung.tiles.size(); ++i) {
+        const Tile& a = copy.dung.tiles[i];
+        const Tile& b = repacked.dung.tiles[i];
+        if (a.type != b.type || a.visible != b.visible || a.explored != b.explored) same = false;
+    }
+    CHECK(same);
+
+    // Walking back up decodes the packed floor.
+    g.changeLevel(LevelId{DungeonBranch::Main, 2}, false);
+    CHECK(!g.dung.tiles.empty());
+    CHECK(g.determinismHash() == g.determinismHashUncached());
+    return true;
+}
+
+bool test_level_swap_benchmark() {
+    // Filing the active level away and bringing it back must be lossless on the move path,
+    // and should be cheaper than the old copy-in/copy-out path. Timings are reported, not
+    // asserted (CI machines are noisy).
+    Game g;
+    g.newGame(0x5A4Bu);
+    g.changeLevel(LevelId{DungeonBranch::Main, 1}, true);
+    g.changeLevel(LevelId{DungeonBranch::Main, 2}, true);
+    for (int i = 0; i < 4; ++i) g.handleAction(Action::Wait);
+
+    const LevelId cur{g.branch_, g.depth_};
+    const uint64_t h0 = g.determinismHashUncached();
+    const size_t ents0 = g.ents.size();
+
+    using clock = std::chrono::steady_clock;
+    constexpr int kRounds = 40;
+
+    const auto c0 = clock::now();
+    for (int i = 0; i < kRounds; ++i) {
+        g.storeCurrentLevel();
+        LevelState copy = g.levels[cur];
+        g.adoptStoredLevel(copy);
+    }
+    const auto c1 = clock::now();
+    CHECK(g.determinismHashUncached() == h0);
+
+    const auto m0 = clock::now();
+    for (int i = 0; i < kRounds; ++i) {
+        g.storeCurrentLevel(/*leaving=*/true);
+        CHECK(g.ents.size() == 1);
+        CHECK(g.restoreLevel(cur));
+    }
+    const auto m1 = clock::now();
+    CHECK(g.ents.size() == ents0);
+    CHECK(g.determinismHashUncached() == h0);
+    CHECK(g.validateEntityIndex());
+
+    auto us = [](clock::duration d) {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(d).count()) / kRounds;
+    };
+    std::cout << "  level swap (store + restore): copy " << us(c1 - c0) << " us, move " << us(m1 - m0) << " us\n";
+    return true;
+}
+
+bool test_overworld_atlas_after_level_swap() {
+    // Restoring a level moves its stored state into the live level. The atlas must then
+    // describe the current chunk from the live tiles, and no stored entry may be left hollow.
+    Game g;
+    g.newGame(0xA71A5u);
+
+    auto step = [&](int dx, int dy) -> bool {
+        const overworld::ChunkGates gates = overworld::gatePositions(g.dung, g.seed_, g.overworldX_, g.overworldY_);
+        const Vec2i gate = (dx > 0) ? gates.east : (dx < 0) ? gates.west : (dy > 0) ? gates.south : gates.north;
+        g.setEntityPos(g.playerMut(), gate);
+        return g.tryOverworldStep(dx, dy);
+    };
+    auto intact = [](const LevelState& st) {
+        return st.packed() || st.dung.tiles.size() == static_cast<size_t>(st.dung.width * st.dung.height);
+    };
+    auto storesIntact = [&] {
+        for (const auto& kv : g.levels) {
+            if (!intact(kv.second)) return false;
+        }
+        for (const auto& kv : g.overworldChunks_) {
+            if (!intact(kv.second)) return false;
+        }
+        return true;
+    };
+    auto summaryMatchesLive = [&](int x, int y) {
+        // Drop the cached summary so the answer comes from the chunk itself.
+        g.overworldTerrainSummary_.erase(Game::OverworldKey{x, y});
+        Game::OverworldTerrainSummary ts;
+        if (!g.overworldChunkTerrainSummary(x, y, ts)) return false;
+        const Game::OverworldTerrainSummary live = Game::computeOverworldTerrainSummaryFromDungeon(g.dung);
+        return ts.chasmTiles == live.chasmTiles && ts.boulderTiles == live.boulderTiles &&
+               ts.pillarTiles == live.pillarTiles;
+    };
+
+    // Out to a fresh chunk, back to camp (restoreLevel), out again (restoreOverworldChunk).
+    CHECK(step(1, 0));
+    CHECK(step(-1, 0));
+    CHECK(g.atHomeCamp());
+    CHECK(storesIntact());
+    CHECK(g.overworldChunkDungeon(0, 0) == &g.dung);
+    CHECK(summaryMatchesLive(0, 0));
+
+    CHECK(step(1, 0));
+    CHECK(g.overworldX_ == 1 && g.overworldY_ == 0);
+    CHECK(storesIntact());
+    CHECK(g.overworldChunks_.find(Game::OverworldKey{1, 0}) == g.overworldChunks_.end());
+    CHECK(g.overworldChunkDungeon(1, 0) == &g.dung);
+    CHECK(summaryMatchesLive(1, 0));
+
+    // The camp, filed away again, is read from its stored copy.
+    const Dungeon* camp = g.overworldChunkDungeon(0, 0);
+    CHECK(camp != nullptr && camp != &g.dung);
+    CHECK(camp && camp->tiles.size() == static_cast<size_t>(camp->width * camp->height));
+    CHECK(g.determinismHash() == g.determinismHashUncached());
+    return true;
+}
+
+// Straight recursive shadowcaster (the pre-iterative implementation), used as the oracle.
+struct ReferenceFov {
+    const Dungeon& d;
+    int px;
+    int py;
+    int radius;
+    std::vector<uint8_t>& mask;
+
+    void mark(int x, int y) {
+        if (d.inBounds(x, y)) mask[static_cast<size_t>(y * d.width + x)] = 1;
+    }
+
+    void cast(int row, float start, float end, int xx, int xy, int yx, int yy) {
+        if (start < end) return;
+        float newStart = start;
+        for (int dist = row; dist <= radius; ++dist) {
+            bool blocked = false;
+            for (int dx = -dist, dy = -dist; dx <= 0; ++dx) {
+                const float lSlope = (dx - 0.5f) / (dy + 0.5f);
+                const float rSlope = (dx + 0.5f) / (dy - 0.5f);
+                if (start < rSlope) continue;
+                if (end > lSlope) break;
+                const int ax = px + dx * xx + dy * xy;
+                const int ay = py + dx * yx + dy * yy;
+                if (!d.inBounds(ax, ay)) continue;
+                if ((ax - px) * (ax - px) + (ay - py) * (ay - py) <= radius * radius) mark(ax, ay);
+                if (blocked) {
+                    if (d.isOpaque(ax, ay)) {
+                        newStart = rSlope;
+                        continue;
+                    }
+                    blocked = false;
+                    start = newStart;
+                } else if (d.isOpaque(ax, ay) && dist < radius) {
+                    blocked = true;
+                    cast(dist + 1, start, lSlope, xx, xy, yx, yy);
+                    newStart = rSlope;
+                }
+            }
+            if (blocked) break;
+        }
+    }
+
+    void run() {
+        mask.assign(static_cast<size_t>(d.width * d.height), 0);
+        if (!d.inBounds(px, py)) return;
+        mark(px, py);
+        static constexpr int kOct[8][4] = {{1, 0, 0, 1}, {0, 1, 1, 0}, {0, -1, 1, 0}, {-1, 0, 0, 1},
+                                           {-1, 0, 0, -1}, {0, -1, -1, 0}, {0, 1, -1, 0}, {1, 0, 0, -1}};
+        for (const auto& o : kOct) cast(1, 1.0f, 0.0f, o[0], o[1], o[2], o[3]);
+    }
+};
+
+bool test_fov_shadowcast_matches_reference() {
+    Game g;
+    g.newGame(0xF0F1u);
+    g.changeLevel(LevelId{DungeonBranch::Main, 3}, true);
+    Dungeon d = g.dung;
+
+    std::vector<Vec2i> origins;
+    for (int y = 0; y < d.height; y += 3) {
+        for (int x = 0; x < d.width; x += 5) {
+            if (d.isWalkable(x, y)) origins.push_back({x, y});
+        }
+    }
+    origins.push_back({-1, 2}); // off-map: only clears
+    CHECK(origins.size() > 20);
+
+    // Mask mode is bit-identical to the recursive caster, including radii beyond the
+    // precomputed slope table.
+    std::vector<uint8_t> mask;
+    std::vector<uint8_t> ref;
+    for (const Vec2i& o : origins) {
+        for (int radius : {0, 1, 4, 9, 12, 20, 70}) {
+            d.computeFovMask(o.x, o.y, radius, mask);
+            ReferenceFov{d, o.x, o.y, radius, ref}.run();
+            CHECK(mask == ref);
+        }
+    }
+
+    // Delta mode: the tile flags match a full recompute after every step (doors toggling
+    // in between), and fovChanges lists exactly the tiles whose flags flipped.
+    std::vector<Vec2i> doors;
+    for (int y = 0; y < d.height; ++y) {
+        for (int x = 0; x < d.width; ++x) {
+            if (d.isDoorClosed(x, y) || d.isDoorOpen(x, y)) doors.push_back({x, y});
+        }
+    }
+    std::vector<uint8_t> explored(d.tiles.size(), 0);
+    for (size_t step = 0; step < origins.size(); ++step) {
+        if (!doors.empty() && step % 4 == 0) {
+            const Vec2i dp = doors[step % doors.size()];
+            if (d.isDoorClosed(dp.x, dp.y)) d.openDoor(dp.x, dp.y);
+            else d.closeDoor(dp.x, dp.y);
+        }
+        std::vector<Tile> before = d.tiles;
+        const uint32_t rev = d.fovRevision;
+        const Vec2i o = origins[step];
+        const int radius = 6 + static_cast<int>(step % 7);
+        d.computeFov(o.x, o.y, radius, step % 5 != 0);
+        ReferenceFov{d, o.x, o.y, radius, ref}.run();
+
+        std::vector<int> flipped;
+        for (size_t i = 0; i < d.tiles.size(); ++i) {
+            CHECK(d.tiles[i].visible == (ref[i] != 0));
+            if (step % 5 != 0 && ref[i]) explored[i] = 1;
+            CHECK(d.tiles[i].explored == (before[i].explored || explored[i] != 0));
+            if (d.tiles[i].visible != before[i].visible || d.tiles[i].explored != before[i].explored) {
+                flipped.push_back(static_cast<int>(i));
+            }
+        }
+        if (flipped.empty()) {
+            CHECK(d.fovRevision == rev);
+        } else {
+            CHECK(d.fovRevision == rev + 1);
+            std::vector<int> changes = d.fovChanges;
+            std::sort(changes.begin(), changes.end());
+            CHECK(changes == flipped);
+        }
+    }
+
+    // Standing still does not touch a single tile (or the revision).
+    d.computeFov(origins.front().x, origins.front().y, 9);
+    const uint32_t rev = d.fovRevision;
+    d.computeFov(origins.front().x, origins.front().y, 9);
+    CHECK(d.fovRevision == rev);
+
+    // The tile planes follow every fog/terrain update and match a from-scratch build.
+    d.revealAll();
+    d.setExplored(origins.front().x, origins.front().y, false);
+    if (!doors.empty()) d.openDoor(doors.front().x, doors.front().y);
+    d.computeFov(origins.back().x, origins.back().y, 7);
+    const TilePlanes& tp = d.planes();
+    TilePlanes fresh;
+    fresh.sync(d);
+    std::vector<TilePlanes::Word> near;
+    tp.nearClear(tp.explored(), near);
+    size_t exploredCount = 0;
+    for (int y = 0; y < d.height; ++y) {
+        for (int x = 0; x < d.width; ++x) {
+            const Tile& t = d.at(x, y);
+            CHECK(tp.types()[y * d.width + x] == static_cast<uint8_t>(t.type));
+            CHECK(tp.test(tp.opaque(), x, y) == d.isOpaque(x, y));
+            CHECK(tp.test(tp.walkable(), x, y) == d.isWalkable(x, y));
+            CHECK(tp.test(tp.passable(), x, y) == d.isPassable(x, y));
+            CHECK(tp.test(tp.visible(), x, y) == t.visible);
+            CHECK(tp.test(tp.explored(), x, y) == t.explored);
+            CHECK(tp.test(fresh.explored(), x, y) == t.explored);
+            bool nearUnexplored = false;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (d.inBounds(x + dx, y + dy) && !d.at(x + dx, y + dy).explored) nearUnexplored = true;
+                }
+            }
+            CHECK(tp.test(near.data(), x, y) == nearUnexplored);
+            if (t.explored) ++exploredCount;
+        }
+    }
+    CHECK(tp.count(tp.explored()) == exploredCount);
+    CHECK(tp.memoryBytes() < d.tiles.size() * sizeof(Tile));
+    return true;
+}
+
+bool test_noise_batch_matches_immediate() {
+    Game g;
+    g.newGame(0x5017u);
+    g.changeLevel(LevelId{DungeonBranch::Main, 4}, true);
+    Dungeon& d = g.dung;
+    d.ensureMaterials(g.materialWorldSeed(), g.branch(), g.materialDepth(), g.dungeonMaxDepth());
+
+    // The cached step costs follow terrain edits.
+    auto gridMatches = [&]() {
+        const AcousticGrid& grid = d.acoustics();
+        for (int y = 0; y < d.height; ++y) {
+            for (int x = 0; x < d.width; ++x) {
+                const int want = d.soundPassable(x, y) ? d.soundTileCost(x, y) : 0;
+                if (grid.cost(x, y) != want) return false;
+            }
+        }
+        return true;
+    };
+    CHECK(gridMatches());
+    std::vector<Vec2i> doors;
+    for (int y = 0; y < d.height; ++y) {
+        for (int x = 0; x < d.width; ++x) {
+            if (d.at(x, y).type == TileType::DoorClosed || d.at(x, y).type == TileType::DoorOpen) doors.push_back({x, y});
+        }
+    }
+    for (size_t i = 0; i < doors.size(); i += 2) {
+        const Vec2i v = doors[i];
+        d.setTileType(v.x, v.y, d.at(v.x, v.y).type == TileType::DoorOpen ? TileType::DoorLocked : TileType::DoorOpen);
+    }
+    CHECK(gridMatches());
+
+    // computeSoundMap() on the grid matches the generic search over the tile rules.
+    const Vec2i pp = g.player().pos;
+    const std::vector<Vec2i> src = {pp};
+    const std::vector<int> ref = dijkstraCostFromSources(
+        d.width, d.height, src,
+        [&](int x, int y) { return d.soundPassable(x, y); },
+        [&](int x, int y) { return d.soundTileCost(x, y); },
+        [&](int x, int y, int dx, int dy) { return d.soundDiagonalOk(x, y, dx, dy); }, 30);
+    CHECK(d.computeSoundMap(pp.x, pp.y, 30) == ref);
+
+    // Unalerted monsters spread over the level.
+    std::vector<Vec2i> floors;
+    for (int y = 0; y < d.height; ++y) {
+        for (int x = 0; x < d.width; ++x) {
+            if (d.isWalkable(x, y) && !g.entityAt(x, y)) floors.push_back({x, y});
+        }
+    }
+    CHECK(floors.size() > 100);
+    for (size_t i = 0; i < floors.size(); i += floors.size() / 24) {
+        g.ents.push_back(g.makeMonster(i % 3 == 0 ? EntityKind::Bat : EntityKind::Goblin, floors[i], 0, false));
+    }
+    for (auto& e : g.ents) {
+        e.alerted = false;
+        e.lastKnownPlayerPos = {-1, -1};
+        e.lastKnownPlayerAge = 99;
+        e.lastKnownPlayerUncertainty = 0;
+    }
+    const std::vector<Entity> before = g.ents;
+
+    struct Noise {
+        Vec2i pos;
+        int volume;
+    };
+    const std::vector<std::vector<Noise>> batches = {
+        {{pp, 1}, {floors[floors.size() / 2], 2}},                       // likely heard by nobody
+        {{pp, 8}, {floors[floors.size() / 3], 12}, {pp, 14}, {pp, 6}},  // repeated source
+        {{floors[5], 16}, {floors[floors.size() - 5], 10}, {floors[floors.size() / 4], 18}},
+    };
+    int heard = 0;
+    for (const auto& batch : batches) {
+        g.ents = before;
+        for (const Noise& n : batch) g.emitNoise(n.pos, n.volume);
+        const std::vector<Entity> immediate = g.ents;
+
+        g.ents = before;
+        {
+            Game::NoiseBatch noises(g);
+            for (const Noise& n : batch) g.emitNoise(n.pos, n.volume);
+            CHECK(g.noiseBatch_.size() == batch.size());
+        }
+        CHECK(g.noiseBatch_.empty());
+
+        CHECK(immediate.size() == g.ents.size());
+        for (size_t i = 0; i < immediate.size(); ++i) {
+            const Entity& a = immediate[i];
+            const Entity& b = g.ents[i];
+            CHECK(a.alerted == b.alerted);
+            CHECK(a.lastKnownPlayerPos == b.lastKnownPlayerPos);
+            CHECK(a.lastKnownPlayerAge == b.lastKnownPlayerAge);
+            CHECK(a.lastKnownPlayerUncertainty == b.lastKnownPlayerUncertainty);
+            if (a.alerted && !before[i].alerted) ++heard;
+        }
+    }
+    CHECK(heard > 0);
+    return true;
+}
+
+bool test_hazard_kernels_match_reference() {
+    Game g;
+    g.newGame(0x4A2Du);
+    g.changeLevel(LevelId{DungeonBranch::Main, 6}, true);
+    Dungeon& d = g.dung;
+    d.ensureMaterials(g.materialWorldSeed(), g.branch(), g.materialDepth(), g.dungeonMaxDepth());
+
+    // Open a few pits so the chasm rules are exercised.
+    int pits = 0;
+    for (int y = 1; y + 1 < d.height && pits < 40; y += 3) {
+        for (int x = 1; x + 1 < d.width && pits < 40; x += 7) {
+            if (d.at(x, y).type == TileType::Floor) {
+                d.setTileType(x, y, TileType::Chasm);
+                ++pits;
+            }
+        }
+    }
+    CHECK(pits > 0);
+
+    const int w = d.width;
+    const int h = d.height;
+    const size_t n = static_cast<size_t>(w * h);
+    uint32_t seed = 0x9E3779B9u;
+    auto randomField = [&](int density) {
+        std::vector<uint8_t> f(n, uint8_t{0});
+        for (size_t i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            if (static_cast<int>((seed >> 8) % 100u) < density) f[i] = static_cast<uint8_t>(seed >> 24);
+        }
+        return f;
+    };
+
+    // The scatter loop the gas passes used before the kernels.
+    auto referenceGas = [&](hazard::Gas gas, const hazard::GasRule& rule, const std::vector<uint8_t>& field) {
+        std::vector<uint8_t> next(n, uint8_t{0});
+        auto open = [&](int x, int y) {
+            return d.inBounds(x, y) && (d.isWalkable(x, y) || d.at(x, y).type == TileType::Chasm);
+        };
+        constexpr Vec2i kDirs[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const size_t i = static_cast<size_t>(y * w + x);
+                const int s = field[i];
+                if (s == 0 || !open(x, y)) continue;
+                const bool pit = d.at(x, y).type == TileType::Chasm;
+                const TerrainMaterial m = d.materialAtCached(x, y);
+                const EcosystemFx fx = ecosystemFx(d.ecosystemAtCached(x, y));
+                const int absorb = (m == TerrainMaterial::Moss || m == TerrainMaterial::Dirt ||
+                                    m == TerrainMaterial::Wood || m == TerrainMaterial::Bone) ? 1 : 0;
+                const int slick = (m == TerrainMaterial::Metal || m == TerrainMaterial::Crystal ||
+                                   m == TerrainMaterial::Obsidian || m == TerrainMaterial::Marble) ? 1 : 0;
+                const int sticky = (m == TerrainMaterial::Metal || m == TerrainMaterial::Obsidian ||
+                                    m == TerrainMaterial::Basalt) ? 1 : 0;
+                int q = fx.poisonGasQuenchDelta;
+                int delta = -absorb + slick + fx.poisonGasSpreadDelta;
+                int decay = 1 + absorb;
+                if (gas == hazard::Gas::Confusion) {
+                    q = fx.confusionGasQuenchDelta;
+                    delta = -absorb + slick + fx.confusionGasSpreadDelta;
+                    if (pit) decay += 1;
+                } else if (gas == hazard::Gas::Corrosive) {
+                    q = fx.corrosiveGasQuenchDelta;
+                    delta = -absorb - sticky + fx.corrosiveGasSpreadDelta;
+                }
+                if (q > 0) decay += q;
+                int self = std::max(0, s - decay);
+                if (q < 0 && s >= 8) self = std::min(255, self - q);
+                next[i] = std::max<uint8_t>(next[i], static_cast<uint8_t>(self));
+                if (s < rule.keep + 1) continue;
+                const int base = std::clamp(s - rule.keep + delta, 0, s);
+                for (const Vec2i& dv : kDirs) {
+                    const int nx = x + dv.x;
+                    const int ny = y + dv.y;
+                    if (!open(nx, ny)) continue;
+                    int spread = base;
+                    if (dv == rule.wind) spread = std::min(s, spread + rule.windBonus);
+                    else if (dv.x == -rule.wind.x && dv.y == -rule.wind.y) spread = std::max(0, spread - rule.windBonus);
+                    const bool npit = d.at(nx, ny).type == TileType::Chasm;
+                    const int adj = (npit && !pit) ? rule.intoChasm : (pit && !npit) ? rule.outOfChasm : 0;
+                    spread = std::clamp(spread + adj, 0, s);
+                    const size_t j = static_cast<size_t>(ny * w + nx);
+                    next[j] = std::max<uint8_t>(next[j], static_cast<uint8_t>(spread));
+                }
+            }
+        }
+        return next;
+    };
+
+    std::vector<uint8_t> scratch;
+    const hazard::HazardPlanes& planes = g.hazardPlanes();
+    const hazard::Gas gases[3] = {hazard::Gas::Confusion, hazard::Gas::Poison, hazard::Gas::Corrosive};
+    for (int k = 0; k < 9; ++k) {
+        hazard::GasRule rule;
+        rule.keep = 2 + k % 3;
+        rule.wind = (k % 2 == 0) ? Vec2i{1, 0} : Vec2i{0, -1};
+        rule.windBonus = k % 4;
+        rule.intoChasm = (k % 3 == 0) ? -2 : 3;
+        rule.outOfChasm = -rule.intoChasm;
+        const std::vector<uint8_t> field = randomField(10 + k * 10);
+        std::vector<uint8_t> out = field;
+        hazard::ActiveRect all;
+        hazard::diffuseGas(planes, gases[k % 3], rule, out, all, scratch);
+        CHECK(out == referenceGas(gases[k % 3], rule, field));
+    }
+
+    // Fire decay (the RNG spread pass stays with the caller).
+    for (int quench = 0; quench < 3; ++quench) {
+        const std::vector<uint8_t> field = randomField(40);
+        std::vector<uint8_t> next;
+        hazard::ActiveRect all;
+        hazard::decayFire(planes, quench, field, next, all);
+        CHECK(next.size() == n);
+        bool same = true;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const size_t i = static_cast<size_t>(y * w + x);
+                const int s = field[i];
+                int want = 0;
+                if (s != 0 && d.isWalkable(x, y)) {
+                    const int q = ecosystemFx(d.ecosystemAtCached(x, y)).fireQuenchDelta;
+                    want = std::max(0, s - (1 + quench + std::max(0, q)));
+                    if (q < 0 && s >= 6) want = std::min(255, want - q);
+                }
+                if (next[i] != want) same = false;
+            }
+        }
+        CHECK(same);
+    }
+
+    // Scent matches the generic helper over the tile rules.
+    ScentFieldParams params;
+    params.windDir = {0, 1};
+    params.windStrength = 2;
+    auto walkable = [&](int x, int y) { return d.inBounds(x, y) && d.isWalkable(x, y); };
+    auto fxAt = [&](int x, int y) {
+        const TerrainMaterialFx m = terrainMaterialFx(d.materialAtCached(x, y));
+        const EcosystemFx e = ecosystemFx(d.ecosystemAtCached(x, y));
+        ScentCellFx out;
+        out.decayDelta = m.scentDecayDelta + e.scentDecayDelta;
+        out.spreadDropDelta = m.scentSpreadDropDelta + e.scentSpreadDropDelta;
+        return out;
+    };
+    std::vector<uint8_t> want = randomField(30);
+    std::vector<uint8_t> got = want;
+    const Vec2i pp = g.player().pos;
+    for (int turn = 0; turn < 6; ++turn) {
+        updateScentField(w, h, want, pp, uint8_t{200}, walkable, fxAt, params);
+        hazard::ActiveRect all;
+        hazard::updateScent(g.hazardPlanes(), got, all, pp, uint8_t{200}, params, scratch);
+        CHECK(got == want);
+    }
+
+    // Terrain edits reach the planes through the journal.
+    d.setTileType(pp.x + 1, pp.y, TileType::Chasm);
+    const size_t pi = static_cast<size_t>((pp.y) * w + pp.x + 1);
+    CHECK(g.hazardPlanes().chasm()[pi] == 0xFFu);
+    CHECK(g.hazardPlanes().walkable()[pi] == 0u);
+    return true;
+}
+
+bool test_hazard_active_regions() {
+    Game g;
+    g.newGame(0x5AC7u);
+    g.changeLevel(LevelId{DungeonBranch::Main, 5}, true);
+    Dungeon& d = g.dung;
+    d.ensureMaterials(g.materialWorldSeed(), g.branch(), g.materialDepth(), g.dungeonMaxDepth());
+    const int w = d.width;
+    const int h = d.height;
+    const size_t n = static_cast<size_t>(w * h);
+    const hazard::HazardPlanes& planes = g.hazardPlanes();
+
+    // A boxed kernel step matches an unbounded one, and the box stays tight.
+    std::vector<Vec2i> floors;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (d.isWalkable(x, y)) floors.push_back({x, y});
+        }
+    }
+    CHECK(floors.size() > 50);
+    std::vector<uint8_t> boxed(n, uint8_t{0});
+    hazard::ActiveRect box = hazard::ActiveRect::none();
+    for (size_t k = 0; k < 3; ++k) {
+        const Vec2i v = floors[(k + 1) * floors.size() / 4];
+        boxed[static_cast<size_t>(v.y * w + v.x)] = uint8_t{40};
+        box.include(v.x, v.y);
+    }
+    std::vector<uint8_t> full = boxed;
+    std::vector<uint8_t> scratch;
+    hazard::GasRule rule;
+    rule.wind = {1, 0};
+    rule.windBonus = 2;
+    const hazard::ActiveRect whole = hazard::ActiveRect{}.clipped(w, h);
+    for (int step = 0; step < 80 && !box.empty(); ++step) {
+        hazard::ActiveRect all;
+        hazard::diffuseGas(planes, hazard::Gas::Poison, rule, boxed, box, scratch);
+        hazard::diffuseGas(planes, hazard::Gas::Poison, rule, full, all, scratch);
+        CHECK(boxed == full);
+        const hazard::ActiveRect tight = hazard::tightBounds(full, w, whole);
+        CHECK(box.empty() == tight.empty());
+        if (!box.empty()) CHECK(box.x0 == tight.x0 && box.y0 == tight.y0 && box.x1 == tight.x1 && box.y1 == tight.y1);
+    }
+    CHECK(box.empty());
+    CHECK(std::all_of(full.begin(), full.end(), [](uint8_t v) { return v == 0u; }));
+
+    // An empty box is a no-op, and scent grows its box from the deposit.
+    hazard::ActiveRect none = hazard::ActiveRect::none();
+    hazard::diffuseGas(planes, hazard::Gas::Confusion, rule, boxed, none, scratch);
+    CHECK(none.empty());
+    std::vector<uint8_t> scent(n, uint8_t{0});
+    std::vector<uint8_t> scentFull(n, uint8_t{0});
+    hazard::ActiveRect scentBox = hazard::ActiveRect::none();
+    ScentFieldParams params;
+    for (int turn = 0; turn < 12; ++turn) {
+        const Vec2i at = floors[static_cast<size_t>(turn) * 7 % floors.size()];
+        hazard::ActiveRect all;
+        hazard::updateScent(planes, scent, scentBox, at, uint8_t{220}, params, scratch);
+        hazard::updateScent(planes, scentFull, all, at, uint8_t{220}, params, scratch);
+        CHECK(scent == scentFull);
+    }
+
+    auto n4 = [](const Game& gg) { return static_cast<size_t>(gg.dung.width * gg.dung.height); };
+
+    // In play: fields seeded by hazards match a run that sweeps every field in full, and
+    // no nonzero tile ever escapes its box.
+    Game tracked;
+    Game swept;
+    tracked.newGame(0x5AC8u);
+    swept.newGame(0x5AC8u);
+    for (Game* gg : {&tracked, &swept}) {
+        gg->changeLevel(LevelId{DungeonBranch::Main, 4}, true);
+        const Vec2i pp = gg->player().pos;
+        gg->confusionGas_[static_cast<size_t>(pp.y * gg->dung.width + pp.x)] = uint8_t{30};
+        gg->markHazard(gg->confusionGas_, pp.x, pp.y);
+        for (std::vector<uint8_t>* f : {&gg->poisonGas_, &gg->corrosiveGas_, &gg->fireField_}) {
+            for (int dx = 2; dx <= 4; ++dx) {
+                const int x = std::min(gg->dung.width - 1, pp.x + dx);
+                if (!gg->dung.isWalkable(x, pp.y)) continue;
+                (*f)[static_cast<size_t>(pp.y * gg->dung.width + x)] = uint8_t{14};
+                gg->markHazard(*f, x, pp.y);
+            }
+        }
+    }
+    for (int turn = 0; turn < 30; ++turn) {
+        swept.resetHazardActivity();
+        tracked.handleAction(Action::Wait);
+        swept.handleAction(Action::Wait);
+        CHECK(tracked.validateHazardActivity());
+        CHECK(tracked.determinismHash() == swept.determinismHash());
+    }
+
+    // Mirroring the level writes empty-box fields straight into packed form.
+    CHECK(tracked.confusionActive_.empty() || tracked.poisonActive_.empty() || tracked.corrosiveActive_.empty() ||
+          tracked.fireActive_.empty());
+    tracked.storeCurrentLevel(false);
+    swept.storeCurrentLevel(false);
+    const LevelId cur{DungeonBranch::Main, 4};
+    const LevelState a = tracked.levels[cur].expanded();
+    const LevelState b = swept.levels[cur].expanded();
+    CHECK(a.fireField.size() == n4(tracked) && a.poisonGas.size() == n4(tracked));
+    CHECK(a.confusionGas == b.confusionGas && a.poisonGas == b.poisonGas && a.corrosiveGas == b.corrosiveGas);
+    CHECK(a.fireField == b.fireField && a.scentField == b.scentField);
+    return true;
+}
+
+bool test_darkness_fov_revision() {
+    // In darkness the fog update is the net effect of computeFov() plus the light filter:
+    // a turn that sees the same tiles leaves the revision alone, and a real change lists
+    // exactly the tiles that flipped.
+    Game g;
+    g.newGame(0xDA4Cu);
+    g.setLightingEnabled(true);
+    g.changeLevel(LevelId{DungeonBranch::Main, 6}, true);
+    CHECK(g.darknessActive());
+    Dungeon& d = g.dung;
+
+    g.recomputeFov();
+    const uint32_t rev = d.fovRevision;
+    const std::vector<int> lastChanges = d.fovChanges;
+    g.recomputeFov();
+    CHECK(d.fovRevision == rev);
+    CHECK(d.fovChanges == lastChanges);
+
+    int moves = 0;
+    for (int step = 0; step < 12; ++step) {
+        const Vec2i pp = g.player().pos;
+        Vec2i next = pp;
+        for (Vec2i dv : {Vec2i{1, 0}, Vec2i{0, 1}, Vec2i{-1, 0}, Vec2i{0, -1}}) {
+            const Vec2i q{pp.x + dv.x, pp.y + dv.y};
+            if (d.inBounds(q.x, q.y) && d.isWalkable(q.x, q.y) && !g.entityAt(q.x, q.y)) {
+                next = q;
+                if ((step + dv.x) % 2 == 0) break;
+            }
+        }
+        if (next.x == pp.x && next.y == pp.y) break;
+        g.playerMut().pos = next;
+        ++moves;
+
+        const std::vector<Tile> before = d.tiles;
+        const uint32_t r0 = d.fovRevision;
+        g.recomputeFov();
+        std::vector<int> flipped;
+        for (size_t i = 0; i < d.tiles.size(); ++i) {
+            if (d.tiles[i].visible != before[i].visible || d.tiles[i].explored != before[i].explored) {
+                flipped.push_back(static_cast<int>(i));
+            }
+        }
+        if (flipped.empty()) {
+            CHECK(d.fovRevision == r0);
+        } else {
+            CHECK(d.fovRevision == r0 + 1u);
+            CHECK(d.fovChanges == flipped);
+        }
+    }
+    CHECK(moves > 0);
+
+    TilePlanes fresh;
+    fresh.sync(d);
+    CHECK(d.planes().visible_ == fresh.visible_ && d.planes().explored_ == fresh.explored_);
+    return true;
+}
+
+bool test_light_map_incremental() {
+    Game g;
+    g.newGame(0x11A7u);
+    g.setLightingEnabled(true);
+    g.changeLevel(LevelId{DungeonBranch::Main, 6}, true);
+    CHECK(g.darknessActive());
+    Dungeon& d = g.dung;
+    const int w = d.width;
+
+    Item torch;
+    torch.id = g.nextItemId++;
+    torch.kind = ItemKind::TorchLit;
+    torch.charges = 500;
+    g.inv.push_back(torch);
+    const Vec2i pp = g.player().pos;
+    GroundItem gi;
+    gi.item = torch;
+    gi.item.id = g.nextItemId++;
+    gi.pos = pp;
+    g.ground.push_back(gi);
+    g.recomputeLightMap();
+
+    // The cached maps match a rebuild from nothing.
+    auto matchesFull = [](Game& gg) {
+        const std::vector<uint8_t> level = gg.lightMap_;
+        const std::vector<Color> color = gg.lightColorMap_;
+        LightMapCache fresh;
+        std::swap(fresh, gg.lightCache_);
+        gg.recomputeLightMap();
+        bool same = gg.lightMap_ == level;
+        for (size_t i = 0; same && i < color.size(); ++i) {
+            const Color a = color[i];
+            const Color b = gg.lightColorMap_[i];
+            same = a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+        }
+        std::swap(fresh, gg.lightCache_);
+        gg.lightMap_ = level;
+        gg.lightColorMap_ = color;
+        return same;
+    };
+    CHECK(matchesFull(g));
+
+    // Nothing changed: no source is recomputed and nothing is dirty.
+    const uint32_t rev = g.lightRevision();
+    g.recomputeLightMap();
+    CHECK(g.lightCache_.recomputedSources() == 0);
+    CHECK(g.lightDirtyRects().empty());
+    CHECK(g.lightRevision() == rev);
+
+    // Moving the dropped torch rebuilds only that source, and every tile whose light
+    // changed lies in a dirty rect.
+    std::vector<Vec2i> floors;
+    for (int y = std::max(0, pp.y - 6); y <= std::min(d.height - 1, pp.y + 6); ++y) {
+        for (int x = std::max(0, pp.x - 6); x <= std::min(w - 1, pp.x + 6); ++x) {
+            if (d.isWalkable(x, y) && !(x == pp.x && y == pp.y)) floors.push_back({x, y});
+        }
+    }
+    CHECK(floors.size() > 4);
+    for (size_t k = 0; k < 4; ++k) {
+        const std::vector<uint8_t> before = g.lightMap_;
+        g.ground.back().pos = floors[k * floors.size() / 4];
+        g.recomputeLightMap();
+        CHECK(g.lightCache_.recomputedSources() == 1);
+        CHECK(g.lightRevision() == rev + static_cast<uint32_t>(k) + 1u);
+        for (size_t i = 0; i < before.size(); ++i) {
+            if (before[i] == g.lightMap_[i]) continue;
+            const int x = static_cast<int>(i) % w;
+            const int y = static_cast<int>(i) / w;
+            CHECK(std::any_of(g.lightDirtyRects().begin(), g.lightDirtyRects().end(), [&](const LightRect& r) {
+                return x >= r.x0 && x <= r.x1 && y >= r.y0 && y <= r.y1;
+            }));
+        }
+        CHECK(matchesFull(g));
+    }
+
+    // Walls raised next to the torches change their LOS.
+    int raised = 0;
+    for (const Vec2i& v : floors) {
+        if (raised >= 3 || chebyshev(v, g.ground.back().pos) > 2 || v == g.ground.back().pos) continue;
+        d.setTileType(v.x, v.y, TileType::Wall);
+        ++raised;
+    }
+    CHECK(raised > 0);
+    g.recomputeLightMap();
+    CHECK(g.lightCache_.recomputedSources() > 0);
+    CHECK(matchesFull(g));
+
+    // In play (monsters, fire, burning): the cache never drifts from a full rebuild.
+    const Vec2i fp = g.player().pos;
+    for (int dx = 1; dx <= 3; ++dx) {
+        const int x = std::min(w - 1, fp.x + dx);
+        if (!d.isWalkable(x, fp.y)) continue;
+        g.fireField_[static_cast<size_t>(fp.y * w + x)] = uint8_t{12};
+        g.markHazard(g.fireField_, x, fp.y);
+    }
+    for (int turn = 0; turn < 20 && !g.isGameOver(); ++turn) {
+        g.handleAction(Action::Wait);
+        CHECK(matchesFull(g));
+    }
+
+    // Lighting off: uniformly white, and one whole-map dirty rect on the switch.
+    g.setLightingEnabled(false);
+    CHECK(g.lightDirtyRects().size() == 1u && g.lightDirtyRects()[0].area() == w * d.height);
+    CHECK(std::all_of(g.lightMap_.begin(), g.lightMap_.end(), [](uint8_t v) { return v == 255u; }));
+    g.recomputeLightMap();
+    CHECK(g.lightDirtyRects().empty());
+    return true;
+}
+
+bool test_explore_frontier_incremental() {
+    Game g;
+    g.newGame(0xF207u);
+    const Dungeon& d = g.dung;
+
+    // The maintained frontier plane always equals "explored with an unexplored 8-neighbor".
+    auto frontierMatches = [&]() {
+        const TilePlanes& tp = d.planes();
+        for (int y = 0; y < d.height; ++y) {
+            for (int x = 0; x < d.width; ++x) {
+                bool expect = false;
+                for (int dy = -1; dy <= 1 && d.at(x, y).explored; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (d.inBounds(x + dx, y + dy) && !d.at(x + dx, y + dy).explored) expect = true;
+                    }
+                }
+                if (tp.test(tp.frontier(), x, y) != expect) return false;
+            }
+        }
+        return true;
+    };
+    CHECK(frontierMatches());
+
+    // Across an auto-explore session (FOV deltas every step) the plane stays exact, and
+    // repeated searches over the reused stamp buffers agree.
+    int steps = 0;
+    int goals = 0;
+    for (int i = 0; i < 600 && !g.isGameOver(); ++i) {
+        if (!g.isAutoActive()) {
+            g.handleAction(Action::Wait);
+            g.requestAutoExplore();
+            if (!g.isAutoActive()) continue;
+        }
+        g.update(0.05f);
+        ++steps;
+        CHECK(frontierMatches());
+        const Vec2i a = g.findNearestExploreFrontier();
+        CHECK(g.findNearestExploreFrontier() == a);
+        if (a.x >= 0) {
+            CHECK(d.at(a.x, a.y).explored);
+            ++goals;
+        }
+    }
+    CHECK(steps > 50 && goals > 0);
+
+    // Fog rewritten by several writers at once (full rebuild) is still exact.
+    g.dung.revealAll();
+    g.dung.setExplored(g.player().pos.x + 1, g.player().pos.y, false);
+    CHECK(frontierMatches());
+    return true;
+}
+
+bool test_parallel_replays_match_serial() {
+    // Headless --jobs verifies replays on a worker pool: one Game per replay, many at once.
+    // Every run must end in the same state as a serial run of the same replay.
+    std::vector<ReplayFile> replays;
+    for (uint32_t k = 0; k < 4; ++k) {
+        ReplayFile rf;
+        rf.meta.seed = 4242u + k * 7919u;
+        rf.meta.bonesEnabled = false;
+        rf.meta.lightingEnabled = (k % 2u) == 1u;
+        for (uint32_t e = 0; e < 40; ++e) {
+            ReplayEvent ev;
+            ev.tMs = 100u * (e + 1u);
+            ev.action = (e % 4u == 3u) ? Action::Wait : Action::AutoExplore;
+            rf.events.push_back(ev);
+        }
+        replays.push_back(rf);
+    }
+
+    auto runOne = [](const ReplayFile& rf, uint64_t& hash, uint32_t& turns) {
+        Game g;
+        std::string err;
+        if (!prepareGameForReplay(g, rf, &err)) return false;
+        ReplayRunOptions opt;
+        opt.verifyHashes = false;
+        ReplayRunStats stats;
+        if (!runReplayHeadless(g, rf, opt, &stats, &err)) return false;
+        hash = g.determinismHash();
+        turns = stats.turns;
+        return true;
+    };
+
+    std::vector<uint64_t> serialHash(replays.size(), 0u);
+    std::vector<uint32_t> serialTurns(replays.size(), 0u);
+    for (size_t i = 0; i < replays.size(); ++i) {
+        CHECK(runOne(replays[i], serialHash[i], serialTurns[i]));
+    }
+
+    std::vector<uint64_t> parHash(replays.size(), 0u);
+    std::vector<uint32_t> parTurns(replays.size(), 0u);
+    std::vector<uint8_t> parOk(replays.size(), 0u);
+    {
+        ThreadPool pool(3);
+        parallelFor(pool, replays.size(), [&](size_t i) {
+            parOk[i] = runOne(replays[i], parHash[i], parTurns[i]) ? 1u : 0u;
+        });
+    }
+
+    for (size_t i = 0; i < replays.size(); ++i) {
+        CHECK(parOk[i] == 1u);
+        CHECK(parTurns[i] == serialTurns[i]);
+        CHECK(parHash[i] == serialHash[i]);
+    }
+    CHECK(serialTurns[0] > 0u);
+    // Different seeds really are different runs.
+    CHECK(serialHash[0] != serialHash[1]);
+    return true;
+}
+
+bool test_replay_binary_roundtrip() {
+    ReplayFile rf;
+    rf.meta.gameVersion = "test";
+    rf.meta.seed = 987654321u;
+    rf.meta.playerClassId = "wizard";
+    rf.meta.lightingEnabled = true;
+    rf.meta.floorCandidates = 3;
+    uint32_t t = 0;
+    for (uint32_t turn = 0; turn < 200; ++turn) {
+        ReplayEvent a;
+        a.tMs = (t += 45u);
+        a.action = (turn % 3u == 0u) ? Action::AutoExplore : Action::Wait;
+        rf.events.push_back(a);
+        ReplayEvent h;
+        h.tMs = t;
+        h.kind = ReplayEventType::StateHash;
+        h.turn = turn;
+        h.hash = 0x9E3779B97F4A7C15ull * (turn + 1u);
+        rf.events.push_back(h);
+    }
+    ReplayEvent ti;
+    ti.tMs = t + 10u;
+    ti.kind = ReplayEventType::TextInput;
+    ti.text = std::string("search \x01\xff", 9);
+    rf.events.push_back(ti);
+    ReplayEvent tr;
+    tr.tMs = t + 5u; // out of order on purpose
+    tr.kind = ReplayEventType::AutoTravel;
+    tr.pos = Vec2i{-3, 70};
+    rf.events.push_back(tr);
+    ReplayEvent cb;
+    cb.tMs = t + 20u;
+    cb.kind = ReplayEventType::CommandBackspace;
+    rf.events.push_back(cb);
+
+    auto sameEvents = [](const ReplayFile& a, const ReplayFile& b) {
+        if (a.events.size() != b.events.size()) return false;
+        for (size_t i = 0; i < a.events.size(); ++i) {
+            const ReplayEvent& x = a.events[i];
+            const ReplayEvent& y = b.events[i];
+            if (x.tMs != y.tMs || x.kind != y.kind || x.turn != y.turn || x.hash != y.hash ||
+                x.action != y.action || x.text != y.text || x.pos.x != y.pos.x || x.pos.y != y.pos.y) {
+                return false;
+            }
+        }
+        return replayHeaderText(a.meta) == replayHeaderText(b.meta);
+    };
+
+    std::vector<uint8_t> bytes;
+    encodeReplayBinary(rf, bytes);
+    ReplayFile back;
+    ReplayIndex index;
+    CHECK(decodeReplayBinary(bytes, back, &index));
+    CHECK(sameEvents(rf, back));
+    CHECK(index.eventCount == rf.events.size());
+    CHECK(index.entries.size() == (200u + kReplayIndexStride - 1u) / kReplayIndexStride);
+    CHECK(index.findAtOrBefore(100u) != nullptr);
+    CHECK(index.findAtOrBefore(100u)->turn == 96u);
+    CHECK(index.findAtOrAfter(100u)->turn == 128u);
+    CHECK(index.findAtOrAfter(500u) == nullptr);
+
+    // text -> binary -> text is lossless, and the binary file is much smaller.
+    const fs::path textPath = testTempFile("binary_roundtrip.prr");
+    const fs::path binPath = testTempFile("binary_roundtrip.prrb");
+    const fs::path textAgain = testTempFile("binary_roundtrip_again.prr");
+    CHECK(writeReplayFile(textPath, rf));
+    ReplayFile fromText;
+    CHECK(loadReplayFile(textPath, fromText));
+    CHECK(writeReplayFile(binPath, fromText));
+    CHECK(isBinaryReplayFile(binPath));
+    CHECK(!isBinaryReplayFile(textPath));
+    ReplayFile fromBin;
+    CHECK(loadReplayFile(binPath, fromBin));
+    CHECK(sameEvents(rf, fromBin));
+    CHECK(writeReplayFile(textAgain, fromBin));
+    std::ifstream ta(textPath, std::ios::binary);
+    std::ifstream tb(textAgain, std::ios::binary);
+    const std::string textA((std::istreambuf_iterator<char>(ta)), std::istreambuf_iterator<char>());
+    const std::string textB((std::istreambuf_iterator<char>(tb)), std::istreambuf_iterator<char>());
+    CHECK(textA == textB);
+    CHECK(fs::file_size(binPath) * 2u < fs::file_size(textPath));
+
+    // Header lines this build does not know survive the binary hop verbatim.
+    {
+        std::string withExtras = textA;
+        const size_t endPos = withExtras.find("@end_header\n");
+        CHECK(endPos != std::string::npos);
+        withExtras.insert(endPos, "# hand-edited\n@future_key 7 x\n");
+        const fs::path extraText = testTempFile("binary_extras.prr");
+        const fs::path extraBin = testTempFile("binary_extras.prrb");
+        const fs::path extraAgain = testTempFile("binary_extras_again.prr");
+        {
+            std::ofstream f(extraText, std::ios::binary);
+            f << withExtras;
+        }
+        ReplayFile ext;
+        CHECK(loadReplayFile(extraText, ext));
+        CHECK((ext.meta.extraHeaderLines == std::vector<std::string>{ "# hand-edited", "@future_key 7 x" }));
+        CHECK(writeReplayFile(extraBin, ext));
+        ReplayFile extBin;
+        CHECK(loadReplayFile(extraBin, extBin));
+        CHECK(extBin.meta.extraHeaderLines == ext.meta.extraHeaderLines);
+        CHECK(writeReplayFile(extraAgain, extBin));
+        std::ifstream ea(extraAgain, std::ios::binary);
+        const std::string extraB((std::istreambuf_iterator<char>(ea)), std::istreambuf_iterator<char>());
+        CHECK(extraB == withExtras);
+    }
+
+    // Prefix loads stop at the first checkpoint at or after the turn, in both encodings.
+    ReplayMeta meta;
+    CHECK(readReplayIndex(binPath, meta, index));
+    CHECK(meta.seed == rf.meta.seed);
+    CHECK(index.entries.size() == 7u);
+    for (const fs::path& p : { binPath, textPath }) {
+        ReplayFile prefix;
+        CHECK(loadReplayPrefix(p, 70u, prefix));
+        CHECK(prefix.events.size() == 142u);
+        CHECK(prefix.events.back().kind == ReplayEventType::StateHash);
+        CHECK(prefix.events.back().turn == 70u);
+        CHECK(prefix.meta.floorCandidates == 3);
+    }
+
+    // Corrupt input fails cleanly.
+    std::vector<uint8_t> cut(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(bytes.size() / 2));
+    std::string err;
+    CHECK(!decodeReplayBinary(cut, back, nullptr, &err));
+    CHECK(!err.empty());
+
+    // An action byte past the end of the enum is rejected, not cast.
+    ReplayFile badAction;
+    ReplayEvent ba;
+    ba.action = static_cast<Action>(static_cast<uint8_t>(kReplayLastAction) + 1u);
+    badAction.events.push_back(ba);
+    std::vector<uint8_t> badBytes;
+    encodeReplayBinary(badAction, badBytes);
+    err.clear();
+    CHECK(!decodeReplayBinary(badBytes, back, nullptr, &err));
+    CHECK(err.find("action") != std::string::npos);
+    badAction.events.back().action = kReplayLastAction;
+    encodeReplayBinary(badAction, badBytes);
+    CHECK(decodeReplayBinary(badBytes, back));
+    return true;
+}
+
+static void recordTurnHash(void* user, uint32_t turn, uint64_t hash) {
+    static_cast<std::vector<std::pair<uint32_t, uint64_t>>*>(user)->push_back({turn, hash});
+}
+
+bool test_replay_snapshot_resume_and_bisect() {
+    ReplayFile base;
+    base.meta.seed = 1357911u;
+    base.meta.bonesEnabled = false;
+    for (uint32_t e = 0; e < 120; ++e) {
+        ReplayEvent ev;
+        ev.tMs = 100u * (e + 1u);
+        ev.action = (e % 5u == 4u) ? Action::Wait : Action::AutoExplore;
+        base.events.push_back(ev);
+    }
+
+    // Reference run, recording every turn's hash (same stepping as the runner).
+    std::vector<std::pair<uint32_t, uint64_t>> turnHashes;
+    uint64_t refHash = 0;
+    uint32_t refTurns = 0;
+    {
+        Game g;
+        std::string err;
+        CHECK(prepareGameForReplay(g, base, &err));
+        g.setTurnHook(&recordTurnHash, &turnHashes);
+        turnHashes.push_back({g.turns(), g.determinismHash()});
+        size_t idx = 0;
+        for (uint32_t ms = 0;; ms += 16u) {
+            while (idx < base.events.size() && base.events[idx].tMs <= ms) g.handleAction(base.events[idx++].action);
+            if (idx >= base.events.size()) break;
+            g.update(0.016f);
+        }
+        g.clearTurnHook();
+        refHash = g.determinismHash();
+        refTurns = g.turns();
+    }
+    CHECK(refTurns > 60u);
+
+    auto withCheckpoints = [&](uint32_t badFrom) {
+        ReplayFile rf = base;
+        for (const auto& th : turnHashes) {
+            ReplayEvent ev;
+            ev.kind = ReplayEventType::StateHash;
+            ev.tMs = base.events.back().tMs;
+            ev.turn = th.first;
+            ev.hash = (badFrom != 0 && th.first >= badFrom) ? (th.second ^ 1u) : th.second;
+            rf.events.push_back(ev);
+        }
+        return rf;
+    };
+    const ReplayFile good = withCheckpoints(0);
+
+    // Taking snapshots must not change the run.
+    ReplaySnapshots snaps;
+    snaps.everyTurns = 10;
+    std::array<uint64_t, Game::kHashPartCount> straightParts{};
+    {
+        Game g;
+        std::string err;
+        CHECK(prepareGameForReplay(g, good, &err));
+        ReplayRunOptions opt;
+        opt.snapshots = &snaps;
+        ReplayRunStats stats;
+        CHECK(runReplayHeadless(g, good, opt, &stats, &err));
+        CHECK(stats.turns == refTurns);
+        CHECK(g.determinismHash() == refHash);
+        straightParts = g.determinismHashParts();
+    }
+    CHECK(snaps.list.size() >= 3u);
+    CHECK(snaps.memoryBytes() > 0u);
+    for (size_t i = 1; i < snaps.list.size(); ++i) CHECK(snaps.list[i - 1].turn < snaps.list[i].turn);
+
+    // Resuming from the middle reaches the same end state.
+    const ReplaySnapshot& mid = snaps.list[snaps.list.size() / 2];
+    CHECK(snaps.atOrBefore(mid.turn) == &mid);
+    CHECK(snaps.atOrBefore(snaps.list.front().turn - 1u) == nullptr);
+    {
+        Game g;
+        std::string err;
+        CHECK(prepareGameForReplay(g, good, &err));
+        ReplayRunStats stats;
+        CHECK(resumeReplayHeadless(g, good, mid, ReplayRunOptions{}, &stats, &err));
+        CHECK(stats.turns == refTurns);
+        CHECK(g.determinismHash() == refHash);
+
+        // Every subsystem hash matches the straight-through run, not just the combined one.
+        const auto parts = g.determinismHashParts();
+        CHECK(parts == straightParts);
+
+        // Dropping an item touches exactly the Items section.
+        g.ground.push_back(GroundItem{Item{}, g.player().pos});
+        const auto mutated = g.determinismHashParts();
+        for (size_t i = 0; i < Game::kHashPartCount; ++i) {
+            const bool isItems = i == static_cast<size_t>(Game::HashPart::Items);
+            CHECK((mutated[i] != parts[i]) == isItems);
+        }
+    }
+
+    // A clean replay bisects to "no divergence".
+    {
+        Game g;
+        std::string err;
+        CHECK(prepareGameForReplay(g, good, &err));
+        ReplayBisectResult br;
+        CHECK(bisectReplayDesync(g, good, ReplayRunOptions{}, 10u, br, &err));
+        CHECK(!br.diverged);
+    }
+
+    // A desync from turn 37 on: the sparse pass sees it at turn 40, the exact pass at 37.
+    {
+        const ReplayFile bad = withCheckpoints(37u);
+        Game g;
+        std::string err;
+        CHECK(prepareGameForReplay(g, bad, &err));
+        ReplayBisectResult br;
+        CHECK(bisectReplayDesync(g, bad, ReplayRunOptions{}, 10u, br, &err));
+        CHECK(br.diverged);
+        CHECK(br.turn == 37u);
+        CHECK(br.resumedFromTurn > 0u);
+        CHECK(br.resumedFromTurn <= 30u);
+        CHECK(br.beforeTurn == 36u);
+        CHECK(br.snapshots > 0u);
+        CHECK(!br.changedParts.empty());
+        CHECK(br.changedParts.front() == Game::HashPart::Core);
+    }
+    return true;
+}
+
+bool test_sprite_batch_parallel_matches_serial() {
+    // Renderer::init() generates its tilesets through SpriteBatch on a worker pool; the
+    // uploaded pixels must be exactly what the serial calls produce, in add() order.
+    constexpr int kFrames = 4; // Renderer::FRAMES
+    struct Slot {
+        int order = -1;
+        SpritePixels px;
+    };
+    std::vector<Slot> slots(3u * 4u * static_cast<size_t>(kFrames));
+    SpriteBatch<Slot> batch;
+    size_t k = 0;
+    for (uint32_t v = 0; v < 4u; ++v) {
+        for (int f = 0; f < kFrames; ++f) {
+            const uint32_t seed = hashCombine(0xF1000u, v);
+            batch.add(&slots[k++], [=] { return generateThemedFloorTile(seed, static_cast<uint8_t>(v % 3u), f, 32); });
+            batch.add(&slots[k++], [=] { return generateWallTile(seed, f, 32); });
+            batch.add(&slots[k++], [=] { return generateChasmTile(seed, f, 32); });
+        }
+    }
+    CHECK(batch.size() == slots.size());
+
+    int uploads = 0;
+    {
+        ThreadPool pool(3);
+        // A small chunk exercises the chunk boundaries.
+        batch.run(pool, [&](Slot& s, const SpritePixels& px) {
+            s.order = uploads++;
+            s.px = px;
+        }, 5u);
+    }
+    CHECK(batch.size() == 0u);
+    CHECK(uploads == static_cast<int>(slots.size()));
+
+    auto same = [](const SpritePixels& a, const SpritePixels& b) {
+        if (a.w != b.w || a.h != b.h || a.px.size() != b.px.size()) return false;
+        for (size_t i = 0; i < a.px.size(); ++i) {
+            const Color& x = a.px[i];
+            const Color& y = b.px[i];
+            if (x.r != y.r || x.g != y.g || x.b != y.b || x.a != y.a) return false;
+        }
+        return true;
+    };
+    k = 0;
+    for (uint32_t v = 0; v < 4u; ++v) {
+        for (int f = 0; f < kFrames; ++f) {
+            const uint32_t seed = hashCombine(0xF1000u, v);
+            CHECK(slots[k].order == static_cast<int>(k));
+            CHECK(same(slots[k++].px, generateThemedFloorTile(seed, static_cast<uint8_t>(v % 3u), f, 32)));
+            CHECK(same(slots[k++].px, generateWallTile(seed, f, 32)));
+            CHECK(same(slots[k++].px, generateChasmTile(seed, f, 32)));
+        }
+    }
+    CHECK(slots[0].px.w == 32);
+    return true;
+}
+
+bool test_sprite_disk_cache_roundtrip() {
+    const fs::path path = testTempFile("sprites.cache");
+    std::error_code ec;
+    fs::remove(path, ec);
+
+    auto sameSprite = [](const SpritePixels& a, const SpritePixels& b) {
+        if (a.w != b.w || a.h != b.h || a.px.size() != b.px.size()) return false;
+        for (size_t i = 0; i < a.px.size(); ++i) {
+            const Color& x = a.px[i];
+            const Color& y = b.px[i];
+            if (x.r != y.r || x.g != y.g || x.b != y.b || x.a != y.a) return false;
+        }
+        return true;
+    };
+
+    SpriteCacheKey wallKey;
+    wallKey.category = 7;
+    wallKey.seed = 0xAA110u;
+    wallKey.pxSize = 32;
+    SpriteCacheKey chasmKey = wallKey;
+    chasmKey.frame = 2;
+    const SpritePixels wall = generateWallTile(0xAA110u, 0, 32);
+    const SpritePixels chasm = generateChasmTile(0xAA110u, 2, 32);
+
+    {
+        SpriteDiskCache cache;
+        CHECK(cache.open(path, "stamp-a", 0));
+        SpritePixels out;
+        CHECK(!cache.get(wallKey, out));
+        int generated = 0;
+        const SpritePixels a = cache.getOrGenerate(wallKey, [&] { ++generated; return wall; });
+        const SpritePixels b = cache.getOrGenerate(wallKey, [&] { ++generated; return wall; });
+        CHECK(generated == 1);
+        CHECK(sameSprite(a, wall));
+        CHECK(sameSprite(b, wall));
+        cache.put(chasmKey, chasm);
+        CHECK(cache.stats().entries == 2u);
+        CHECK(cache.stats().writes == 2u);
+    }
+
+    // Reopened: served from the mapped file.
+    {
+        SpriteDiskCache cache;
+        CHECK(cache.open(path, "stamp-a", 0));
+        CHECK(cache.stats().entries == 2u);
+        SpritePixels out;
+        CHECK(cache.get(chasmKey, out));
+        CHECK(sameSprite(out, chasm));
+        CHECK(cache.get(wallKey, out));
+        CHECK(sameSprite(out, wall));
+        CHECK(cache.stats().hits == 2u);
+    }
+
+    // A torn tail (crash mid-append) is cut off; everything before it survives.
+    const auto fullSize = fs::file_size(path);
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::app);
+        f << "torn";
+    }
+    {
+        SpriteDiskCache cache;
+        CHECK(cache.open(path, "stamp-a", 0));
+        CHECK(cache.stats().entries == 2u);
+        CHECK(fs::file_size(path) == fullSize);
+    }
+
+    // A corrupted record reads as a miss.
+    {
+        std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(static_cast<std::streamoff>(fullSize) - 3);
+        f.put('\x5A');
+    }
+    {
+        SpriteDiskCache cache;
+        CHECK(cache.open(path, "stamp-a", 0));
+        SpritePixels out;
+        CHECK(!cache.get(chasmKey, out));
+        CHECK(cache.get(wallKey, out));
+    }
+
+    // Another stamp (new build / generator revision) starts over.
+    {
+        SpriteDiskCache cache;
+        CHECK(cache.open(path, "stamp-b", 0));
+        CHECK(cache.stats().entries == 0u);
+        SpritePixels out;
+        CHECK(!cache.get(wallKey, out));
+
+        // The size cap stops appends.
+        cache.close();
+        CHECK(cache.open(path, "stamp-b", 64));
+        cache.put(wallKey, wall);
+        CHECK(cache.stats().entries == 0u);
+    }
+    CHECK(!SpriteDiskCache::defaultStamp().empty());
+    return true;
+}
+
+bool test_sprite_job_queue_async_generation() {
+    // Renderer sprite-cache misses go through SpriteJobQueue: each key is generated once
+    // while pending, results come back through drain() within its byte budget, and
+    // cancelAll() discards work queued before a cache invalidation.
+    constexpr int kFrames = 4; // Renderer::FRAMES
+    auto genFrames = [](uint32_t seed) {
+        SpriteJobQueue::Frames frames;
+        for (int f = 0; f < kFrames; ++f) frames.push_back(generateEntitySprite(EntityKind::Goblin, seed, f, true, 24));
+        return frames;
+    };
+    auto same = [](const SpritePixels& a, const SpritePixels& b) {
+        if (a.w != b.w || a.h != b.h || a.px.size() != b.px.size()) return false;
+        for (size_t i = 0; i < a.px.size(); ++i) {
+            const Color& x = a.px[i];
+            const Color& y = b.px[i];
+            if (x.r != y.r || x.g != y.g || x.b != y.b || x.a != y.a) return false;
+        }
+        return true;
+    };
+
+    ThreadPool pool(2);
+    SpriteJobQueue q(pool);
+    for (uint64_t key = 1; key <= 6u; ++key) {
+        CHECK(q.request(key, [=] { return genFrames(static_cast<uint32_t>(key) * 977u); }));
+        CHECK(!q.request(key, [=] { return genFrames(0u); }));
+        CHECK(q.pending(key));
+    }
+    q.waitIdle();
+    CHECK(q.stats().queued == 6u);
+    CHECK(q.stats().depth == 6u);
+
+    // A budget smaller than one sprite still delivers one per call.
+    std::vector<uint64_t> order;
+    std::unordered_map<uint64_t, SpriteJobQueue::Frames> got;
+    auto upload = [&](uint64_t key, SpriteJobQueue::Frames& frames) {
+        order.push_back(key);
+        got[key] = frames;
+    };
+    CHECK(q.drain(1u, upload) == 1u);
+    CHECK(q.stats().depth == 5u);
+    CHECK(q.drain(0u, upload) == 5u);
+    CHECK(q.drain(0u, upload) == 0u);
+    CHECK(order.size() == 6u);
+
+    const SpriteJobQueue::Stats st = q.stats();
+    CHECK(st.depth == 0u);
+    CHECK(st.uploaded == 6u);
+    CHECK(st.avgMs > 0.0f);
+    CHECK(st.lastMs > 0.0f);
+    for (uint64_t key = 1; key <= 6u; ++key) {
+        CHECK(!q.pending(key));
+        const SpriteJobQueue::Frames want = genFrames(static_cast<uint32_t>(key) * 977u);
+        const SpriteJobQueue::Frames& have = got[key];
+        CHECK(have.size() == want.size());
+        for (size_t f = 0; f < want.size(); ++f) CHECK(same(have[f], want[f]));
+    }
+
+    // Cancelled while running: the job finishes but its result is dropped, and the key
+    // can be requested again right away.
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    CHECK(q.request(42u, [=] { opened.wait(); return genFrames(1u); }));
+    q.cancelAll();
+    CHECK(!q.pending(42u));
+    CHECK(q.stats().cancelled == 1u);
+    CHECK(q.request(42u, [=] { return genFrames(2u); }));
+    gate.set_value();
+    q.waitIdle();
+    order.clear();
+    CHECK(q.drain(0u, upload) == 1u);
+    CHECK(order.size() == 1u);
+    CHECK(!got[42u].empty());
+    CHECK(same(got[42u][0], genFrames(2u)[0]));
+    return true;
+}
+
+bool test_raycast_shade_kernel_matches_reference() {
+    // The Raycast3D column kernel must reproduce the renderer's old per-pixel lighting
+    // exactly: (texel * mod) / 255, clamp(round(c * shade)) with shade in 0..1.25, then a
+    // saturating specular add.
+    const raycast::PixelShifts shifts{16, 8, 0, 24};
+    auto reference = [&](const Color& c, const Color& mod, float s, int ar, int ag, int ab) -> uint32_t {
+        s = std::clamp(s, 0.0f, 1.25f);
+        auto ch = [&](uint8_t v, uint8_t m, int add) {
+            const int lit = (static_cast<int>(v) * static_cast<int>(m)) / 255;
+            const int shaded = std::clamp(static_cast<int>(std::round(static_cast<float>(lit) * s)), 0, 255);
+            return static_cast<uint32_t>(std::clamp(shaded + add, 0, 255));
+        };
+        return (ch(c.r, mod.r, ar) << 16) | (ch(c.g, mod.g, ag) << 8) | ch(c.b, mod.b, ab) | (255u << 24);
+    };
+
+    // Every texel/mod pair at a handful of shades (including the clamps and .5 ties).
+    const float shades[] = {0.0f, 0.5f, 0.85f, 1.0f, 1.15f, 1.25f, 1.4f, -0.2f};
+    raycast::ShadeSpan span;
+    std::vector<uint32_t> out(256u * 3u, 0u);
+    for (float s : shades) {
+        for (int m = 0; m < 256; ++m) {
+            span.reset(256);
+            for (int v = 0; v < 256; ++v) {
+                const uint8_t vb = static_cast<uint8_t>(v);
+                const uint8_t mb = static_cast<uint8_t>(m);
+                span.set(static_cast<size_t>(v), Color{vb, static_cast<uint8_t>(255 - v), static_cast<uint8_t>(v / 2), 255},
+                         Color{mb, mb, static_cast<uint8_t>(255 - m), 255}, s);
+                span.setSpecular(static_cast<size_t>(v), (v * 7) % 300 - 20, m % 3 == 0 ? 255 : 0, v % 5);
+            }
+            // Strided output, with an odd count so the scalar tail runs too.
+            raycast::shadeSpan(span, 255, shifts, out.data(), 3);
+            for (int v = 0; v < 255; ++v) {
+                const uint8_t vb = static_cast<uint8_t>(v);
+                const uint8_t mb = static_cast<uint8_t>(m);
+                const uint32_t want = reference(Color{vb, static_cast<uint8_t>(255 - v), static_cast<uint8_t>(v / 2), 255},
+                                                Color{mb, mb, static_cast<uint8_t>(255 - m), 255}, s,
+                                                std::clamp((v * 7) % 300 - 20, 0, 255), m % 3 == 0 ? 255 : 0, v % 5);
+                if (out[static_cast<size_t>(v) * 3u] != want) {
+                    std::cerr << "    shade " << s << " v " << v << " m " << m << std::hex << " got " << out[static_cast<size_t>(v) * 3u]
+                              << " want " << want << std::dec << "\n";
+                    return false;
+                }
+                CHECK(raycast::shadePixel(span, static_cast<size_t>(v), shifts) == want);
+            }
+            CHECK(out[1] == 0u);
+        }
+    }
+
+    // Near ties: for every lit value, shades putting lit * shade on, just below and just
+    // above each k + 0.5 (e.g. 1 * 0.49999997f must round to 0, not 1).
+    {
+        std::vector<std::pair<uint8_t, float>> ties;
+        for (int lit = 1; lit < 256; ++lit) {
+            for (int k = 0; (k + 0.5f) / static_cast<float>(lit) <= 1.25f; ++k) {
+                const float t = (static_cast<float>(k) + 0.5f) / static_cast<float>(lit);
+                for (float sv : {t, std::nextafter(t, 0.0f), std::nextafter(t, 2.0f)}) {
+                    ties.emplace_back(static_cast<uint8_t>(lit), sv);
+                }
+            }
+        }
+        span.reset(ties.size());
+        for (size_t i = 0; i < ties.size(); ++i) {
+            span.set(i, Color{ties[i].first, ties[i].first, ties[i].first, 255}, Color{255, 255, 255, 255}, ties[i].second);
+        }
+        std::vector<uint32_t> tieOut(ties.size(), 0u);
+        raycast::shadeSpan(span, ties.size(), shifts, tieOut.data(), 1);
+        size_t bad = 0;
+        for (size_t i = 0; i < ties.size(); ++i) {
+            const Color c{ties[i].first, ties[i].first, ties[i].first, 255};
+            if (tieOut[i] != reference(c, Color{255, 255, 255, 255}, ties[i].second, 0, 0, 0)) ++bad;
+        }
+        CHECK(bad == 0u);
+
+        span.reset(4);
+        for (size_t i = 0; i < 4; ++i) span.set(i, Color{1, 1, 1, 255}, Color{255, 255, 255, 255}, 0.49999997f);
+        raycast::shadeSpan(span, 4, shifts, tieOut.data(), 1);
+        CHECK(tieOut[0] == 0xff000000u);
+    }
+
+    // Fresh spans are black (opaque).
+    span.reset(8);
+    raycast::shadeSpan(span, 8, shifts, out.data(), 1);
+    for (size_t i = 0; i < 8; ++i) CHECK(out[i] == (255u << 24));
+    return true;
+}
+
+bool test_voxel_turntable_reuses_prepared_model() {
+    // Codex turntables keep the prepared voxel model and its lighting between yaw steps:
+    // a preview drawn from that cache must match one drawn from a freshly built model,
+    // also after the entry was evicted by other turntables, and previews of the same
+    // sprite rendered concurrently must agree.
+    auto opaque = [](const SpritePixels& s) {
+        size_t n = 0;
+        for (const Color& c : s.px) n += (c.a > 0) ? 1u : 0u;
+        return n;
+    };
+
+    const uint32_t seed = 4242u;
+    const SpritePixels base = generateEntitySprite(EntityKind::Goblin, seed, 1, false, 16);
+    auto preview = [&](float yaw) { return renderSprite3DEntityTurntable(EntityKind::Goblin, base, seed, 1, yaw, 64); };
+
+    // Fresh model: nothing cached yet.
+    clearVoxelTurntableCache();
+    const VoxelTurntableCacheStats s0 = voxelTurntableCacheStats();
+    const SpritePixels fresh = preview(0.7f);
+    const uint32_t freshHash = hashSpritePixels(fresh);
+    CHECK(fresh.w == 64 && fresh.h == 64);
+    CHECK(opaque(fresh) > 0u);
+    CHECK(voxelTurntableCacheStats().builds == s0.builds + 1u);
+
+    // Same and other yaw steps come from the cache.
+    CHECK(hashSpritePixels(preview(0.7f)) == freshHash);
+    const SpritePixels turned = preview(2.2f);
+    CHECK(hashSpritePixels(turned) != freshHash);
+    const VoxelTurntableCacheStats s1 = voxelTurntableCacheStats();
+    CHECK(s1.builds == s0.builds + 1u);
+    CHECK(s1.hits == s0.hits + 2u);
+
+    // Other entity, item and extruded turntables share the cache and push the goblin out;
+    // rebuilding it changes nothing.
+    const SpritePixels dagger = generateItemSprite(ItemKind::Dagger, seed, 0, false, 16);
+    for (uint32_t s = 0; s < 4u; ++s) {
+        CHECK(opaque(renderSprite3DItemTurntable(ItemKind::Dagger, dagger, seed + s, 0, 0.7f, 64)) > 0u);
+        CHECK(opaque(renderSprite3DEntityTurntable(EntityKind::Goblin, base, seed + 1u + s, 1, 0.7f, 64)) > 0u);
+        CHECK(opaque(renderSprite3DExtrudedTurntable(dagger, seed + s, 0, 0.7f, 64)) > 0u);
+    }
+    const VoxelTurntableCacheStats s2 = voxelTurntableCacheStats();
+    CHECK(s2.builds == s1.builds + 12u);
+    CHECK(hashSpritePixels(preview(0.7f)) == freshHash);
+    CHECK(voxelTurntableCacheStats().builds == s2.builds + 1u);
+    CHECK(hashSpritePixels(preview(2.2f)) == hashSpritePixels(turned));
+    CHECK(voxelTurntableCacheStats().builds == s2.builds + 1u);
+
+    ThreadPool pool(3);
+    std::vector<SpritePixels> got(6);
+    parallelFor(pool, got.size(), [&](size_t i) { got[i] = preview((i % 2 == 0) ? 0.7f : 2.2f); });
+    for (size_t i = 0; i < got.size(); i += 2) CHECK(hashSpritePixels(got[i]) == freshHash);
+    for (size_t i = 1; i < got.size(); i += 2) CHECK(hashSpritePixels(got[i]) == hashSpritePixels(turned));
+    return true;
+}
+
+bool test_entity_spatial_index() {
+    Game g;
+    g.newGame(0x51A7u);
+    g.changeLevel(1, true);
+
+    CHECK(g.validateEntityIndex());
+
+    // Spawn a handful of monsters next to the player (structural edit: detected by fingerprint).
+    const Vec2i pp = g.player().pos;
+    std::vector<int> ids;
+    for (int y = pp.y - 6; y <= pp.y + 6 && ids.size() < 6; ++y) {
+        for (int x = pp.x - 6; x <= pp.x + 6 && ids.size() < 6; ++x) {
+            if (!g.dung.inBounds(x, y) || !g.dung.isWalkable(x, y) || g.entityAt(x, y)) continue;
+            const Vec2i v{x, y};
+            Entity m = g.makeMonster(EntityKind::Goblin, v, 0, false);
+            ids.push_back(m.id);
+            g.ents.push_back(m);
+            CHECK(g.entityAt(v.x, v.y) != nullptr);
+            CHECK(g.entityAt(v.x, v.y)->id == m.id);
+        }
+    }
+    CHECK(ids.size() >= 2);
+    CHECK(g.validateEntityIndex());
+
+    // Stack two monsters on one tile, then split them again; lookups must keep ents order.
+    Entity* a = g.entityById(ids[0]);
+    Entity* b = g.entityById(ids[1]);
+    CHECK(a && b);
+    const Vec2i bPos = b->pos;
+    g.setEntityPos(*b, a->pos);
+    CHECK(g.entityAt(a->pos.x, a->pos.y) == a);
+    CHECK(g.entityAt(bPos.x, bPos.y) == nullptr);
+    CHECK(g.validateEntityIndex());
+    g.setEntityPos(*a, bPos);
+    CHECK(g.entityAt(bPos.x, bPos.y) == a);
+    CHECK(g.entityAt(b->pos.x, b->pos.y) == b);
+    CHECK(g.validateEntityIndex());
+
+    // Dead entities are not occupants, and cleanupDead() compacts the slots.
+    b->hp = 0;
+    CHECK(g.entityAt(b->pos.x, b->pos.y) == nullptr);
+    const int deadId = ids[1];
+    g.cleanupDead();
+    CHECK(g.entityById(deadId) == nullptr);
+    CHECK(g.entityById(ids[0]) != nullptr);
+    CHECK(g.validateEntityIndex());
+
+    // Play a few turns so monsters move through the normal AI paths.
+    for (int i = 0; i < 20; ++i) g.handleAction(Action::Wait);
+    CHECK(g.validateEntityIndex());
+
+    return true;
+}
+
 bool test_save_load_roundtrip() {
     Game g;
     g.newGame(98765u);
@@ -3392,6 +5638,10 @@ bool test_auto_explore_frontier_levitation_crosses_chasm() {
     d.at(chasm.x, chasm.y).explored = true;
     d.at(frontier.x, frontier.y).explored = true;
 
+    // The tiles above were hand-edited (bypassing the terrain journal): start a new layout
+    // epoch so derived caches (nav grid, tile planes) rebuild from them.
+    d.resetTerrainJournal();
+
     g.playerMut().pos = start;
 
     // Without levitation: frontier is unreachable (only path crosses chasm).
@@ -3472,6 +5722,10 @@ bool test_auto_explore_frontier_levitation_diagonal_chasm_corner() {
     if (i1 >= 0 && static_cast<size_t>(i1) < g.fireField_.size()) g.fireField_[static_cast<size_t>(i1)] = 10u;
     if (i2 >= 0 && static_cast<size_t>(i2) < g.fireField_.size()) g.fireField_[static_cast<size_t>(i2)] = 10u;
 
+    // The tiles above were hand-edited (bypassing the terrain journal): start a new layout
+    // epoch so derived caches (nav grid, tile planes) rebuild from them.
+    d.resetTerrainJournal();
+
     g.playerMut().pos = start;
 
     // Without levitation: frontier is unreachable.
@@ -4466,6 +6720,36 @@ bool test_spritegen_resample_rect_factor_6_matches_chain() {
 int main(int argc, char** argv) {
     std::vector<TestCase> tests = {
         {"new_game_determinism", test_new_game_determinism},
+        {"dijkstra_engine_relaxation", test_dijkstra_engine_matches_relaxation},
+        {"entity_spatial_index", test_entity_spatial_index},
+        {"monster_nav_grid_tracks_terrain_edits", test_monster_nav_grid_tracks_terrain_edits},
+        {"monster_cost_cache_lru", test_monster_cost_cache_lru},
+        {"monster_cost_cache_hazard_ids", test_monster_cost_cache_hazard_ids},
+        {"monster_cost_cache_hazard_decay_hits", test_monster_cost_cache_hazard_decay_hits},
+        {"determinism_hash_cache", test_determinism_hash_cache},
+        {"floor_candidates_parallel", test_floor_candidates_parallel},
+        {"parallel_for_ordered", test_parallel_for_ordered},
+        {"floor_prefetch_matches_sync", test_floor_prefetch_matches_sync},
+        {"overworld_prefetch_matches_sync", test_overworld_prefetch_matches_sync},
+        {"overworld_prefetch_eviction", test_overworld_prefetch_eviction},
+        {"overworld_atlas_after_level_swap", test_overworld_atlas_after_level_swap},
+        {"level_snapshot_pack", test_level_snapshot_pack},
+        {"level_swap_benchmark", test_level_swap_benchmark},
+        {"fov_shadowcast_matches_reference", test_fov_shadowcast_matches_reference},
+        {"noise_batch_matches_immediate", test_noise_batch_matches_immediate},
+        {"hazard_kernels_match_reference", test_hazard_kernels_match_reference},
+        {"hazard_active_regions", test_hazard_active_regions},
+        {"darkness_fov_revision", test_darkness_fov_revision},
+        {"light_map_incremental", test_light_map_incremental},
+        {"explore_frontier_incremental", test_explore_frontier_incremental},
+        {"parallel_replays_match_serial", test_parallel_replays_match_serial},
+        {"replay_binary_roundtrip", test_replay_binary_roundtrip},
+        {"replay_snapshot_resume_and_bisect", test_replay_snapshot_resume_and_bisect},
+        {"sprite_batch_parallel_matches_serial", test_sprite_batch_parallel_matches_serial},
+        {"sprite_disk_cache_roundtrip", test_sprite_disk_cache_roundtrip},
+        {"sprite_job_queue_async_generation", test_sprite_job_queue_async_generation},
+        {"raycast_shade_kernel_matches_reference", test_raycast_shade_kernel_matches_reference},
+        {"voxel_turntable_reuses_prepared_model", test_voxel_turntable_reuses_prepared_model},
         {"scent_field_wind_bias", test_scent_field_wind_bias},
         {"ecosystem_stealth_fx", test_ecosystem_stealth_fx_sanity},
         {"ecosystem_weapon_ego_loot_bias", test_ecosystem_weapon_ego_loot_bias},